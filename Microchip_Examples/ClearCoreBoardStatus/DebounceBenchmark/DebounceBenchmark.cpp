@@ -0,0 +1,174 @@
+/*
+ * Title: DebounceBenchmark
+ *
+ * Objective:
+ *    This example measures the cost of debouncing a port of inputs with the
+ *    per-connector countdown filter that DigitalIn used to run against the
+ *    bit-parallel VerticalDebounce now used by the InputManager.
+ *
+ * Description:
+ *    Feeds the same pseudo-random input port through both filters and prints
+ *    the average CPU cycles per sample of each to the USB serial port, both
+ *    with the inputs toggling and with them quiet, along with the number of
+ *    filtered states that differ. Both filters should agree.
+ *
+ * Requirements:
+ * ** None
+ *
+ * Links:
+ * ** ClearCore Documentation: https://teknic-inc.github.io/ClearCore-library/
+ * ** ClearCore Manual: https://www.teknic.com/files/downloads/clearcore_user_manual.pdf
+ *
+ * 
+ * Copyright (c) 2020 Teknic Inc. This work is free to use, copy and distribute under the terms of
+ * the standard MIT permissive software license which can be found at https://opensource.org/licenses/MIT
+ */
+
+#include "ClearCore.h"
+
+// Select the baud rate to match the target serial device
+#define baudRate 9600
+
+// Specify which serial to use: ConnectorUsb, ConnectorCOM0, or ConnectorCOM1.
+#define SerialPort ConnectorUsb
+
+// Time between repeated runs of the benchmark, in milliseconds
+#define repeatTimeMs 5000
+
+// Number of samples filtered by the benchmark
+#define filterSamples 10000
+
+// Number of inputs debounced by the benchmark, one per connector that has a
+// digital input filter
+#define debounceInputs 17
+
+// Declares a helper function used to run the measurement
+void BenchmarkDebounce();
+
+int main() {
+    // Set up serial communication at a baud rate of 9600 bps then wait up to
+    // 5 seconds for a port to open.
+    SerialPort.Mode(Connector::USB_CDC);
+    SerialPort.Speed(baudRate);
+    uint32_t timeout = 5000;
+    uint32_t startTime = Milliseconds();
+    SerialPort.PortOpen();
+    while (!SerialPort && Milliseconds() - startTime < timeout) {
+        continue;
+    }
+
+    while (true) {
+        BenchmarkDebounce();
+        Delay_ms(repeatTimeMs);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * CountdownFilter
+ *
+ *    The per-connector filter DigitalIn ran from its virtual Refresh(): reload
+ *    a countdown on every input change and take the input's value when it
+ *    expires.
+ */
+class CountdownFilter {
+public:
+    CountdownFilter() : length(3), ticksLeft(1), filtered(false) {}
+    virtual ~CountdownFilter() {}
+
+    virtual void Refresh(uint32_t inputs, uint32_t changes, uint32_t mask) {
+        if (changes & mask) {
+            ticksLeft = length;
+            if (!length) {
+                filtered = inputs & mask;
+            }
+        }
+        else if (ticksLeft && !--ticksLeft) {
+            filtered = inputs & mask;
+        }
+    }
+
+    uint16_t length;
+    uint16_t ticksLeft;
+    bool filtered;
+};
+//------------------------------------------------------------------------------
+
+/*------------------------------------------------------------------------------
+ * BenchmarkDebounce
+ *
+ *    Feeds the same pseudo-random input port through one CountdownFilter per
+ *    input and through a VerticalDebounce, using a mix of filter lengths.
+ *    Prints the average cycles per sample of each, both with the inputs
+ *    toggling and with them quiet, and the number of filtered states that
+ *    differ.
+ *
+ * Parameters: None
+ *
+ * Returns: None
+ */
+void BenchmarkDebounce() {
+    CountdownFilter countdown[debounceInputs];
+    CountdownFilter *filters[debounceInputs];
+    ClearCore::VerticalDebounce vertical;
+    uint32_t countdownCycles[2] = {0, 0};
+    uint32_t verticalCycles[2] = {0, 0};
+    uint32_t mismatches = 0;
+    uint32_t inputs = 0;
+    uint32_t seed = 1;
+
+    for (uint8_t i = 0; i < debounceInputs; i++) {
+        // Mostly the default length, with a few short and long filters
+        uint16_t length = (i % 4) ? 3 : (i * 5) % 60;
+        // Both start settled with every input deasserted
+        countdown[i].length = length;
+        countdown[i].ticksLeft = 0;
+        filters[i] = &countdown[i];
+        vertical.Length(1UL << i, length);
+        vertical.Stop(1UL << i);
+    }
+
+    for (uint32_t sample = 0; sample < 2 * filterSamples; sample++) {
+        // Toggle random inputs for the first half, then hold them steady
+        bool quiet = sample >= filterSamples;
+        uint32_t changes = 0;
+        if (!quiet) {
+            seed = seed * 1103515245 + 12345;
+            changes = (seed >> 8) & (seed >> 16) &
+                      ((1UL << debounceInputs) - 1);
+        }
+        inputs ^= changes;
+
+        __disable_irq();
+        uint32_t start = DWT->CYCCNT;
+        for (uint8_t i = 0; i < debounceInputs; i++) {
+            filters[i]->Refresh(inputs, changes, 1UL << i);
+        }
+        uint32_t middle = DWT->CYCCNT;
+        vertical.Update(inputs, changes);
+        uint32_t end = DWT->CYCCNT;
+        __enable_irq();
+
+        countdownCycles[quiet] += middle - start;
+        verticalCycles[quiet] += end - middle;
+        for (uint8_t i = 0; i < debounceInputs; i++) {
+            if (countdown[i].filtered != ((vertical.Filtered() >> i) & 1)) {
+                mismatches++;
+            }
+        }
+    }
+
+    SerialPort.Send("Countdown cycles/sample:\t");
+    SerialPort.Send(countdownCycles[0] / filterSamples);
+    SerialPort.Send(" toggling, ");
+    SerialPort.Send(countdownCycles[1] / filterSamples);
+    SerialPort.SendLine(" quiet");
+    SerialPort.Send("Vertical cycles/sample:\t\t");
+    SerialPort.Send(verticalCycles[0] / filterSamples);
+    SerialPort.Send(" toggling, ");
+    SerialPort.Send(verticalCycles[1] / filterSamples);
+    SerialPort.SendLine(" quiet");
+    SerialPort.Send("Mismatched states:\t\t");
+    SerialPort.SendLine(mismatches);
+    SerialPort.SendLine();
+}
+//------------------------------------------------------------------------------
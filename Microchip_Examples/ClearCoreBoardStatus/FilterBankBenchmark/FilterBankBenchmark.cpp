@@ -0,0 +1,138 @@
+/*
+ * Title: FilterBankBenchmark
+ *
+ * Objective:
+ *    This example measures the cost of filtering every ADC channel with
+ *    individual Iir16 filters against the Iir16Bank used by the AdcManager.
+ *
+ * Description:
+ *    Runs the same pseudo-random inputs through one Iir16 per ADC channel
+ *    and through an Iir16Bank, first changing every sample and then held
+ *    steady, and prints the average CPU cycles per sample of each to the USB
+ *    serial port, along with the number of outputs that differ. Both filters
+ *    should produce identical outputs. Once the inputs are steady, the bank
+ *    skips the filters that have settled.
+ *
+ * Requirements:
+ * ** None
+ *
+ * Links:
+ * ** ClearCore Documentation: https://teknic-inc.github.io/ClearCore-library/
+ * ** ClearCore Manual: https://www.teknic.com/files/downloads/clearcore_user_manual.pdf
+ *
+ * 
+ * Copyright (c) 2020 Teknic Inc. This work is free to use, copy and distribute under the terms of
+ * the standard MIT permissive software license which can be found at https://opensource.org/licenses/MIT
+ */
+
+#include "ClearCore.h"
+
+// Select the baud rate to match the target serial device
+#define baudRate 9600
+
+// Specify which serial to use: ConnectorUsb, ConnectorCOM0, or ConnectorCOM1.
+#define SerialPort ConnectorUsb
+
+// Time between repeated runs of the benchmark, in milliseconds
+#define repeatTimeMs 5000
+
+// Number of samples filtered by the benchmark
+#define filterSamples 10000
+
+// Declares a helper function used to run the measurement
+void BenchmarkFilters();
+
+int main() {
+    // Set up serial communication at a baud rate of 9600 bps then wait up to
+    // 5 seconds for a port to open.
+    SerialPort.Mode(Connector::USB_CDC);
+    SerialPort.Speed(baudRate);
+    uint32_t timeout = 5000;
+    uint32_t startTime = Milliseconds();
+    SerialPort.PortOpen();
+    while (!SerialPort && Milliseconds() - startTime < timeout) {
+        continue;
+    }
+
+    while (true) {
+        BenchmarkFilters();
+        Delay_ms(repeatTimeMs);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * BenchmarkFilters
+ *
+ *    Runs the same pseudo-random inputs through one Iir16 per ADC channel and
+ *    through an Iir16Bank, changing the inputs for the first half of the run
+ *    and holding them for the second. Prints the average cycles per sample
+ *    of each, with the inputs changing and steady, and the number of outputs
+ *    that differ.
+ *
+ * Parameters: None
+ *
+ * Returns: None
+ */
+void BenchmarkFilters() {
+    const uint8_t channels = AdcManager::ADC_CHANNEL_COUNT;
+    ClearCore::Iir16 single[channels];
+    ClearCore::Iir16Bank<channels> bank;
+    uint16_t inputs[channels];
+    uint16_t outputs[channels];
+    uint32_t singleCycles[2] = {0, 0};
+    uint32_t bankCycles[2] = {0, 0};
+    uint32_t mismatches = 0;
+    uint32_t seed = 1;
+
+    for (uint8_t i = 0; i < channels; i++) {
+        uint16_t tc = ClearCore::Iir16::TcFromSamples(5 + i * 20);
+        single[i].Tc(tc);
+        bank.Tc(i, tc);
+    }
+
+    for (uint32_t sample = 0; sample < 2 * filterSamples; sample++) {
+        // Change the inputs for the first half, then hold them steady
+        bool steady = sample >= filterSamples;
+        if (!steady) {
+            for (uint8_t i = 0; i < channels; i++) {
+                seed = seed * 1103515245 + 12345;
+                inputs[i] = (seed >> 16) & INT16_MAX;
+            }
+        }
+
+        // Keep the interrupt out of the measurements
+        __disable_irq();
+        uint32_t start = DWT->CYCCNT;
+        for (uint8_t i = 0; i < channels; i++) {
+            single[i].Update(inputs[i]);
+            outputs[i] = single[i].LastOutput();
+        }
+        uint32_t middle = DWT->CYCCNT;
+        bank.Update(inputs, outputs);
+        uint32_t end = DWT->CYCCNT;
+        __enable_irq();
+
+        singleCycles[steady] += middle - start;
+        bankCycles[steady] += end - middle;
+        for (uint8_t i = 0; i < channels; i++) {
+            if (outputs[i] != single[i].LastOutput()) {
+                mismatches++;
+            }
+        }
+    }
+
+    SerialPort.Send("Iir16 cycles/sample:\t\t");
+    SerialPort.Send(singleCycles[0] / filterSamples);
+    SerialPort.Send(" changing, ");
+    SerialPort.Send(singleCycles[1] / filterSamples);
+    SerialPort.SendLine(" steady");
+    SerialPort.Send("Iir16Bank cycles/sample:\t");
+    SerialPort.Send(bankCycles[0] / filterSamples);
+    SerialPort.Send(" changing, ");
+    SerialPort.Send(bankCycles[1] / filterSamples);
+    SerialPort.SendLine(" steady");
+    SerialPort.Send("Mismatched outputs:\t\t");
+    SerialPort.SendLine(mismatches);
+    SerialPort.SendLine();
+}
+//------------------------------------------------------------------------------
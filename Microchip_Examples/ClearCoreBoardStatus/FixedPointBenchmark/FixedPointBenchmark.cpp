@@ -0,0 +1,134 @@
+/*
+ * Title: FixedPointBenchmark
+ *
+ * Objective:
+ *    This example measures the cost of the single-precision HLFB duty
+ *    conversion against the double-precision math it replaced, and checks
+ *    the saturating FixedPoint operations.
+ *
+ * Description:
+ *    Converts pseudo-random HLFB pulse widths to a duty percentage with both
+ *    methods and prints the average CPU cycles of each to the USB serial
+ *    port, along with the largest difference between them. It also runs Q15
+ *    additions and multiplications through both FixedPoint and a reference
+ *    written with 32-bit integers and prints the number of results that
+ *    differ.
+ *
+ * Requirements:
+ * ** None
+ *
+ * Links:
+ * ** ClearCore Documentation: https://teknic-inc.github.io/ClearCore-library/
+ * ** ClearCore Manual: https://www.teknic.com/files/downloads/clearcore_user_manual.pdf
+ *
+ * 
+ * Copyright (c) 2020 Teknic Inc. This work is free to use, copy and distribute under the terms of
+ * the standard MIT permissive software license which can be found at https://opensource.org/licenses/MIT
+ */
+
+#include "ClearCore.h"
+
+// Select the baud rate to match the target serial device
+#define baudRate 9600
+
+// Specify which serial to use: ConnectorUsb, ConnectorCOM0, or ConnectorCOM1.
+#define SerialPort ConnectorUsb
+
+// Time between repeated runs of the benchmark, in milliseconds
+#define repeatTimeMs 5000
+
+// Number of samples converted by the benchmark
+#define filterSamples 10000
+
+// Declares a helper function used to run the measurement
+void BenchmarkFixedPoint();
+
+int main() {
+    // Set up serial communication at a baud rate of 9600 bps then wait up to
+    // 5 seconds for a port to open.
+    SerialPort.Mode(Connector::USB_CDC);
+    SerialPort.Speed(baudRate);
+    uint32_t timeout = 5000;
+    uint32_t startTime = Milliseconds();
+    SerialPort.PortOpen();
+    while (!SerialPort && Milliseconds() - startTime < timeout) {
+        continue;
+    }
+
+    while (true) {
+        BenchmarkFixedPoint();
+        Delay_ms(repeatTimeMs);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * BenchmarkFixedPoint
+ *
+ *    Converts pseudo-random HLFB pulse widths to a duty percentage with the
+ *    original double-precision formula and with the single-precision one
+ *    that MotorDriver uses now, and runs Q15
+ *    additions and multiplications through both FixedPoint and a reference
+ *    written with 32-bit integers. Prints the average cycles of each duty
+ *    conversion, the largest duty difference, and the number of Q15 results
+ *    that differ from the reference.
+ *
+ * Parameters: None
+ *
+ * Returns: None
+ */
+void BenchmarkFixedPoint() {
+    uint32_t doubleCycles = 0;
+    uint32_t singleCycles = 0;
+    uint32_t mismatches = 0;
+    float maxError = 0;
+    uint32_t seed = 1;
+
+    for (uint32_t sample = 0; sample < filterSamples; sample++) {
+        seed = seed * 1103515245 + 12345;
+        uint16_t period = (seed >> 16) | 1;
+        uint16_t width = (seed & UINT16_MAX) % period;
+
+        __disable_irq();
+        uint32_t start = DWT->CYCCNT;
+        volatile float dutyDouble = (static_cast<float>(width) /
+                                     static_cast<float>(period) - 0.05) *
+                                    (10000. / 90.);
+        uint32_t middle = DWT->CYCCNT;
+        volatile float dutySingle =
+            static_cast<float>((20 * width - period) * 50) /
+            static_cast<float>(9 * period);
+        uint32_t end = DWT->CYCCNT;
+        __enable_irq();
+
+        doubleCycles += middle - start;
+        singleCycles += end - middle;
+        float error = fabsf(dutyDouble - dutySingle);
+        if (error > maxError) {
+            maxError = error;
+        }
+
+        int16_t a = seed >> 16;
+        int16_t b = seed;
+        int32_t sum = static_cast<int32_t>(a) + b;
+        sum = (sum > INT16_MAX) ? INT16_MAX :
+              (sum < INT16_MIN) ? INT16_MIN : sum;
+        int32_t product = (static_cast<int32_t>(a) * b) >> 15;
+        product = (product > INT16_MAX) ? INT16_MAX : product;
+        ClearCore::Q15 qa = ClearCore::Q15::FromRaw(a);
+        ClearCore::Q15 qb = ClearCore::Q15::FromRaw(b);
+        if ((qa + qb).Raw() != sum || (qa * qb).Raw() != product) {
+            mismatches++;
+        }
+    }
+
+    SerialPort.Send("HLFB duty (double) cycles:\t");
+    SerialPort.SendLine(doubleCycles / filterSamples);
+    SerialPort.Send("HLFB duty (single) cycles:\t");
+    SerialPort.SendLine(singleCycles / filterSamples);
+    SerialPort.Send("Max duty difference (%):\t");
+    SerialPort.SendLine(maxError, 6);
+    SerialPort.Send("Mismatched Q15 results:\t\t");
+    SerialPort.SendLine(mismatches);
+    SerialPort.SendLine();
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,183 @@
+/*
+ * Title: IsrTimingBenchmark
+ *
+ * Objective:
+ *    This example measures the execution time of the ClearCore's sample-rate
+ *    interrupt under different code placement and cache configurations.
+ *
+ * Description:
+ *    For each cache configuration, this example clears the interrupt timing
+ *    statistics, lets the board run for a few seconds, then prints the
+ *    minimum and maximum interrupt duration in CPU cycles to the USB serial
+ *    port. The spread between the minimum and maximum is the jitter caused
+ *    by flash wait states and cache misses.
+ *
+ *    Build both this example and libClearCore with CLEARCORE_HOT_CODE_IN_RAM
+ *    defined to run the sample-rate code from SRAM, and compare the results
+ *    against a build without it. Likewise, build both with
+ *    CLEARCORE_STATIC_SINGLETONS defined to compare the library managers
+ *    defined as plain globals against the default heap-allocated managers
+ *    reached through global references.
+ *
+ *    Each pass also prints three figures that differ between those builds:
+ *    the flash image size taken from the linker symbols, the CPU cycles
+ *    spent from reset to main(), and the average cycles for one call made
+ *    through a manager global with interrupts masked. The flash size can be
+ *    cross-checked with arm-none-eabi-size on the two .elf files.
+ *
+ * Requirements:
+ * ** None
+ *
+ * Links:
+ * ** ClearCore Documentation: https://teknic-inc.github.io/ClearCore-library/
+ * ** ClearCore Manual: https://www.teknic.com/files/downloads/clearcore_user_manual.pdf
+ *
+ * 
+ * Copyright (c) 2020 Teknic Inc. This work is free to use, copy and distribute under the terms of
+ * the standard MIT permissive software license which can be found at https://opensource.org/licenses/MIT
+ */
+
+#include "ClearCore.h"
+
+// Select the baud rate to match the target serial device
+#define baudRate 9600
+
+// Specify which serial to use: ConnectorUsb, ConnectorCOM0, or ConnectorCOM1.
+#define SerialPort ConnectorUsb
+
+// Length of each measurement, in milliseconds
+#define measureTimeMs 5000
+
+// Number of calls timed by the manager access measurement
+#define accessCount 1000
+
+// Flash image bounds from the linker script
+extern uint32_t __text_start__;
+extern uint32_t __etext;
+extern uint32_t __data_start__;
+extern uint32_t __data_end__;
+
+// Declares helper functions used to run the measurements
+void MeasureIsr(const char *description);
+void MeasureStorage();
+
+int main() {
+    // Set up serial communication at a baud rate of 9600 bps then wait up to
+    // 5 seconds for a port to open.
+    SerialPort.Mode(Connector::USB_CDC);
+    SerialPort.Speed(baudRate);
+    uint32_t timeout = 5000;
+    uint32_t startTime = Milliseconds();
+    SerialPort.PortOpen();
+    while (!SerialPort && Milliseconds() - startTime < timeout) {
+        continue;
+    }
+
+    while (true) {
+#ifdef CLEARCORE_HOT_CODE_IN_RAM
+        SerialPort.SendLine("Sample-rate code placement: SRAM");
+#else
+        SerialPort.SendLine("Sample-rate code placement: flash");
+#endif
+#ifdef CLEARCORE_STATIC_SINGLETONS
+        SerialPort.SendLine("Manager storage: static globals");
+#else
+        SerialPort.SendLine("Manager storage: heap");
+#endif
+        MeasureStorage();
+
+        // Default configuration, cache enabled and all ways available
+        SysMgr.CacheWaysLock(0);
+        SysMgr.CacheInvalidate();
+        SysMgr.CacheEnable(true);
+        MeasureIsr("Cache enabled:\t\t");
+
+        // Every fetch from flash pays the wait states
+        SysMgr.CacheEnable(false);
+        MeasureIsr("Cache disabled:\t\t");
+
+        // Let the interrupt fill way 0 while the other ways are locked, then
+        // lock way 0 as well so that its contents stay resident.
+        SysMgr.CacheInvalidate();
+        SysMgr.CacheEnable(true);
+        SysMgr.CacheWaysLock(0xE);
+        Delay_ms(100);
+        SysMgr.CacheWaysLock(0xF);
+        MeasureIsr("Cache locked:\t\t");
+
+        SysMgr.CacheWaysLock(0);
+        SerialPort.SendLine();
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * MeasureIsr
+ *
+ *    Clears the interrupt timing statistics, waits for the measurement
+ *    period, and prints the minimum and maximum interrupt durations.
+ *
+ * Parameters:
+ *    const char *description - Label printed before the results
+ *
+ * Returns: None
+ */
+void MeasureIsr(const char *description) {
+    uint32_t minCycles, maxCycles;
+
+    // Discard anything collected before this configuration took effect
+    Delay_ms(10);
+    TimingMgr.GetIsrLoading(minCycles, maxCycles);
+
+    Delay_ms(measureTimeMs);
+    TimingMgr.GetIsrLoading(minCycles, maxCycles);
+
+    SerialPort.Send(description);
+    SerialPort.Send("min ");
+    SerialPort.Send(minCycles);
+    SerialPort.Send(" cycles, max ");
+    SerialPort.Send(maxCycles);
+    SerialPort.Send(" cycles, jitter ");
+    SerialPort.Send(maxCycles - minCycles);
+    SerialPort.SendLine(" cycles");
+}
+//------------------------------------------------------------------------------
+
+/*------------------------------------------------------------------------------
+ * MeasureStorage
+ *
+ *    Prints the flash image size, the startup cycle count, and the average
+ *    cycles taken by a call made through a manager global.
+ *
+ * Parameters: None
+ *
+ * Returns: None
+ */
+void MeasureStorage() {
+    uint32_t flashBytes =
+        reinterpret_cast<uint32_t>(&__etext) -
+        reinterpret_cast<uint32_t>(&__text_start__) +
+        reinterpret_cast<uint32_t>(&__data_end__) -
+        reinterpret_cast<uint32_t>(&__data_start__);
+    SerialPort.Send("Flash image:\t\t");
+    SerialPort.Send(flashBytes);
+    SerialPort.SendLine(" bytes");
+
+    SerialPort.Send("Startup:\t\t");
+    SerialPort.Send(SysMgr.StartupCycles());
+    SerialPort.SendLine(" cycles");
+
+    // The empty asm statement makes the compiler reload the manager each
+    // time around, as separate interrupt handlers would
+    __disable_irq();
+    uint32_t startCycles = DWT->CYCCNT;
+    for (uint32_t i = 0; i < accessCount; i++) {
+        StatusMgr.StatusRT();
+        __asm__ volatile("" ::: "memory");
+    }
+    uint32_t accessCycles = DWT->CYCCNT - startCycles;
+    __enable_irq();
+    SerialPort.Send("Manager access:\t\t");
+    SerialPort.Send(accessCycles / accessCount);
+    SerialPort.SendLine(" cycles per call");
+}
+//------------------------------------------------------------------------------
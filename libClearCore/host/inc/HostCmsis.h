@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file HostCmsis.h
+    \brief Host model of the Cortex-M4 core used by the library.
+
+    Provides the subset of CMSIS-Core that libClearCore uses: the interrupt
+    numbers, the NVIC, SysTick, SCB, DWT and CoreDebug registers, and the
+    core intrinsics. Interrupts are delivered by the virtual-time scheduler
+    in HostCore.cpp, which advances time whenever DWT->CYCCNT is read.
+**/
+
+#ifndef __HOSTCMSIS_H__
+#define __HOSTCMSIS_H__
+
+#include <stdint.h>
+
+// As in CMSIS, read-only registers are only const to C code
+#ifdef __cplusplus
+#define __I volatile
+#else
+#define __I volatile const
+#endif
+#define __O volatile
+#define __IO volatile
+
+/** Number of NVIC priority bits implemented by the SAME53. **/
+#define __NVIC_PRIO_BITS 3
+
+/**
+    Interrupt numbers, matching the SAME53 vector table.
+**/
+typedef enum IRQn {
+    NonMaskableInt_IRQn = -14,
+    HardFault_IRQn = -13,
+    MemoryManagement_IRQn = -12,
+    BusFault_IRQn = -11,
+    UsageFault_IRQn = -10,
+    SVCall_IRQn = -5,
+    DebugMonitor_IRQn = -4,
+    PendSV_IRQn = -2,
+    SysTick_IRQn = -1,
+    PM_IRQn = 0,
+    MCLK_IRQn = 1,
+    OSCCTRL_0_IRQn = 2,
+    OSC32KCTRL_IRQn = 7,
+    SUPC_0_IRQn = 8,
+    SUPC_1_IRQn = 9,
+    WDT_IRQn = 10,
+    RTC_IRQn = 11,
+    EIC_0_IRQn = 12,
+    EIC_1_IRQn = 13,
+    EIC_2_IRQn = 14,
+    EIC_3_IRQn = 15,
+    EIC_4_IRQn = 16,
+    EIC_5_IRQn = 17,
+    EIC_6_IRQn = 18,
+    EIC_7_IRQn = 19,
+    EIC_8_IRQn = 20,
+    EIC_9_IRQn = 21,
+    EIC_10_IRQn = 22,
+    EIC_11_IRQn = 23,
+    EIC_12_IRQn = 24,
+    EIC_13_IRQn = 25,
+    EIC_14_IRQn = 26,
+    EIC_15_IRQn = 27,
+    FREQM_IRQn = 28,
+    NVMCTRL_0_IRQn = 29,
+    NVMCTRL_1_IRQn = 30,
+    DMAC_0_IRQn = 31,
+    DMAC_1_IRQn = 32,
+    DMAC_2_IRQn = 33,
+    DMAC_3_IRQn = 34,
+    DMAC_4_IRQn = 35,
+    EVSYS_0_IRQn = 36,
+    PAC_IRQn = 41,
+    RAMECC_IRQn = 45,
+    SERCOM0_0_IRQn = 46,
+    SERCOM1_0_IRQn = 50,
+    SERCOM2_0_IRQn = 54,
+    SERCOM3_0_IRQn = 58,
+    SERCOM4_0_IRQn = 62,
+    SERCOM5_0_IRQn = 66,
+    SERCOM6_0_IRQn = 70,
+    SERCOM7_0_IRQn = 74,
+    CAN0_IRQn = 78,
+    CAN1_IRQn = 79,
+    USB_0_IRQn = 80,
+    USB_1_IRQn = 81,
+    USB_2_IRQn = 82,
+    USB_3_IRQn = 83,
+    GMAC_IRQn = 84,
+    TCC0_0_IRQn = 85,
+    TCC1_0_IRQn = 92,
+    TCC2_0_IRQn = 97,
+    TCC3_0_IRQn = 101,
+    TCC4_0_IRQn = 104,
+    TC0_IRQn = 107,
+    PDEC_0_IRQn = 115,
+    ADC0_0_IRQn = 118,
+    ADC1_0_IRQn = 120,
+    DAC_0_IRQn = 123,
+    PERIPH_COUNT_IRQn = 137
+} IRQn_Type;
+
+//*****************************************************************************
+// Scheduler entry points (HostCore.cpp)
+//
+
+/** Advance virtual time by one poll and return the cycle counter. **/
+uint32_t HostCycleRead();
+/** Set the cycle counter without moving virtual time. **/
+void HostCycleWrite(uint32_t value);
+/** Enable or disable an interrupt in the NVIC. **/
+void HostIrqEnable(IRQn_Type irq, bool enable);
+/** Return whether an interrupt is enabled in the NVIC. **/
+bool HostIrqEnabled(IRQn_Type irq);
+/** Set or clear an interrupt's pending state. **/
+void HostIrqPend(IRQn_Type irq, bool pend);
+/** Set the priority (0-7) of an interrupt or system exception. **/
+void HostIrqPriority(IRQn_Type irq, uint32_t priority);
+/** Return the priority (0-7) of an interrupt or system exception. **/
+uint32_t HostIrqPriorityGet(IRQn_Type irq);
+/** Set PRIMASK; clearing it delivers any interrupts that became due. **/
+void HostIrqMask(bool masked);
+/** Return PRIMASK. **/
+bool HostIrqMasked();
+/** Restart the SysTick timer from its LOAD register. **/
+void HostSysTickStart();
+/** Handle a software reset request. **/
+void HostSystemReset() __attribute__((noreturn));
+/** Return a stack pointer value inside the modelled RAM. **/
+uint32_t HostStackPointer();
+
+//*****************************************************************************
+// Core peripherals
+//
+
+/**
+    DWT->CYCCNT. Every read costs a few virtual cycles so that code polling
+    the counter (Delay_cycles(), Microseconds()) lets interrupts run.
+**/
+class HostCycleCounter {
+public:
+    operator uint32_t() const volatile {
+        return HostCycleRead();
+    }
+    void operator=(uint32_t value) volatile {
+        HostCycleWrite(value);
+    }
+};
+
+/** SCB->ICSR. Writing PENDSVSET pends PendSV in the scheduler. **/
+class HostIcsr {
+public:
+    operator uint32_t() const volatile {
+        return m_reg;
+    }
+    void operator=(uint32_t value) volatile;
+    uint32_t m_reg;
+};
+
+typedef struct {
+    __I uint32_t CPUID;
+    HostIcsr ICSR;
+    __IO uint32_t VTOR;
+    __IO uint32_t AIRCR;
+    __IO uint32_t SCR;
+    __IO uint32_t CCR;
+    __IO uint8_t SHP[12];
+    __IO uint32_t SHCSR;
+    __IO uint32_t CFSR;
+    __IO uint32_t HFSR;
+    __IO uint32_t DFSR;
+    __IO uint32_t MMFAR;
+    __IO uint32_t BFAR;
+    __IO uint32_t AFSR;
+    __I uint32_t PFR[2];
+    __I uint32_t DFR;
+    __I uint32_t ADR;
+    __I uint32_t MMFR[4];
+    __I uint32_t ISAR[5];
+    uint32_t RESERVED0[5];
+    __IO uint32_t CPACR;
+} SCB_Type;
+
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t LOAD;
+    __IO uint32_t VAL;
+    __I uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+    __IO uint32_t CTRL;
+    HostCycleCounter CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t DHCSR;
+    __O uint32_t DCRSR;
+    __IO uint32_t DCRDR;
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern SCB_Type HostScb;
+extern SysTick_Type HostSysTick;
+extern DWT_Type HostDwt;
+extern CoreDebug_Type HostCoreDebug;
+
+#define SCB (&HostScb)
+#define SysTick (&HostSysTick)
+#define DWT (&HostDwt)
+#define CoreDebug (&HostCoreDebug)
+
+#define SCB_ICSR_PENDSVSET_Pos 28U
+#define SCB_ICSR_PENDSVSET_Msk (1UL << SCB_ICSR_PENDSVSET_Pos)
+#define SCB_ICSR_PENDSVCLR_Pos 27U
+#define SCB_ICSR_PENDSVCLR_Msk (1UL << SCB_ICSR_PENDSVCLR_Pos)
+
+#define SysTick_CTRL_COUNTFLAG_Msk (1UL << 16U)
+#define SysTick_CTRL_CLKSOURCE_Msk (1UL << 2U)
+#define SysTick_CTRL_TICKINT_Msk (1UL << 1U)
+#define SysTick_CTRL_ENABLE_Msk (1UL << 0U)
+#define SysTick_LOAD_RELOAD_Msk (0xFFFFFFUL)
+
+#define DWT_CTRL_CYCCNTENA_Pos 0U
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << DWT_CTRL_CYCCNTENA_Pos)
+
+#define CoreDebug_DEMCR_TRCENA_Pos 24U
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << CoreDebug_DEMCR_TRCENA_Pos)
+
+//*****************************************************************************
+// NVIC and SysTick functions
+//
+
+static inline void NVIC_EnableIRQ(IRQn_Type IRQn) {
+    HostIrqEnable(IRQn, true);
+}
+
+static inline void NVIC_DisableIRQ(IRQn_Type IRQn) {
+    HostIrqEnable(IRQn, false);
+}
+
+static inline uint32_t NVIC_GetEnableIRQ(IRQn_Type IRQn) {
+    return HostIrqEnabled(IRQn);
+}
+
+static inline void NVIC_SetPendingIRQ(IRQn_Type IRQn) {
+    HostIrqPend(IRQn, true);
+}
+
+static inline void NVIC_ClearPendingIRQ(IRQn_Type IRQn) {
+    HostIrqPend(IRQn, false);
+}
+
+static inline void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority) {
+    HostIrqPriority(IRQn, priority);
+}
+
+static inline uint32_t NVIC_GetPriority(IRQn_Type IRQn) {
+    return HostIrqPriorityGet(IRQn);
+}
+
+static inline void NVIC_SystemReset(void) {
+    HostSystemReset();
+}
+
+static inline uint32_t SysTick_Config(uint32_t ticks) {
+    if ((ticks - 1UL) > SysTick_LOAD_RELOAD_Msk) {
+        return 1UL;
+    }
+    SysTick->LOAD = ticks - 1UL;
+    NVIC_SetPriority(SysTick_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL);
+    SysTick->VAL = 0UL;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk |
+                    SysTick_CTRL_ENABLE_Msk;
+    HostSysTickStart();
+    return 0UL;
+}
+
+//*****************************************************************************
+// Core intrinsics
+//
+
+static inline void __disable_irq(void) {
+    HostIrqMask(true);
+}
+
+static inline void __enable_irq(void) {
+    HostIrqMask(false);
+}
+
+static inline uint32_t __get_PRIMASK(void) {
+    return HostIrqMasked();
+}
+
+static inline void __set_PRIMASK(uint32_t priMask) {
+    HostIrqMask(priMask & 1);
+}
+
+static inline uint32_t __get_MSP(void) {
+    return HostStackPointer();
+}
+
+static inline void __DMB(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __DSB(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __ISB(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __NOP(void) {}
+
+static inline uint8_t __CLZ(uint32_t value) {
+    return value ? __builtin_clz(value) : 32;
+}
+
+static inline uint32_t __REV(uint32_t value) {
+    return __builtin_bswap32(value);
+}
+
+/** Saturating add of the two signed halfwords packed in each operand. **/
+static inline uint32_t __QADD16(uint32_t op1, uint32_t op2) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 16) {
+        int32_t sum = (int16_t)(op1 >> shift) + (int16_t)(op2 >> shift);
+        sum = sum > INT16_MAX ? INT16_MAX : sum < INT16_MIN ? INT16_MIN : sum;
+        result |= ((uint32_t)sum & 0xFFFFU) << shift;
+    }
+    return result;
+}
+
+#endif // __HOSTCMSIS_H__
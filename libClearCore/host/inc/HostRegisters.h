@@ -0,0 +1,1956 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file HostRegisters.h
+    \brief Host model of the SAME53 peripheral registers used by the library.
+
+    Each peripheral instance is an ordinary global structure (defined in
+    HostPeripherals.cpp) laid out with the same register and bit-field names
+    as the device pack, so the library sources compile unchanged. Registers
+    are plain memory: writes are stored and reads return the last value
+    written, with these exceptions that keep the library's polling loops from
+    hanging:
+    - software reset (SWRST) of a DMA channel or of the DMAC completes at
+      once, and enabling a DMA channel runs its transfer (HostDma.cpp);
+    - the PORT set, clear and toggle registers act on OUT and DIR;
+    - the CMCC status follows the cache enable;
+    - ready and complete flags (NVMCTRL READY, DAC READY, GMAC IDLE, SERCOM
+      DRE/TXC/RXC) read as set from reset.
+
+    Bit positions follow the SAME53 datasheet for the fields that are
+    modelled; only the registers and fields the library uses are present.
+**/
+
+#ifndef __HOSTREGISTERS_H__
+#define __HOSTREGISTERS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define _U_(x) x##U
+#define _L_(x) x##L
+#define _UL_(x) x##UL
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/** Core clock frequency, in Hz. **/
+extern uint32_t SystemCoreClock;
+/** Clock tree setup; the host has no clock tree to configure. **/
+void SystemInit(void);
+#ifdef __cplusplus
+}
+#endif
+
+//*****************************************************************************
+// Registers with side effects
+//
+
+/**
+    A control register whose SWRST bit (bit 0) self-clears as soon as it is
+    written, returning the register to its reset value of zero.
+**/
+class HostSwrstReg {
+public:
+    operator uint32_t() const volatile {
+        return m_reg;
+    }
+    void operator=(uint32_t value) volatile {
+        m_reg = (value & 1) ? 0 : value;
+    }
+    void operator|=(uint32_t value) volatile {
+        *this = m_reg | value;
+    }
+    void operator&=(uint32_t value) volatile {
+        *this = m_reg & value;
+    }
+    uint32_t m_reg;
+};
+
+/** Start the transfer of the DMA channel that owns \a chctrla. **/
+void HostDmaEnable(volatile void *chctrla);
+
+/**
+    A DMA channel's CHCTRLA. Besides the self-clearing SWRST, setting ENABLE
+    starts the channel's transfer in the DMA model.
+**/
+class HostDmaCtrlReg {
+public:
+    operator uint32_t() const volatile {
+        return m_reg;
+    }
+    void operator=(uint32_t value) volatile {
+        bool start = (value & 2) && !(m_reg & 2);
+        m_reg = (value & 1) ? 0 : value;
+        if (start && !(value & 1)) {
+            HostDmaEnable(this);
+        }
+    }
+    void operator|=(uint32_t value) volatile {
+        *this = m_reg | value;
+    }
+    void operator&=(uint32_t value) volatile {
+        *this = m_reg & value;
+    }
+    uint32_t m_reg;
+};
+
+/**
+    A PORT set, clear or toggle register. Writing it updates the OUT or DIR
+    register \a Offset words before it in the port group; reading it returns
+    that register.
+**/
+class HostPortSetReg {
+public:
+    operator uint32_t() const volatile {
+        return Target();
+    }
+    void operator=(uint32_t value) volatile {
+        Target() |= value;
+    }
+private:
+    volatile uint32_t &Target() const volatile {
+        return (reinterpret_cast<volatile uint32_t *>(
+                    const_cast<HostPortSetReg *>(this)))[-2];
+    }
+    uint32_t m_reg;
+};
+
+/** See HostPortSetReg. **/
+class HostPortClrReg {
+public:
+    operator uint32_t() const volatile {
+        return Target();
+    }
+    void operator=(uint32_t value) volatile {
+        Target() &= ~value;
+    }
+private:
+    volatile uint32_t &Target() const volatile {
+        return (reinterpret_cast<volatile uint32_t *>(
+                    const_cast<HostPortClrReg *>(this)))[-1];
+    }
+    uint32_t m_reg;
+};
+
+/** See HostPortSetReg. **/
+class HostPortTglReg {
+public:
+    operator uint32_t() const volatile {
+        return Target();
+    }
+    void operator=(uint32_t value) volatile {
+        Target() ^= value;
+    }
+private:
+    volatile uint32_t &Target() const volatile {
+        return (reinterpret_cast<volatile uint32_t *>(
+                    const_cast<HostPortTglReg *>(this)))[-3];
+    }
+    uint32_t m_reg;
+};
+
+/** CMCC->CTRL. Writing CEN updates the CSTS bit of the following SR. **/
+class HostCmccCtrlReg {
+public:
+    operator uint32_t() const volatile {
+        return m_reg;
+    }
+    void operator=(uint32_t value) volatile {
+        m_reg = value;
+        (reinterpret_cast<volatile uint32_t *>(
+             const_cast<HostCmccCtrlReg *>(this)))[1] = value & 1;
+    }
+    uint32_t m_reg;
+};
+
+/** Declare a register with only whole-register access. **/
+#define HOST_REG(TYPE, BITS)                                                  \
+typedef union {                                                               \
+    uint##BITS##_t reg;                                                       \
+} TYPE
+
+//*****************************************************************************
+// ADC
+//
+
+typedef union {
+    struct {
+        uint16_t SWRST: 1;
+        uint16_t ENABLE: 1;
+        uint16_t : 1;
+        uint16_t DUALSEL: 2;
+        uint16_t SLAVEEN: 1;
+        uint16_t RUNSTDBY: 1;
+        uint16_t ONDEMAND: 1;
+        uint16_t PRESCALER: 3;
+        uint16_t : 4;
+        uint16_t R2R: 1;
+    } bit;
+    uint16_t reg;
+} ADC_CTRLA_Type;
+
+typedef union {
+    struct {
+        uint8_t DBGRUN: 1;
+        uint8_t : 7;
+    } bit;
+    uint8_t reg;
+} ADC_DBGCTRL_Type;
+
+typedef union {
+    struct {
+        uint16_t MUXPOS: 5;
+        uint16_t : 2;
+        uint16_t DIFFMODE: 1;
+        uint16_t MUXNEG: 5;
+        uint16_t : 2;
+        uint16_t DSEQSTOP: 1;
+    } bit;
+    uint16_t reg;
+} ADC_INPUTCTRL_Type;
+
+typedef union {
+    struct {
+        uint16_t LEFTADJ: 1;
+        uint16_t FREERUN: 1;
+        uint16_t CORREN: 1;
+        uint16_t RESSEL: 2;
+        uint16_t : 3;
+        uint16_t WINMODE: 3;
+        uint16_t WINSS: 1;
+        uint16_t : 4;
+    } bit;
+    uint16_t reg;
+} ADC_CTRLB_Type;
+
+typedef union {
+    struct {
+        uint8_t REFSEL: 4;
+        uint8_t : 3;
+        uint8_t REFCOMP: 1;
+    } bit;
+    uint8_t reg;
+} ADC_REFCTRL_Type;
+
+typedef union {
+    struct {
+        uint8_t SAMPLENUM: 4;
+        uint8_t ADJRES: 3;
+        uint8_t : 1;
+    } bit;
+    uint8_t reg;
+} ADC_AVGCTRL_Type;
+
+typedef union {
+    struct {
+        uint8_t SAMPLEN: 6;
+        uint8_t : 1;
+        uint8_t OFFCOMP: 1;
+    } bit;
+    uint8_t reg;
+} ADC_SAMPCTRL_Type;
+
+typedef union {
+    struct {
+        uint8_t ADCBUSY: 1;
+        uint8_t : 1;
+        uint8_t WCC: 6;
+    } bit;
+    uint8_t reg;
+} ADC_STATUS_Type;
+
+typedef union {
+    struct {
+        uint32_t INPUTCTRL: 1;
+        uint32_t CTRLB: 1;
+        uint32_t REFCTRL: 1;
+        uint32_t AVGCTRL: 1;
+        uint32_t SAMPCTRL: 1;
+        uint32_t WINLT: 1;
+        uint32_t WINUT: 1;
+        uint32_t GAINCORR: 1;
+        uint32_t OFFSETCORR: 1;
+        uint32_t : 22;
+        uint32_t AUTOSTART: 1;
+    } bit;
+    uint32_t reg;
+} ADC_DSEQCTRL_Type;
+
+HOST_REG(ADC_SYNCBUSY_Type, 32);
+HOST_REG(ADC_DSEQDATA_Type, 32);
+HOST_REG(ADC_RESULT_Type, 16);
+HOST_REG(ADC_INTFLAG_Type, 8);
+
+typedef struct {
+    __IO ADC_CTRLA_Type CTRLA;
+    __IO uint8_t EVCTRL;
+    __IO ADC_DBGCTRL_Type DBGCTRL;
+    __IO ADC_INPUTCTRL_Type INPUTCTRL;
+    __IO ADC_CTRLB_Type CTRLB;
+    __IO ADC_REFCTRL_Type REFCTRL;
+    __IO ADC_AVGCTRL_Type AVGCTRL;
+    __IO ADC_SAMPCTRL_Type SAMPCTRL;
+    __IO ADC_INTFLAG_Type INTFLAG;
+    __I ADC_STATUS_Type STATUS;
+    __I ADC_SYNCBUSY_Type SYNCBUSY;
+    __O ADC_DSEQDATA_Type DSEQDATA;
+    __IO ADC_DSEQCTRL_Type DSEQCTRL;
+    __I ADC_RESULT_Type RESULT;
+} Adc;
+
+#define ADC_CTRLA_PRESCALER_DIV4_Val 0x1U
+#define ADC_INPUTCTRL_MUXPOS(value) ((value) & 0x1FU)
+#define ADC_INPUTCTRL_MUXPOS_AIN4 ADC_INPUTCTRL_MUXPOS(4)
+#define ADC_INPUTCTRL_MUXPOS_AIN5 ADC_INPUTCTRL_MUXPOS(5)
+#define ADC_INPUTCTRL_MUXPOS_AIN6 ADC_INPUTCTRL_MUXPOS(6)
+#define ADC_INPUTCTRL_MUXPOS_AIN7 ADC_INPUTCTRL_MUXPOS(7)
+#define ADC_INPUTCTRL_MUXPOS_AIN8 ADC_INPUTCTRL_MUXPOS(8)
+#define ADC_INPUTCTRL_MUXPOS_AIN9 ADC_INPUTCTRL_MUXPOS(9)
+#define ADC_INPUTCTRL_MUXPOS_AIN10 ADC_INPUTCTRL_MUXPOS(10)
+#define ADC_INPUTCTRL_MUXPOS_AIN11 ADC_INPUTCTRL_MUXPOS(11)
+#define ADC_INPUTCTRL_DSEQSTOP (0x1U << 15)
+#define ADC_CTRLB_RESSEL_Pos 3
+#define ADC_CTRLB_RESSEL_12BIT_Val 0x0U
+#define ADC_CTRLB_RESSEL_16BIT_Val 0x1U
+#define ADC_CTRLB_RESSEL_10BIT_Val 0x2U
+#define ADC_CTRLB_RESSEL_8BIT_Val 0x3U
+#define ADC_CTRLB_RESSEL_12BIT (ADC_CTRLB_RESSEL_12BIT_Val << ADC_CTRLB_RESSEL_Pos)
+#define ADC_CTRLB_RESSEL_16BIT (ADC_CTRLB_RESSEL_16BIT_Val << ADC_CTRLB_RESSEL_Pos)
+#define ADC_CTRLB_RESSEL_10BIT (ADC_CTRLB_RESSEL_10BIT_Val << ADC_CTRLB_RESSEL_Pos)
+#define ADC_CTRLB_RESSEL_8BIT (ADC_CTRLB_RESSEL_8BIT_Val << ADC_CTRLB_RESSEL_Pos)
+#define ADC_REFCTRL_REFSEL_INTVCC1 (0x3U << 0)
+#define ADC_REFCTRL_REFCOMP (0x1U << 7)
+#define ADC_AVGCTRL_SAMPLENUM_1 (0x0U << 0)
+#define ADC_AVGCTRL_SAMPLENUM_4 (0x2U << 0)
+#define ADC_AVGCTRL_SAMPLENUM_16 (0x4U << 0)
+#define ADC_AVGCTRL_ADJRES(value) (((value) & 0x7U) << 4)
+#define ADC_SAMPCTRL_SAMPLEN(value) ((value) & 0x3FU)
+#define ADC_SYNCBUSY_SWRST (0x1U << 0)
+#define ADC_SYNCBUSY_ENABLE (0x1U << 1)
+#define ADC_SYNCBUSY_INPUTCTRL (0x1U << 2)
+#define ADC_SYNCBUSY_CTRLB (0x1U << 3)
+#define ADC_SYNCBUSY_REFCTRL (0x1U << 4)
+#define ADC_SYNCBUSY_AVGCTRL (0x1U << 5)
+#define ADC_SYNCBUSY_SAMPCTRL (0x1U << 6)
+#define ADC_DSEQCTRL_INPUTCTRL (0x1U << 0)
+#define ADC_DSEQCTRL_CTRLB (0x1U << 1)
+#define ADC_DSEQCTRL_REFCTRL (0x1U << 2)
+#define ADC_DSEQCTRL_AVGCTRL (0x1U << 3)
+#define ADC_DSEQCTRL_SAMPCTRL (0x1U << 4)
+
+//*****************************************************************************
+// CCL
+//
+
+typedef union {
+    struct {
+        uint8_t SWRST: 1;
+        uint8_t ENABLE: 1;
+        uint8_t : 4;
+        uint8_t RUNSTDBY: 1;
+        uint8_t : 1;
+    } bit;
+    uint8_t reg;
+} CCL_CTRL_Type;
+
+typedef union {
+    struct {
+        uint32_t : 1;
+        uint32_t ENABLE: 1;
+        uint32_t : 2;
+        uint32_t FILTSEL: 2;
+        uint32_t : 1;
+        uint32_t EDGESEL: 1;
+        uint32_t INSEL0: 4;
+        uint32_t INSEL1: 4;
+        uint32_t INSEL2: 4;
+        uint32_t INVEI: 1;
+        uint32_t LUTEI: 1;
+        uint32_t LUTEO: 1;
+        uint32_t : 1;
+        uint32_t TRUTH: 8;
+    } bit;
+    uint32_t reg;
+} CCL_LUTCTRL_Type;
+
+#define CCL_LUT_NUM 4
+
+typedef struct {
+    __IO CCL_CTRL_Type CTRL;
+    __IO uint8_t SEQCTRL[2];
+    __IO CCL_LUTCTRL_Type LUTCTRL[CCL_LUT_NUM];
+} Ccl;
+
+#define CCL_LUTCTRL_ENABLE (0x1U << 1)
+#define CCL_LUTCTRL_INSEL0_EVENT (0x3U << 8)
+#define CCL_LUTCTRL_INSEL1_LINK (0x2U << 12)
+#define CCL_LUTCTRL_LUTEI (0x1U << 21)
+#define CCL_LUTCTRL_TRUTH(value) (((value) & 0xFFU) << 24)
+
+//*****************************************************************************
+// CMCC
+//
+
+typedef union {
+    struct {
+        uint32_t CSTS: 1;
+        uint32_t : 31;
+    } bit;
+    uint32_t reg;
+} CMCC_SR_Type;
+
+typedef union {
+    HostCmccCtrlReg reg;
+} CMCC_CTRL_Type;
+
+HOST_REG(CMCC_LCKWAY_Type, 32);
+HOST_REG(CMCC_MAINT0_Type, 32);
+
+typedef struct {
+    __I uint32_t TYPE;
+    __IO uint32_t CFG;
+    __O CMCC_CTRL_Type CTRL;
+    __I CMCC_SR_Type SR;
+    __IO CMCC_LCKWAY_Type LCKWAY;
+    __O CMCC_MAINT0_Type MAINT0;
+} Cmcc;
+
+#define CMCC_CTRL_CEN (0x1U << 0)
+#define CMCC_LCKWAY_LCKWAY(value) ((value) & 0xFU)
+#define CMCC_MAINT0_INVALL (0x1U << 0)
+
+//*****************************************************************************
+// DAC
+//
+
+typedef union {
+    struct {
+        uint8_t SWRST: 1;
+        uint8_t ENABLE: 1;
+        uint8_t : 6;
+    } bit;
+    uint8_t reg;
+} DAC_CTRLA_Type;
+
+typedef union {
+    struct {
+        uint8_t DIFF: 1;
+        uint8_t REFSEL: 2;
+        uint8_t : 5;
+    } bit;
+    uint8_t reg;
+} DAC_CTRLB_Type;
+
+typedef union {
+    struct {
+        uint8_t READY0: 1;
+        uint8_t READY1: 1;
+        uint8_t EOC0: 1;
+        uint8_t EOC1: 1;
+        uint8_t : 4;
+    } bit;
+    struct {
+        uint8_t READY: 2;
+        uint8_t EOC: 2;
+        uint8_t : 4;
+    } vec;
+    uint8_t reg;
+} DAC_STATUS_Type;
+
+typedef union {
+    struct {
+        uint16_t LEFTADJ: 1;
+        uint16_t ENABLE: 1;
+        uint16_t CCTRL: 2;
+        uint16_t : 1;
+        uint16_t FEXT: 1;
+        uint16_t RUNSTDBY: 1;
+        uint16_t DITHER: 1;
+        uint16_t REFRESH: 4;
+        uint16_t : 1;
+        uint16_t OSR: 3;
+    } bit;
+    uint16_t reg;
+} DAC_DACCTRL_Type;
+
+HOST_REG(DAC_SYNCBUSY_Type, 32);
+HOST_REG(DAC_DATA_Type, 16);
+
+typedef struct {
+    __IO DAC_CTRLA_Type CTRLA;
+    __IO DAC_CTRLB_Type CTRLB;
+    __IO uint8_t EVCTRL;
+    __IO uint8_t INTENCLR;
+    __IO uint8_t INTENSET;
+    __IO uint8_t INTFLAG;
+    __I DAC_STATUS_Type STATUS;
+    __I DAC_SYNCBUSY_Type SYNCBUSY;
+    __IO DAC_DACCTRL_Type DACCTRL[2];
+    __O DAC_DATA_Type DATA[2];
+    __O DAC_DATA_Type DATABUF[2];
+} Dac;
+
+#define DAC_CTRLB_REFSEL_INTREF_Val 0x3U
+#define DAC_DACCTRL_CCTRL_CC12M_Val 0x2U
+#define DAC_SYNCBUSY_SWRST (0x1U << 0)
+#define DAC_SYNCBUSY_ENABLE (0x1U << 1)
+#define DAC_SYNCBUSY_DATA0 (0x1U << 2)
+
+//*****************************************************************************
+// DMAC
+//
+
+#define DMAC_CH_NUM 32
+
+typedef union {
+    struct {
+        uint32_t SWRST: 1;
+        uint32_t ENABLE: 1;
+        uint32_t : 4;
+        uint32_t RUNSTDBY: 1;
+        uint32_t : 1;
+        uint32_t TRIGSRC: 7;
+        uint32_t : 5;
+        uint32_t TRIGACT: 2;
+        uint32_t : 2;
+        uint32_t BURSTLEN: 4;
+        uint32_t THRESHOLD: 2;
+        uint32_t : 2;
+    } bit;
+    HostDmaCtrlReg reg;
+} DMAC_CHCTRLA_Type;
+
+typedef union {
+    struct {
+        uint8_t TERR: 1;
+        uint8_t TCMPL: 1;
+        uint8_t SUSP: 1;
+        uint8_t : 5;
+    } bit;
+    uint8_t reg;
+} DMAC_CHINTFLAG_Type;
+
+typedef DMAC_CHINTFLAG_Type DMAC_CHINTENCLR_Type;
+typedef DMAC_CHINTFLAG_Type DMAC_CHINTENSET_Type;
+
+typedef union {
+    struct {
+        uint8_t PEND: 1;
+        uint8_t BUSY: 1;
+        uint8_t FERR: 1;
+        uint8_t CRCERR: 1;
+        uint8_t : 4;
+    } bit;
+    uint8_t reg;
+} DMAC_CHSTATUS_Type;
+
+typedef struct {
+    __IO DMAC_CHCTRLA_Type CHCTRLA;
+    __IO uint8_t CHCTRLB;
+    __IO uint8_t CHPRILVL;
+    __IO uint8_t CHEVCTRL;
+    __IO DMAC_CHINTENCLR_Type CHINTENCLR;
+    __IO DMAC_CHINTENSET_Type CHINTENSET;
+    __IO DMAC_CHINTFLAG_Type CHINTFLAG;
+    __IO DMAC_CHSTATUS_Type CHSTATUS;
+} DmacChannel;
+
+typedef union {
+    struct {
+        uint32_t SWRST: 1;
+        uint32_t DMAENABLE: 1;
+        uint32_t : 6;
+        uint32_t LVLEN0: 1;
+        uint32_t LVLEN1: 1;
+        uint32_t LVLEN2: 1;
+        uint32_t LVLEN3: 1;
+        uint32_t : 20;
+    } bit;
+    HostSwrstReg reg;
+} DMAC_CTRL_Type;
+
+typedef union {
+    struct {
+        uint8_t DBGRUN: 1;
+        uint8_t : 7;
+    } bit;
+    uint8_t reg;
+} DMAC_DBGCTRL_Type;
+
+HOST_REG(DMAC_SWTRIGCTRL_Type, 32);
+HOST_REG(DMAC_BASEADDR_Type, 32);
+HOST_REG(DMAC_WRBADDR_Type, 32);
+
+typedef struct {
+    __IO DMAC_CTRL_Type CTRL;
+    __IO DMAC_DBGCTRL_Type DBGCTRL;
+    __IO DMAC_SWTRIGCTRL_Type SWTRIGCTRL;
+    __IO uint32_t PRICTRL0;
+    __IO uint16_t INTPEND;
+    __I uint32_t INTSTATUS;
+    __I uint32_t BUSYCH;
+    __I uint32_t PENDCH;
+    __I uint32_t ACTIVE;
+    __IO DMAC_BASEADDR_Type BASEADDR;
+    __IO DMAC_WRBADDR_Type WRBADDR;
+    DmacChannel Channel[DMAC_CH_NUM];
+} Dmac;
+
+HOST_REG(DMAC_BTCTRL_Type, 16);
+HOST_REG(DMAC_BTCNT_Type, 16);
+HOST_REG(DMAC_SRCADDR_Type, 32);
+HOST_REG(DMAC_DSTADDR_Type, 32);
+HOST_REG(DMAC_DESCADDR_Type, 32);
+
+typedef struct {
+    __IO DMAC_BTCTRL_Type BTCTRL;
+    __IO DMAC_BTCNT_Type BTCNT;
+    __IO DMAC_SRCADDR_Type SRCADDR;
+    __IO DMAC_DSTADDR_Type DSTADDR;
+    __IO DMAC_DESCADDR_Type DESCADDR;
+} DmacDescriptor;
+
+#define DMAC_CTRL_SWRST (0x1U << 0)
+#define DMAC_CTRL_DMAENABLE (0x1U << 1)
+#define DMAC_CTRL_LVLEN(value) (((value) & 0xFU) << 8)
+#define DMAC_CHCTRLA_SWRST (0x1U << 0)
+#define DMAC_CHCTRLA_ENABLE (0x1U << 1)
+#define DMAC_CHCTRLA_TRIGSRC_Pos 8
+#define DMAC_CHCTRLA_TRIGSRC_Msk (0x7FU << DMAC_CHCTRLA_TRIGSRC_Pos)
+#define DMAC_CHCTRLA_TRIGSRC(value) (((value) & 0x7FU) << 8)
+#define DMAC_CHCTRLA_TRIGSRC_DISABLE_Val 0x0U
+#define DMAC_CHCTRLA_TRIGACT_BURST (0x2U << 20)
+#define DMAC_CHCTRLA_BURSTLEN_SINGLE (0x0U << 24)
+#define DMAC_CHINTFLAG_TCMPL (0x1U << 1)
+#define DMAC_CHINTFLAG_MASK 0x07U
+#define DMAC_CHINTENSET_TCMPL (0x1U << 1)
+#define DMAC_CHINTENCLR_TCMPL (0x1U << 1)
+#define DMAC_BTCTRL_VALID (0x1U << 0)
+#define DMAC_BTCTRL_BLOCKACT_Msk (0x3U << 3)
+#define DMAC_BTCTRL_BLOCKACT_NOACT (0x0U << 3)
+#define DMAC_BTCTRL_BLOCKACT_INT (0x1U << 3)
+#define DMAC_BTCTRL_BEATSIZE_BYTE (0x0U << 8)
+#define DMAC_BTCTRL_BEATSIZE_HWORD (0x1U << 8)
+#define DMAC_BTCTRL_BEATSIZE_WORD (0x2U << 8)
+#define DMAC_BTCTRL_BEATSIZE_Pos 8
+#define DMAC_BTCTRL_BEATSIZE_Msk (0x3U << 8)
+#define DMAC_BTCTRL_SRCINC (0x1U << 10)
+#define DMAC_BTCTRL_DSTINC (0x1U << 11)
+#define DMAC_BTCTRL_STEPSEL_SRC (0x1U << 12)
+
+//*****************************************************************************
+// EIC
+//
+
+typedef union {
+    struct {
+        uint8_t SWRST: 1;
+        uint8_t ENABLE: 1;
+        uint8_t : 2;
+        uint8_t CKSEL: 1;
+        uint8_t : 3;
+    } bit;
+    uint8_t reg;
+} EIC_CTRLA_Type;
+
+typedef union {
+    struct {
+        uint32_t EXTINT: 16;
+        uint32_t : 16;
+    } bit;
+    uint32_t reg;
+} EIC_INTFLAG_Type;
+
+typedef EIC_INTFLAG_Type EIC_INTENCLR_Type;
+typedef EIC_INTFLAG_Type EIC_INTENSET_Type;
+
+HOST_REG(EIC_SYNCBUSY_Type, 32);
+HOST_REG(EIC_EVCTRL_Type, 32);
+HOST_REG(EIC_ASYNCH_Type, 32);
+HOST_REG(EIC_CONFIG_Type, 32);
+
+typedef struct {
+    __IO EIC_CTRLA_Type CTRLA;
+    __IO uint8_t NMICTRL;
+    __IO uint16_t NMIFLAG;
+    __I EIC_SYNCBUSY_Type SYNCBUSY;
+    __IO EIC_EVCTRL_Type EVCTRL;
+    __IO EIC_INTENCLR_Type INTENCLR;
+    __IO EIC_INTENSET_Type INTENSET;
+    __IO EIC_INTFLAG_Type INTFLAG;
+    __IO EIC_ASYNCH_Type ASYNCH;
+    __IO EIC_CONFIG_Type CONFIG[2];
+    __IO uint32_t DEBOUNCEN;
+    __IO uint32_t DPRESCALER;
+    __I uint32_t PINSTATE;
+} Eic;
+
+#define EIC_NUMBER_OF_INTERRUPTS 16
+#define EIC_SYNCBUSY_ENABLE (0x1U << 1)
+#define EIC_CONFIG_SENSE0_NONE_Val 0x0U
+#define EIC_CONFIG_SENSE0_RISE_Val 0x1U
+#define EIC_CONFIG_SENSE0_FALL_Val 0x2U
+#define EIC_CONFIG_SENSE0_BOTH_Val 0x3U
+#define EIC_CONFIG_SENSE0_HIGH_Val 0x4U
+#define EIC_CONFIG_SENSE0_LOW_Val 0x5U
+#define EIC_CONFIG_SENSE0_NONE EIC_CONFIG_SENSE0_NONE_Val
+#define EIC_CONFIG_SENSE0_RISE EIC_CONFIG_SENSE0_RISE_Val
+#define EIC_CONFIG_SENSE0_FALL EIC_CONFIG_SENSE0_FALL_Val
+#define EIC_CONFIG_SENSE0_BOTH EIC_CONFIG_SENSE0_BOTH_Val
+#define EIC_CONFIG_SENSE0_HIGH EIC_CONFIG_SENSE0_HIGH_Val
+#define EIC_CONFIG_SENSE0_LOW EIC_CONFIG_SENSE0_LOW_Val
+
+//*****************************************************************************
+// EVSYS
+//
+
+typedef union {
+    struct {
+        uint8_t OVR: 1;
+        uint8_t EVD: 1;
+        uint8_t : 6;
+    } bit;
+    uint8_t reg;
+} EVSYS_CHINTFLAG_Type;
+
+HOST_REG(EVSYS_CHANNEL_Type, 32);
+HOST_REG(EVSYS_CHSTATUS_Type, 8);
+HOST_REG(EVSYS_USER_Type, 8);
+
+typedef struct {
+    __IO EVSYS_CHANNEL_Type CHANNEL;
+    __IO uint8_t CHINTENCLR;
+    __IO uint8_t CHINTENSET;
+    __IO EVSYS_CHINTFLAG_Type CHINTFLAG;
+    __I EVSYS_CHSTATUS_Type CHSTATUS;
+} EvsysChannel;
+
+typedef struct {
+    __IO uint8_t CTRLA;
+    __O uint32_t SWEVT;
+    __IO uint8_t PRICTRL;
+    __IO uint16_t INTPEND;
+    __I uint32_t INTSTATUS;
+    __I uint32_t BUSYCH;
+    __I uint32_t READYUSR;
+    EvsysChannel Channel[32];
+    __IO EVSYS_USER_Type USER[67];
+} Evsys;
+
+#define EVSYS_CHANNEL_EVGEN(value) ((value) & 0x7FU)
+#define EVSYS_CHANNEL_PATH_ASYNCHRONOUS (0x2U << 8)
+#define EVSYS_CHSTATUS_RDYUSR (0x1U << 0)
+#define EVSYS_CHSTATUS_BUSYCH (0x1U << 1)
+#define EVSYS_ID_GEN_EIC_EXTINT_0 18
+#define EVSYS_ID_USER_CCL_LUT_0 16
+#define EVSYS_ID_USER_TC0_EVU 44
+#define EVSYS_ID_USER_TC7_EVU 51
+
+//*****************************************************************************
+// GCLK
+//
+
+typedef union {
+    struct {
+        uint32_t SRC: 4;
+        uint32_t : 4;
+        uint32_t GENEN: 1;
+        uint32_t IDC: 1;
+        uint32_t OOV: 1;
+        uint32_t OE: 1;
+        uint32_t DIVSEL: 1;
+        uint32_t RUNSTDBY: 1;
+        uint32_t : 2;
+        uint32_t DIV: 16;
+    } bit;
+    uint32_t reg;
+} GCLK_GENCTRL_Type;
+
+typedef union {
+    struct {
+        uint32_t GEN: 4;
+        uint32_t : 2;
+        uint32_t CHEN: 1;
+        uint32_t WRTLOCK: 1;
+        uint32_t : 24;
+    } bit;
+    uint32_t reg;
+} GCLK_PCHCTRL_Type;
+
+HOST_REG(GCLK_SYNCBUSY_Type, 32);
+
+typedef struct {
+    __IO uint8_t CTRLA;
+    __I GCLK_SYNCBUSY_Type SYNCBUSY;
+    __IO GCLK_GENCTRL_Type GENCTRL[12];
+    __IO GCLK_PCHCTRL_Type PCHCTRL[48];
+} Gclk;
+
+#define GCLK_PCHCTRL_GEN(value) ((value) & 0xFU)
+#define GCLK_PCHCTRL_GEN_GCLK6 GCLK_PCHCTRL_GEN(6)
+#define GCLK_PCHCTRL_CHEN (0x1U << 6)
+#define GCLK_SYNCBUSY_GENCTRL(value) (((value) & 0xFFFU) << 2)
+
+#define EIC_GCLK_ID 4
+#define EVSYS_GCLK_ID_0 11
+#define TC0_GCLK_ID 9
+#define TC1_GCLK_ID 9
+#define TCC0_GCLK_ID 25
+#define TCC1_GCLK_ID 25
+#define TC2_GCLK_ID 26
+#define TC3_GCLK_ID 26
+#define TCC2_GCLK_ID 29
+#define TCC3_GCLK_ID 29
+#define TC4_GCLK_ID 30
+#define TC5_GCLK_ID 30
+#define PDEC_GCLK_ID 31
+#define TCC4_GCLK_ID 38
+#define TC6_GCLK_ID 39
+#define TC7_GCLK_ID 39
+#define ADC1_GCLK_ID 41
+#define DAC_GCLK_ID 42
+#define USB_GCLK_ID 10
+#define SERCOM0_GCLK_ID_CORE 7
+#define SERCOM2_GCLK_ID_CORE 23
+#define SERCOM3_GCLK_ID_CORE 24
+#define SERCOM4_GCLK_ID_CORE 34
+#define SERCOM5_GCLK_ID_CORE 35
+#define SERCOM6_GCLK_ID_CORE 36
+#define SERCOM7_GCLK_ID_CORE 37
+
+//*****************************************************************************
+// GMAC
+//
+
+typedef union {
+    struct {
+        uint32_t : 1;
+        uint32_t LBL: 1;
+        uint32_t RXEN: 1;
+        uint32_t TXEN: 1;
+        uint32_t MPE: 1;
+        uint32_t CLRSTAT: 1;
+        uint32_t INCSTAT: 1;
+        uint32_t WESTAT: 1;
+        uint32_t BP: 1;
+        uint32_t TSTART: 1;
+        uint32_t THALT: 1;
+        uint32_t : 21;
+    } bit;
+    uint32_t reg;
+} GMAC_NCR_Type;
+
+typedef union {
+    struct {
+        uint32_t SPD: 1;
+        uint32_t FD: 1;
+        uint32_t DNVLAN: 1;
+        uint32_t JFRAME: 1;
+        uint32_t CAF: 1;
+        uint32_t NBC: 1;
+        uint32_t MTIHEN: 1;
+        uint32_t UNIHEN: 1;
+        uint32_t MAXFS: 1;
+        uint32_t : 3;
+        uint32_t RTY: 1;
+        uint32_t PEN: 1;
+        uint32_t RXBUFO: 2;
+        uint32_t LFERD: 1;
+        uint32_t RFCS: 1;
+        uint32_t CLK: 3;
+        uint32_t DBW: 2;
+        uint32_t DCPF: 1;
+        uint32_t RXCOEN: 1;
+        uint32_t EFRHD: 1;
+        uint32_t IRXFCS: 1;
+        uint32_t : 1;
+        uint32_t IPGSEN: 1;
+        uint32_t RXBP: 1;
+        uint32_t IRXER: 1;
+        uint32_t : 1;
+    } bit;
+    uint32_t reg;
+} GMAC_NCFGR_Type;
+
+typedef union {
+    struct {
+        uint32_t MII: 1;
+        uint32_t : 31;
+    } bit;
+    uint32_t reg;
+} GMAC_UR_Type;
+
+typedef union {
+    struct {
+        uint32_t FBLDO: 5;
+        uint32_t : 1;
+        uint32_t ESMA: 1;
+        uint32_t ESPA: 1;
+        uint32_t RXBMS: 2;
+        uint32_t TXPBMS: 1;
+        uint32_t TXCOEN: 1;
+        uint32_t : 4;
+        uint32_t DRBS: 8;
+        uint32_t DDRP: 1;
+        uint32_t : 7;
+    } bit;
+    uint32_t reg;
+} GMAC_DCFGR_Type;
+
+typedef union {
+    struct {
+        uint32_t MFS: 1;
+        uint32_t RCOMP: 1;
+        uint32_t RXUBR: 1;
+        uint32_t TXUBR: 1;
+        uint32_t TUR: 1;
+        uint32_t RLEX: 1;
+        uint32_t TFC: 1;
+        uint32_t TCOMP: 1;
+        uint32_t : 2;
+        uint32_t ROVR: 1;
+        uint32_t HRESP: 1;
+        uint32_t : 20;
+    } bit;
+    uint32_t reg;
+} GMAC_IER_Type;
+
+HOST_REG(GMAC_NSR_Type, 32);
+HOST_REG(GMAC_TSR_Type, 32);
+HOST_REG(GMAC_RBQB_Type, 32);
+HOST_REG(GMAC_TBQB_Type, 32);
+HOST_REG(GMAC_RSR_Type, 32);
+HOST_REG(GMAC_ISR_Type, 32);
+HOST_REG(GMAC_MAN_Type, 32);
+HOST_REG(GMAC_SAB_Type, 32);
+HOST_REG(GMAC_SAT_Type, 32);
+HOST_REG(GMAC_WOL_Type, 32);
+HOST_REG(GMAC_IPGS_Type, 32);
+
+typedef struct {
+    __IO GMAC_SAB_Type SAB;
+    __IO GMAC_SAT_Type SAT;
+} GmacSa;
+
+typedef struct {
+    __IO GMAC_NCR_Type NCR;
+    __IO GMAC_NCFGR_Type NCFGR;
+    __I GMAC_NSR_Type NSR;
+    __IO GMAC_UR_Type UR;
+    __IO GMAC_DCFGR_Type DCFGR;
+    __IO GMAC_TSR_Type TSR;
+    __IO GMAC_RBQB_Type RBQB;
+    __IO GMAC_TBQB_Type TBQB;
+    __IO GMAC_RSR_Type RSR;
+    __IO GMAC_ISR_Type ISR;
+    __O GMAC_IER_Type IER;
+    __O uint32_t IDR;
+    __IO uint32_t IMR;
+    __IO GMAC_MAN_Type MAN;
+    GmacSa Sa[4];
+    __IO GMAC_WOL_Type WOL;
+    __IO GMAC_IPGS_Type IPGS;
+} Gmac;
+
+#define GMAC_NSR_IDLE_Pos 2
+#define GMAC_NSR_IDLE (0x1U << GMAC_NSR_IDLE_Pos)
+#define GMAC_TSR_TXCOMP (0x1U << 5)
+#define GMAC_RSR_REC (0x1U << 1)
+#define GMAC_MAN_DATA(value) ((value) & 0xFFFFU)
+#define GMAC_MAN_WTN(value) (((value) & 0x3U) << 16)
+#define GMAC_MAN_REGA(value) (((value) & 0x1FU) << 18)
+#define GMAC_MAN_PHYA(value) (((value) & 0x1FU) << 23)
+#define GMAC_MAN_OP(value) (((value) & 0x3U) << 28)
+#define GMAC_MAN_CLTTO (0x1U << 30)
+#define GMAC_IPGS_FL(value) ((value) & 0xFFFFU)
+
+//*****************************************************************************
+// MCLK
+//
+
+typedef union {
+    struct {
+        uint32_t : 9;
+        uint32_t DMAC_: 1;
+        uint32_t USB_: 1;
+        uint32_t : 3;
+        uint32_t GMAC_: 1;
+        uint32_t : 17;
+    } bit;
+    uint32_t reg;
+} MCLK_AHBMASK_Type;
+
+typedef union {
+    struct {
+        uint32_t : 10;
+        uint32_t EIC_: 1;
+        uint32_t : 1;
+        uint32_t SERCOM0_: 1;
+        uint32_t SERCOM1_: 1;
+        uint32_t TC0_: 1;
+        uint32_t TC1_: 1;
+        uint32_t : 16;
+    } bit;
+    uint32_t reg;
+} MCLK_APBAMASK_Type;
+
+typedef union {
+    struct {
+        uint32_t : 4;
+        uint32_t PORT_: 1;
+        uint32_t : 2;
+        uint32_t EVSYS_: 1;
+        uint32_t : 1;
+        uint32_t SERCOM2_: 1;
+        uint32_t SERCOM3_: 1;
+        uint32_t TCC0_: 1;
+        uint32_t TCC1_: 1;
+        uint32_t TC2_: 1;
+        uint32_t TC3_: 1;
+        uint32_t : 17;
+    } bit;
+    uint32_t reg;
+} MCLK_APBBMASK_Type;
+
+typedef union {
+    struct {
+        uint32_t : 2;
+        uint32_t GMAC_: 1;
+        uint32_t TCC2_: 1;
+        uint32_t TCC3_: 1;
+        uint32_t TC4_: 1;
+        uint32_t TC5_: 1;
+        uint32_t PDEC_: 1;
+        uint32_t : 1;
+        uint32_t CCL_: 1;
+        uint32_t : 22;
+    } bit;
+    uint32_t reg;
+} MCLK_APBCMASK_Type;
+
+typedef union {
+    struct {
+        uint32_t SERCOM4_: 1;
+        uint32_t SERCOM5_: 1;
+        uint32_t SERCOM6_: 1;
+        uint32_t SERCOM7_: 1;
+        uint32_t TCC4_: 1;
+        uint32_t TC6_: 1;
+        uint32_t TC7_: 1;
+        uint32_t ADC0_: 1;
+        uint32_t ADC1_: 1;
+        uint32_t DAC_: 1;
+        uint32_t : 22;
+    } bit;
+    uint32_t reg;
+} MCLK_APBDMASK_Type;
+
+typedef struct {
+    __IO uint8_t CTRLA;
+    __IO uint8_t INTENCLR;
+    __IO uint8_t INTENSET;
+    __IO uint8_t INTFLAG;
+    __I uint8_t HSDIV;
+    __IO uint8_t CPUDIV;
+    __IO MCLK_AHBMASK_Type AHBMASK;
+    __IO MCLK_APBAMASK_Type APBAMASK;
+    __IO MCLK_APBBMASK_Type APBBMASK;
+    __IO MCLK_APBCMASK_Type APBCMASK;
+    __IO MCLK_APBDMASK_Type APBDMASK;
+} Mclk;
+
+//*****************************************************************************
+// NVMCTRL
+//
+
+typedef union {
+    struct {
+        uint16_t : 2;
+        uint16_t AUTOWS: 1;
+        uint16_t SUSPEN: 1;
+        uint16_t WMODE: 2;
+        uint16_t PRM: 2;
+        uint16_t RWS: 4;
+        uint16_t AHBNS0: 1;
+        uint16_t AHBNS1: 1;
+        uint16_t CACHEDIS0: 1;
+        uint16_t CACHEDIS1: 1;
+    } bit;
+    uint16_t reg;
+} NVMCTRL_CTRLA_Type;
+
+typedef union {
+    struct {
+        uint16_t DONE: 1;
+        uint16_t ADDRE: 1;
+        uint16_t PROGE: 1;
+        uint16_t LOCKE: 1;
+        uint16_t ECCSE: 1;
+        uint16_t ECCDE: 1;
+        uint16_t NVME: 1;
+        uint16_t SUSP: 1;
+        uint16_t SEESFULL: 1;
+        uint16_t SEESOVF: 1;
+        uint16_t : 6;
+    } bit;
+    uint16_t reg;
+} NVMCTRL_INTFLAG_Type;
+
+typedef union {
+    struct {
+        uint16_t READY: 1;
+        uint16_t PRM: 1;
+        uint16_t LOAD: 1;
+        uint16_t SUSP: 1;
+        uint16_t AFIRST: 1;
+        uint16_t BPDIS: 1;
+        uint16_t : 2;
+        uint16_t BOOTPROT: 4;
+        uint16_t : 4;
+    } bit;
+    uint16_t reg;
+} NVMCTRL_STATUS_Type;
+
+HOST_REG(NVMCTRL_CTRLB_Type, 16);
+HOST_REG(NVMCTRL_ADDR_Type, 32);
+
+typedef struct {
+    __IO NVMCTRL_CTRLA_Type CTRLA;
+    __O NVMCTRL_CTRLB_Type CTRLB;
+    __I uint32_t PARAM;
+    __IO uint16_t INTENCLR;
+    __IO uint16_t INTENSET;
+    __IO NVMCTRL_INTFLAG_Type INTFLAG;
+    __I NVMCTRL_STATUS_Type STATUS;
+    __IO NVMCTRL_ADDR_Type ADDR;
+} Nvmctrl;
+
+/** Size of an NVM page, in bytes. **/
+#define NVMCTRL_PAGE_SIZE 512
+/** Storage that stands in for the NVM user page. **/
+extern uint32_t HostNvmUserPage[NVMCTRL_PAGE_SIZE / sizeof(uint32_t)];
+#define NVMCTRL_USER (reinterpret_cast<uintptr_t>(HostNvmUserPage))
+
+#define NVMCTRL_CTRLA_WMODE_MAN_Val 0x0U
+#define NVMCTRL_CTRLA_WMODE_MAN NVMCTRL_CTRLA_WMODE_MAN_Val
+#define NVMCTRL_CTRLB_CMD_EP 0x00U
+#define NVMCTRL_CTRLB_CMD_WQW 0x04U
+#define NVMCTRL_CTRLB_CMD_PBC 0x15U
+#define NVMCTRL_CTRLB_CMDEX_KEY (0xA5U << 8)
+
+//*****************************************************************************
+// PDEC
+//
+
+typedef union {
+    struct {
+        uint32_t SWRST: 1;
+        uint32_t ENABLE: 1;
+        uint32_t MODE: 2;
+        uint32_t : 2;
+        uint32_t RUNSTDBY: 1;
+        uint32_t : 1;
+        uint32_t CONF: 3;
+        uint32_t ALOCK: 1;
+        uint32_t : 2;
+        uint32_t SWAP: 1;
+        uint32_t PEREN: 1;
+        uint32_t PINEN0: 1;
+        uint32_t PINEN1: 1;
+        uint32_t PINEN2: 1;
+        uint32_t : 1;
+        uint32_t PINVEN0: 1;
+        uint32_t PINVEN1: 1;
+        uint32_t PINVEN2: 1;
+        uint32_t : 1;
+        uint32_t ANGULAR: 3;
+        uint32_t : 1;
+        uint32_t MAXCMP: 4;
+    } bit;
+    uint32_t reg;
+} PDEC_CTRLA_Type;
+
+typedef union {
+    struct {
+        uint16_t QERR: 1;
+        uint16_t IDXERR: 1;
+        uint16_t MPERR: 1;
+        uint16_t : 1;
+        uint16_t WINERR: 1;
+        uint16_t HERR: 1;
+        uint16_t STOP: 1;
+        uint16_t DIR: 1;
+        uint16_t : 8;
+    } bit;
+    uint16_t reg;
+} PDEC_STATUS_Type;
+
+HOST_REG(PDEC_CTRLBSET_Type, 8);
+HOST_REG(PDEC_SYNCBUSY_Type, 32);
+HOST_REG(PDEC_COUNT_Type, 32);
+
+typedef struct {
+    __IO PDEC_CTRLA_Type CTRLA;
+    __IO uint8_t CTRLBCLR;
+    __IO PDEC_CTRLBSET_Type CTRLBSET;
+    __IO uint16_t EVCTRL;
+    __IO uint8_t INTENCLR;
+    __IO uint8_t INTENSET;
+    __IO uint8_t INTFLAG;
+    __IO PDEC_STATUS_Type STATUS;
+    __I PDEC_SYNCBUSY_Type SYNCBUSY;
+    __IO PDEC_COUNT_Type COUNT;
+} Pdec;
+
+#define PDEC_CTRLA_MODE_QDEC (0x0U << 2)
+#define PDEC_CTRLA_CONF_X4 (0x0U << 8)
+#define PDEC_CTRLA_PINEN0 (0x1U << 16)
+#define PDEC_CTRLA_PINEN1 (0x1U << 17)
+#define PDEC_CTRLA_ANGULAR_Msk (0x7U << 24)
+#define PDEC_CTRLBSET_CMD_READSYNC (0x3U << 5)
+#define PDEC_CTRLBSET_CMD_START (0x4U << 5)
+#define PDEC_CTRLBSET_CMD_STOP (0x5U << 5)
+#define PDEC_STATUS_QERR (0x1U << 0)
+#define PDEC_SYNCBUSY_ENABLE (0x1U << 1)
+#define PDEC_SYNCBUSY_CTRLB (0x1U << 2)
+#define PDEC_SYNCBUSY_COUNT (0x1U << 6)
+
+//*****************************************************************************
+// PORT
+//
+
+typedef union {
+    struct {
+        uint8_t PMUXE: 4;
+        uint8_t PMUXO: 4;
+    } bit;
+    uint8_t reg;
+} PORT_PMUX_Type;
+
+typedef union {
+    struct {
+        uint8_t PMUXEN: 1;
+        uint8_t INEN: 1;
+        uint8_t PULLEN: 1;
+        uint8_t : 3;
+        uint8_t DRVSTR: 1;
+        uint8_t : 1;
+    } bit;
+    uint8_t reg;
+} PORT_PINCFG_Type;
+
+typedef union {
+    uint32_t reg;
+} PORT_DATA_Type;
+
+typedef union {
+    HostPortClrReg reg;
+} PORT_CLR_Type;
+
+typedef union {
+    HostPortSetReg reg;
+} PORT_SET_Type;
+
+typedef union {
+    HostPortTglReg reg;
+} PORT_TGL_Type;
+
+typedef struct {
+    __IO PORT_DATA_Type DIR;
+    __IO PORT_CLR_Type DIRCLR;
+    __IO PORT_SET_Type DIRSET;
+    __IO PORT_TGL_Type DIRTGL;
+    __IO PORT_DATA_Type OUT;
+    __IO PORT_CLR_Type OUTCLR;
+    __IO PORT_SET_Type OUTSET;
+    __IO PORT_TGL_Type OUTTGL;
+    __I PORT_DATA_Type IN;
+    __IO uint32_t CTRL;
+    __O uint32_t WRCONFIG;
+    __IO uint32_t EVCTRL;
+    __IO PORT_PMUX_Type PMUX[16];
+    __IO PORT_PINCFG_Type PINCFG[32];
+    uint8_t Reserved[32];
+} PortGroup;
+
+#define PORT_GROUPS 4
+
+typedef struct {
+    PortGroup Group[PORT_GROUPS];
+} Port;
+
+#define PORT_PINCFG_PMUXEN (0x1U << 0)
+#define PORT_PINCFG_INEN (0x1U << 1)
+
+//*****************************************************************************
+// SERCOM
+//
+
+typedef union {
+    struct {
+        uint32_t SWRST: 1;
+        uint32_t ENABLE: 1;
+        uint32_t MODE: 3;
+        uint32_t : 2;
+        uint32_t RUNSTDBY: 1;
+        uint32_t IBON: 1;
+        uint32_t : 7;
+        uint32_t DOPO: 2;
+        uint32_t : 2;
+        uint32_t DIPO: 2;
+        uint32_t : 2;
+        uint32_t FORM: 4;
+        uint32_t CPHA: 1;
+        uint32_t CPOL: 1;
+        uint32_t DORD: 1;
+        uint32_t : 1;
+    } bit;
+    uint32_t reg;
+} SERCOM_SPI_CTRLA_Type;
+
+typedef union {
+    struct {
+        uint32_t CHSIZE: 3;
+        uint32_t : 3;
+        uint32_t PLOADEN: 1;
+        uint32_t : 2;
+        uint32_t SSDE: 1;
+        uint32_t : 3;
+        uint32_t MSSEN: 1;
+        uint32_t AMODE: 2;
+        uint32_t : 1;
+        uint32_t RXEN: 1;
+        uint32_t : 14;
+    } bit;
+    uint32_t reg;
+} SERCOM_SPI_CTRLB_Type;
+
+typedef union {
+    struct {
+        uint8_t BAUD: 8;
+    } bit;
+    uint8_t reg;
+} SERCOM_SPI_BAUD_Type;
+
+typedef union {
+    struct {
+        uint8_t DRE: 1;
+        uint8_t TXC: 1;
+        uint8_t RXC: 1;
+        uint8_t SSL: 1;
+        uint8_t : 3;
+        uint8_t ERROR: 1;
+    } bit;
+    uint8_t reg;
+} SERCOM_SPI_INTFLAG_Type;
+
+typedef union {
+    struct {
+        uint32_t DATA: 32;
+    } bit;
+    uint32_t reg;
+} SERCOM_DATA_Type;
+
+HOST_REG(SERCOM_SYNCBUSY_Type, 32);
+HOST_REG(SERCOM_CTRLC_Type, 32);
+
+typedef struct {
+    __IO SERCOM_SPI_CTRLA_Type CTRLA;
+    __IO SERCOM_SPI_CTRLB_Type CTRLB;
+    __IO SERCOM_CTRLC_Type CTRLC;
+    __IO SERCOM_SPI_BAUD_Type BAUD;
+    uint8_t Reserved1[7];
+    __IO uint8_t INTENCLR;
+    uint8_t Reserved2[1];
+    __IO uint8_t INTENSET;
+    uint8_t Reserved3[1];
+    __IO SERCOM_SPI_INTFLAG_Type INTFLAG;
+    uint8_t Reserved4[1];
+    __IO uint16_t STATUS;
+    __I SERCOM_SYNCBUSY_Type SYNCBUSY;
+    uint8_t Reserved5[4];
+    __IO uint16_t LENGTH;
+    uint8_t Reserved6[2];
+    __IO uint32_t ADDR;
+    __IO SERCOM_DATA_Type DATA;
+} SercomSpi;
+
+typedef union {
+    struct {
+        uint32_t SWRST: 1;
+        uint32_t ENABLE: 1;
+        uint32_t MODE: 3;
+        uint32_t : 2;
+        uint32_t RUNSTDBY: 1;
+        uint32_t IBON: 1;
+        uint32_t TXINV: 1;
+        uint32_t RXINV: 1;
+        uint32_t : 2;
+        uint32_t SAMPR: 3;
+        uint32_t TXPO: 2;
+        uint32_t : 2;
+        uint32_t RXPO: 2;
+        uint32_t SAMPA: 2;
+        uint32_t FORM: 4;
+        uint32_t CMODE: 1;
+        uint32_t CPOL: 1;
+        uint32_t DORD: 1;
+        uint32_t : 1;
+    } bit;
+    uint32_t reg;
+} SERCOM_USART_CTRLA_Type;
+
+typedef union {
+    struct {
+        uint32_t CHSIZE: 3;
+        uint32_t : 3;
+        uint32_t SBMODE: 1;
+        uint32_t : 1;
+        uint32_t COLDEN: 1;
+        uint32_t SFDE: 1;
+        uint32_t ENC: 1;
+        uint32_t : 2;
+        uint32_t PMODE: 1;
+        uint32_t : 2;
+        uint32_t TXEN: 1;
+        uint32_t RXEN: 1;
+        uint32_t : 14;
+    } bit;
+    uint32_t reg;
+} SERCOM_USART_CTRLB_Type;
+
+typedef union {
+    struct {
+        uint16_t BAUD: 16;
+    } bit;
+    uint16_t reg;
+} SERCOM_USART_BAUD_Type;
+
+typedef union {
+    struct {
+        uint8_t DRE: 1;
+        uint8_t TXC: 1;
+        uint8_t RXC: 1;
+        uint8_t RXS: 1;
+        uint8_t CTSIC: 1;
+        uint8_t RXBRK: 1;
+        uint8_t : 1;
+        uint8_t ERROR: 1;
+    } bit;
+    uint8_t reg;
+} SERCOM_USART_INTFLAG_Type;
+
+typedef union {
+    struct {
+        uint16_t PERR: 1;
+        uint16_t FERR: 1;
+        uint16_t BUFOVF: 1;
+        uint16_t CTS: 1;
+        uint16_t ISF: 1;
+        uint16_t COLL: 1;
+        uint16_t TXE: 1;
+        uint16_t ITER: 1;
+        uint16_t : 8;
+    } bit;
+    uint16_t reg;
+} SERCOM_USART_STATUS_Type;
+
+HOST_REG(SERCOM_USART_INTEN_Type, 8);
+HOST_REG(SERCOM_USART_RXERRCNT_Type, 8);
+
+typedef struct {
+    __IO SERCOM_USART_CTRLA_Type CTRLA;
+    __IO SERCOM_USART_CTRLB_Type CTRLB;
+    __IO SERCOM_CTRLC_Type CTRLC;
+    __IO SERCOM_USART_BAUD_Type BAUD;
+    __IO uint8_t RXPL;
+    uint8_t Reserved1[5];
+    __IO SERCOM_USART_INTEN_Type INTENCLR;
+    uint8_t Reserved2[1];
+    __IO SERCOM_USART_INTEN_Type INTENSET;
+    uint8_t Reserved3[1];
+    __IO SERCOM_USART_INTFLAG_Type INTFLAG;
+    uint8_t Reserved4[1];
+    __IO SERCOM_USART_STATUS_Type STATUS;
+    __I SERCOM_SYNCBUSY_Type SYNCBUSY;
+    __I SERCOM_USART_RXERRCNT_Type RXERRCNT;
+    uint8_t Reserved5[3];
+    __IO uint16_t LENGTH;
+    uint8_t Reserved6[6];
+    __IO SERCOM_DATA_Type DATA;
+} SercomUsart;
+
+typedef union {
+    SercomSpi SPI;
+    SercomUsart USART;
+} Sercom;
+
+#define SERCOM_INST_NUM 8
+
+#define SERCOM_SPI_CTRLA_MODE(value) (((value) & 0x7U) << 2)
+#define SERCOM_SPI_CTRLA_DOPO(value) (((value) & 0x3U) << 16)
+#define SERCOM_SPI_CTRLA_DIPO(value) (((value) & 0x3U) << 20)
+#define SERCOM_SPI_CTRLA_DORD (0x1U << 30)
+#define SERCOM_SPI_CTRLB_CHSIZE_Msk (0x7U << 0)
+#define SERCOM_SPI_CTRLC_DATA32B (0x1U << 24)
+#define SERCOM_SPI_INTFLAG_DRE (0x1U << 0)
+#define SERCOM_SPI_INTFLAG_TXC (0x1U << 1)
+#define SERCOM_SPI_INTFLAG_RXC (0x1U << 2)
+#define SERCOM_SPI_SYNCBUSY_ENABLE (0x1U << 1)
+#define SERCOM_USART_CTRLB_CHSIZE_Msk (0x7U << 0)
+#define SERCOM_USART_INTENCLR_DRE (0x1U << 0)
+#define SERCOM_USART_INTENCLR_RXC (0x1U << 2)
+#define SERCOM_USART_INTENSET_DRE (0x1U << 0)
+#define SERCOM_USART_INTENSET_RXC (0x1U << 2)
+#define SERCOM_USART_INTENSET_ERROR (0x1U << 7)
+#define SERCOM_USART_INTFLAG_DRE_Pos 0
+#define SERCOM_USART_INTFLAG_RXC_Pos 2
+#define SERCOM_USART_INTFLAG_RXS_Pos 3
+#define SERCOM_USART_INTFLAG_ERROR (0x1U << 7)
+#define SERCOM_USART_SYNCBUSY_SWRST (0x1U << 0)
+#define SERCOM_USART_SYNCBUSY_ENABLE (0x1U << 1)
+#define SERCOM_USART_SYNCBUSY_CTRLB (0x1U << 2)
+
+#define SERCOM0_DMAC_ID_RX 0x04
+#define SERCOM0_DMAC_ID_TX 0x05
+#define SERCOM7_DMAC_ID_RX 0x12
+#define SERCOM7_DMAC_ID_TX 0x13
+
+//*****************************************************************************
+// SUPC
+//
+
+typedef union {
+    struct {
+        uint32_t : 1;
+        uint32_t ENABLE: 1;
+        uint32_t ACTION: 2;
+        uint32_t STDBYCFG: 1;
+        uint32_t RUNSTDBY: 1;
+        uint32_t RUNHIB: 1;
+        uint32_t RUNBKUP: 1;
+        uint32_t HYST: 4;
+        uint32_t PSEL: 3;
+        uint32_t : 1;
+        uint32_t LEVEL: 8;
+        uint32_t VBATLEVEL: 8;
+    } bit;
+    uint32_t reg;
+} SUPC_BOD33_Type;
+
+typedef union {
+    struct {
+        uint32_t : 1;
+        uint32_t TSEN: 1;
+        uint32_t VREFOE: 1;
+        uint32_t TSSEL: 1;
+        uint32_t : 2;
+        uint32_t RUNSTDBY: 1;
+        uint32_t ONDEMAND: 1;
+        uint32_t : 8;
+        uint32_t SEL: 4;
+        uint32_t : 12;
+    } bit;
+    uint32_t reg;
+} SUPC_VREF_Type;
+
+typedef struct {
+    __IO uint32_t INTENCLR;
+    __IO uint32_t INTENSET;
+    __IO uint32_t INTFLAG;
+    __I uint32_t STATUS;
+    __IO SUPC_BOD33_Type BOD33;
+    __IO uint32_t REG;
+    __IO SUPC_VREF_Type VREF;
+} Supc;
+
+#define SUPC_BOD33_ACTION_RESET_Val 0x1U
+#define SUPC_VREF_SEL_2V5_Val 0x7U
+
+//*****************************************************************************
+// TC
+//
+
+typedef union {
+    struct {
+        uint32_t SWRST: 1;
+        uint32_t ENABLE: 1;
+        uint32_t MODE: 2;
+        uint32_t PRESCSYNC: 2;
+        uint32_t RUNSTDBY: 1;
+        uint32_t ONDEMAND: 1;
+        uint32_t PRESCALER: 3;
+        uint32_t ALOCK: 1;
+        uint32_t : 4;
+        uint32_t CAPTEN0: 1;
+        uint32_t CAPTEN1: 1;
+        uint32_t : 2;
+        uint32_t COPEN0: 1;
+        uint32_t COPEN1: 1;
+        uint32_t : 1;
+        uint32_t DMAOS: 1;
+        uint32_t CAPTMODE0: 2;
+        uint32_t : 1;
+        uint32_t CAPTMODE1: 2;
+        uint32_t : 3;
+    } bit;
+    uint32_t reg;
+} TC_CTRLA_Type;
+
+typedef union {
+    struct {
+        uint8_t DIR: 1;
+        uint8_t LUPD: 1;
+        uint8_t ONESHOT: 1;
+        uint8_t : 2;
+        uint8_t CMD: 3;
+    } bit;
+    uint8_t reg;
+} TC_CTRLB_Type;
+
+typedef union {
+    struct {
+        uint16_t EVACT: 3;
+        uint16_t : 1;
+        uint16_t TCINV: 1;
+        uint16_t TCEI: 1;
+        uint16_t : 2;
+        uint16_t OVFEO: 1;
+        uint16_t : 3;
+        uint16_t MCEO0: 1;
+        uint16_t MCEO1: 1;
+        uint16_t : 2;
+    } bit;
+    uint16_t reg;
+} TC_EVCTRL_Type;
+
+typedef union {
+    struct {
+        uint8_t OVF: 1;
+        uint8_t ERR: 1;
+        uint8_t : 2;
+        uint8_t MC0: 1;
+        uint8_t MC1: 1;
+        uint8_t : 2;
+    } bit;
+    uint8_t reg;
+} TC_INTFLAG_Type;
+
+HOST_REG(TC_WAVE_Type, 8);
+HOST_REG(TC_DRVCTRL_Type, 8);
+HOST_REG(TC_SYNCBUSY_Type, 32);
+HOST_REG(TC_COUNT8_Type, 8);
+HOST_REG(TC_COUNT16_Type, 16);
+
+typedef struct {
+    __IO TC_CTRLA_Type CTRLA;
+    __IO TC_CTRLB_Type CTRLBCLR;
+    __IO TC_CTRLB_Type CTRLBSET;
+    __IO TC_EVCTRL_Type EVCTRL;
+    __IO TC_INTFLAG_Type INTENCLR;
+    __IO TC_INTFLAG_Type INTENSET;
+    __IO TC_INTFLAG_Type INTFLAG;
+    __IO uint8_t STATUS;
+    __IO TC_WAVE_Type WAVE;
+    __IO TC_DRVCTRL_Type DRVCTRL;
+    uint8_t Reserved1[1];
+    __IO uint8_t DBGCTRL;
+    __I TC_SYNCBUSY_Type SYNCBUSY;
+    __IO TC_COUNT8_Type COUNT;
+    uint8_t Reserved2[6];
+    __IO TC_COUNT8_Type PER;
+    __IO TC_COUNT8_Type CC[2];
+    uint8_t Reserved3[17];
+    __IO TC_COUNT8_Type PERBUF;
+    __IO TC_COUNT8_Type CCBUF[2];
+} TcCount8;
+
+typedef struct {
+    __IO TC_CTRLA_Type CTRLA;
+    __IO TC_CTRLB_Type CTRLBCLR;
+    __IO TC_CTRLB_Type CTRLBSET;
+    __IO TC_EVCTRL_Type EVCTRL;
+    __IO TC_INTFLAG_Type INTENCLR;
+    __IO TC_INTFLAG_Type INTENSET;
+    __IO TC_INTFLAG_Type INTFLAG;
+    __IO uint8_t STATUS;
+    __IO TC_WAVE_Type WAVE;
+    __IO TC_DRVCTRL_Type DRVCTRL;
+    uint8_t Reserved1[1];
+    __IO uint8_t DBGCTRL;
+    __I TC_SYNCBUSY_Type SYNCBUSY;
+    __IO TC_COUNT16_Type COUNT;
+    uint8_t Reserved2[6];
+    __IO TC_COUNT16_Type CC[2];
+    uint8_t Reserved3[16];
+    __IO TC_COUNT16_Type CCBUF[2];
+} TcCount16;
+
+typedef union {
+    TcCount8 COUNT8;
+    TcCount16 COUNT16;
+} Tc;
+
+#define TC_INST_NUM 8
+
+#define TC_CTRLA_MODE_COUNT16_Val 0x0U
+#define TC_CTRLA_MODE_COUNT8_Val 0x1U
+#define TC_CTRLA_MODE_COUNT16 (TC_CTRLA_MODE_COUNT16_Val << 2)
+#define TC_CTRLA_PRESCSYNC_GCLK_Val 0x0U
+#define TC_CTRLA_PRESCSYNC_GCLK (TC_CTRLA_PRESCSYNC_GCLK_Val << 4)
+#define TC_CTRLA_PRESCALER_DIV1_Val 0x0U
+#define TC_CTRLA_PRESCALER_DIV16_Val 0x4U
+#define TC_CTRLA_PRESCALER_DIV1024_Val 0x7U
+#define TC_CTRLA_PRESCALER_DIV1 (TC_CTRLA_PRESCALER_DIV1_Val << 8)
+#define TC_CTRLBCLR_ONESHOT (0x1U << 2)
+#define TC_CTRLBSET_ONESHOT (0x1U << 2)
+#define TC_CTRLBSET_CMD_STOP (0x2U << 5)
+#define TC_CTRLBSET_CMD_READSYNC (0x4U << 5)
+#define TC_EVCTRL_EVACT_RETRIGGER (0x1U << 0)
+#define TC_EVCTRL_EVACT_COUNT (0x2U << 0)
+#define TC_EVCTRL_EVACT_PPW_Val 0x5U
+#define TC_EVCTRL_TCEI (0x1U << 5)
+#define TC_INTFLAG_OVF (0x1U << 0)
+#define TC_INTFLAG_ERR (0x1U << 1)
+#define TC_INTFLAG_MC0 (0x1U << 4)
+#define TC_INTFLAG_MC1 (0x1U << 5)
+#define TC_WAVE_WAVEGEN_NPWM (0x2U << 0)
+#define TC_WAVE_WAVEGEN_MPWM (0x3U << 0)
+#define TC_DRVCTRL_INVEN0 (0x1U << 0)
+#define TC_DRVCTRL_INVEN_Msk (0x3U << 0)
+#define TC_SYNCBUSY_SWRST (0x1U << 0)
+#define TC_SYNCBUSY_ENABLE (0x1U << 1)
+#define TC_SYNCBUSY_CTRLB (0x1U << 2)
+#define TC_SYNCBUSY_COUNT (0x1U << 4)
+#define TC_SYNCBUSY_PER (0x1U << 5)
+#define TC_SYNCBUSY_CC0 (0x1U << 6)
+#define TC_SYNCBUSY_CC1 (0x1U << 7)
+
+//*****************************************************************************
+// TCC
+//
+
+typedef union {
+    struct {
+        uint32_t SWRST: 1;
+        uint32_t ENABLE: 1;
+        uint32_t : 3;
+        uint32_t RESOLUTION: 2;
+        uint32_t : 1;
+        uint32_t PRESCALER: 3;
+        uint32_t RUNSTDBY: 1;
+        uint32_t PRESCSYNC: 2;
+        uint32_t ALOCK: 1;
+        uint32_t MSYNC: 1;
+        uint32_t : 7;
+        uint32_t DMAOS: 1;
+        uint32_t CPTEN0: 1;
+        uint32_t CPTEN1: 1;
+        uint32_t CPTEN2: 1;
+        uint32_t CPTEN3: 1;
+        uint32_t CPTEN4: 1;
+        uint32_t CPTEN5: 1;
+        uint32_t : 2;
+    } bit;
+    uint32_t reg;
+} TCC_CTRLA_Type;
+
+typedef union {
+    struct {
+        uint8_t DIR: 1;
+        uint8_t LUPD: 1;
+        uint8_t ONESHOT: 1;
+        uint8_t IDXCMD: 2;
+        uint8_t CMD: 3;
+    } bit;
+    uint8_t reg;
+} TCC_CTRLB_Type;
+
+typedef union {
+    struct {
+        uint32_t OVF: 1;
+        uint32_t TRG: 1;
+        uint32_t CNT: 1;
+        uint32_t ERR: 1;
+        uint32_t : 6;
+        uint32_t UFS: 1;
+        uint32_t DFS: 1;
+        uint32_t FAULTA: 1;
+        uint32_t FAULTB: 1;
+        uint32_t FAULT0: 1;
+        uint32_t FAULT1: 1;
+        uint32_t MC0: 1;
+        uint32_t MC1: 1;
+        uint32_t MC2: 1;
+        uint32_t MC3: 1;
+        uint32_t MC4: 1;
+        uint32_t MC5: 1;
+        uint32_t : 10;
+    } bit;
+    uint32_t reg;
+} TCC_INTFLAG_Type;
+
+HOST_REG(TCC_SYNCBUSY_Type, 32);
+HOST_REG(TCC_DBGCTRL_Type, 8);
+HOST_REG(TCC_COUNT_Type, 32);
+HOST_REG(TCC_WAVE_Type, 32);
+HOST_REG(TCC_PER_Type, 32);
+HOST_REG(TCC_CC_Type, 32);
+
+typedef struct {
+    __IO TCC_CTRLA_Type CTRLA;
+    __IO TCC_CTRLB_Type CTRLBCLR;
+    __IO TCC_CTRLB_Type CTRLBSET;
+    uint8_t Reserved1[2];
+    __I TCC_SYNCBUSY_Type SYNCBUSY;
+    __IO uint32_t FCTRLA;
+    __IO uint32_t FCTRLB;
+    __IO uint32_t WEXCTRL;
+    __IO uint32_t DRVCTRL;
+    uint8_t Reserved2[2];
+    __IO TCC_DBGCTRL_Type DBGCTRL;
+    uint8_t Reserved3[1];
+    __IO uint32_t EVCTRL;
+    __IO TCC_INTFLAG_Type INTENCLR;
+    __IO TCC_INTFLAG_Type INTENSET;
+    __IO TCC_INTFLAG_Type INTFLAG;
+    __IO uint32_t STATUS;
+    __IO TCC_COUNT_Type COUNT;
+    __IO uint16_t PATT;
+    uint8_t Reserved4[2];
+    __IO TCC_WAVE_Type WAVE;
+    __IO TCC_PER_Type PER;
+    __IO TCC_CC_Type CC[6];
+    uint8_t Reserved5[16];
+    __IO uint16_t PATTBUF;
+    uint8_t Reserved6[6];
+    __IO TCC_PER_Type PERBUF;
+    __IO TCC_CC_Type CCBUF[6];
+} Tcc;
+
+#define TCC_INST_NUM 5
+#define TCC0_CC_NUM 6
+#define TCC1_CC_NUM 4
+#define TCC2_CC_NUM 3
+#define TCC3_CC_NUM 2
+#define TCC4_CC_NUM 2
+
+#define TCC_CTRLA_PRESCALER(value) (((value) & 0x7U) << 8)
+#define TCC_DBGCTRL_DBGRUN (0x1U << 0)
+#define TCC_INTFLAG_MASK 0x003FFC0FU
+#define TCC_WAVE_WAVEGEN_NFRQ (0x1U << 0)
+#define TCC_WAVE_WAVEGEN_NPWM (0x2U << 0)
+#define TCC_WAVE_WAVEGEN_DSBOTTOM (0x5U << 0)
+#define TCC_WAVE_POL_Msk (0x3FU << 16)
+#define TCC_SYNCBUSY_SWRST (0x1U << 0)
+#define TCC_SYNCBUSY_ENABLE (0x1U << 1)
+#define TCC_SYNCBUSY_COUNT (0x1U << 4)
+#define TCC_SYNCBUSY_WAVE (0x1U << 6)
+#define TCC_SYNCBUSY_PER (0x1U << 7)
+#define TCC_SYNCBUSY_CC(value) (((value) & 0x3FU) << 8)
+
+#define TCC0_DMAC_ID_OVF 0x16
+#define TCC1_DMAC_ID_OVF 0x1D
+#define TCC2_DMAC_ID_OVF 0x22
+#define TCC3_DMAC_ID_OVF 0x26
+#define TCC4_DMAC_ID_OVF 0x29
+#define ADC1_DMAC_ID_RESRDY 0x46
+#define ADC1_DMAC_ID_SEQ 0x47
+
+//*****************************************************************************
+// Memories
+//
+
+/** Size of the SAME53N19A SRAM, in bytes. **/
+#define HSRAM_SIZE 0x30000U
+/** Storage that stands in for the SRAM; used for the stack model. **/
+extern uint32_t HostRam[HSRAM_SIZE / sizeof(uint32_t)];
+#define HSRAM_ADDR (reinterpret_cast<uintptr_t>(HostRam))
+
+//*****************************************************************************
+// Peripheral instances
+//
+
+extern Adc HostAdc1;
+extern Ccl HostCcl;
+extern Cmcc HostCmcc;
+extern Dac HostDac;
+extern Dmac HostDmac;
+extern Eic HostEic;
+extern Evsys HostEvsys;
+extern Gclk HostGclk;
+extern Gmac HostGmac;
+extern Mclk HostMclk;
+extern Nvmctrl HostNvmctrl;
+extern Pdec HostPdec;
+extern Port HostPort;
+extern Sercom HostSercom[SERCOM_INST_NUM];
+extern Supc HostSupc;
+extern Tc HostTc[TC_INST_NUM];
+extern Tcc HostTcc[TCC_INST_NUM];
+
+#define ADC1 (&HostAdc1)
+#define CCL (&HostCcl)
+#define CMCC (&HostCmcc)
+#define DAC (&HostDac)
+#define DMAC (&HostDmac)
+#define EIC (&HostEic)
+#define EVSYS (&HostEvsys)
+#define GCLK (&HostGclk)
+#define GMAC (&HostGmac)
+#define MCLK (&HostMclk)
+#define NVMCTRL (&HostNvmctrl)
+#define PDEC (&HostPdec)
+#define PORT (&HostPort)
+#define SUPC (&HostSupc)
+#define SERCOM0 (&HostSercom[0])
+#define SERCOM1 (&HostSercom[1])
+#define SERCOM2 (&HostSercom[2])
+#define SERCOM3 (&HostSercom[3])
+#define SERCOM4 (&HostSercom[4])
+#define SERCOM5 (&HostSercom[5])
+#define SERCOM6 (&HostSercom[6])
+#define SERCOM7 (&HostSercom[7])
+#define TC0 (&HostTc[0])
+#define TC1 (&HostTc[1])
+#define TC2 (&HostTc[2])
+#define TC3 (&HostTc[3])
+#define TC4 (&HostTc[4])
+#define TC5 (&HostTc[5])
+#define TC6 (&HostTc[6])
+#define TC7 (&HostTc[7])
+#define TCC0 (&HostTcc[0])
+#define TCC1 (&HostTcc[1])
+#define TCC2 (&HostTcc[2])
+#define TCC3 (&HostTcc[3])
+#define TCC4 (&HostTcc[4])
+
+#define SERCOM_INSTS {SERCOM0, SERCOM1, SERCOM2, SERCOM3, SERCOM4, SERCOM5,   \
+                      SERCOM6, SERCOM7}
+#define TC_INSTS {TC0, TC1, TC2, TC3, TC4, TC5, TC6, TC7}
+#define TCC_INSTS {TCC0, TCC1, TCC2, TCC3, TCC4}
+
+#define REG_ADC1_DSEQDATA (ADC1->DSEQDATA.reg)
+
+#endif // __HOSTREGISTERS_H__
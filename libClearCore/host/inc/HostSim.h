@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file HostSim.h
+    \brief Control of the host simulation from test programs.
+
+    A host test provides its own main(), calls ClearCoreHost::Boot() in place
+    of the target's Reset_Handler, and then drives virtual time:
+
+    \code{.cpp}
+    int main() {
+        ClearCoreHost::Boot();
+        ClearCoreHost::Run(5);  // five sample periods
+        return 0;
+    }
+    \endcode
+
+    Virtual time advances only when DWT->CYCCNT is read, which Delay_ms(),
+    Microseconds() and the library's own timing all do. A loop that waits on
+    Milliseconds() alone (or on a flag set by an interrupt) must call Run()
+    in its body, or it will never see time pass.
+**/
+
+#ifndef __HOSTSIM_H__
+#define __HOSTSIM_H__
+
+#include <stdint.h>
+#include "HostCmsis.h"
+
+namespace ClearCoreHost {
+
+/**
+    Prepare the host process and run SysMgr.Initialize().
+**/
+void Boot();
+
+/**
+    Advance virtual time by \a samples sample periods, running every
+    interrupt that comes due.
+**/
+void Run(uint32_t samples);
+
+/**
+    Advance virtual time by \a cycles CPU cycles.
+**/
+void RunCycles(uint64_t cycles);
+
+/**
+    Virtual CPU cycles elapsed since the program started.
+**/
+uint64_t Cycles();
+
+/**
+    Pend an interrupt, as the peripheral behind it would.
+**/
+void Pend(IRQn_Type irq);
+
+/**
+    Number of times an interrupt has been taken.
+**/
+uint32_t IrqCount(IRQn_Type irq);
+
+/**
+    Set the raw ADC result that the \a index'th conversion of each sample's
+    sequence returns; the index is the AdcManager::AdcChannels value.
+**/
+void AdcResult(uint32_t index, uint16_t raw);
+
+/**
+    Queue characters to arrive on the USB serial port.
+**/
+void UsbInput(const char *text);
+
+} // ClearCoreHost namespace
+
+#endif // __HOSTSIM_H__
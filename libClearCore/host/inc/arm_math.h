@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file arm_math.h
+    \brief Host replacement for the CMSIS-DSP functions the library calls.
+
+    arm_sin_q15() is computed in double precision and rounded, where the
+    CMSIS version interpolates a 512-entry table; the two agree to within a
+    few counts of a q15.
+**/
+
+#ifndef __HOST_ARM_MATH_H__
+#define __HOST_ARM_MATH_H__
+
+#include <math.h>
+#include <stdint.h>
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+/**
+    Sine of a q15 angle, where 0 to 0x7FFF spans one full turn.
+**/
+static inline q15_t arm_sin_q15(q15_t x) {
+    double s = sin((x & 0x7FFF) * (2.0 * M_PI / 32768.0));
+    return static_cast<q15_t>(lrint(s * 32767.0));
+}
+
+#endif // __HOST_ARM_MATH_H__
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file cdcdf_acm.h
+    \brief Host stand-in for the ASF USB CDC ACM function driver header.
+
+    UsbManager.h only needs the CDC control signal and transfer result types;
+    the host build replaces UsbManager.cpp with host/src/HostUsbManager.cpp,
+    so none of the ASF driver functions are declared here.
+**/
+
+#ifndef __HOST_CDCDF_ACM_H__
+#define __HOST_CDCDF_ACM_H__
+
+#include <stdint.h>
+
+typedef struct usb_cdc_control_signal {
+    union {
+        uint16_t value;
+        struct {
+            uint8_t dte_present;
+            uint8_t carrier_ctrl;
+        } modem;
+        struct {
+            uint8_t DTR : 1;
+            uint8_t RTS : 1;
+        } rs232;
+        struct {
+            uint8_t s108_2 : 1;
+            uint8_t s105 : 1;
+        } v24;
+    };
+} usb_cdc_control_signal_t;
+
+enum usb_xfer_code {
+    USB_XFER_DONE,
+    USB_XFER_ERROR,
+    USB_XFER_HALT,
+    USB_XFER_UNDERRUN,
+    USB_XFER_OVERRUN,
+    USB_XFER_ABORT,
+    USB_XFER_TIMEOUT,
+    USB_XFER_RESET
+};
+
+#endif // __HOST_CDCDF_ACM_H__
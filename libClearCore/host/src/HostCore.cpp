@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file HostCore.cpp
+    \brief Virtual-time model of the Cortex-M4 core for host builds.
+
+    Time only moves when DWT->CYCCNT is read: each read costs
+    HOST_POLL_CYCLES, after which the modelled timers are brought up to date
+    and any interrupt that became due is run. Interrupts are delivered by
+    calling their handlers directly, honouring PRIMASK, NVIC enables and
+    priorities, so a higher priority interrupt can nest inside a lower one
+    the way it does on the target.
+
+    Modelled interrupt sources:
+    - TCC0_0, every CYCLES_PER_INTERRUPT cycles while TCC0 is enabled with
+      its overflow interrupt on (the library's sample interrupt);
+    - SysTick, every LOAD + 1 cycles while enabled with TICKINT set;
+    - PendSV, when PENDSVSET is written to SCB->ICSR;
+    - anything pended through NVIC_SetPendingIRQ() or ClearCoreHost::Pend().
+**/
+
+#include <sam.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "HostSim.h"
+#include "SysTiming.h"
+
+// Cycles charged for each read of the cycle counter
+#define HOST_POLL_CYCLES 8
+// Exceptions are stored after the 16 Cortex-M system vectors
+#define HOST_VECTOR_OFFSET 16
+#define HOST_VECTOR_COUNT (HOST_VECTOR_OFFSET + PERIPH_COUNT_IRQn)
+// Active priority of thread mode: below every exception
+#define HOST_THREAD_PRIORITY 0x100
+
+#define HOST_WEAK_HANDLER(name) \
+    extern "C" void name(void) __attribute__((weak))
+
+HOST_WEAK_HANDLER(PendSV_Handler);
+HOST_WEAK_HANDLER(SysTick_Handler);
+HOST_WEAK_HANDLER(EIC_0_Handler);
+HOST_WEAK_HANDLER(EIC_1_Handler);
+HOST_WEAK_HANDLER(EIC_2_Handler);
+HOST_WEAK_HANDLER(EIC_3_Handler);
+HOST_WEAK_HANDLER(EIC_4_Handler);
+HOST_WEAK_HANDLER(EIC_5_Handler);
+HOST_WEAK_HANDLER(EIC_6_Handler);
+HOST_WEAK_HANDLER(EIC_7_Handler);
+HOST_WEAK_HANDLER(EIC_8_Handler);
+HOST_WEAK_HANDLER(EIC_9_Handler);
+HOST_WEAK_HANDLER(EIC_10_Handler);
+HOST_WEAK_HANDLER(EIC_11_Handler);
+HOST_WEAK_HANDLER(EIC_12_Handler);
+HOST_WEAK_HANDLER(EIC_13_Handler);
+HOST_WEAK_HANDLER(EIC_14_Handler);
+HOST_WEAK_HANDLER(EIC_15_Handler);
+HOST_WEAK_HANDLER(DMAC_0_Handler);
+HOST_WEAK_HANDLER(DMAC_1_Handler);
+HOST_WEAK_HANDLER(DMAC_2_Handler);
+HOST_WEAK_HANDLER(DMAC_3_Handler);
+HOST_WEAK_HANDLER(DMAC_4_Handler);
+HOST_WEAK_HANDLER(SERCOM0_0_Handler);
+HOST_WEAK_HANDLER(SERCOM0_2_Handler);
+HOST_WEAK_HANDLER(SERCOM0_3_Handler);
+HOST_WEAK_HANDLER(SERCOM2_0_Handler);
+HOST_WEAK_HANDLER(SERCOM2_2_Handler);
+HOST_WEAK_HANDLER(SERCOM2_3_Handler);
+HOST_WEAK_HANDLER(SERCOM7_0_Handler);
+HOST_WEAK_HANDLER(SERCOM7_2_Handler);
+HOST_WEAK_HANDLER(SERCOM7_3_Handler);
+HOST_WEAK_HANDLER(USB_0_Handler);
+HOST_WEAK_HANDLER(USB_1_Handler);
+HOST_WEAK_HANDLER(USB_2_Handler);
+HOST_WEAK_HANDLER(USB_3_Handler);
+HOST_WEAK_HANDLER(GMAC_Handler);
+HOST_WEAK_HANDLER(TCC0_0_Handler);
+
+SCB_Type HostScb;
+SysTick_Type HostSysTick;
+DWT_Type HostDwt;
+CoreDebug_Type HostCoreDebug;
+
+namespace {
+
+typedef void (*Handler)(void);
+
+struct Vector {
+    Handler handler;
+    bool enabled;
+    bool pending;
+    uint8_t priority;
+    uint32_t count;
+};
+
+Vector vectors[HOST_VECTOR_COUNT];
+// Virtual time since the program started, in CPU cycles
+uint64_t now;
+// Difference between CYCCNT and the low word of the virtual time
+uint32_t cycleOffset;
+uint64_t nextSample;
+bool sampleTimerRunning;
+uint64_t nextTick;
+bool primask;
+uint32_t activePriority = HOST_THREAD_PRIORITY;
+uint32_t pendingCount;
+
+Vector &VectorOf(IRQn_Type irq) {
+    int32_t index = irq + HOST_VECTOR_OFFSET;
+    if (index < 0 || index >= HOST_VECTOR_COUNT) {
+        fprintf(stderr, "ClearCore host: bad interrupt number %d\n", irq);
+        abort();
+    }
+    return vectors[index];
+}
+
+void Connect(IRQn_Type irq, Handler handler) {
+    Vector &vector = VectorOf(irq);
+    vector.handler = handler;
+    // System exceptions cannot be disabled
+    vector.enabled = irq < 0;
+}
+
+void ConnectAll() {
+    Connect(PendSV_IRQn, PendSV_Handler);
+    Connect(SysTick_IRQn, SysTick_Handler);
+    const Handler eic[] = {
+        EIC_0_Handler, EIC_1_Handler, EIC_2_Handler, EIC_3_Handler,
+        EIC_4_Handler, EIC_5_Handler, EIC_6_Handler, EIC_7_Handler,
+        EIC_8_Handler, EIC_9_Handler, EIC_10_Handler, EIC_11_Handler,
+        EIC_12_Handler, EIC_13_Handler, EIC_14_Handler, EIC_15_Handler
+    };
+    for (int32_t i = 0; i < 16; i++) {
+        Connect(static_cast<IRQn_Type>(EIC_0_IRQn + i), eic[i]);
+    }
+    const Handler dmac[] = {
+        DMAC_0_Handler, DMAC_1_Handler, DMAC_2_Handler, DMAC_3_Handler,
+        DMAC_4_Handler
+    };
+    for (int32_t i = 0; i < 5; i++) {
+        Connect(static_cast<IRQn_Type>(DMAC_0_IRQn + i), dmac[i]);
+    }
+    Connect(SERCOM0_0_IRQn, SERCOM0_0_Handler);
+    Connect(static_cast<IRQn_Type>(SERCOM0_0_IRQn + 2), SERCOM0_2_Handler);
+    Connect(static_cast<IRQn_Type>(SERCOM0_0_IRQn + 3), SERCOM0_3_Handler);
+    Connect(SERCOM2_0_IRQn, SERCOM2_0_Handler);
+    Connect(static_cast<IRQn_Type>(SERCOM2_0_IRQn + 2), SERCOM2_2_Handler);
+    Connect(static_cast<IRQn_Type>(SERCOM2_0_IRQn + 3), SERCOM2_3_Handler);
+    Connect(SERCOM7_0_IRQn, SERCOM7_0_Handler);
+    Connect(static_cast<IRQn_Type>(SERCOM7_0_IRQn + 2), SERCOM7_2_Handler);
+    Connect(static_cast<IRQn_Type>(SERCOM7_0_IRQn + 3), SERCOM7_3_Handler);
+    Connect(USB_0_IRQn, USB_0_Handler);
+    Connect(USB_1_IRQn, USB_1_Handler);
+    Connect(USB_2_IRQn, USB_2_Handler);
+    Connect(USB_3_IRQn, USB_3_Handler);
+    Connect(GMAC_IRQn, GMAC_Handler);
+    Connect(TCC0_0_IRQn, TCC0_0_Handler);
+}
+
+// Run before the library's static constructors, which may enable interrupts
+__attribute__((constructor(101))) void HostCoreReset() {
+    ConnectAll();
+}
+
+void SetPending(Vector &vector, bool pend) {
+    if (vector.pending != pend) {
+        vector.pending = pend;
+        pendingCount += pend ? 1 : -1;
+    }
+}
+
+/**
+    Run every pending, enabled interrupt that can preempt the current
+    priority, highest priority (lowest number) first.
+**/
+void Deliver() {
+    while (pendingCount && !primask) {
+        Vector *next = nullptr;
+        for (int32_t i = 0; i < HOST_VECTOR_COUNT; i++) {
+            Vector &vector = vectors[i];
+            if (vector.pending && vector.enabled &&
+                    vector.priority < activePriority &&
+                    (!next || vector.priority < next->priority)) {
+                next = &vector;
+            }
+        }
+        if (!next) {
+            return;
+        }
+        SetPending(*next, false);
+        next->count++;
+        if (!next->handler) {
+            continue;
+        }
+        uint32_t interrupted = activePriority;
+        activePriority = next->priority;
+        next->handler();
+        activePriority = interrupted;
+    }
+}
+
+/**
+    Pend the timer interrupts that have come due by the current time.
+**/
+void UpdateTimers() {
+    // The sample interrupt runs off TCC0's overflow
+    if (TCC0->CTRLA.bit.ENABLE && TCC0->INTENSET.bit.OVF) {
+        if (!sampleTimerRunning) {
+            sampleTimerRunning = true;
+            nextSample = now + CYCLES_PER_INTERRUPT;
+        }
+        if (now >= nextSample) {
+            // Overflows that were missed coalesce into one interrupt
+            while (nextSample <= now) {
+                nextSample += CYCLES_PER_INTERRUPT;
+            }
+            TCC0->INTFLAG.bit.OVF = 1;
+            SetPending(VectorOf(TCC0_0_IRQn), true);
+        }
+    }
+    else {
+        sampleTimerRunning = false;
+    }
+
+    const uint32_t tickEnable =
+        SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk;
+    if ((SysTick->CTRL & tickEnable) == tickEnable && now >= nextTick) {
+        uint64_t period = (SysTick->LOAD & SysTick_LOAD_RELOAD_Msk) + 1;
+        while (nextTick <= now) {
+            nextTick += period;
+        }
+        SetPending(VectorOf(SysTick_IRQn), true);
+    }
+}
+
+} // anonymous namespace
+
+uint32_t HostCycleRead() {
+    now += HOST_POLL_CYCLES;
+    UpdateTimers();
+    Deliver();
+    return static_cast<uint32_t>(now) + cycleOffset;
+}
+
+void HostCycleWrite(uint32_t value) {
+    cycleOffset = value - static_cast<uint32_t>(now);
+}
+
+void HostIrqEnable(IRQn_Type irq, bool enable) {
+    VectorOf(irq).enabled = enable || irq < 0;
+    Deliver();
+}
+
+bool HostIrqEnabled(IRQn_Type irq) {
+    return VectorOf(irq).enabled;
+}
+
+void HostIrqPend(IRQn_Type irq, bool pend) {
+    SetPending(VectorOf(irq), pend);
+    Deliver();
+}
+
+void HostIrqPriority(IRQn_Type irq, uint32_t priority) {
+    VectorOf(irq).priority = priority & ((1UL << __NVIC_PRIO_BITS) - 1);
+}
+
+uint32_t HostIrqPriorityGet(IRQn_Type irq) {
+    return VectorOf(irq).priority;
+}
+
+void HostIrqMask(bool masked) {
+    primask = masked;
+    Deliver();
+}
+
+bool HostIrqMasked() {
+    return primask;
+}
+
+void HostSysTickStart() {
+    nextTick = now + (SysTick->LOAD & SysTick_LOAD_RELOAD_Msk) + 1;
+}
+
+void HostSystemReset() {
+    fflush(stdout);
+    fprintf(stderr, "ClearCore host: system reset requested\n");
+    exit(EXIT_FAILURE);
+}
+
+uint32_t HostStackPointer() {
+    // A fixed point near the top of the modelled RAM
+    return static_cast<uint32_t>(HSRAM_ADDR + HSRAM_SIZE - 1024);
+}
+
+void HostIcsr::operator=(uint32_t value) volatile {
+    if (value & SCB_ICSR_PENDSVSET_Msk) {
+        HostIrqPend(PendSV_IRQn, true);
+    }
+    else if (value & SCB_ICSR_PENDSVCLR_Msk) {
+        HostIrqPend(PendSV_IRQn, false);
+    }
+}
+
+namespace ClearCoreHost {
+
+void RunCycles(uint64_t cycles) {
+    uint64_t end = now + cycles;
+    while (now < end) {
+        HostCycleRead();
+    }
+}
+
+void Run(uint32_t samples) {
+    RunCycles(static_cast<uint64_t>(samples) * CYCLES_PER_INTERRUPT);
+}
+
+uint64_t Cycles() {
+    return now;
+}
+
+void Pend(IRQn_Type irq) {
+    HostIrqPend(irq, true);
+}
+
+uint32_t IrqCount(IRQn_Type irq) {
+    return VectorOf(irq).count;
+}
+
+} // ClearCoreHost namespace
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file HostDma.cpp
+    \brief Model of the DMA controller for host builds.
+
+    A channel's transfer runs to completion at the moment it is enabled,
+    following its descriptor chain until a descriptor whose DESCADDR is zero.
+    That covers the library's one-shot transfers (the per-sample ADC
+    sequence and results, SPI blocks). Circular chains are paced by a timer
+    on the target (DAC waveforms, H-bridge tones); they are left enabled but
+    idle, as no peripheral trigger is modelled.
+
+    Beats read from the ADC result register take their value from the table
+    set with ClearCoreHost::AdcResult(), one entry per beat of the transfer.
+**/
+
+#include <sam.h>
+#include <string.h>
+#include "HostSim.h"
+
+// Longest descriptor chain followed before it is treated as circular
+#define HOST_DMA_MAX_BLOCKS 16
+
+namespace {
+
+// Raw ADC results returned by successive beats of a results transfer
+uint16_t adcResults[32];
+
+IRQn_Type ChannelIrq(uint32_t channel) {
+    return static_cast<IRQn_Type>(DMAC_0_IRQn + (channel < 4 ? channel : 4));
+}
+
+DmacDescriptor *Descriptor(uint32_t address) {
+    return reinterpret_cast<DmacDescriptor *>(static_cast<uintptr_t>(address));
+}
+
+/**
+    Return whether the chain that starts at \a first ends; a chain that
+    loops, or runs past HOST_DMA_MAX_BLOCKS, is treated as circular.
+**/
+bool ChainEnds(DmacDescriptor *first) {
+    DmacDescriptor *desc = first;
+    for (uint32_t blocks = 0; blocks < HOST_DMA_MAX_BLOCKS; blocks++) {
+        if (!desc->DESCADDR.reg) {
+            return true;
+        }
+        desc = Descriptor(desc->DESCADDR.reg);
+        if (desc == first) {
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+    Copy one block. Incrementing addresses in a descriptor are end
+    addresses, as on the target.
+**/
+void RunBlock(DmacDescriptor *desc, bool adcSource) {
+    uint32_t btctrl = desc->BTCTRL.reg;
+    uint32_t beatSize = 1U << ((btctrl & DMAC_BTCTRL_BEATSIZE_Msk) >>
+                               DMAC_BTCTRL_BEATSIZE_Pos);
+    uint32_t count = desc->BTCNT.reg;
+    uintptr_t src = desc->SRCADDR.reg;
+    uintptr_t dst = desc->DSTADDR.reg;
+    if (btctrl & DMAC_BTCTRL_SRCINC) {
+        src -= count * beatSize;
+    }
+    if (btctrl & DMAC_BTCTRL_DSTINC) {
+        dst -= count * beatSize;
+    }
+    for (uint32_t beat = 0; beat < count; beat++) {
+        if (adcSource) {
+            ADC1->RESULT.reg =
+                adcResults[beat % (sizeof(adcResults) / sizeof(adcResults[0]))];
+        }
+        memcpy(reinterpret_cast<void *>(dst),
+               const_cast<const void *>(reinterpret_cast<volatile void *>(src)),
+               beatSize);
+        if (btctrl & DMAC_BTCTRL_SRCINC) {
+            src += beatSize;
+        }
+        if (btctrl & DMAC_BTCTRL_DSTINC) {
+            dst += beatSize;
+        }
+    }
+}
+
+} // anonymous namespace
+
+void HostDmaEnable(volatile void *chctrla) {
+    uint32_t channel = (reinterpret_cast<volatile uint8_t *>(chctrla) -
+                        reinterpret_cast<volatile uint8_t *>(DMAC->Channel)) /
+                       sizeof(DmacChannel);
+    volatile DmacChannel &ch = DMAC->Channel[channel];
+    DmacDescriptor *desc = Descriptor(DMAC->BASEADDR.reg) + channel;
+    if (!ChainEnds(desc)) {
+        return;
+    }
+    uint32_t trigger = (ch.CHCTRLA.reg & DMAC_CHCTRLA_TRIGSRC_Msk) >>
+                       DMAC_CHCTRLA_TRIGSRC_Pos;
+    bool adcSource = trigger == ADC1_DMAC_ID_RESRDY;
+    bool interrupt = false;
+    while (desc) {
+        if (!(desc->BTCTRL.reg & DMAC_BTCTRL_VALID)) {
+            // The target stops with a transfer error
+            ch.CHINTFLAG.bit.TERR = 1;
+            interrupt = interrupt || ch.CHINTENSET.bit.TERR;
+            break;
+        }
+        RunBlock(desc, adcSource);
+        if ((desc->BTCTRL.reg & DMAC_BTCTRL_BLOCKACT_Msk) ==
+                DMAC_BTCTRL_BLOCKACT_INT) {
+            ch.CHINTFLAG.bit.TCMPL = 1;
+            interrupt = interrupt || ch.CHINTENSET.bit.TCMPL;
+        }
+        desc = desc->DESCADDR.reg ? Descriptor(desc->DESCADDR.reg) : nullptr;
+    }
+    ch.CHCTRLA.reg.m_reg &= ~DMAC_CHCTRLA_ENABLE;
+    if (interrupt) {
+        NVIC_SetPendingIRQ(ChannelIrq(channel));
+    }
+}
+
+namespace ClearCoreHost {
+
+void AdcResult(uint32_t index, uint16_t raw) {
+    if (index < sizeof(adcResults) / sizeof(adcResults[0])) {
+        adcResults[index] = raw;
+    }
+}
+
+} // ClearCoreHost namespace
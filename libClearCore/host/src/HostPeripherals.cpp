@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file HostPeripherals.cpp
+    \brief Storage and reset state of the modelled SAME53 peripherals.
+**/
+
+#include <sam.h>
+
+Adc HostAdc1;
+Ccl HostCcl;
+Cmcc HostCmcc;
+Dac HostDac;
+Dmac HostDmac;
+Eic HostEic;
+Evsys HostEvsys;
+Gclk HostGclk;
+Gmac HostGmac;
+Mclk HostMclk;
+Nvmctrl HostNvmctrl;
+Pdec HostPdec;
+Port HostPort;
+Sercom HostSercom[SERCOM_INST_NUM];
+Supc HostSupc;
+Tc HostTc[TC_INST_NUM];
+Tcc HostTcc[TCC_INST_NUM];
+
+namespace {
+
+/**
+    Set the status bits that the library polls for. Nothing in the model
+    ever clears them, so every ready/complete wait finishes at once. Run
+    ahead of the library's static constructors, which touch the NVM.
+**/
+__attribute__((constructor(101))) void HostPeripheralsReset() {
+    NVMCTRL->STATUS.bit.READY = 1;
+    DAC->STATUS.vec.READY = 3;
+    GMAC->NSR.reg = GMAC_NSR_IDLE;
+    for (uint8_t i = 0; i < SERCOM_INST_NUM; i++) {
+        HostSercom[i].SPI.INTFLAG.reg = SERCOM_SPI_INTFLAG_DRE |
+                                         SERCOM_SPI_INTFLAG_TXC |
+                                         SERCOM_SPI_INTFLAG_RXC;
+    }
+}
+
+} // anonymous namespace
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file HostStartup.cpp
+    \brief Host stand-ins for the startup code, clock setup and C library
+    extensions that the target build gets from its toolchain and device pack.
+**/
+
+#include <malloc.h>
+#include <sam.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "HostSim.h"
+#include "SysManager.h"
+#include "SysTiming.h"
+#include "SysUtils.h"
+
+uint32_t HostRam[HSRAM_SIZE / sizeof(uint32_t)];
+uint32_t HostNvmUserPage[NVMCTRL_PAGE_SIZE / sizeof(uint32_t)];
+
+extern "C" {
+
+uint32_t SystemCoreClock = CPU_CLK;
+
+// The host has no clock tree; the peripherals run on virtual time
+void SystemInit(void) {}
+
+// Generators are never switched to XOSC1 on the host, so, as on the target
+// in that case, there is nothing to adjust
+void GClkFreqUpdate(uint8_t gclkIndex, uint32_t freqReq) {
+    (void)gclkIndex;
+    (void)freqReq;
+}
+
+// glibc runs the static constructors itself
+void __libc_init_array(void) {}
+
+char *_sbrk(int incr) {
+    return static_cast<char *>(sbrk(incr));
+}
+
+char *utoa(unsigned value, char *str, int base) {
+    char digits[33];
+    int count = 0;
+    do {
+        unsigned digit = value % base;
+        digits[count++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+    } while (value);
+    for (int i = 0; i < count; i++) {
+        str[i] = digits[count - 1 - i];
+    }
+    str[count] = '\0';
+    return str;
+}
+
+char *itoa(int value, char *str, int base) {
+    // Like newlib, only base 10 shows a sign
+    if (base == 10 && value < 0) {
+        str[0] = '-';
+        utoa(0U - static_cast<unsigned>(value), str + 1, base);
+        return str;
+    }
+    return utoa(static_cast<unsigned>(value), str, base);
+}
+
+} // extern "C"
+
+namespace ClearCore {
+extern SysManager SysMgr;
+}
+
+namespace {
+
+/**
+    The library stores addresses in 32-bit registers and variables, so keep
+    the heap in the low brk arena (the build links without PIE) rather than
+    in mmap regions that land above 4 GB.
+**/
+__attribute__((constructor(101))) void HostHeapSetup() {
+    mallopt(M_MMAP_MAX, 0);
+}
+
+} // anonymous namespace
+
+namespace ClearCoreHost {
+
+void Boot() {
+    ClearCore::SysMgr.Initialize();
+}
+
+} // ClearCoreHost namespace
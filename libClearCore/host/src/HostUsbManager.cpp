@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file HostUsbManager.cpp
+    \brief Host replacement for UsbManager.cpp.
+
+    The USB serial port is a terminal that is always attached: characters
+    sent to it go straight to standard output, and characters queued with
+    ClearCoreHost::UsbInput() arrive in the receive buffer on the next
+    Refresh(), which the sample interrupt calls.
+**/
+
+#include "UsbManager.h"
+#include <stdio.h>
+#include <string.h>
+#include "HostSim.h"
+#include "SysSingleton.h"
+#include "SysTiming.h"
+#include "SysUtils.h"
+
+namespace {
+
+// Characters queued by the test that have not reached the receive buffer
+char hostInput[1024];
+uint32_t hostInputHead, hostInputTail;
+
+} // anonymous namespace
+
+namespace ClearCore {
+
+SINGLETON_DEFINE(UsbManager, UsbMgr)
+
+UsbManager::UsbManager() :
+    m_inHead(0),
+    m_inTail(0),
+    m_outHead(0),
+    m_outTail(0),
+    m_sendActive(false),
+    m_readActive(false),
+    m_readBufPtr(m_usbReadBuf),
+    m_readBufAvail(0),
+    m_portOpen(false) {
+    m_lineState.value = 0;
+}
+
+bool UsbManager::Initialize() {
+    m_lineState.rs232.DTR = 1;
+    return true;
+}
+
+bool UsbManager::Speed(uint32_t bitsPerSecond) {
+    (void)bitsPerSecond;
+    return true;
+}
+
+uint32_t UsbManager::Speed() {
+    return 115200;
+}
+
+bool UsbManager::PortIsOpen() {
+    return m_portOpen;
+}
+
+void UsbManager::PortOpen() {
+    m_portOpen = true;
+}
+
+void UsbManager::PortClose() {
+    fflush(stdout);
+    m_portOpen = false;
+    m_inHead = 0;
+    m_inTail = 0;
+}
+
+void UsbManager::FlushInput() {
+    m_inHead = 0;
+    m_inTail = 0;
+}
+
+void UsbManager::WaitForWriteFinish() {
+    fflush(stdout);
+}
+
+bool UsbManager::Connected() {
+    return true;
+}
+
+UsbManager::operator bool() {
+    return Connected();
+}
+
+int16_t UsbManager::CharGet() {
+    uint32_t head = m_inHead;
+    if (m_inTail == head) {
+        return -1;
+    }
+    uint8_t retVal = m_bufferIn[head];
+    m_inHead = (head + 1) & (sizeof(m_bufferIn) - 1);
+    RxCopyToRingBuf();
+    return retVal;
+}
+
+int16_t UsbManager::CharPeek() {
+    if (m_inTail == m_inHead) {
+        return -1;
+    }
+    return m_bufferIn[m_inHead];
+}
+
+bool UsbManager::SendChar(uint8_t charToSend) {
+    if (!m_portOpen) {
+        return false;
+    }
+    putchar(charToSend);
+    return true;
+}
+
+int32_t UsbManager::AvailableForRead() {
+    int32_t difference = m_inTail - m_inHead;
+
+    if (difference < 0) {
+        return sizeof(m_bufferIn) + difference;
+    }
+    else {
+        return difference;
+    }
+}
+
+int32_t UsbManager::AvailableForWrite() {
+    // Output is never held back
+    return sizeof(m_bufferOut) - 1;
+}
+
+void UsbManager::Refresh(void) {
+    RxCopyToRingBuf();
+}
+
+void UsbManager::RxCopyToRingBuf() {
+    __disable_irq();
+    while (m_portOpen && hostInputHead != hostInputTail &&
+            AvailableForRead() < static_cast<int32_t>(sizeof(m_bufferIn) - 1)) {
+        m_bufferIn[m_inTail] = hostInput[hostInputHead];
+        m_inTail = (m_inTail + 1) & (sizeof(m_bufferIn) - 1);
+        hostInputHead = (hostInputHead + 1) % sizeof(hostInput);
+    }
+    __enable_irq();
+}
+
+} // ClearCore namespace
+
+namespace ClearCoreHost {
+
+void UsbInput(const char *text) {
+    for (; *text; text++) {
+        uint32_t next = (hostInputTail + 1) % sizeof(hostInput);
+        if (next == hostInputHead) {
+            break;
+        }
+        hostInput[hostInputTail] = *text;
+        hostInputTail = next;
+    }
+}
+
+} // ClearCoreHost namespace
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+    \file BiquadTest.cpp
+    \brief Compares Biquad16 with an unquantized double-precision
+    Butterworth filter, and checks the filter selection through AdcManager.
+**/
+
+#include <math.h>
+#include "ClearCore.h"
+#include "DigitalFilters.h"
+#include "HostSim.h"
+#include "HostTest.h"
+
+using ClearCore::Biquad16;
+
+namespace {
+
+// The Butterworth cascade with exact coefficients and states
+class ReferenceBiquad {
+public:
+    ReferenceBiquad(double cutoffHz, uint8_t order) : m_sections(order / 2) {
+        static const double q2[1] = {0.7071067811865476};
+        static const double q4[2] = {0.5411961001461971, 1.3065629648763766};
+        const double *q = (order == 2) ? q2 : q4;
+        double w0 = 2 * M_PI * cutoffHz / SampleRateHz;
+        for (uint8_t i = 0; i < m_sections; i++) {
+            double alpha = sin(w0) / (2 * q[i]);
+            double a0 = 1 + alpha;
+            Section &s = m_section[i];
+            s.b0 = s.b2 = (1 - cos(w0)) / 2 / a0;
+            s.b1 = (1 - cos(w0)) / a0;
+            s.a1 = -2 * cos(w0) / a0;
+            s.a2 = (1 - alpha) / a0;
+            s.x1 = s.x2 = s.y1 = s.y2 = 0;
+        }
+    }
+
+    double Update(double x) {
+        for (uint8_t i = 0; i < m_sections; i++) {
+            Section &s = m_section[i];
+            double y = s.b0 * x + s.b1 * s.x1 + s.b2 * s.x2 -
+                       s.a1 * s.y1 - s.a2 * s.y2;
+            s.x2 = s.x1;
+            s.x1 = x;
+            s.y2 = s.y1;
+            s.y1 = y;
+            x = y;
+        }
+        return x;
+    }
+
+private:
+    struct Section {
+        double b0, b1, b2, a1, a2;
+        double x1, x2, y1, y2;
+    };
+    uint8_t m_sections;
+    Section m_section[2];
+};
+
+// Largest output difference over steps with noise on them. The levels keep
+// the overshoot of both orders clear of the output clamp.
+double MaxError(float cutoffHz, uint8_t order) {
+    Biquad16 filter;
+    if (!filter.Butterworth(cutoffHz, order)) {
+        return INFINITY;
+    }
+    ReferenceBiquad reference(cutoffHz, order);
+    uint32_t samples = 80 * SampleRateHz / cutoffHz + 20000;
+    uint32_t seed = 1;
+    double maxError = 0;
+    for (uint32_t i = 0; i < samples; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint16_t input = ((4 * i / samples) % 2 ? 24000 : 4000) +
+                         (seed >> 16) % 200;
+        filter.Update(input);
+        double error = fabs(filter.LastOutput() - reference.Update(input));
+        maxError = (error > maxError) ? error : maxError;
+    }
+    return maxError;
+}
+
+} // anonymous namespace
+
+int main() {
+    // Within rounding of the exact filter, except near the lowest cutoff
+    // where coefficient quantization moves the poles slightly
+    const float cutoffs[] = {5, 20, 100, 500, 1000, 2400};
+    for (float cutoff : cutoffs) {
+        CHECK_NEAR(MaxError(cutoff, 2), 0, 0.6);
+        CHECK_NEAR(MaxError(cutoff, 4), 0, 0.6);
+    }
+    CHECK_NEAR(MaxError(2, 2), 0, 1.5);
+    CHECK_NEAR(MaxError(2, 4), 0, 1.5);
+    CHECK_NEAR(MaxError(BIQUAD_CUTOFF_MIN_HZ, 2), 0, 1.5);
+    CHECK_NEAR(MaxError(BIQUAD_CUTOFF_MIN_HZ, 4), 0, 5);
+
+    // Out of range designs are rejected
+    Biquad16 filter;
+    CHECK(!filter.Butterworth(0.99f, 2));
+    CHECK(!filter.Butterworth(0, 4));
+    CHECK(!filter.Butterworth(SampleRateHz / 2, 2));
+    CHECK(!filter.Butterworth(100, 3));
+
+    // The lowest cutoff settles exactly on a constant input
+    CHECK(filter.Butterworth(BIQUAD_CUTOFF_MIN_HZ, 4));
+    for (uint32_t i = 0; i < 20 * SampleRateHz; i++) {
+        filter.Update(12345);
+    }
+    CHECK(filter.LastOutput() == 12345);
+
+    // Selection through AdcManager and the connector
+    ClearCoreHost::Boot();
+    ClearCoreHost::AdcResult(ClearCore::AdcManager::ADC_AIN10, 1000);
+    ClearCoreHost::Run(1000);
+    CHECK(!ClearCore::AdcMgr.FilterBiquad(ClearCore::AdcManager::ADC_AIN10,
+                                          0.5f, 2));
+    CHECK(ClearCore::AdcMgr.FilterType(ClearCore::AdcManager::ADC_AIN10) ==
+          ClearCore::AdcManager::FILTER_TYPE_IIR);
+    CHECK(ConnectorA10.FilterBiquad(50, 4));
+    CHECK(ClearCore::AdcMgr.FilterType(ClearCore::AdcManager::ADC_AIN10) ==
+          ClearCore::AdcManager::FILTER_TYPE_BIQUAD);
+    ClearCoreHost::AdcResult(ClearCore::AdcManager::ADC_AIN10, 3000);
+    ClearCoreHost::Run(2000);
+    CHECK(ClearCore::AdcMgr.FilteredResult(ClearCore::AdcManager::ADC_AIN10) ==
+          ClearCore::AdcMgr.ConvertedResult(ClearCore::AdcManager::ADC_AIN10));
+    CHECK(ClearCore::AdcMgr.ConvertedResult(ClearCore::AdcManager::ADC_AIN10) >
+          0);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+    \file FixedPointTest.cpp
+    \brief Checks the FixedPoint primitives, and the call sites moved onto
+    them, against the integer arithmetic they replaced.
+**/
+
+#include "ClearCore.h"
+#include "FixedPoint.h"
+#include "IirFilter.h"
+#include "HostTest.h"
+
+using namespace ClearCore;
+
+namespace {
+
+uint32_t seed = 1;
+
+// Pseudo-random 32-bit values, weighted toward the ends of the range
+int32_t Random() {
+    seed = seed * 1103515245 + 12345;
+    uint32_t value = seed ^ (seed << 13) ^ (seed >> 7);
+    switch (value & 3) {
+        case 0:
+            return INT32_MAX - (value >> 24);
+        case 1:
+            return INT32_MIN + (value >> 24);
+        default:
+            return value;
+    }
+}
+
+int64_t Clamp(int64_t value, int64_t lo, int64_t hi) {
+    return (value < lo) ? lo : (value > hi) ? hi : value;
+}
+
+} // anonymous namespace
+
+int main() {
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < 200000; i++) {
+        int32_t a = Random();
+        int32_t b = Random();
+        int16_t a16 = a;
+        int16_t b16 = b >> 16;
+        int64_t wide = (static_cast<int64_t>(a) << 20) + b;
+
+        mismatches += SatAdd(a, b) !=
+                      Clamp(static_cast<int64_t>(a) + b, INT32_MIN, INT32_MAX);
+        mismatches += SatSub(a, b) !=
+                      Clamp(static_cast<int64_t>(a) - b, INT32_MIN, INT32_MAX);
+        mismatches += Sat<16>(a) != Clamp(a, INT16_MIN, INT16_MAX);
+        mismatches += Sat<12>(a) != Clamp(a, -2048, 2047);
+        mismatches += Sat32(wide) != Clamp(wide, INT32_MIN, INT32_MAX);
+        // USat<15> is the Biquad16 output clamp
+        mismatches += static_cast<int32_t>(USat<15>(a)) !=
+                      ((a < 0) ? 0 : (a > INT16_MAX) ? INT16_MAX : a);
+        mismatches += USat<12>(a) != Clamp(a, 0, 4095);
+        // The Iir16 update multiplies the state by a Q15 time constant
+        uint16_t tc = b & INT16_MAX;
+        mismatches += MulQ<15>(a, tc) !=
+                      ((static_cast<int64_t>(a) * tc) >> 15);
+
+        Q15 qa = Q15::FromRaw(a16);
+        Q15 qb = Q15::FromRaw(b16);
+        mismatches += (qa + qb).Raw() != Clamp(a16 + b16, INT16_MIN, INT16_MAX);
+        mismatches += (qa - qb).Raw() != Clamp(a16 - b16, INT16_MIN, INT16_MAX);
+        mismatches += (-qa).Raw() != Clamp(-a16, INT16_MIN, INT16_MAX);
+        mismatches += (qa * qb).Raw() !=
+                      Clamp((a16 * b16) >> 15, INT16_MIN, INT16_MAX);
+        mismatches += (qa < qb) != (a16 < b16);
+
+        Q16_15 va = Q16_15::FromRaw(a);
+        Q16_15 vb = Q16_15::FromRaw(b);
+        mismatches += (va + vb).Raw() != SatAdd(a, b);
+        mismatches += (va * qb).Raw() !=
+                      Clamp((static_cast<int64_t>(a) * b16) >> 15,
+                            INT32_MIN, INT32_MAX);
+        mismatches += (va * vb).Raw() !=
+                      Clamp((static_cast<int64_t>(a) * b) >> 15,
+                            INT32_MIN, INT32_MAX);
+        mismatches += va.Convert<15, int16_t>().Raw() !=
+                      Clamp(a, INT16_MIN, INT16_MAX);
+        mismatches += va.Convert<16, int32_t>().Raw() !=
+                      Clamp(static_cast<int64_t>(a) * 2, INT32_MIN, INT32_MAX);
+        mismatches += qa.Convert<15, int32_t>().Raw() != a16;
+
+        // The StepGenerator position conversions
+        Q48_15 posn = Q48_15::FromRaw(wide);
+        mismatches += posn.ToInt() != (wide >> 15);
+        mismatches += posn.Frac().Raw() !=
+                      static_cast<int64_t>(wide & ~(UINT64_MAX << 15));
+        mismatches += posn.ToIntRounded() != ((wide + (1 << 14)) >> 15);
+        mismatches += Q48_15::FromInt(a).Raw() !=
+                      (static_cast<int64_t>(a) << 15);
+        mismatches += Q48_15::FromInt(static_cast<uint32_t>(b)).Raw() !=
+                      (static_cast<int64_t>(static_cast<uint32_t>(b)) << 15);
+        mismatches += (posn + posn).Raw() != wide * 2;
+    }
+    CHECK(mismatches == 0);
+
+    // Saturation at the ends of the 64-bit format
+    Q48_15 big = Q48_15::FromRaw(INT64_MAX - 1);
+    CHECK((big + big).Raw() == INT64_MAX);
+    CHECK((-big - big).Raw() == INT64_MIN);
+
+    // Float construction rounds to nearest and saturates
+    CHECK(Q15::FromFloat(0.5f).Raw() == 16384);
+    CHECK(Q15::FromFloat(-0.25f).Raw() == -8192);
+    CHECK(Q15::FromFloat(1.0f).Raw() == INT16_MAX);
+    CHECK(Q15::FromFloat(-2.0f).Raw() == INT16_MIN);
+    CHECK(Q15::FromFloat(1.4f / 32768).Raw() == 1);
+    CHECK(Q15::FromFloat(-1.6f / 32768).Raw() == -2);
+    CHECK(Q15_16::FromFloat(0.05f).Raw() == 3277);
+    CHECK(Q16_15::FromInt(INT32_MAX).Raw() == INT32_MAX);
+    CHECK(Q16_15::FromInt(-70000).Raw() == INT32_MIN);
+    CHECK_NEAR(Q16_15::FromRaw(-49152).ToFloat(), -1.5, 0);
+    CHECK(Q16_15::FromRaw(-49152).ToInt() == -2);
+    CHECK(Q16_15::FromRaw(-49152).ToIntRounded() == -1);
+
+    // AdcManager's Q15 normalization, for each resolution the ADC supports
+    uint32_t adcMismatches = 0;
+    const uint8_t resolutions[] = {8, 10, 12, 16};
+    for (uint8_t bits : resolutions) {
+        for (uint32_t result = 0; result < (1UL << bits); result++) {
+            uint16_t fullScale = result << (16 - bits);
+            adcMismatches +=
+                Q15::FromUnsigned(result, bits).Raw() != (fullScale >> 1);
+        }
+    }
+    CHECK(adcMismatches == 0);
+
+    // Iir16 and Iir16Bank::UpdateScalar against the original state update
+    Iir16 iir;
+    Iir16Bank<2> bank;
+    uint32_t iirMismatches = 0;
+    for (uint32_t run = 0; run < 50; run++) {
+        uint16_t tc = static_cast<uint32_t>(Random()) % 32768;
+        uint16_t start = Random();
+        iir.Tc(tc);
+        iir.Reset(start);
+        bank.Tc(1, tc);
+        bank.Reset(1, start);
+        int32_t z = start << 16;
+        for (uint32_t i = 0; i < 2000; i++) {
+            uint16_t input = (i % 400 < 200) ? Random() : start;
+            z = ((static_cast<int64_t>(z) * tc) >> 15) -
+                ((static_cast<int32_t>(input) * tc) << 1) +
+                (static_cast<int32_t>(input) << 16);
+            iir.Update(input);
+            bank.UpdateScalar(1, input);
+            uint16_t output = z >> 16;
+            iirMismatches += iir.LastOutput() != output ||
+                             bank.LastOutput(1) != output;
+        }
+    }
+    CHECK(iirMismatches == 0);
+
+    return TEST_RESULT();
+}
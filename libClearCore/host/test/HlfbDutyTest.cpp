@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+    \file HlfbDutyTest.cpp
+    \brief Feeds HLFB PWM captures through MotorDriver::Refresh() and checks
+    the duty against exact and original results.
+
+    The exact duty is computed in double precision from the integer capture
+    counts. The library's result must round to within one float ULP of it.
+    The original code rounded width / period to a float before removing the
+    5% offset, which made its own result up to about 1e-5% away from exact.
+    So it is compared with a tolerance of 2e-5%.
+**/
+
+#include <float.h>
+#include <math.h>
+#include "ClearCore.h"
+#include "HostSim.h"
+#include "HostTest.h"
+
+namespace {
+
+// ConnectorM0 captures HLFB on TC4
+TcCount16 *const hlfbTc = &TC4->COUNT16;
+
+float CaptureDuty(uint16_t width, uint16_t period) {
+    hlfbTc->CC[0].reg = period;
+    hlfbTc->CC[1].reg = width;
+    // The history keeps one capture back, and the first capture after
+    // an error is discarded
+    for (uint8_t i = 0; i < 4; i++) {
+        hlfbTc->INTFLAG.reg = TC_INTFLAG_MC0 | TC_INTFLAG_MC1;
+        ClearCoreHost::Run(1);
+    }
+    return ConnectorM0.HlfbPercent();
+}
+
+double ExactDuty(uint16_t width, uint16_t period) {
+    return (20.0 * width - period) * 50.0 / (9.0 * period);
+}
+
+float OldDuty(uint16_t width, uint16_t period) {
+    float dutyCycle = static_cast<float>(width) / static_cast<float>(period);
+    return (dutyCycle - 0.05) * (10000. / 90.);
+}
+
+} // anonymous namespace
+
+int main() {
+    ClearCoreHost::Boot();
+    ConnectorM0.HlfbMode(MotorDriver::HLFB_MODE_HAS_PWM);
+
+    uint32_t notExact = 0;
+    uint32_t notOld = 0;
+    uint32_t seed = 1;
+    for (uint32_t sample = 0; sample < 2000; sample++) {
+        seed = seed * 1103515245 + 12345;
+        uint16_t period = (seed >> 16) | 1;
+        uint16_t width = (seed & UINT16_MAX) % (period + 1);
+        float duty = CaptureDuty(width, period);
+        double exact = ExactDuty(width, period);
+        if (fabs(duty - exact) > fabs(exact) * FLT_EPSILON) {
+            notExact++;
+        }
+        if (fabs(duty - OldDuty(width, period)) > 2e-5) {
+            notOld++;
+        }
+    }
+    CHECK(notExact == 0);
+    CHECK(notOld == 0);
+
+    // The ends of the 5-95% range, and a zero duty that is exactly zero
+    CHECK(CaptureDuty(500, 10000) == 0.0f);
+    CHECK(CaptureDuty(9500, 10000) == 100.0f);
+    CHECK(CaptureDuty(5000, 10000) == 50.0f);
+    CHECK_NEAR(CaptureDuty(0, 65535), -50.0 / 9.0, 1e-5);
+
+    ConnectorM0.HlfbMode(MotorDriver::HLFB_MODE_HAS_BIPOLAR_PWM);
+    CHECK(CaptureDuty(500, 10000) == -100.0f);
+    CHECK(CaptureDuty(5000, 10000) == 0.0f);
+    CHECK(CaptureDuty(7250, 10000) == 50.0f);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file HostTest.h
+    \brief Minimal checking macros for the host test programs.
+**/
+
+#ifndef __HOSTTEST_H__
+#define __HOSTTEST_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int hostTestFailures = 0;
+
+/** Record a failure, with its location, if \a cond is false. **/
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);  \
+            hostTestFailures++;                                               \
+        }                                                                     \
+    } while (0)
+
+/** Check that \a a and \a b differ by at most \a tol. **/
+#define CHECK_NEAR(a, b, tol)                                                 \
+    do {                                                                      \
+        double hostTestA = (a), hostTestB = (b);                              \
+        double hostTestDiff = hostTestA - hostTestB;                          \
+        if (hostTestDiff > (tol) || -hostTestDiff > (tol)) {                  \
+            printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g\n",            \
+                   __FILE__, __LINE__, #a, #b, hostTestA, hostTestB);         \
+            hostTestFailures++;                                               \
+        }                                                                     \
+    } while (0)
+
+/** Print the result line and return the exit status for main(). **/
+#define TEST_RESULT()                                                         \
+    (printf(hostTestFailures ? "FAILED (%d)\n" : "PASSED\n",                 \
+            hostTestFailures), hostTestFailures ? EXIT_FAILURE : EXIT_SUCCESS)
+
+#endif // __HOSTTEST_H__
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file SchedulerTest.cpp
+    \brief Boots the library on the host model and checks that the sample
+    interrupt and SysTick run on virtual time.
+**/
+
+#include "ClearCore.h"
+#include "HostSim.h"
+#include "HostTest.h"
+
+int main() {
+    ClearCoreHost::Boot();
+
+    // SysMgr.Initialize() waits about 10 ms for the board to settle
+    CHECK(ClearCoreHost::Cycles() >= 10000ULL * CYCLES_PER_MICROSECOND);
+    CHECK(TCC0->CTRLA.bit.ENABLE);
+    CHECK(NVIC_GetPriority(TCC0_0_IRQn) == 3);
+
+    uint32_t samples = ClearCoreHost::IrqCount(TCC0_0_IRQn);
+    uint32_t ticks = ClearCoreHost::IrqCount(SysTick_IRQn);
+    uint32_t ms = Milliseconds();
+    uint32_t us = Microseconds();
+
+    ClearCoreHost::Run(5000);
+
+    // One second: 5000 sample interrupts, 1000 SysTicks
+    CHECK(ClearCoreHost::IrqCount(TCC0_0_IRQn) - samples == 5000);
+    CHECK(ClearCoreHost::IrqCount(SysTick_IRQn) - ticks == 1000);
+    CHECK(Milliseconds() - ms == 1000);
+    CHECK_NEAR(Microseconds() - us, 1000000, 10);
+
+    // Delay_ms() polls the cycle counter, so the interrupts keep running
+    samples = ClearCoreHost::IrqCount(TCC0_0_IRQn);
+    Delay_ms(10);
+    CHECK(ClearCoreHost::IrqCount(TCC0_0_IRQn) - samples >= 49);
+
+    // Masked interrupts wait, and coalesce, until PRIMASK clears
+    samples = ClearCoreHost::IrqCount(TCC0_0_IRQn);
+    __disable_irq();
+    ClearCoreHost::Run(10);
+    CHECK(ClearCoreHost::IrqCount(TCC0_0_IRQn) == samples);
+    __enable_irq();
+    CHECK(ClearCoreHost::IrqCount(TCC0_0_IRQn) == samples + 1);
+
+    // Digital inputs are active low on the pins
+    ConnectorDI6.Mode(Connector::INPUT_DIGITAL);
+    ClearCoreHost::Run(10);
+    CHECK(ConnectorDI6.State());
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+    \file StepGeneratorTest.cpp
+    \brief Runs StepGenerator move profiles and the analog jog mapping
+    against their fixed-point reference results.
+
+    The move profiles are reduced to a hash of every sample's step count,
+    direction and commanded velocity. The expected hashes were recorded from
+    the shift-based FRACT_BITS code before it moved to FixedPoint, so any
+    change in rounding or saturation shows up here. The jog mapping is
+    checked against the original formulas directly.
+**/
+
+#include "ClearCore.h"
+#include "HostSim.h"
+#include "HostTest.h"
+
+namespace ClearCore {
+
+// The StepGenerator's test hook; it is a friend of the class
+class TestIO {
+public:
+    static void MaxSteps(StepGenerator &gen, uint32_t steps) {
+        gen.StepsPerSampleMaxSet(steps);
+    }
+    static void Sample(StepGenerator &gen) {
+        gen.StepsCalculated();
+    }
+    static uint32_t Steps(StepGenerator &gen) {
+        return gen.StepsPrevious();
+    }
+    static bool Idle(StepGenerator &gen) {
+        return gen.m_moveState == StepGenerator::MS_IDLE;
+    }
+    static int32_t JogTarget(StepGenerator &gen, uint16_t center,
+                             uint16_t deadband,
+                             StepGenerator::JogCurves curve,
+                             int32_t velMaxQx, bool &negative) {
+        gen.m_jogCenter = center;
+        gen.m_jogDeadband = deadband;
+        gen.m_jogCurve = curve;
+        gen.m_jogVelMaxQx = velMaxQx;
+        return gen.JogAnalogTarget(negative);
+    }
+};
+
+} // ClearCore namespace
+
+using ClearCore::StepGenerator;
+using ClearCore::TestIO;
+
+namespace {
+
+class TestGenerator : public StepGenerator {
+    void OutputDirection() override {}
+};
+
+struct Profile {
+    uint32_t hash;
+    uint32_t samples;
+};
+
+// FNV-1a over the per-sample outputs
+void HashWord(uint32_t &hash, uint32_t word) {
+    for (uint8_t i = 0; i < 4; i++) {
+        hash = (hash ^ ((word >> (8 * i)) & 0xff)) * 16777619U;
+    }
+}
+
+void RecordSamples(TestGenerator &gen, Profile &profile, uint32_t count) {
+    for (uint32_t i = 0; i < count && !TestIO::Idle(gen); i++) {
+        TestIO::Sample(gen);
+        HashWord(profile.hash, TestIO::Steps(gen));
+        HashWord(profile.hash, gen.PositionRefCommanded());
+        HashWord(profile.hash, gen.VelocityRefCommanded());
+        profile.samples++;
+    }
+}
+
+Profile PositionalMove(int32_t dist, uint32_t vel, uint32_t accel) {
+    TestGenerator gen;
+    TestIO::MaxSteps(gen, 100);
+    gen.VelMax(vel);
+    gen.AccelMax(accel);
+    Profile profile = {2166136261U, 0};
+    gen.Move(dist);
+    RecordSamples(gen, profile, 1000000);
+    CHECK(gen.PositionRefCommanded() == dist);
+    return profile;
+}
+
+Profile VelocityMoves() {
+    TestGenerator gen;
+    TestIO::MaxSteps(gen, 100);
+    gen.VelMax(20000);
+    gen.AccelMax(200000);
+    Profile profile = {2166136261U, 0};
+    gen.MoveVelocity(30000);
+    RecordSamples(gen, profile, 2000);
+    // Reverse through zero, stop, then make a positional move from rest
+    gen.MoveVelocity(-12345);
+    RecordSamples(gen, profile, 3000);
+    gen.MoveStopDecel(1000000);
+    RecordSamples(gen, profile, 1000000);
+    CHECK(TestIO::Idle(gen));
+    gen.Move(4321);
+    RecordSamples(gen, profile, 1000000);
+    CHECK(TestIO::Idle(gen));
+    gen.MoveVelocity(777);
+    RecordSamples(gen, profile, 500);
+    gen.MoveStopDecel(0);
+    RecordSamples(gen, profile, 1000000);
+    CHECK(TestIO::Idle(gen));
+    return profile;
+}
+
+// The jog mapping as it was written before the FixedPoint migration
+int32_t OldJogTarget(int32_t filtered, int32_t center, int32_t deadband,
+                     StepGenerator::JogCurves curve, int32_t velMaxQx) {
+    int32_t deflection = filtered - center;
+    bool negative = deflection < 0;
+    int32_t span = (negative ? center : INT16_MAX - center) - deadband;
+    int32_t magnitude = abs(deflection) - deadband;
+    if (magnitude <= 0 || span <= 0) {
+        return 0;
+    }
+    int32_t fract = (magnitude << 15) / span;
+    fract = (fract < (1 << 15)) ? fract : (1 << 15);
+    if (curve == StepGenerator::JOG_CURVE_SQUARE) {
+        fract = (fract * fract) >> 15;
+    }
+    else if (curve == StepGenerator::JOG_CURVE_CUBE) {
+        fract = (((fract * fract) >> 15) * fract) >> 15;
+    }
+    return (static_cast<int64_t>(fract) * velMaxQx) >> 15;
+}
+
+} // anonymous namespace
+
+int main() {
+    // Positional moves: trapezoids, triangles, and the step rate limit
+    const struct {
+        int32_t dist;
+        uint32_t vel;
+        uint32_t accel;
+        uint32_t hash;
+        uint32_t samples;
+    } moves[] = {
+        {10000, 5000, 100000, 0x1e21c2a2, 10253},
+        {-10000, 5000, 100000, 0xe64887be, 10253},
+        {300, 50000, 20000, 0xa3cde42c, 1226},
+        {123457, 400000, 1000000, 0x100f3108, 3515},
+        {1, 1, 2, 0xffc4c0e5, 5465},
+        {-98765, 77777, 33333, 0x30c9d8af, 17546},
+        {200000, 900000, 5000000, 0x625d00fc, 2502},
+    };
+    for (const auto &move : moves) {
+        Profile profile = PositionalMove(move.dist, move.vel, move.accel);
+        printf("move %ld: hash 0x%08x, %u samples\n", (long)move.dist,
+               profile.hash, profile.samples);
+        CHECK(profile.hash == move.hash);
+        CHECK(profile.samples == move.samples);
+    }
+
+    Profile velocity = VelocityMoves();
+    printf("velocity moves: hash 0x%08x, %u samples\n", velocity.hash,
+           velocity.samples);
+    CHECK(velocity.hash == 0xb660f6be);
+    CHECK(velocity.samples == 7151);
+
+    // The jog target reads the filtered ADC value, so settle one first
+    ClearCoreHost::Boot();
+    ClearCoreHost::AdcResult(ClearCore::AdcManager::ADC_AIN09, 1234);
+    ClearCoreHost::Run(5000);
+    int32_t filtered =
+        ClearCore::AdcMgr.FilteredResult(ClearCore::AdcManager::ADC_AIN09);
+    CHECK(filtered > 0 && filtered < INT16_MAX);
+
+    const int32_t velMaxes[] = {1, 3277, 1 << 15, 100 << 15, INT32_MAX};
+    const uint16_t deadbands[] = {0, 50, 2000};
+    const StepGenerator::JogCurves curves[] = {
+        StepGenerator::JOG_CURVE_LINEAR,
+        StepGenerator::JOG_CURVE_SQUARE,
+        StepGenerator::JOG_CURVE_CUBE,
+    };
+    TestGenerator gen;
+    uint32_t jogMismatches = 0;
+    for (int32_t center = 0; center <= INT16_MAX; center += 37) {
+        for (uint16_t deadband : deadbands) {
+            for (StepGenerator::JogCurves curve : curves) {
+                for (int32_t velMax : velMaxes) {
+                    bool negative;
+                    int32_t target = TestIO::JogTarget(gen, center, deadband,
+                                                       curve, velMax,
+                                                       negative);
+                    if (target != OldJogTarget(filtered, center, deadband,
+                                               curve, velMax) ||
+                            negative != (filtered < center)) {
+                        jogMismatches++;
+                    }
+                }
+            }
+        }
+    }
+    CHECK(jogMismatches == 0);
+
+    return TEST_RESULT();
+}
@@ -31,10 +31,16 @@
 #define __ADCMANAGER_H__
 
 #include <stdint.h>
+#include "DigitalFilters.h"
 #include "IirFilter.h"
+#include "SysSingleton.h"
 
 namespace ClearCore {
 
+typedef void (*voidFuncPtr)(void);
+
+class StepGenerator;
+
 /**
     \brief ADC Peripheral Manager for the ClearCore Board
 
@@ -81,6 +87,132 @@ public:
         FILTER_UNIT_SAMPLES,
     } FilterUnits;
 
+    /**
+        \enum AdcOversampling
+        \brief Oversampling and decimation settings for an ADC channel.
+
+        Oversampled channels are converted several times per sample time and
+        the conversions are accumulated by the ADC hardware. The 15- and
+        16-bit settings further average the hardware result in software over
+        multiple sample times, so their result updates at a lower rate.
+
+        Each extra bit of resolution requires 4 times as many conversions.
+        The effective number of bits achieved depends on the noise on the
+        input; oversampling only adds resolution when there is at least about
+        one count of random noise present.
+
+        | Setting                  | Conversions/sample | Result rate |
+        |--------------------------|--------------------|-------------|
+        | #ADC_OVERSAMPLE_NONE     | 1                  | 5 kHz       |
+        | #ADC_OVERSAMPLE_13BIT    | 4                  | 5 kHz       |
+        | #ADC_OVERSAMPLE_14BIT    | 16                 | 5 kHz       |
+        | #ADC_OVERSAMPLE_15BIT    | 16                 | 1.25 kHz    |
+        | #ADC_OVERSAMPLE_16BIT    | 16                 | 312.5 Hz    |
+    **/
+    typedef enum {
+        /** A single conversion at the configured ADC resolution. **/
+        ADC_OVERSAMPLE_NONE,
+        /** 13-bit result from 4 accumulated conversions. **/
+        ADC_OVERSAMPLE_13BIT,
+        /** 14-bit result from 16 accumulated conversions. **/
+        ADC_OVERSAMPLE_14BIT,
+        /** 15-bit result from 4 sample times of 14-bit results. **/
+        ADC_OVERSAMPLE_15BIT,
+        /** 16-bit result from 16 sample times of 14-bit results. **/
+        ADC_OVERSAMPLE_16BIT,
+        ADC_OVERSAMPLE_COUNT // Keep at end
+    } AdcOversampling;
+
+    /**
+        \enum FilterTypes
+        \brief The digital filter applied to an ADC channel's result.
+
+        | Type                         | Cost per sample        |
+        |------------------------------|------------------------|
+        | #FILTER_TYPE_IIR             | Fixed, lowest          |
+        | #FILTER_TYPE_BIQUAD          | Grows with the order   |
+        | #FILTER_TYPE_MOVING_AVERAGE  | Fixed                  |
+        | #FILTER_TYPE_MEDIAN          | Grows with the length  |
+    **/
+    typedef enum {
+        /** Single pole low-pass filter set by FilterTc(). **/
+        FILTER_TYPE_IIR,
+        /** 2nd or 4th order Butterworth low-pass filter. **/
+        FILTER_TYPE_BIQUAD,
+        /** Moving average (box car) filter. **/
+        FILTER_TYPE_MOVING_AVERAGE,
+        /** Running median filter, for rejecting impulse noise. **/
+        FILTER_TYPE_MEDIAN,
+    } FilterTypes;
+
+    /**
+        \enum CaptureTriggers
+        \brief The condition that triggers a raw waveform capture.
+
+        Level and edge triggers compare the raw conversion result of the
+        trigger channel against the trigger level.
+    **/
+    typedef enum {
+        /** Triggered only by CaptureForce(). **/
+        CAPTURE_TRIGGER_SOFTWARE,
+        /** The result rises to or above the level. **/
+        CAPTURE_TRIGGER_RISING,
+        /** The result falls below the level. **/
+        CAPTURE_TRIGGER_FALLING,
+        /** The result is at or above the level. **/
+        CAPTURE_TRIGGER_ABOVE,
+        /** The result is below the level. **/
+        CAPTURE_TRIGGER_BELOW,
+    } CaptureTriggers;
+
+    /**
+        \enum CaptureStates
+        \brief The state of a raw waveform capture.
+    **/
+    typedef enum {
+        /** No capture is in progress. **/
+        CAPTURE_IDLE,
+        /** Recording pre-trigger history and waiting for the trigger. **/
+        CAPTURE_ARMED,
+        /** Triggered; recording the post-trigger frames. **/
+        CAPTURE_TRIGGERED,
+        /** The capture buffer is complete and may be read. **/
+        CAPTURE_DONE,
+    } CaptureStates;
+
+    /**
+        \enum ComparatorStates
+        \brief Where a channel's filtered reading is relative to its
+        comparator thresholds.
+    **/
+    typedef enum {
+        /** Between the thresholds. **/
+        COMPARATOR_IN_WINDOW,
+        /** Above the upper threshold. **/
+        COMPARATOR_ABOVE,
+        /** Below the lower threshold. **/
+        COMPARATOR_BELOW,
+    } ComparatorStates;
+
+    /**
+        \brief Statistics of an ADC channel over one window.
+
+        Values are in Q15 ADC units, the same units as ConvertedResult().
+    **/
+    typedef struct {
+        /// Smallest reading in the window.
+        uint16_t Min;
+        /// Largest reading in the window.
+        uint16_t Max;
+        /// Number of readings in the window. A channel that decimates
+        /// oversampled results has one reading per decimated result.
+        uint32_t Count;
+        /// Sum of the readings.
+        uint32_t Sum;
+        /// Sum of the squares of the readings.
+        uint64_t SumSquares;
+    } AdcStats;
+
     /**
         The default resolution of the ADC, in bits.
     **/
@@ -93,6 +225,16 @@ public:
         The default ADC filter time constant, in milliseconds.
     **/
     static const uint32_t ADC_IIR_FILTER_TC_MS = 2;
+    /**
+        The longest time, in microseconds, that the ADC conversion sequence
+        is allowed to take each sample time.
+    **/
+    static const uint32_t ADC_SEQUENCE_BUDGET_US = 150;
+    /**
+        The estimated CPU cycles that the filters of all ADC channels are
+        allowed to take each sample time.
+    **/
+    static const uint32_t ADC_FILTER_BUDGET_CYCLES = 1200;
 
 #ifndef HIDE_FROM_DOXYGEN
     // Max voltage that a channel can read.
@@ -205,6 +347,83 @@ public:
         return m_AdcResultsConverted[adcChannel];
     }
 
+    /**
+        \brief Returns the unfiltered ADC result of a specific channel, scaled
+        to a full 16-bit range.
+
+        Unlike the Q15 ConvertedResult(), this keeps all of the bits of a
+        channel set to #ADC_OVERSAMPLE_16BIT.
+
+        \code{.cpp}
+        // Save the high resolution reading of analog input A-10.
+        uint16_t result = AdcMgr.FullScaleResult(AdcManager::ADC_AIN10);
+        \endcode
+
+        \param[in] adcChannel ADC channel to get the results of.
+        \return Result in the range of 0 to 65535.
+
+        \note For performance reasons, does not perform any bounds checking.
+    **/
+    volatile const uint16_t &FullScaleResult(AdcChannels adcChannel) {
+        return m_AdcResultsFullScale[adcChannel];
+    }
+
+    /**
+        \brief Configure oversampling for an ADC channel.
+
+        The change is applied at the start of the next conversion sequence.
+
+        \code{.cpp}
+        // Read A-10 with 16-bit resolution for a load cell.
+        if (!AdcMgr.Oversampling(AdcManager::ADC_AIN10,
+                                 AdcManager::ADC_OVERSAMPLE_16BIT)) {
+            // The conversions would not fit in the sample time
+        }
+        \endcode
+
+        \param[in] adcChannel ADC channel to configure.
+        \param[in] setting The oversampling setting. See #AdcOversampling.
+
+        \return False if the arguments are invalid, or if the conversion
+        sequence with this setting would take longer than
+        #ADC_SEQUENCE_BUDGET_US.
+    **/
+    bool Oversampling(AdcChannels adcChannel, AdcOversampling setting);
+
+    /**
+        \brief Returns the oversampling setting of an ADC channel.
+
+        \param[in] adcChannel ADC channel to query.
+        \return The oversampling setting, or #ADC_OVERSAMPLE_NONE if the
+        channel is invalid.
+    **/
+    AdcOversampling Oversampling(AdcChannels adcChannel);
+
+    /**
+        \brief Returns the effective resolution of an ADC channel, in bits.
+
+        This is the ADC resolution for channels that are not oversampled.
+
+        \param[in] adcChannel ADC channel to query.
+        \return Resolution in bits.
+
+        \note For performance reasons, does not perform any bounds checking.
+    **/
+    uint8_t ChannelResolution(AdcChannels adcChannel);
+
+    /**
+        \brief Returns the time the ADC conversion sequence takes each sample
+        time, in microseconds.
+
+        \code{.cpp}
+        // Check how much of the 200us sample time the ADC is busy for.
+        uint32_t adcBusyUs = AdcMgr.SequenceTimeUs();
+        \endcode
+
+        \return Time in microseconds.
+    **/
+    uint32_t SequenceTimeUs();
+
     /**
         \brief Sets the IIR filter time constant for an ADC channel.
 
@@ -223,6 +442,71 @@ public:
     **/
     bool FilterTc(AdcChannels adcChannel, uint16_t tc, FilterUnits theUnits);
 
+    /**
+        \brief Selects a Butterworth low-pass filter for an ADC channel.
+
+        \code{.cpp}
+        // Filter A-10 with a 4th order 50Hz low-pass filter
+        bool succeeded = AdcMgr.FilterBiquad(AdcManager::ADC_AIN10, 50, 4);
+        \endcode
+
+        \param[in] adcChannel ADC channel to configure
+        \param[in] cutoffHz The -3dB frequency, from 1Hz to below half the
+        sample rate. For slower filtering use FilterTc().
+        \param[in] order The filter order, 2 or 4
+        \return Success. Fails if the arguments are out of range or the
+        filters would exceed #ADC_FILTER_BUDGET_CYCLES.
+    **/
+    bool FilterBiquad(AdcChannels adcChannel, float cutoffHz, uint8_t order);
+
+    /**
+        \brief Selects a moving average filter for an ADC channel.
+
+        \code{.cpp}
+        // Average A-10 over the last 10 samples (2ms)
+        bool succeeded = AdcMgr.FilterMovingAverage(AdcManager::ADC_AIN10, 10);
+        \endcode
+
+        \param[in] adcChannel ADC channel to configure
+        \param[in] length The window length in samples, 1 to 64
+        \return Success. Fails if the arguments are out of range or the
+        filters would exceed #ADC_FILTER_BUDGET_CYCLES.
+    **/
+    bool FilterMovingAverage(AdcChannels adcChannel, uint8_t length);
+
+    /**
+        \brief Selects a running median filter for an ADC channel.
+
+        \code{.cpp}
+        // Reject single sample spikes on A-10
+        bool succeeded = AdcMgr.FilterMedian(AdcManager::ADC_AIN10, 3);
+        \endcode
+
+        \param[in] adcChannel ADC channel to configure
+        \param[in] length The window length in samples; odd, 3 to 9
+        \return Success. Fails if the arguments are out of range or the
+        filters would exceed #ADC_FILTER_BUDGET_CYCLES.
+    **/
+    bool FilterMedian(AdcChannels adcChannel, uint8_t length);
+
+    /**
+        \brief Gets the filter type of an ADC channel.
+
+        \code{.cpp}
+        if (AdcMgr.FilterType(AdcManager::ADC_AIN10) ==
+                AdcManager::FILTER_TYPE_MEDIAN) {
+            // A-10 is median filtered
+        }
+        \endcode
+
+        \param[in] adcChannel ADC channel to query
+        \return The active filter type, see #FilterTypes.
+    **/
+    FilterTypes FilterType(AdcChannels adcChannel) {
+        return (adcChannel < ADC_CHANNEL_COUNT) ? m_filterType[adcChannel]
+               : FILTER_TYPE_IIR;
+    }
+
     /**
         \brief Gets the IIR filter time constant of an ADC channel.
 
@@ -253,15 +537,7 @@ public:
         \param[in] newSetting The initial filter value.
         \return Success.
     **/
-    bool FilterReset(AdcChannels adcChannel, uint16_t newSetting) {
-        if (adcChannel >= ADC_CHANNEL_COUNT) {
-            return false;
-        }
-        m_analogFilter[adcChannel].Reset(newSetting);
-        m_AdcResultsConvertedFiltered[adcChannel] =
-            m_analogFilter[adcChannel].LastOutput();
-        return true;
-    }
+    bool FilterReset(AdcChannels adcChannel, uint16_t newSetting);
 
     /**
         \brief Configure the ADC conversion timeout.
@@ -310,13 +586,331 @@ public:
         \note For performance reasons, does not perform any bounds checking.
     **/
     float AnalogVoltage(AdcChannels adcChannel) {
-        uint16_t maxReading = INT16_MAX & ~(INT16_MAX >> m_AdcResolution);
+        uint8_t bits = ChannelResolution(adcChannel);
+        if (bits > 15) {
+            bits = 15;
+        }
+        uint16_t maxReading = INT16_MAX & ~(INT16_MAX >> bits);
         float voltage = ADC_CHANNEL_MAX_FLOAT[adcChannel] *
                         m_AdcResultsConvertedFiltered[adcChannel] / maxReading;
         return voltage;
     }
 
+    /**
+        \brief Configure the raw waveform capture.
+
+        Every sample time, the raw conversion results of the channels in
+        \a channelMask are appended as one frame to \a buffer, which is used
+        as a circular buffer. A frame holds one result per selected channel,
+        in #AdcChannels order. Results are in raw ADC counts at the
+        channel's conversion resolution; oversampled channels record the
+        accumulated hardware result before software decimation.
+
+        \code{.cpp}
+        // Capture 1000 frames of both screwdriver current monitors, with
+        // 200 frames of history before the trigger.
+        static uint16_t captureBuffer[2 * 1000];
+        AdcMgr.CaptureConfig(captureBuffer, 1000,
+                             (1 << AdcManager::ADC_SDRVR2_IMON) |
+                             (1 << AdcManager::ADC_SDRVR3_IMON), 200);
+        \endcode
+
+        \param[in] buffer The capture storage; must hold \a frames times the
+        number of selected channels results, and stay valid while capturing.
+        \param[in] frames The number of frames in \a buffer.
+        \param[in] channelMask Bit mask of the #AdcChannels to record.
+        \param[in] preTriggerFrames The number of frames recorded before the
+        trigger; must be less than \a frames.
+        \return Success. Fails while a capture is in progress.
+    **/
+    bool CaptureConfig(uint16_t *buffer, uint32_t frames,
+                       uint16_t channelMask, uint32_t preTriggerFrames);
+
+    /**
+        \brief Set the trigger condition of the raw waveform capture.
+
+        \code{.cpp}
+        // Trigger when the raw A-10 result rises through 2048
+        AdcMgr.CaptureTrigger(AdcManager::CAPTURE_TRIGGER_RISING,
+                              AdcManager::ADC_AIN10, 2048);
+        \endcode
+
+        \param[in] trigger The trigger condition.
+        \param[in] channel The channel that the condition is evaluated on.
+        It does not need to be one of the recorded channels.
+        \param[in] level The trigger level in raw ADC counts.
+        \return Success. Fails while a capture is in progress.
+    **/
+    bool CaptureTrigger(CaptureTriggers trigger, AdcChannels channel,
+                        uint16_t level);
+
+    /**
+        \brief Start recording and wait for the trigger.
+
+        The trigger is not evaluated until the pre-trigger history is full.
+
+        \return Success. Fails if the capture is not configured or is in
+        progress.
+    **/
+    bool CaptureArm();
+
+    /**
+        \brief Trigger an armed capture immediately.
+
+        The pre-trigger history may be shorter than configured if the
+        capture was armed less than the pre-trigger length ago.
+    **/
+    void CaptureForce() {
+        m_captureForce = true;
+    }
+
+    /**
+        \brief Abandon any capture in progress.
+    **/
+    void CaptureStop();
+
+    /**
+        \brief Get the state of the raw waveform capture.
+
+        \return The capture state, see #CaptureStates.
+    **/
+    volatile const CaptureStates &CaptureState() {
+        return m_captureState;
+    }
+
+    /**
+        \brief Access a completed capture without copying it.
+
+        The frames are returned in chronological order as up to two
+        contiguous regions of the capture buffer, suitable for passing
+        directly to a serial or Ethernet send. The buffer must not be
+        reconfigured or re-armed until the data has been consumed.
+
+        \code{.cpp}
+        const uint16_t *first, *second;
+        uint32_t firstFrames, secondFrames;
+        if (AdcMgr.CaptureData(first, firstFrames, second, secondFrames)) {
+            uint8_t frameBytes = AdcMgr.CaptureFrameChannels() * 2;
+            ConnectorUsb.Send(reinterpret_cast<const char *>(first),
+                              firstFrames * frameBytes);
+            ConnectorUsb.Send(reinterpret_cast<const char *>(second),
+                              secondFrames * frameBytes);
+        }
+        \endcode
+
+        \param[out] first The oldest region of frames.
+        \param[out] firstFrames The number of frames in \a first.
+        \param[out] second The newest region of frames.
+        \param[out] secondFrames The number of frames in \a second; may be 0.
+        \return True if a completed capture is available.
+    **/
+    bool CaptureData(const uint16_t *&first, uint32_t &firstFrames,
+                     const uint16_t *&second, uint32_t &secondFrames);
+
+    /**
+        \brief The number of results in each capture frame.
+    **/
+    uint8_t CaptureFrameChannels() {
+        return m_captureChannels;
+    }
+
+    /**
+        \brief The chronological index of the trigger frame in a completed
+        capture.
+    **/
+    uint32_t CaptureTriggerFrame() {
+        return m_captureTriggerFrame;
+    }
+
+    /**
+        \brief Configure the threshold comparator of an ADC channel.
+
+        The comparator checks the channel's filtered reading every sample
+        time. The reading goes above the window when it reaches
+        \a upperVolts and returns when it drops below
+        \a upperVolts - \a hysteresisVolts; the lower threshold works the
+        same way in the opposite direction. A change must persist for
+        \a qualifySamples consecutive samples to be accepted.
+
+        The thresholds are converted to ADC units once here, so the check
+        in the interrupt is integer compares only. Reconfigure the
+        comparator after changing the ADC resolution.
+
+        \code{.cpp}
+        // Flag A-10 above 8V or below 1V, with 0.2V of hysteresis and a
+        // 1ms qualifier
+        AdcMgr.ComparatorConfig(AdcManager::ADC_AIN10, 8.0, 1.0, 0.2, 5);
+        AdcMgr.ComparatorEnable(AdcManager::ADC_AIN10, true);
+        \endcode
+
+        \param[in] adcChannel ADC channel to configure
+        \param[in] upperVolts The upper threshold
+        \param[in] lowerVolts The lower threshold, below \a upperVolts
+        \param[in] hysteresisVolts The hysteresis of both thresholds
+        \param[in] qualifySamples The minimum duration of a change, in samples
+        \return Success.
+    **/
+    bool ComparatorConfig(AdcChannels adcChannel, float upperVolts,
+                          float lowerVolts, float hysteresisVolts,
+                          uint16_t qualifySamples);
+
+    /**
+        \brief Enable or disable the threshold comparator of an ADC channel.
+
+        Enabling starts the comparator in the window without posting events,
+        so a reading already outside the window is reported once qualified.
+
+        \param[in] adcChannel ADC channel to enable
+        \param[in] enable True to enable the comparator
+        \return Success.
+    **/
+    bool ComparatorEnable(AdcChannels adcChannel, bool enable);
+
+    /**
+        \brief Set a function called from the sample interrupt when the
+        channel's comparator goes above or below its window.
+
+        \code{.cpp}
+        void PressureHandler() {
+            if (AdcMgr.ComparatorsRisen(1 << AdcManager::ADC_AIN10)) {
+                // Overpressure
+            }
+        }
+        AdcMgr.ComparatorCallback(AdcManager::ADC_AIN10, PressureHandler);
+        \endcode
+
+        \param[in] adcChannel ADC channel to attach to
+        \param[in] callback The function, or nullptr to remove it. It must
+        be short since it runs in the sample interrupt.
+        \return Success.
+    **/
+    bool ComparatorCallback(AdcChannels adcChannel, voidFuncPtr callback);
+
+    /**
+        \brief Abruptly stop a motor's move from the sample interrupt when
+        the channel's comparator goes above or below its window.
+
+        \code{.cpp}
+        AdcMgr.ComparatorStopMotor(AdcManager::ADC_AIN10, &ConnectorM0);
+        \endcode
+
+        \param[in] adcChannel ADC channel to attach to
+        \param[in] motor The motor to stop, or nullptr for none.
+        \return Success.
+    **/
+    bool ComparatorStopMotor(AdcChannels adcChannel, StepGenerator *motor);
+
+    /**
+        \brief Get the current comparator state of an ADC channel.
+
+        \return The qualified state, see #ComparatorStates.
+    **/
+    ComparatorStates ComparatorState(AdcChannels adcChannel) {
+        return (adcChannel < ADC_CHANNEL_COUNT) ? m_compState[adcChannel]
+               : COMPARATOR_IN_WINDOW;
+    }
+
+    /**
+        \brief Check which comparators have gone above their window since
+        the last call, and clear those flags.
+
+        \code{.cpp}
+        if (AdcMgr.ComparatorsRisen(1 << AdcManager::ADC_AIN10)) {
+            // A-10 went above its upper threshold
+        }
+        \endcode
+
+        \param[in] mask Bit mask of the #AdcChannels to check and clear.
+        \return Bit mask of the channels that have gone above their window.
+    **/
+    uint32_t ComparatorsRisen(uint32_t mask = UINT32_MAX);
+
+    /**
+        \brief Check which comparators have gone below their window since
+        the last call, and clear those flags.
+
+        \param[in] mask Bit mask of the #AdcChannels to check and clear.
+        \return Bit mask of the channels that have gone below their window.
+    **/
+    uint32_t ComparatorsFallen(uint32_t mask = UINT32_MAX);
+
+    /**
+        \brief Set the length of the statistics window.
+
+        Every new result of every channel is accumulated into integer
+        running statistics. Channels that decimate oversampled results
+        contribute one reading per decimated result, not one per sample. At
+        the end of each window the totals are published as a snapshot and the
+        accumulators restart.
+
+        \code{.cpp}
+        // Collect statistics over 100ms windows
+        AdcMgr.StatsWindow(100 * 5);
+        \endcode
+
+        \param[in] samples The window length in sample times, at most
+        131072; 0 stops collecting statistics.
+        \return Success.
+    **/
+    bool StatsWindow(uint32_t samples);
+
+    /**
+        \brief Get the length of the statistics window.
+
+        \return The window length in sample times.
+    **/
+    uint32_t StatsWindow() {
+        return m_statsWindow;
+    }
+
+    /**
+        \brief Get the number of statistics windows completed.
+
+        Compare against a previous value to detect a new snapshot.
+    **/
+    volatile const uint32_t &StatsSequence() {
+        return m_statsSequence;
+    }
+
+    /**
+        \brief Copy the statistics of the last completed window.
+
+        \code{.cpp}
+        AdcManager::AdcStats stats;
+        if (AdcMgr.Stats(AdcManager::ADC_AIN10, stats)) {
+            uint16_t peakToPeak = stats.Max - stats.Min;
+        }
+        \endcode
+
+        \param[in] adcChannel ADC channel to read
+        \param[out] stats The statistics of the last window
+        \return True if a window has completed.
+    **/
+    bool Stats(AdcChannels adcChannel, AdcStats &stats);
+
+    /**
+        \brief Get the statistics of the last completed window in volts.
+
+        \code{.cpp}
+        float minV, maxV, meanV, rmsV;
+        AdcMgr.StatsVolts(AdcManager::ADC_AIN10, minV, maxV, meanV, rmsV);
+        \endcode
+
+        \return True if a window has completed.
+    **/
+    bool StatsVolts(AdcChannels adcChannel, float &minVolts, float &maxVolts,
+                    float &meanVolts, float &rmsVolts);
+
 #ifndef HIDE_FROM_DOXYGEN
+    /**
+        \brief Constructor for AdcManager.
+
+        Initializes member variables, doesn't do any work.
+
+        \note Should not be called by anything other than SysManager.
+    **/
+    AdcManager();
+
     /**
         Public accessor for the AdcManager singleton instance.
     **/
@@ -353,7 +947,65 @@ private:
     // ADC state holders in Q15. ADC logic has already been performed
     volatile uint16_t m_AdcResultsConverted[ADC_CHANNEL_COUNT] = {0};
     volatile uint16_t m_AdcResultsConvertedFiltered[ADC_CHANNEL_COUNT] = {0};
-    Iir16 m_analogFilter[ADC_CHANNEL_COUNT];
+    // ADC results scaled to the full 16-bit range
+    volatile uint16_t m_AdcResultsFullScale[ADC_CHANNEL_COUNT] = {0};
+    Iir16Bank<ADC_CHANNEL_COUNT> m_analogFilter;
+
+    // Per channel filter selection. The IIR filter keeps its own state so
+    // that its time constant survives switching to another filter type.
+    FilterTypes m_filterType[ADC_CHANNEL_COUNT];
+    union {
+        Biquad16 biquad;
+        MovingAverage16 movingAverage;
+        Median16 median;
+    } m_altFilter[ADC_CHANNEL_COUNT];
+
+    // Per channel oversampling settings and software decimation state
+    AdcOversampling m_oversampling[ADC_CHANNEL_COUNT];
+    AdcOversampling m_oversamplingPending[ADC_CHANNEL_COUNT];
+    volatile bool m_sequencePending;
+    uint32_t m_decimateAccum[ADC_CHANNEL_COUNT];
+    uint8_t m_decimateCount[ADC_CHANNEL_COUNT];
+
+    // Raw waveform capture
+    uint16_t *m_captureBuffer;
+    uint32_t m_captureFrames;
+    uint32_t m_capturePreTrigger;
+    uint16_t m_captureMask;
+    uint8_t m_captureChannels;
+    CaptureTriggers m_captureTrigger;
+    AdcChannels m_captureTriggerChannel;
+    uint16_t m_captureLevel;
+    uint16_t m_captureLastResult;
+    volatile CaptureStates m_captureState;
+    volatile bool m_captureForce;
+    uint32_t m_captureHead;
+    uint32_t m_captureCount;
+    uint32_t m_capturePostRemaining;
+    uint32_t m_capturePostFrames;
+    uint32_t m_captureTriggerFrame;
+
+    // Threshold comparators, thresholds in Q15 ADC units
+    volatile uint32_t m_compEnabled;
+    uint16_t m_compUpper[ADC_CHANNEL_COUNT];
+    uint16_t m_compUpperExit[ADC_CHANNEL_COUNT];
+    uint16_t m_compLower[ADC_CHANNEL_COUNT];
+    uint16_t m_compLowerExit[ADC_CHANNEL_COUNT];
+    uint16_t m_compQualify[ADC_CHANNEL_COUNT];
+    uint16_t m_compCount[ADC_CHANNEL_COUNT];
+    ComparatorStates m_compState[ADC_CHANNEL_COUNT];
+    voidFuncPtr m_compCallback[ADC_CHANNEL_COUNT];
+    StepGenerator *m_compMotor[ADC_CHANNEL_COUNT];
+    uint32_t m_compRisen;
+    uint32_t m_compFallen;
+
+    // Windowed statistics; the snapshot of window n is in m_statsSnapshot
+    // [n & 1] so that the other buffer can be written at the next window.
+    uint32_t m_statsWindow;
+    uint32_t m_statsCount;
+    AdcStats m_statsAccum[ADC_CHANNEL_COUNT];
+    AdcStats m_statsSnapshot[2][ADC_CHANNEL_COUNT];
+    volatile uint32_t m_statsSequence;
 
     bool m_initialized;
 
@@ -372,15 +1024,6 @@ private:
     /** Count of samples since last ADC conversion. **/
     uint32_t m_AdcBusyCount;
 
-    /**
-        \brief Constructor for AdcManager.
-
-        Initializes member variables, doesn't do any work.
-
-        \note Should not be called by anything other than SysManager.
-    **/
-    AdcManager();
-
     void DmaInit();
     void DmaUpdate();
 
@@ -394,6 +1037,71 @@ private:
     **/
     bool AdcResChange();
 
+    /**
+        \brief Rebuild the DMA conversion sequence from the resolution and
+        oversampling settings.
+
+        Only called when the ADC conversion is idle.
+    **/
+    void SequenceUpdate();
+
+    /**
+        \brief Calculate the conversion sequence time for a set of
+        oversampling settings.
+    **/
+    uint32_t SequenceTimeUs(const AdcOversampling *settings);
+
+    /**
+        \brief Estimate the CPU cycles per sample of the channel filters if
+        \a adcChannel were changed to \a cycles.
+    **/
+    uint32_t FilterCycles(AdcChannels adcChannel, uint32_t cycles);
+
+    /**
+        \brief Estimate the CPU cycles per sample of a channel's filter.
+    **/
+    uint32_t FilterCycles(AdcChannels adcChannel);
+
+    /**
+        \brief Reset the active filter of a channel and its output.
+    **/
+    void FilterResetImpl(AdcChannels adcChannel, uint16_t newSetting);
+
+    /**
+        \brief Record the latest conversion results into the capture buffer
+        and evaluate the trigger.
+    **/
+    void CaptureUpdate();
+
+    /**
+        \brief Evaluate the capture trigger condition on a result.
+    **/
+    bool CaptureTriggered(uint16_t result);
+
+    /**
+        \brief Run the threshold comparators on the filtered results.
+    **/
+    void ComparatorUpdate();
+
+    /**
+        \brief Convert a voltage on a channel to Q15 ADC units.
+    **/
+    uint16_t VoltsToQ15(AdcChannels adcChannel, float volts);
+
+    /**
+        \brief Accumulate the latest conversion results into the windowed
+        statistics.
+
+        \param[in] freshResults Bit mask of the channels with a new result
+        this sample.
+    **/
+    void StatsUpdate(uint32_t freshResults);
+
+    /**
+        \brief Restart the statistics accumulators.
+    **/
+    void StatsRestart();
+
 }; // AdcManager
 
 } // ClearCore namespace
@@ -38,6 +38,7 @@
 #include "CcioPin.h"
 #include "SerialDriver.h"
 #include "SysConnectors.h"
+#include "SysSingleton.h"
 #include "SysTiming.h"
 
 namespace ClearCore {
@@ -89,11 +90,20 @@ namespace ClearCore {
     CCIOMain informational page.
 **/
 class CcioBoardManager {
-    friend class SysManager;
     friend class CcioPin;
+    friend class IoManager;
+    friend class PulseCounter;
+    friend class SysManager;
 
 public:
 #ifndef HIDE_FROM_DOXYGEN
+    /**
+        Constructor
+
+        \note Only the library's global instance should be constructed
+    **/
+    CcioBoardManager();
+
     /**
         Public accessor for singleton instance
     **/
@@ -195,6 +205,62 @@ public:
         return m_pulseActive;
     }
 
+    /**
+        \brief Play a table of output steps on a CCIO-8 output.
+
+        The sequence is advanced every sample time, so step lengths are kept
+        exactly over the whole sequence, but the outputs are only sent at the
+        #RefreshRate(), so each edge goes out at the next refresh. When the
+        sequence finishes the output holds the level of the last step.
+
+        Starting a sequence stops any output pulses on the pin, and starting
+        output pulses stops the sequence.
+
+        \code{.cpp}
+        // Loop a 20ms on/30ms off/20ms on/130ms off pattern on the first
+        // CCIO-8 board's connector 0 until stopped
+        const OutputSequenceStep flash[] = {
+            {true, 20 * MS_TO_SAMPLES}, {false, 30 * MS_TO_SAMPLES},
+            {true, 20 * MS_TO_SAMPLES}, {false, 130 * MS_TO_SAMPLES}
+        };
+        CcioMgr.OutputSequenceStart(CLEARCORE_PIN_CCIOA0, flash, 4, 0);
+        \endcode
+
+        \param[in] pinNum The CCIO-8 pin number.
+        \param[in] steps The steps to play. The table is read as it plays,
+        so it must remain valid until the sequence is done.
+        \param[in] count The number of steps in the table.
+        \param[in] loops (optional) The number of times to play the table.
+        0 plays it until stopped. Default: 1.
+        \param[in] queue (optional) If true and a sequence is already
+        playing, start this one when that sequence finishes, or at the end
+        of its current pass if it loops forever. Default: false.
+
+        \return Success. Fails if the pin is not a CCIO-8 output, or a step
+        has a length of 0.
+    **/
+    bool OutputSequenceStart(ClearCorePins pinNum,
+                             const OutputSequenceStep *steps, uint16_t count,
+                             uint16_t loops = 1, bool queue = false);
+
+    /**
+        \brief Stop the output sequence on a CCIO-8 output.
+
+        The output is set to FALSE and any queued sequence is dropped.
+
+        \param[in] pinNum The CCIO-8 pin number.
+    **/
+    void OutputSequenceStop(ClearCorePins pinNum);
+
+    /**
+        \brief Check the output sequence state.
+
+        \return A bitmask representing which pins are playing a sequence.
+    **/
+    volatile const uint64_t &OutputSequencesActive() {
+        return m_sequenceActive;
+    }
+
     /**
         \brief Polls for and discovers all CCIO-8 boards connected to the
         ClearCore.
@@ -465,6 +531,7 @@ private:
     uint64_t m_pulseActive;
     uint64_t m_pulseValue;
     uint64_t m_pulseStopPending;
+    uint64_t m_sequenceActive;
 
     uint16_t m_consGlitchCnt;   // count of consecutive glitches detected
     bool m_ccioLinkBroken;
@@ -476,14 +543,10 @@ private:
     uint32_t m_faultLed;
     bool m_autoRediscover;
     uint32_t m_lastDiscoverTime;
+    volatile bool m_rediscoverPending;
 
     CcioPin m_ccioPins[CCIO_PIN_CNT];
 
-    /**
-        Constructor
-    **/
-    CcioBoardManager();
-
     /**
         Initializes the CCIO-8 manager and the CcioPin objects.
     **/
@@ -499,11 +562,23 @@ private:
     **/
     void RefreshSlow();
 
+    /**
+        Background work item that performs the blocking rediscover.
+    **/
+    static void RediscoverWork(void *context);
+
     /**
         Set the current output overload bits
     **/
     void IoOverloadRT(uint64_t overloadState);
 
+    /**
+        Stop any pulses or sequences on the pins so that a direct write to
+        m_currentOutputs holds. Call with interrupts masked or from the
+        sample interrupt.
+    **/
+    void OutputsLatch(uint64_t pinMask);
+
     /*
         Fill a buffer with len bytes of the given val
     */
@@ -34,6 +34,7 @@
 #include <stdint.h>
 
 #include "Connector.h"
+#include "OutputSequence.h"
 #include "SysConnectors.h"
 
 namespace ClearCore {
@@ -274,6 +275,41 @@ public:
     **/
     void OutputPulsesStop(bool stopImmediately = true);
 
+    /**
+        \brief Play a table of output steps.
+
+        The sequence is advanced every sample time, but the CCIO-8 outputs
+        are only sent at the CCIO-8 refresh rate, so step edges are rounded
+        to the next refresh.
+
+        \code{.cpp}
+        // Play the dispense table on the first CCIO-8's connector 0 twice
+        CcioMgr.PinByIndex(CLEARCORE_PIN_CCIOA0)->OutputSequenceStart(dispense,
+                                                                      7, 2);
+        \endcode
+
+        \param[in] steps The steps to play; must remain valid until the
+        sequence is done.
+        \param[in] count The number of steps in the table.
+        \param[in] loops (optional) The number of times to play the table.
+        0 plays it until stopped. Default: 1.
+        \param[in] queue (optional) If true and a sequence is already
+        playing, start this one when that sequence finishes. Default: false.
+
+        \return Success.
+
+        \see CcioBoardManager::OutputSequenceStart
+    **/
+    bool OutputSequenceStart(const OutputSequenceStep *steps, uint16_t count,
+                             uint16_t loops = 1, bool queue = false);
+
+    /**
+        \brief Stop the output sequence and drop any queued sequence.
+
+        The output is set to FALSE.
+    **/
+    void OutputSequenceStop();
+
 protected:
 #ifndef HIDE_FROM_DOXYGEN
     /**
@@ -315,6 +351,8 @@ private:
     uint32_t m_pulseTicksRemaining;
     uint16_t m_pulseStopCount;
     uint16_t m_pulseCounter;
+
+    OutputSequencer m_sequence;
 };
 
 } // ClearCore namespace
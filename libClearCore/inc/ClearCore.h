@@ -26,6 +26,7 @@
 // Header files from the ClearCore hardware that define connectors available
 #include "AdcManager.h"
 #include "CcioBoardManager.h"
+#include "ControlLoopManager.h"
 #include "DigitalIn.h"
 #include "DigitalInAnalogIn.h"
 #include "DigitalInOut.h"
@@ -33,16 +34,20 @@
 #include "DigitalInOutHBridge.h"
 #include "EthernetManager.h"
 #include "InputManager.h"
+#include "IoManager.h"
 #include "LedDriver.h"
 #include "EncoderInput.h"
 #include "MotorDriver.h"
 #include "MotorManager.h"
+#include "PulseCounter.h"
+#include "ReflexManager.h"
 #include "SdCardDriver.h"
 #include "SerialDriver.h"
 #include "SerialUsb.h"
 #include "StatusManager.h"
 #include "SysManager.h"
 #include "SysTiming.h"
+#include "WorkScheduler.h"
 #include "XBeeDriver.h"
 
 
@@ -83,19 +88,25 @@ extern SerialDriver ConnectorCOM0;          ///< COM-0 connector instance
 extern SerialDriver ConnectorCOM1;          ///< COM-1 connector instance
 
 /// Ethernet manager
-extern EthernetManager &EthernetMgr;
+extern SINGLETON_REF(EthernetManager) EthernetMgr;
 
 /// CCIO-8 manager
-extern CcioBoardManager &CcioMgr;
+extern SINGLETON_REF(CcioBoardManager) CcioMgr;
 
 /// Motor connector manager
-extern MotorManager &MotorMgr;
+extern SINGLETON_REF(MotorManager) MotorMgr;
 
 /// ADC module manager
-extern AdcManager &AdcMgr;
+extern SINGLETON_REF(AdcManager) AdcMgr;
+
+/// Sample-rate control loop manager
+extern SINGLETON_REF(ControlLoopManager) ControlLoopMgr;
 
 /// Input manager
-extern InputManager &InputMgr;
+extern SINGLETON_REF(InputManager) InputMgr;
+
+/// Bulk output write and I/O snapshot manager
+extern SINGLETON_REF(IoManager) IoMgr;
 
 /// Xbee wireless
 extern XBeeDriver XBee;
@@ -103,11 +114,20 @@ extern XBeeDriver XBee;
 /// Position Decoder
 extern EncoderInput EncoderIn;
 
+/// Hardware pulse counter
+extern PulseCounter CounterIn;
+
+/// Input-to-output reflex links
+extern ReflexManager ReflexMgr;
+
 /// Status manager
-extern StatusManager &StatusMgr;
+extern SINGLETON_REF(StatusManager) StatusMgr;
 
 /// Timing manager
-extern SysTiming &TimingMgr;
+extern SINGLETON_REF(SysTiming) TimingMgr;
+
+/// Deferred work scheduler
+extern SINGLETON_REF(WorkScheduler) WorkSched;
 
 /// SD card
 extern SdCardDriver SdCard;
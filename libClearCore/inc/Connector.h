@@ -161,7 +161,17 @@ public:
         /**
             [17] Serial port mode for USB.
         **/
-        USB_CDC
+        USB_CDC,
+        /**
+            [18] Digital input mode that measures the averaged frequency and
+            duty cycle of the input signal.
+        **/
+        INPUT_FREQUENCY,
+        /**
+            [19] Digital input mode that counts the input's pulses in
+            hardware.
+        **/
+        INPUT_COUNTER
     } ConnectorModes;
 
     /**
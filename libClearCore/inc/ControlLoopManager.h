@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file ControlLoopManager.h
+    \brief Runs control loops in the sample-rate interrupt.
+**/
+
+#ifndef __CONTROLLOOPMANAGER_H__
+#define __CONTROLLOOPMANAGER_H__
+
+#include <stdint.h>
+#include "PidLoop.h"
+#include "SysSingleton.h"
+
+namespace ClearCore {
+
+/** Number of control loops that can be added to the ControlLoopManager. **/
+#ifndef CONTROL_LOOP_MAX
+#define CONTROL_LOOP_MAX 8
+#endif
+
+/**
+    \brief Runs control loops deterministically at the sample rate.
+
+    Loops are run in the order they were added, once per sample time, after
+    the ADC, connector and encoder inputs have been updated. Outputs to the
+    DAC, PWM and H-bridge take effect immediately; motor velocity commands
+    take effect at the next sample time.
+
+    \code{.cpp}
+    PidLoop tensionLoop;
+    ControlLoopMgr.Add(tensionLoop);
+    \endcode
+**/
+class ControlLoopManager {
+    friend class SysManager;
+
+public:
+    /**
+        \brief Add a loop to be run every sample time.
+
+        \param[in] loop The loop; must remain valid until removed.
+        \return Success. Fails if the loop was already added or
+        #CONTROL_LOOP_MAX loops are running.
+    **/
+    bool Add(PidLoop &loop);
+
+    /**
+        \brief Stop running a loop.
+
+        \param[in] loop The loop to remove.
+        \return True if the loop was removed.
+    **/
+    bool Remove(PidLoop &loop);
+
+    /**
+        \brief The number of loops added.
+    **/
+    uint8_t Count() {
+        return m_count;
+    }
+
+    /**
+        \brief CPU cycles taken by all of the loops at the last sample time.
+    **/
+    volatile const uint32_t &CyclesLast() {
+        return m_cyclesLast;
+    }
+
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        \brief Constructor for ControlLoopManager
+
+        \note Should not be called by anything other than SysManager
+    **/
+    ControlLoopManager();
+
+    /**
+        Public accessor for singleton instance
+    **/
+    static ControlLoopManager &Instance();
+#endif
+
+private:
+    PidLoop *m_loops[CONTROL_LOOP_MAX];
+    volatile uint8_t m_count;
+    volatile uint32_t m_cyclesLast;
+
+    /**
+        \brief Run the loops. Called from the sample-rate interrupt.
+    **/
+    void Update();
+}; // ControlLoopManager
+
+} // ClearCore namespace
+
+#endif // __CONTROLLOOPMANAGER_H__
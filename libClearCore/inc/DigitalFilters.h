@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __DIGITALFILTERS_H__
+#define __DIGITALFILTERS_H__
+
+#include <math.h>
+#include <stdint.h>
+#include "FixedPoint.h"
+#include "SysTiming.h"
+
+#ifndef HIDE_FROM_DOXYGEN
+namespace ClearCore {
+
+/** Maximum number of second order sections in a Biquad16 cascade. **/
+#define BIQUAD_SECTIONS_MAX 2
+/** Fractional bits kept in the Biquad16 section states. **/
+#define BIQUAD_STATE_FRAC_BITS 12
+/**
+    Lowest Biquad16 cutoff frequency, in Hz. Below this the Q30 coefficients
+    can't place the poles closely enough, and a 4th order step response
+    strays more than a few LSBs from the exact filter.
+**/
+#define BIQUAD_CUTOFF_MIN_HZ 1
+/** Maximum length of a MovingAverage16 window. **/
+#define MOVING_AVERAGE_LENGTH_MAX 64
+/** Maximum length of a Median16 window. **/
+#define MEDIAN_LENGTH_MAX 9
+
+//*****************************************************************************
+// NAME                                                                       *
+//  Biquad16 class
+//
+// DESCRIPTION
+///     \brief A cascade of second order IIR sections that filters a 16-bit
+///     input and provides a 16-bit output.
+///
+///     Each section is evaluated in direct form I:
+///     y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2
+///
+///     Coefficients are Q30 and the section states keep
+///     #BIQUAD_STATE_FRAC_BITS fractional bits. The truncation error of each
+///     section output is fed back through a second order error feedback
+///     path, so that low cutoff frequencies settle on the input instead of
+///     stalling in a deadband around it.
+///
+///     \note Has no constructor so that it can be held in a union; call
+///     Butterworth() or Reset() before use.
+//
+class Biquad16 {
+public:
+    /**
+        Update the output with this input.
+    **/
+    void Update(uint16_t input) {
+        int32_t x = static_cast<int32_t>(input) << BIQUAD_STATE_FRAC_BITS;
+        for (uint8_t i = 0; i < m_sections; i++) {
+            Section &s = m_section[i];
+            int64_t acc = static_cast<int64_t>(s.b0) * x +
+                          static_cast<int64_t>(s.b1) * s.x1 +
+                          static_cast<int64_t>(s.b2) * s.x2 -
+                          static_cast<int64_t>(s.a1) * s.y1 -
+                          static_cast<int64_t>(s.a2) * s.y2 +
+                          2 * static_cast<int64_t>(s.e1) - s.e2;
+            s.x2 = s.x1;
+            s.x1 = x;
+            s.y2 = s.y1;
+            s.y1 = static_cast<int32_t>(acc >> 30);
+            s.e2 = s.e1;
+            s.e1 = static_cast<int32_t>(acc & ((1L << 30) - 1));
+            x = s.y1;
+        }
+        m_output = USat<15>((x + (1 << (BIQUAD_STATE_FRAC_BITS - 1))) >>
+                            BIQUAD_STATE_FRAC_BITS);
+    }
+
+    /**
+        \return Return the last output
+    **/
+    uint16_t LastOutput() {
+        return m_output;
+    }
+
+    /**
+        Design a Butterworth low-pass filter.
+
+        The coefficients are designed in double precision and the DC gain of
+        each section is made exactly one after they are quantized.
+
+        \param[in] cutoffHz The -3dB frequency.
+        \param[in] order Filter order, 2 or 4.
+        \return False if the arguments cannot be realized, including cutoffs
+        below #BIQUAD_CUTOFF_MIN_HZ.
+    **/
+    bool Butterworth(float cutoffHz, uint8_t order) {
+        if ((order != 2 && order != 4) || cutoffHz < BIQUAD_CUTOFF_MIN_HZ ||
+                cutoffHz >= SampleRateHz / 2) {
+            return false;
+        }
+        // Quality factors of the Butterworth pole pairs
+        static const double q2[1] = {0.7071067811865476};
+        static const double q4[2] = {0.5411961001461971, 1.3065629648763766};
+        const double *q = (order == 2) ? q2 : q4;
+
+        uint8_t sections = order / 2;
+        double w0 = 2 * M_PI * cutoffHz / SampleRateHz;
+        // 1 - cos(w0), without the cancellation at low cutoffs
+        double sinHalf = sin(w0 / 2);
+        double oneMinusCos = 2 * sinHalf * sinHalf;
+        for (uint8_t i = 0; i < sections; i++) {
+            double alpha = sin(w0) / (2 * q[i]);
+            double a0 = 1 + alpha;
+            double a1 = -2 * (1 - oneMinusCos) / a0;
+            // Q30 only holds magnitudes below 2
+            if (fabs(a1) >= 2) {
+                return false;
+            }
+            Section &s = m_section[i];
+            s.a1 = ToQ30(a1);
+            s.a2 = ToQ30((1 - alpha) / a0);
+            // Split 1 + a1 + a2 between the b coefficients so that the DC
+            // gain is exactly one
+            int64_t dcSum = (1LL << 30) + s.a1 + s.a2;
+            int64_t b0 = (dcSum + 2) / 4;
+            if (dcSum - 2 * b0 > INT32_MAX) {
+                return false;
+            }
+            s.b0 = s.b2 = static_cast<int32_t>(b0);
+            s.b1 = static_cast<int32_t>(dcSum - 2 * b0);
+        }
+        m_sections = sections;
+        Reset(0);
+        return true;
+    }
+
+    /**
+        \return The number of second order sections.
+    **/
+    uint8_t Sections() {
+        return m_sections;
+    }
+
+    // Reset the filter to this level
+    void Reset(uint16_t newSetting) {
+        int32_t state = static_cast<int32_t>(newSetting) <<
+                        BIQUAD_STATE_FRAC_BITS;
+        for (uint8_t i = 0; i < BIQUAD_SECTIONS_MAX; i++) {
+            m_section[i].x1 = m_section[i].x2 = state;
+            m_section[i].y1 = m_section[i].y2 = state;
+            m_section[i].e1 = m_section[i].e2 = 0;
+        }
+        m_output = newSetting;
+    }
+
+private:
+    typedef struct {
+        int32_t b0, b1, b2, a1, a2; // Q30 coefficients
+        int32_t x1, x2;             // Previous inputs
+        int32_t y1, y2;             // Previous outputs
+        int32_t e1, e2;             // Previous output truncation errors
+    } Section;
+
+    static int32_t ToQ30(double coeff) {
+        return static_cast<int32_t>(lround(coeff * (1L << 30)));
+    }
+
+    Section m_section[BIQUAD_SECTIONS_MAX];
+    uint8_t m_sections;
+    uint16_t m_output;
+};
+
+//*****************************************************************************
+// NAME                                                                       *
+//  MovingAverage16 class
+//
+// DESCRIPTION
+///     \brief A moving average (box car) filter of 16-bit inputs.
+///
+///     A running sum is kept so that the cost is independent of the window
+///     length. This is equivalent to a single stage CIC decimator evaluated
+///     at every input.
+///
+///     \note Has no constructor so that it can be held in a union; call
+///     Length() before use.
+//
+class MovingAverage16 {
+public:
+    /**
+        Update the output with this input.
+    **/
+    void Update(uint16_t input) {
+        m_sum += input - m_window[m_index];
+        m_window[m_index] = input;
+        if (++m_index >= m_length) {
+            m_index = 0;
+        }
+    }
+
+    /**
+        \return Return the last output
+    **/
+    uint16_t LastOutput() {
+        return m_sum / m_length;
+    }
+
+    /**
+        Set the window length, in samples.
+
+        \return False if the length is out of range.
+    **/
+    bool Length(uint8_t length) {
+        if (length == 0 || length > MOVING_AVERAGE_LENGTH_MAX) {
+            return false;
+        }
+        m_length = length;
+        Reset(0);
+        return true;
+    }
+
+    uint8_t Length() {
+        return m_length;
+    }
+
+    // Reset the filter to this level
+    void Reset(uint16_t newSetting) {
+        for (uint8_t i = 0; i < m_length; i++) {
+            m_window[i] = newSetting;
+        }
+        m_sum = static_cast<uint32_t>(newSetting) * m_length;
+        m_index = 0;
+    }
+
+private:
+    uint16_t m_window[MOVING_AVERAGE_LENGTH_MAX];
+    uint32_t m_sum;
+    uint8_t m_length;
+    uint8_t m_index;
+};
+
+//*****************************************************************************
+// NAME                                                                       *
+//  Median16 class
+//
+// DESCRIPTION
+///     \brief A running median filter of 16-bit inputs for rejecting
+///     impulse noise.
+///
+///     A sorted copy of the window is maintained; each input removes the
+///     oldest sample and inserts the new one, so the cost grows linearly
+///     with the window length.
+///
+///     \note Has no constructor so that it can be held in a union; call
+///     Length() before use.
+//
+class Median16 {
+public:
+    /**
+        Update the output with this input.
+    **/
+    void Update(uint16_t input) {
+        uint16_t oldest = m_window[m_index];
+        m_window[m_index] = input;
+        if (++m_index >= m_length) {
+            m_index = 0;
+        }
+
+        // Find the oldest sample in the sorted list, and slide the entries
+        // over it to open a slot where the new input belongs.
+        uint8_t pos = 0;
+        while (m_sorted[pos] != oldest) {
+            pos++;
+        }
+        while (pos > 0 && m_sorted[pos - 1] > input) {
+            m_sorted[pos] = m_sorted[pos - 1];
+            pos--;
+        }
+        while (pos < m_length - 1 && m_sorted[pos + 1] < input) {
+            m_sorted[pos] = m_sorted[pos + 1];
+            pos++;
+        }
+        m_sorted[pos] = input;
+    }
+
+    /**
+        \return Return the last output
+    **/
+    uint16_t LastOutput() {
+        return m_sorted[m_length / 2];
+    }
+
+    /**
+        Set the window length, in samples. Must be odd.
+
+        \return False if the length is out of range or even.
+    **/
+    bool Length(uint8_t length) {
+        if (length == 0 || length > MEDIAN_LENGTH_MAX || !(length & 1)) {
+            return false;
+        }
+        m_length = length;
+        Reset(0);
+        return true;
+    }
+
+    uint8_t Length() {
+        return m_length;
+    }
+
+    // Reset the filter to this level
+    void Reset(uint16_t newSetting) {
+        for (uint8_t i = 0; i < m_length; i++) {
+            m_window[i] = newSetting;
+            m_sorted[i] = newSetting;
+        }
+        m_index = 0;
+    }
+
+private:
+    uint16_t m_window[MEDIAN_LENGTH_MAX];
+    uint16_t m_sorted[MEDIAN_LENGTH_MAX];
+    uint8_t m_length;
+    uint8_t m_index;
+};
+
+} // ClearCore namespace
+#endif // HIDE_FROM_DOXYGEN
+#endif // #ifndef __DIGITALFILTERS_H__
+//                                                                            *
+//*****************************************************************************
@@ -34,6 +34,7 @@
 #include "InputManager.h"
 #include "PeripheralRoute.h"
 #include "ShiftRegister.h"
+#include "SysTiming.h"
 
 namespace ClearCore {
 
@@ -120,12 +121,7 @@ public:
         (default) or milliseconds.
     **/
     void FilterLength(uint16_t length,
-                      FilterUnits units = FILTER_UNIT_SAMPLES) {
-        // 1 ms = 1000 us = 5 * (200 us) = 5 sample times
-        uint16_t samples = (units == FILTER_UNIT_MS) ? 5 * length : length;
-        m_filterLength = samples;
-        m_filterTicksLeft = samples;
-    }
+                      FilterUnits units = FILTER_UNIT_SAMPLES);
 
     /**
         \brief Get the connector's digital filter length in samples. The default
@@ -166,18 +162,14 @@ public:
         \brief Set the connector's operational mode.
 
         \param[in] newMode The new mode to be set.
-        The only valid mode for this connector type is: #INPUT_DIGITAL.
+        The valid modes for this connector type are:
+        - #INPUT_DIGITAL
+        - #INPUT_FREQUENCY (DI-6 through A-12 only)
+        - #INPUT_COUNTER (DI-6 through A-12, one connector at a time; see
+          PulseCounter)
         \return Returns false if the mode is invalid or setup fails.
     **/
-    virtual bool Mode(ConnectorModes newMode) override {
-        if (newMode == ConnectorModes::INPUT_DIGITAL) {
-            m_mode = newMode;
-            return true;
-        }
-        else {
-            return false;
-        }
-    }
+    virtual bool Mode(ConnectorModes newMode) override;
 
     /**
         \brief Get connector type.
@@ -358,6 +350,133 @@ public:
     **/
     void InterruptEnable(bool enable);
 
+    /**
+        \brief Record every edge on this input, with a timestamp, into a
+        queue that the main loop drains with EdgeEvents().
+
+        On connectors that can trigger interrupts (DI-6 through A-12) edges
+        are recorded by the external interrupt handler with a cycle-accurate
+        timestamp, independent of the input filter and of the sample rate.
+        The line is set to trigger on both edges, so an ISR registered with
+        InterruptHandlerSet() will also run on both edges, and the events
+        stop if interrupts are disabled with InterruptEnable() or
+        InputMgr.InterruptsEnabled().
+
+        On other connectors the unfiltered input is compared each sample
+        time and changes are timestamped with the sample time. Edges closer
+        together than one sample time are not resolved.
+
+        \code{.cpp}
+        InputEdgeEvent flowEvents[64];
+        ConnectorDI6.EdgeEventsEnable(flowEvents, 64);
+        \endcode
+
+        \param[in] buffer Storage for the queue, or nullptr to stop
+        recording. The buffer must remain valid while recording.
+        \param[in] size The number of events the buffer holds; a power of
+        two from 2 to 32768.
+
+        \return True if the queue was configured.
+    **/
+    bool EdgeEventsEnable(InputEdgeEvent *buffer, uint16_t size);
+
+    /**
+        \brief Drain recorded edge events, oldest first.
+
+        \code{.cpp}
+        InputEdgeEvent events[16];
+        uint16_t count;
+        while ((count = ConnectorDI6.EdgeEvents(events, 16))) {
+            for (uint16_t i = 0; i < count; i++) {
+                // Process events[i]
+            }
+        }
+        \endcode
+
+        \param[out] events Where to copy the events.
+        \param[in] max The maximum number of events to copy.
+
+        \return The number of events copied.
+    **/
+    uint16_t EdgeEvents(InputEdgeEvent *events, uint16_t max) {
+        return m_edgeQueue.Pop(events, max);
+    }
+
+    /**
+        \brief The number of edge events waiting to be drained.
+    **/
+    uint16_t EdgeEventsAvailable() {
+        return m_edgeQueue.Count();
+    }
+
+    /**
+        \brief The number of edges discarded because the queue was full
+        since EdgeEventsEnable() was called.
+    **/
+    uint32_t EdgeEventsDropped() {
+        return m_edgeQueue.Dropped();
+    }
+
+    /**
+        \brief Set the gate time over which #INPUT_FREQUENCY mode averages.
+        The default is 100 ms.
+
+        Each gate the frequency is averaged over all of the whole periods
+        that completed in it. A longer gate gives a steadier reading of a
+        jittery signal and a lower minimum frequency: an input with no
+        period completing within one gate time reads 0 Hz.
+
+        \code{.cpp}
+        // Average the flow meter on DI-6 over half a second
+        ConnectorDI6.Mode(Connector::INPUT_FREQUENCY);
+        ConnectorDI6.FrequencyGate(500);
+        \endcode
+
+        \param[in] gateMs The gate time in milliseconds, from 1 to 10000.
+        \return True if the gate time was valid.
+    **/
+    bool FrequencyGate(uint16_t gateMs);
+
+    /**
+        \brief Get the #INPUT_FREQUENCY mode gate time in milliseconds.
+    **/
+    uint16_t FrequencyGate() {
+        return m_frequencyMeter.GateSamples() / MS_TO_SAMPLES;
+    }
+
+    /**
+        \brief The input's frequency in Hz, averaged over the last gate.
+
+        Valid in #INPUT_FREQUENCY mode. Edges are timestamped by the
+        external interrupt handler with CPU clock resolution, and the
+        result is computed in the sample interrupt once per gate, so no
+        main-loop time is used.
+
+        \code{.cpp}
+        if (ConnectorDI6.Frequency() > 250.0f) {
+            // The input is pulsing faster than 250 Hz
+        }
+        \endcode
+
+        \return The averaged frequency, or 0 if the input is idle.
+    **/
+    volatile const float &Frequency() {
+        return m_frequencyMeter.Frequency();
+    }
+
+    /**
+        \brief The percentage of the time the input was asserted, averaged
+        over the whole periods of the last gate.
+
+        Valid in #INPUT_FREQUENCY mode. If the input is idle this is 100
+        while it is held asserted and 0 otherwise.
+
+        \return The duty cycle, from 0 to 100 percent.
+    **/
+    volatile const float &DutyCycle() {
+        return m_frequencyMeter.Duty();
+    }
+
 protected:
     // LED associated with input
     ShiftRegister::Masks m_ledMask;
@@ -375,13 +494,16 @@ protected:
     uint32_t *m_inRegPtr;
     uint32_t *m_inputRegRTPtr;
 
-    // Boolean state holders
-    bool m_stateFiltered;
-
-    // Stability filter
+    // Stability filter length; the filtering itself is done for all
+    // inputs at once by InputManager::UpdateFilters()
     uint16_t m_filterLength;
-    // Set to filter length on input state change
-    uint16_t m_filterTicksLeft;
+
+    // Edge event queue, and whether the sample-rate refresh feeds it
+    InputEdgeQueue m_edgeQueue;
+    volatile bool m_edgeQueueSampled;
+
+    // INPUT_FREQUENCY mode measurement
+    InputFrequencyMeter m_frequencyMeter;
 
     /**
         Construct, wire in pads and LED shift register object.
@@ -407,9 +529,27 @@ protected:
     void Initialize(ClearCorePins clearCorePin) override;
 
     /**
-        Set the filtered pin value to the current input register state.
+        The filtered input state, as published by InputManager.
+    **/
+    bool FilteredState() {
+        return (*m_inputRegRTPtr >> m_clearCorePin) & 1;
+    }
+
+    /**
+        Have the filtered state take the input's current value at the next
+        sample, skipping the rest of the filter time.
+    **/
+    void FilterExpire();
+
+    /**
+        Start or stop feeding the frequency meter from the EIC line.
+    **/
+    bool FrequencyEnable(bool enable);
+
+    /**
+        Start or stop counting this input with the hardware pulse counter.
     **/
-    void UpdateFilterState();
+    bool CounterEnable(bool enable);
 
 }; // DigitalIn
 
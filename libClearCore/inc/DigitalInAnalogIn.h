@@ -105,7 +105,9 @@ public:
         \param[in] newMode The new mode to be set.
         The valid modes for this connector type are:
         - #INPUT_DIGITAL
-        - #INPUT_ANALOG.
+        - #INPUT_ANALOG
+        - #INPUT_FREQUENCY
+        - #INPUT_COUNTER.
         \return Returns false if the mode is invalid or setup fails.
     **/
     bool Mode(ConnectorModes newMode) override;
@@ -158,6 +160,64 @@ public:
     **/
     bool FilterTc(uint16_t tc, AdcManager::FilterUnits theUnits);
 
+    /**
+        \brief Use a Butterworth low-pass filter on the analog input.
+
+        \code{.cpp}
+        // Filter A-9 with a 2nd order 100Hz low-pass filter
+        ConnectorA9.FilterBiquad(100, 2);
+        \endcode
+
+        \param[in] cutoffHz The -3dB frequency, from 1Hz to below half the
+        sample rate.
+        \param[in] order The filter order, 2 or 4.
+
+        \return success
+        \see AdcManager::FilterBiquad()
+    **/
+    bool FilterBiquad(float cutoffHz, uint8_t order);
+
+    /**
+        \brief Use a moving average filter on the analog input.
+
+        \code{.cpp}
+        // Average A-9 over the last 25 samples (5ms)
+        ConnectorA9.FilterMovingAverage(25);
+        \endcode
+
+        \param[in] length The window length in samples.
+
+        \return success
+        \see AdcManager::FilterMovingAverage()
+    **/
+    bool FilterMovingAverage(uint8_t length);
+
+    /**
+        \brief Use a running median filter on the analog input.
+
+        \code{.cpp}
+        // Reject spikes up to 2 samples long on A-9
+        ConnectorA9.FilterMedian(5);
+        \endcode
+
+        \param[in] length The odd window length in samples.
+
+        \return success
+        \see AdcManager::FilterMedian()
+    **/
+    bool FilterMedian(uint8_t length);
+
+    /**
+        \brief Get the type of filter used on the analog input.
+
+        \code{.cpp}
+        AdcManager::FilterTypes type = ConnectorA9.FilterType();
+        \endcode
+
+        \return The filter type, see AdcManager#FilterTypes.
+    **/
+    AdcManager::FilterTypes FilterType();
+
     /**
         \brief Get the connector's last majority-filtered sampled value.
 
@@ -33,6 +33,7 @@
 #include <sam.h>
 #include "Connector.h"
 #include "DigitalIn.h"
+#include "OutputSequence.h"
 #include "ShiftRegister.h"
 #include "SysUtils.h"
 
@@ -58,6 +59,9 @@ namespace ClearCore {
     out the \ref ConnectorMain informational page.
 **/
 class DigitalInOut : public DigitalIn {
+    friend class IoManager;
+    friend class PulseCounter;
+    friend class ReflexManager;
     friend class SysManager;
 
 public:
@@ -178,6 +182,8 @@ public:
         \endcode
 
         \param[in] newState The value to be output.
+        \return Success. Fails if the connector is not writable, or its
+        output is driven by a reflex link.
     **/
     bool State(int16_t newState) override;
 
@@ -251,6 +257,68 @@ public:
         return m_pulseActive;
     }
 
+    /**
+        \brief Play a table of output steps.
+
+        Each step holds the output at its level for its number of sample
+        times. The output changes exactly on sample times, so no main loop
+        involvement is needed once the sequence is started. When the
+        sequence finishes the output holds the level of the last step.
+
+        Starting a sequence stops any output pulses, and calling State()
+        or OutputPulsesStart() stops the sequence.
+
+        \code{.cpp}
+        // Play the dispense table from the OutputSequenceStep example once
+        ConnectorIO1.OutputSequenceStart(dispense, 7);
+        // Then close the valve for 1 second, open it for 50ms, and repeat
+        const OutputSequenceStep idle[] = {
+            {false, 1000 * MS_TO_SAMPLES}, {true, 50 * MS_TO_SAMPLES}
+        };
+        ConnectorIO1.OutputSequenceStart(idle, 2, 0, true);
+        \endcode
+
+        \param[in] steps The steps to play. The table is read as it plays,
+        so it must remain valid until the sequence is done.
+        \param[in] count The number of steps in the table.
+        \param[in] loops (optional) The number of times to play the table.
+        0 plays it until stopped. Default: 1.
+        \param[in] queue (optional) If true and a sequence is already
+        playing, start this one when that sequence finishes, or at the end
+        of its current pass if it loops forever. A sequence already queued
+        is replaced. Default: false, which starts the sequence now.
+
+        \return Success. Fails if the connector is not writable or is driven
+        by a reflex link, or a step has a length of 0.
+    **/
+    bool OutputSequenceStart(const OutputSequenceStep *steps, uint16_t count,
+                             uint16_t loops = 1, bool queue = false);
+
+    /**
+        \brief Stop the output sequence and drop any queued sequence.
+
+        The output is set to FALSE.
+    **/
+    void OutputSequenceStop();
+
+    /**
+        \brief Check whether an output sequence is playing.
+
+        \return True if a sequence is playing.
+    **/
+    bool OutputSequenceActive() {
+        return m_sequence.Active();
+    }
+
+    /**
+        \brief Check whether an output sequence is waiting to be played.
+
+        \return True if a queued sequence has not started yet.
+    **/
+    bool OutputSequenceQueued() {
+        return m_sequence.Queued();
+    }
+
     /**
         \brief Set the PWM duty on the I/O pin.
 
@@ -271,6 +339,75 @@ public:
     **/
     bool PwmDuty(uint8_t newDuty);
 
+    /**
+        \brief Set the PWM duty on the I/O pin with 16-bit resolution.
+
+        The pin must be in #OUTPUT_PWM mode, or else nothing will happen and
+        this function will return false. The duty is scaled to the number of
+        steps the current carrier supports (see #PwmResolution()). The new
+        duty takes effect at the start of the next PWM period.
+
+        \code{.cpp}
+        // Run IO-1 at 2 kHz and set it to be asserted 30% of the time
+        ConnectorIO1.PwmFrequency(2000, true);
+        ConnectorIO1.Mode(Connector::OUTPUT_PWM);
+        ConnectorIO1.PwmDuty16(UINT16_MAX * 3 / 10);
+        \endcode
+
+        \param[in] newDuty The PWM duty cycle for the pin, from 0 to
+        65535 (UINT16_MAX).
+
+        \return Successfully set the PWM duty value.
+    **/
+    bool PwmDuty16(uint16_t newDuty);
+
+    /**
+        \brief Set the PWM carrier frequency and resolution.
+
+        The PWM outputs are generated in pairs by one timer each: IO-0 and
+        IO-1, IO-2 and IO-3, IO-4 and IO-5. Both connectors of a pair share
+        the carrier, so setting it here also changes the frequency of the
+        other connector in the pair. The duty of any connector in the pair
+        is kept, but the timer is restarted, so its current period is cut
+        short.
+
+        In the default 8-bit mode both connectors of a pair can output PWM,
+        with up to 256 duty steps. In 16-bit mode the timer uses one of its
+        channels to set the period, leaving only IO-1, IO-3, or IO-5 able to
+        output PWM, with up to 65536 duty steps. The timer runs from a fixed
+        2.048 MHz clock shared with the HLFB timers, so the number of steps
+        falls as the carrier rises; see #PwmResolution().
+
+        \code{.cpp}
+        // 20 kHz carrier for LED dimming on IO-3
+        ConnectorIO3.PwmFrequency(20000);
+        // 16-bit, 200 Hz carrier for a proportional valve on IO-5
+        ConnectorIO5.PwmFrequency(200, true);
+        \endcode
+
+        \param[in] frequency The carrier frequency, from 10 Hz to 50 kHz.
+        \param[in] wide (optional) Use 16-bit mode. Default: false.
+
+        \return Success. Fails if \a frequency is out of range, or if
+        \a wide is set and this is IO-0, IO-2, or IO-4, or the other
+        connector in the pair is in #OUTPUT_PWM mode. Also fails while a
+        reflex pulse link is using the pair's timer.
+    **/
+    bool PwmFrequency(uint32_t frequency, bool wide = false);
+
+    /**
+        \brief The PWM carrier frequency, in Hz.
+
+        \return The actual frequency, which may differ slightly from the one
+        requested because the period is a whole number of timer clocks.
+    **/
+    uint32_t PwmFrequency();
+
+    /**
+        \brief The number of distinct PWM duty steps at the current carrier.
+    **/
+    uint32_t PwmResolution();
+
 protected:
     // Port access
     uint32_t m_outputPort;
@@ -320,12 +457,64 @@ private:
     bool m_pulseValue;
     bool m_pulseStopPending;
     uint16_t m_overloadFoldbackCnt;
+    uint16_t m_pwmDuty;
+    OutputSequencer m_sequence;
+    // Driven by a reflex link, and TC taken by a reflex link
+    bool m_reflexOutput;
+    bool m_reflexTc;
+
+    // Divide ratio of each TC_CTRLA_PRESCALER value, as a shift
+    static const uint8_t TcPrescalerShift[8];
 
     void OutputPin(bool val) {
         DATA_OUTPUT_STATE(m_outputPort, m_outputDataMask,
                           val != m_logicInversion);
     }
 
+    /**
+        \brief Latch a new digital output state without touching the pin.
+
+        Cancels any pulses or sequence and restarts the overload trip timer
+        on a change.
+
+        \param[in] newState The commanded output state.
+        \return The logical state the pin should be driven to; false while
+        the output is in overload foldback.
+    **/
+    bool OutputLatch(bool newState);
+
+    /**
+        \brief Drive the output to the current sequence step's level.
+    **/
+    void SequenceOutput(bool level);
+
+    /**
+        \brief True if this connector's timer is in 16-bit PWM mode.
+    **/
+    bool PwmWide() {
+        return m_tc->COUNT8.CTRLA.bit.MODE == TC_CTRLA_MODE_COUNT16_Val;
+    }
+
+    /**
+        \brief The TC compare value for a 16-bit duty.
+
+        A period that fills the counter has no compare value that holds the
+        output on for the whole period, so full duty is one timer clock
+        short there.
+
+        \param[in] duty The duty, from 0 to UINT16_MAX.
+        \param[in] period The number of timer clocks in one PWM period.
+    **/
+    uint32_t PwmCount(uint16_t duty, uint32_t period);
+
+    /**
+        \brief The number of timer clocks in one PWM period.
+    **/
+    uint32_t PwmPeriod() {
+        return PwmWide() ? m_tc->COUNT16.CCBUF[0].reg + 1UL
+               : m_tc->COUNT8.PERBUF.reg + 1UL;
+    }
+
     /**
         \brief Sets whether the connector is in a hardware fault state.
 
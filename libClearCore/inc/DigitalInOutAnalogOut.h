@@ -54,6 +54,25 @@ class DigitalInOutAnalogOut : public DigitalInOut {
     friend class SysManager;
 
 public:
+    /**
+        \enum WaveformModes
+        \brief Playback modes of the analog output waveform.
+    **/
+    typedef enum {
+        /** Play the table once and hold the last value. **/
+        WAVEFORM_ONE_SHOT,
+        /** Repeat the table until stopped. **/
+        WAVEFORM_LOOP,
+        /** Alternate between two tables, refilling each one while the
+            other plays. **/
+        WAVEFORM_PING_PONG,
+    } WaveformModes;
+
+    /**
+        The fastest waveform playback rate, in samples per second.
+    **/
+    static const uint32_t WAVEFORM_RATE_MAX_HZ = 500000;
+
 #ifndef HIDE_FROM_DOXYGEN
     /**
         \brief Default constructor so this connector can be a global and
@@ -173,6 +192,21 @@ public:
     **/
     void AnalogWrite(uint16_t value);
 
+    /**
+        \brief Command the DAC to output a (calibrated) value without waiting
+        on the DAC.
+
+        Safe to call from an interrupt, e.g. by a PidLoop. If the DAC is still
+        synchronizing the previous value the write is skipped rather than
+        waited out; a caller that writes every sample simply retries on the
+        next one. Unlike AnalogWrite(), a playing waveform is not stopped.
+
+        \param[in] value The 11-bit value to command analog current.
+        \return True if the value was written. Fails if not in analog output
+        mode, a waveform is playing, or the DAC is busy.
+    **/
+    bool AnalogWriteNoWait(uint16_t value);
+
     /**
         \brief Command the DAC to output the given number of microamps (uA).
 
@@ -187,6 +221,94 @@ public:
     **/
     void OutputCurrent(uint16_t currentuA);
 
+    /**
+        \brief Play a table of output values through the DAC at a fixed rate.
+
+        The DMA engine writes each value to the DAC on a timer, without
+        involving the CPU. Values use the same 11-bit scale as AnalogWrite().
+        The DAC calibration is applied to the table here, in place, so the
+        table must be writable. The table is consumed: once this returns it
+        holds calibrated DAC commands rather than the values written to it,
+        and passing it to Waveform() again would calibrate it twice. Refill
+        it with 11-bit values before each call, including to replay it after
+        WaveformStop(). The table must remain valid until playback is
+        stopped.
+
+        \code{.cpp}
+        // Repeat a 100 point ramp at 10kHz, giving a 100Hz sawtooth
+        static uint16_t ramp[100];
+        for (uint16_t i = 0; i < 100; i++) {
+            ramp[i] = i * 2047 / 99;
+        }
+        ConnectorIO0.Mode(Connector::OUTPUT_ANALOG);
+        ConnectorIO0.Waveform(ramp, 100, 10000);
+        \endcode
+
+        \param[in,out] table The output values, converted to DAC commands by
+        this call.
+        \param[in] length The number of values in \a table, and in
+        \a table2 in ping-pong mode.
+        \param[in] rateHz The playback rate in values per second, up to
+        #WAVEFORM_RATE_MAX_HZ. The rate is derived from the 120MHz CPU
+        clock, prescaled as needed for rates below about 1.8kHz.
+        \param[in] mode The playback mode, see #WaveformModes.
+        \param[in,out] table2 The second table in ping-pong mode, consumed
+        like \a table.
+        \return True if playback started. Fails if not in analog output mode
+        or the arguments are invalid.
+    **/
+    bool Waveform(uint16_t *table, uint16_t length, uint32_t rateHz,
+                  WaveformModes mode = WAVEFORM_LOOP,
+                  uint16_t *table2 = nullptr);
+
+    /**
+        \brief Stop waveform playback. The output holds its last value.
+
+        Playback is also stopped by AnalogWrite() and by leaving analog
+        output mode.
+    **/
+    void WaveformStop();
+
+    /**
+        \brief Check whether a waveform is playing.
+
+        \return True until playback is stopped, or a one-shot table has
+        finished.
+    **/
+    bool WaveformActive();
+
+    /**
+        \brief In ping-pong mode, get the table that has finished playing
+        and may be refilled.
+
+        Poll this at least once per table length. After filling the table
+        with new 11-bit values, pass it to WaveformCalibrate() before the
+        other table finishes. The table returned is always the one not
+        playing, even if a poll was missed; the missed table will have
+        replayed its old contents.
+
+        \code{.cpp}
+        uint16_t *table = ConnectorIO0.WaveformBufferFree();
+        if (table) {
+            FillNextBlock(table, blockLength);
+            ConnectorIO0.WaveformCalibrate(table, blockLength);
+        }
+        \endcode
+
+        \return The free table, or nullptr if neither has finished since the
+        last call.
+    **/
+    uint16_t *WaveformBufferFree();
+
+    /**
+        \brief Convert 11-bit output values to calibrated DAC commands, in
+        place.
+
+        \param[in,out] values The values to convert.
+        \param[in] count The number of values.
+    **/
+    void WaveformCalibrate(uint16_t *values, uint32_t count);
+
 #ifndef HIDE_FROM_DOXYGEN
     /**
         \brief This function should only be used for calibration purposes.
@@ -227,6 +349,12 @@ private:
     uint16_t m_dacZero;
     uint16_t m_dacSpan;
 
+    // Waveform playback state
+    bool m_waveformActive;
+    WaveformModes m_waveformMode;
+    uint16_t *m_waveformTables[2];
+    uint16_t m_waveformLength;
+
 #ifndef HIDE_FROM_DOXYGEN
     /**
         Construct and wire in the Input/Output pair.
@@ -286,6 +414,11 @@ private:
     **/
     void DacRegisterWrite(uint16_t value);
 
+    /**
+        Apply the DAC calibration to an 11-bit output value.
+    **/
+    uint16_t DacCommand(uint16_t value);
+
 }; // DigitalInOutAnalogOut class
 
 } // ClearCore namespace
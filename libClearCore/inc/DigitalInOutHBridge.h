@@ -36,8 +36,10 @@
 #define __DIGITALINOUTHBRIDGE_H__
 
 #include <stdint.h>
+#include "AdcManager.h"
 #include "Connector.h"
 #include "DigitalInOut.h"
+#include "DmaManager.h"
 #include "PeripheralRoute.h"
 #include "ShiftRegister.h"
 #include "StatusManager.h"
@@ -100,6 +102,27 @@ public:
         TONE_PERIODIC_OFF,
     } ToneState;
 
+    /**
+       \enum DcMotorModes
+
+       \brief Closed-loop modes of the brushed DC motor drive.
+    **/
+    typedef enum {
+        /**
+            The drive is off; the H-bridge output is set with State().
+        **/
+        DC_MOTOR_OFF = 0,
+        /**
+            The drive holds the motor current (torque) at the command.
+        **/
+        DC_MOTOR_TORQUE,
+        /**
+            The drive holds the encoder input velocity at the command,
+            through the current loop.
+        **/
+        DC_MOTOR_VELOCITY,
+    } DcMotorModes;
+
 #ifndef HIDE_FROM_DOXYGEN
     /**
         \brief Default constructor so this connector can be a global and
@@ -230,9 +253,224 @@ public:
         \param[in] frequency The frequency of the tone (Hz)
         \param[in] timeOn Periodic on time (ms)
         \param[in] timeOff Periodic off time (ms)
+
+        \note The tone is synthesized a block of about 1.5ms ahead of the
+        output, so each on and off edge sounds up to about 3ms after its
+        time.
     **/
     void TonePeriodic(uint16_t frequency, uint32_t timeOn, uint32_t timeOff);
 
+    /**
+        \brief Output a tone that sweeps linearly from one frequency to
+        another over the specified duration.
+
+        \code{.cpp}
+        // Sweep IO-4 from 200Hz up to 2kHz over one second
+        ConnectorIO4.ToneChirp(200, 2000, 1000);
+        \endcode
+
+        \param[in] startFrequency The frequency at the start of the sweep (Hz)
+        \param[in] endFrequency The frequency at the end of the sweep (Hz)
+        \param[in] duration How long the sweep takes (ms). Must be non-zero.
+        \param[in] blocking (optional) Sets whether the function will block all
+        other operations until the tone has finished playing. Default: false.
+        \param[in] forceDuration (optional) If true, the tone will be made to
+        sound for the full \a duration specified, regardless of any subsequent
+        tone function calls made before the \a duration has elapsed.
+        Default: false.
+    **/
+    void ToneChirp(uint16_t startFrequency, uint16_t endFrequency,
+                   uint32_t duration, bool blocking = false,
+                   bool forceDuration = false);
+
+    /**
+        \brief Mix a second frequency into the tones played on this connector.
+
+        The two frequencies are mixed at equal levels, keeping the peak of the
+        mixed tone within the tone amplitude. The mix applies to every
+        following tone until it is cleared.
+
+        \code{.cpp}
+        // Sound the DTMF digit "5" (770Hz + 1336Hz) for 200ms on IO-4
+        ConnectorIO4.ToneMix(1336);
+        ConnectorIO4.ToneTimed(770, 200);
+        \endcode
+
+        \param[in] frequency The frequency to mix in (Hz), or 0 to play single
+        tones again.
+    **/
+    void ToneMix(uint16_t frequency);
+
+    /**
+        \brief Set the amplitude envelope of the tones played on this
+        connector.
+
+        Each tone ramps up from silence over the attack time when it starts,
+        and down to silence over the release time when it stops.
+
+        \code{.cpp}
+        // Soften the start and end of IO-4's tones
+        ConnectorIO4.ToneEnvelope(20, 50);
+        \endcode
+
+        \param[in] attack The ramp-up time (ms). 0 starts at full amplitude.
+        \param[in] release The ramp-down time (ms). 0 ends the tone at the end
+        of its current cycle.
+    **/
+    void ToneEnvelope(uint16_t attack, uint16_t release);
+
+    /**
+        \brief Set the current feedback of the brushed DC motor drive.
+
+        The drive runs a small brushed DC motor across the H-bridge in closed
+        loop. IO-4 and IO-5 have no current sensing of their own, so the
+        motor current is read from an ADC channel, typically a current sense
+        amplifier wired to one of the analog inputs. The feedback is taken as
+        the current magnitude; the drive signs it by the sign of the H-bridge
+        output it applied the sample before.
+
+        \note Because the sign comes from the drive output and not from the
+        current itself, the feedback has the wrong sign whenever the current
+        flows against the output, such as when the load back-drives the motor
+        or the output reverses while current is still flowing. The current
+        loop then pushes the wrong way until the current decays, so this
+        drive suits loads that do not overhaul the motor.
+
+        The current loop runs every sample time with fixed-point PI control.
+        Its command is clamped to the current limit. If the loops run out of
+        authority for the stall time, the drive turns the bridge off and
+        flags a stall (see DcMotorStallTime()).
+
+        \code{.cpp}
+        // Hold 300mA of tension on a roller motor on IO-4, with a current
+        // sense amplifier on A-9 that reads 2A at full scale
+        ConnectorA9.Mode(Connector::INPUT_ANALOG);
+        ConnectorIO4.Mode(Connector::OUTPUT_H_BRIDGE);
+        ConnectorIO4.DcMotorCurrentSense(AdcManager::ADC_AIN09, 2000);
+        ConnectorIO4.DcMotorCurrentGains(20, 40000);
+        ConnectorIO4.DcMotorCurrentLimit(800);
+        ConnectorIO4.DcMotorStallTime(500);
+        ConnectorIO4.DcMotorTorque(300);
+        \endcode
+
+        \param[in] adcChannel The ADC channel measuring the motor current.
+        \param[in] fullScale The current at the ADC full scale (mA).
+        \return Success.
+    **/
+    bool DcMotorCurrentSense(AdcManager::AdcChannels adcChannel,
+                             uint16_t fullScale);
+
+    /**
+        \brief Set the current loop gains of the brushed DC motor drive.
+
+        \param[in] kp Proportional gain, in H-bridge output units (full scale
+        32767) per mA of current error.
+        \param[in] ki Integral gain, in H-bridge output units per mA of
+        current error per second.
+        \return Success. Fails if a gain does not fit in its fixed point
+        format at the sample rate.
+    **/
+    bool DcMotorCurrentGains(float kp, float ki);
+
+    /**
+        \brief Set the velocity loop gains of the brushed DC motor drive.
+
+        \param[in] kp Proportional gain, in mA per count/second of velocity
+        error.
+        \param[in] ki Integral gain, in mA per count/second of velocity error
+        per second.
+        \return Success. Fails if a gain does not fit in its fixed point
+        format at the sample rate.
+    **/
+    bool DcMotorVelocityGains(float kp, float ki);
+
+    /**
+        \brief Set the current limit of the brushed DC motor drive.
+
+        Torque commands and the velocity loop output are clamped to the
+        limit. There is no default: the limit starts at 0, and the drive
+        will not start until a limit is set.
+
+        \param[in] limit The current limit (mA).
+    **/
+    void DcMotorCurrentLimit(uint16_t limit);
+
+    /**
+        \brief Set how long the drive may run out of authority before it
+        declares a stall.
+
+        In #DC_MOTOR_TORQUE mode, holding the commanded current at standstill
+        is normal, so a stall is the current loop driving the H-bridge at
+        full output. In #DC_MOTOR_VELOCITY mode, a stall is the velocity loop
+        asking for the full current limit while the encoder velocity is below
+        half the command.
+
+        \param[in] stallTime The stall time (ms). 0 disables stall detection.
+    **/
+    void DcMotorStallTime(uint16_t stallTime);
+
+    /**
+        \brief Run the brushed DC motor drive in current (torque) mode.
+
+        The connector must be in #OUTPUT_H_BRIDGE mode with the current
+        feedback and current limit set. Clears a stall.
+
+        \param[in] current The current command (mA); the sign sets the
+        direction.
+        \return Success.
+    **/
+    bool DcMotorTorque(int32_t current);
+
+    /**
+        \brief Run the brushed DC motor drive in velocity mode, using the
+        encoder input as the velocity feedback.
+
+        The connector must be in #OUTPUT_H_BRIDGE mode with the current
+        feedback and current limit set. Clears a stall.
+
+        The encoder is read earlier in the same sample time, so the feedback
+        is this sample's velocity. It is averaged over the encoder's 10 ms
+        velocity window, which delays it by about 5 ms.
+
+        \param[in] velocity The velocity command (counts/second).
+        \return Success.
+    **/
+    bool DcMotorVelocity(int32_t velocity);
+
+    /**
+        \brief Turn the brushed DC motor drive off and the H-bridge output to
+        zero.
+
+        Setting the H-bridge output with State() or changing the connector
+        mode also turns the drive off.
+    **/
+    void DcMotorStop();
+
+    /**
+        \brief The mode of the brushed DC motor drive.
+    **/
+    volatile const DcMotorModes &DcMotorMode() {
+        return m_dcMode;
+    }
+
+    /**
+        \brief Check whether the drive stopped on a stall.
+
+        Cleared by the next torque or velocity command.
+    **/
+    volatile const bool &DcMotorStalled() {
+        return m_dcStalled;
+    }
+
+    /**
+        \brief The last motor current measured by the drive (mA), signed by
+        the drive direction of the previous sample (see
+        DcMotorCurrentSense()).
+    **/
+    volatile const int32_t &DcMotorCurrent() {
+        return m_dcCurrent;
+    }
+
     /**
         Stop the tone output.
 
@@ -240,6 +478,10 @@ public:
         // Stop a tone playing on IO-4
         ConnectorIO4.ToneStop();
         \endcode
+
+        \note The tone is synthesized a block of about 1.5ms ahead of the
+        output, so it stops (or starts its release) up to about 3ms after
+        the call.
     **/
     void ToneStop();
 
@@ -260,6 +502,34 @@ public:
         return m_toneState;
     }
 
+    /**
+        \brief Most CPU cycles taken by any tone block refill since the last
+        call to ToneCyclesMaxReset().
+    **/
+    volatile const uint32_t &ToneCyclesMax() {
+        return m_toneCyclesMax;
+    }
+
+    /**
+        \brief Clear the maximum tone block refill cycles.
+    **/
+    void ToneCyclesMaxReset() {
+        m_toneCyclesMax = 0;
+    }
+
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        Refill the tone block the DMA has finished with, and stop the
+        playback once the tone has died out.
+
+        Called from the DMA interrupt, which runs below the sample-rate
+        interrupt, when a tone block finishes playing (about every 1.5ms).
+        Refresh() can preempt it, so a change to the tone state takes effect
+        at the next block.
+    **/
+    void ToneService();
+#endif
+
     /**
         \brief Get connector's last sampled value.
 
@@ -328,18 +598,21 @@ public:
     **/
     bool IsWritable() override;
 
-#ifndef HIDE_FROM_DOXYGEN
-    /**
-        Update the tone sine wave output value
-    **/
-    void ToneUpdate();
-#endif
-
 private:
+    // Samples in each half of the tone DMA buffers
+    static const uint8_t TONE_BLOCK_SAMPLES = 32;
+
     // Tone values
     int16_t m_amplitude;
-    int16_t m_sinStep;
-    int16_t m_angle;
+    // Phase accumulators of the tone and the mixed-in tone; a full cycle
+    // is 2^32
+    uint32_t m_phase[2];
+    uint32_t m_phaseStep[2];
+    int32_t m_chirpStep;
+    uint32_t m_chirpSamples;
+    uint32_t m_toneGain;
+    uint32_t m_attackStep;
+    uint32_t m_releaseStep;
     uint32_t m_toneStartTick;
     uint32_t m_toneOnTicks;
     uint32_t m_toneOffTicks;
@@ -350,11 +623,39 @@ private:
     const PeripheralRoute *m_pwmBInfo;
 
     Tcc *m_tcc;
-    IRQn_Type m_tccIrq;
 
     bool m_inFault;
     bool m_forceToneDuration;
 
+    // Brushed DC motor drive
+    volatile DcMotorModes m_dcMode;
+    AdcManager::AdcChannels m_dcSenseChannel;
+    uint16_t m_dcSenseFullScale;
+    int32_t m_dcCurrentLimit;
+    int32_t m_dcCommand;
+    // Q16 gains, scaled to the sample time; the integral gains are Q24
+    int32_t m_dcKp;
+    int32_t m_dcKi;
+    int32_t m_dcVelocityKp;
+    int32_t m_dcVelocityKi;
+    // Q24, scaled like the integral gains
+    int64_t m_dcIntegral;
+    int64_t m_dcVelocityIntegral;
+    int16_t m_dcOutput;
+    uint32_t m_dcStallSamples;
+    uint32_t m_dcStallCount;
+    volatile bool m_dcStalled;
+    volatile int32_t m_dcCurrent;
+
+    // Tone DMA playback: one channel per TCC compare buffer, each fed by a
+    // pair of ping-pong blocks
+    DmaChannels m_toneDma;
+    bool m_toneRunning;
+    bool m_toneSilent;
+    uint8_t m_toneNextFree;
+    volatile uint32_t m_toneCyclesMax;
+    uint16_t m_toneBuffer[2][2][TONE_BLOCK_SAMPLES];
+
     /**
         Initialize hardware and/or internal state.
     **/
@@ -377,6 +678,46 @@ private:
     **/
     inline void ToneFrequency(uint16_t frequency);
 
+    /**
+        \brief Start a timed tone, sweeping if the frequencies differ.
+
+        \return False if a tone that must finish first is playing.
+    **/
+    bool ToneTimedStart(uint16_t startFrequency, uint16_t endFrequency,
+                        uint32_t duration, bool forceDuration);
+
+    /**
+        Start the DMA playback of the tone buffers, if not already running.
+    **/
+    void ToneStart();
+
+    /**
+        Stop the DMA playback and leave the outputs at zero.
+    **/
+    void ToneEnd();
+
+    /**
+        \brief Synthesize one block of both compare buffers.
+
+        \return True if any of the block is sounding.
+    **/
+    bool ToneFill(uint8_t block);
+
+    /**
+        Drive the H-bridge differential output, -INT16_MAX to INT16_MAX.
+    **/
+    void BridgeWrite(int16_t value);
+
+    /**
+        Start the brushed DC motor drive in a closed-loop mode.
+    **/
+    bool DcMotorStart(DcMotorModes mode, int32_t command);
+
+    /**
+        Run one sample of the brushed DC motor drive.
+    **/
+    void DcMotorUpdate();
+
     /**
         \brief Sets the fault flag and disables the H-Bridge output when faulted
 
@@ -392,7 +733,7 @@ private:
                         const PeripheralRoute *outputInfo,
                         const PeripheralRoute *pwmAInfo,
                         const PeripheralRoute *pwmBInfo,
-                        IRQn_Type tccIrq,
+                        DmaChannels toneDma,
                         bool invertDigitalLogic);
 }; // DigitalInOutHBridge
 
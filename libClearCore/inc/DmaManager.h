@@ -32,6 +32,7 @@
 
 #include <stdint.h>
 #include <sam.h>
+#include "SysSingleton.h"
 
 #ifndef HIDE_FROM_DOXYGEN
 namespace ClearCore {
@@ -44,6 +45,11 @@ typedef enum {
     DMA_SERCOM0_SPI_TX, ///< COM1 SPI streaming output
     DMA_SERCOM7_SPI_RX, ///< COM0 SPI streaming input
     DMA_SERCOM7_SPI_TX, ///< COM0 SPI streaming output
+    DMA_DAC_WAVEFORM,   ///< IO-0 DAC waveform playback
+    DMA_IO4_TONE_A,     ///< IO-4 tone, H-bridge leg A compare
+    DMA_IO4_TONE_B,     ///< IO-4 tone, H-bridge leg B compare
+    DMA_IO5_TONE_A,     ///< IO-5 tone, H-bridge leg A compare
+    DMA_IO5_TONE_B,     ///< IO-5 tone, H-bridge leg B compare
     DMA_CHANNEL_COUNT,  // Keep at end
     DMA_INVALID_CHANNEL // Placeholder for unset values
 } DmaChannels;
@@ -59,18 +65,13 @@ class DmaManager {
 public:
     static DmacChannel *Channel(DmaChannels index);
     static DmacDescriptor *BaseDescriptor(DmaChannels index);
-
     /**
-        Public accessor for singleton instance
+        The descriptor the DMAC writes back with the transfer state of an
+        active channel.
     **/
-    static DmaManager &Instance();
-private:
-
-    static DmacDescriptor writeBackDescriptor[DMA_CHANNEL_COUNT] __attribute__((
-                aligned(16)));
-    static DmacDescriptor descriptorBase[DMA_CHANNEL_COUNT] __attribute__((aligned(
-                16)));
+    static volatile DmacDescriptor *WriteBackDescriptor(DmaChannels index);
 
+#ifndef HIDE_FROM_DOXYGEN
     /**
         \brief Constructor for DmaManager
 
@@ -79,6 +80,18 @@ private:
         \note Should not be called by anything other than SysManager
     **/
     DmaManager() {};
+#endif
+
+    /**
+        Public accessor for singleton instance
+    **/
+    static DmaManager &Instance();
+private:
+
+    static DmacDescriptor writeBackDescriptor[DMA_CHANNEL_COUNT] __attribute__((
+                aligned(16)));
+    static DmacDescriptor descriptorBase[DMA_CHANNEL_COUNT] __attribute__((aligned(
+                16)));
 
     /**
         \brief One-time initialization of the DMAC
@@ -37,6 +37,7 @@
 #include "HardwareMapping.h"
 #include "IpAddress.h"
 #include "Phy.h"
+#include "SysSingleton.h"
 #include "SysUtils.h"
 #include "lwip/dhcp.h"
 #include "lwip/ip_addr.h"
@@ -58,6 +59,13 @@ class EthernetManager {
 
 public:
 #ifndef HIDE_FROM_DOXYGEN
+    /**
+        Construct
+
+        \note Only the library's global instance should be constructed
+    **/
+    EthernetManager();
+
     /**
         Public accessor for singleton instance
     **/
@@ -427,11 +435,6 @@ private:
     **/
     void ConfigureGpioPerGmac(uint32_t port, uint32_t pin);
 
-    /**
-        Construct
-    **/
-    EthernetManager();
-
 }; // EthernetManager
 
 } // ClearCore namespace
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __FIXEDPOINT_H__
+#define __FIXEDPOINT_H__
+
+#include <stdint.h>
+#ifdef __ARM_FEATURE_DSP
+#include <sam.h>
+#endif
+
+#ifndef HIDE_FROM_DOXYGEN
+namespace ClearCore {
+
+//*****************************************************************************
+// Saturating primitives
+//
+// These map onto the Cortex-M4 DSP instructions when they are available and
+// fall back to portable arithmetic with identical results otherwise.
+//
+
+/**
+    Signed 32-bit addition, saturated to the int32_t range.
+**/
+inline int32_t SatAdd(int32_t a, int32_t b) {
+#ifdef __ARM_FEATURE_DSP
+    return __QADD(a, b);
+#else
+    int64_t sum = static_cast<int64_t>(a) + b;
+    return (sum > INT32_MAX) ? INT32_MAX : (sum < INT32_MIN) ? INT32_MIN : sum;
+#endif
+}
+
+/**
+    Signed 32-bit subtraction, saturated to the int32_t range.
+**/
+inline int32_t SatSub(int32_t a, int32_t b) {
+#ifdef __ARM_FEATURE_DSP
+    return __QSUB(a, b);
+#else
+    int64_t diff = static_cast<int64_t>(a) - b;
+    return (diff > INT32_MAX) ? INT32_MAX :
+           (diff < INT32_MIN) ? INT32_MIN : diff;
+#endif
+}
+
+/**
+    Saturate a signed value to a BITS wide signed range.
+**/
+template<uint8_t BITS>
+inline int32_t Sat(int32_t value) {
+    static_assert(BITS >= 1 && BITS <= 32, "Sat: BITS must be 1..32");
+#ifdef __ARM_FEATURE_DSP
+    return __SSAT(value, BITS);
+#else
+    const int64_t hi = (static_cast<int64_t>(1) << (BITS - 1)) - 1;
+    const int64_t lo = -hi - 1;
+    return (value > hi) ? hi : (value < lo) ? lo : value;
+#endif
+}
+
+/**
+    Saturate a signed value to a BITS wide unsigned range.
+**/
+template<uint8_t BITS>
+inline uint32_t USat(int32_t value) {
+    static_assert(BITS <= 31, "USat: BITS must be 0..31");
+#ifdef __ARM_FEATURE_DSP
+    return __USAT(value, BITS);
+#else
+    const int32_t hi = (static_cast<int64_t>(1) << BITS) - 1;
+    return (value < 0) ? 0 : (value > hi) ? hi : value;
+#endif
+}
+
+/**
+    Saturate a 64-bit intermediate result to the int32_t range.
+**/
+inline int32_t Sat32(int64_t value) {
+    return (value > INT32_MAX) ? INT32_MAX :
+           (value < INT32_MIN) ? INT32_MIN : value;
+}
+
+/**
+    Multiply two fixed-point values and drop FRAC fractional bits, rounding
+    toward negative infinity. The caller must ensure the result fits.
+**/
+template<uint8_t FRAC>
+inline int32_t MulQ(int32_t a, int32_t b) {
+    return (static_cast<int64_t>(a) * b) >> FRAC;
+}
+
+//*****************************************************************************
+// NAME                                                                       *
+//  FixedPoint class
+//
+// DESCRIPTION
+///     \brief A signed fixed-point number with FRAC fractional bits stored
+///     in T (int16_t, int32_t or int64_t).
+///
+///     Construction and comparison are constexpr so that constants can be
+///     folded at compile time. Arithmetic saturates at the limits of T;
+///     multiplication truncates toward negative infinity like the
+///     hand-written shifts it replaces. The wrapper is a single T, so it
+///     costs nothing over the raw integer.
+//
+template<uint8_t FRAC, typename T>
+class FixedPoint {
+public:
+    typedef T Storage;
+
+    constexpr FixedPoint() : m_raw(0) {}
+
+    /**
+        Construct from the raw integer representation.
+    **/
+    static constexpr FixedPoint FromRaw(T raw) {
+        return FixedPoint(raw, RawTag());
+    }
+
+    /**
+        Construct from a float, rounding to nearest and saturating.
+    **/
+    static constexpr FixedPoint FromFloat(float value) {
+        return FromRaw(Clamp(static_cast<int64_t>(
+                                 value * One() + (value < 0 ? -0.5f : 0.5f))));
+    }
+
+    /**
+        Construct from an integer, saturating. The value must fit in
+        64 - FRAC bits.
+    **/
+    static constexpr FixedPoint FromInt(int64_t value) {
+        return FromRaw(Clamp(value << FRAC));
+    }
+
+    /**
+        Construct from an unsigned reading that is BITS wide, treating its
+        full scale as 1.0.
+    **/
+    static constexpr FixedPoint FromUnsigned(uint32_t value, uint8_t bits) {
+        return FromRaw(bits > FRAC ? value >> (bits - FRAC)
+                                   : value << (FRAC - bits));
+    }
+
+    constexpr T Raw() const {
+        return m_raw;
+    }
+
+    constexpr float ToFloat() const {
+        return m_raw * (1.0f / One());
+    }
+
+    /**
+        \return The integer part, rounded toward negative infinity.
+    **/
+    constexpr T ToInt() const {
+        return m_raw >> FRAC;
+    }
+
+    /**
+        \return The nearest integer, with halves rounded up.
+    **/
+    constexpr T ToIntRounded() const {
+        return (static_cast<int64_t>(m_raw) +
+                (static_cast<int64_t>(1) << (FRAC - 1))) >> FRAC;
+    }
+
+    /**
+        \return The fractional part, which is never negative.
+    **/
+    constexpr FixedPoint Frac() const {
+        return FromRaw(m_raw & ((static_cast<T>(1) << FRAC) - 1));
+    }
+
+    /**
+        Convert to another format, saturating if the value doesn't fit.
+    **/
+    template<uint8_t F2, typename T2>
+    FixedPoint<F2, T2> Convert() const {
+        const int8_t shift = static_cast<int8_t>(F2) - FRAC;
+        int64_t raw = (shift >= 0) ? static_cast<int64_t>(m_raw) << shift
+                                   : static_cast<int64_t>(m_raw) >> -shift;
+        return FixedPoint<F2, T2>::FromRaw(
+                   static_cast<T2>(FixedPoint<F2, T2>::Clamp(raw)));
+    }
+
+    FixedPoint operator+(FixedPoint other) const {
+        return FromRaw(Add(m_raw, other.m_raw));
+    }
+
+    FixedPoint operator-(FixedPoint other) const {
+        return FromRaw(Sub(m_raw, other.m_raw));
+    }
+
+    FixedPoint operator-() const {
+        return FromRaw(Sub(static_cast<T>(0), m_raw));
+    }
+
+    /**
+        Multiply by a value in any format; the result keeps this format.
+    **/
+    template<uint8_t F2, typename T2>
+    FixedPoint operator*(FixedPoint<F2, T2> other) const {
+        static_assert(sizeof(T) < 8 && sizeof(T2) < 8,
+                      "FixedPoint: 64-bit formats can't be multiplied");
+        return FromRaw(Clamp((static_cast<int64_t>(m_raw) * other.Raw()) >>
+                             F2));
+    }
+
+    FixedPoint &operator+=(FixedPoint other) {
+        return *this = *this + other;
+    }
+
+    FixedPoint &operator-=(FixedPoint other) {
+        return *this = *this - other;
+    }
+
+    template<uint8_t F2, typename T2>
+    FixedPoint &operator*=(FixedPoint<F2, T2> other) {
+        return *this = *this * other;
+    }
+
+    constexpr bool operator==(FixedPoint other) const {
+        return m_raw == other.m_raw;
+    }
+    constexpr bool operator!=(FixedPoint other) const {
+        return m_raw != other.m_raw;
+    }
+    constexpr bool operator<(FixedPoint other) const {
+        return m_raw < other.m_raw;
+    }
+    constexpr bool operator<=(FixedPoint other) const {
+        return m_raw <= other.m_raw;
+    }
+    constexpr bool operator>(FixedPoint other) const {
+        return m_raw > other.m_raw;
+    }
+    constexpr bool operator>=(FixedPoint other) const {
+        return m_raw >= other.m_raw;
+    }
+
+    /**
+        Saturate a wide intermediate to the range of T.
+    **/
+    static constexpr T Clamp(int64_t raw) {
+        return (raw > Max()) ? Max() : (raw < Min()) ? Min() : raw;
+    }
+
+private:
+    struct RawTag {};
+    constexpr FixedPoint(T raw, RawTag) : m_raw(raw) {}
+
+    static constexpr float One() {
+        return static_cast<float>(static_cast<int64_t>(1) << FRAC);
+    }
+    static constexpr int64_t Max() {
+        return INT64_MAX >> (64 - 8 * sizeof(T));
+    }
+    static constexpr int64_t Min() {
+        return -Max() - 1;
+    }
+
+    // A 16-bit sum can't overflow 32 bits, so one SSAT is enough
+    static int16_t Add(int16_t a, int16_t b) {
+        return Sat<16>(static_cast<int32_t>(a) + b);
+    }
+    static int16_t Sub(int16_t a, int16_t b) {
+        return Sat<16>(static_cast<int32_t>(a) - b);
+    }
+    static int32_t Add(int32_t a, int32_t b) {
+        return SatAdd(a, b);
+    }
+    static int32_t Sub(int32_t a, int32_t b) {
+        return SatSub(a, b);
+    }
+    static int64_t Add(int64_t a, int64_t b) {
+        int64_t sum;
+        return __builtin_add_overflow(a, b, &sum) ?
+               ((b < 0) ? INT64_MIN : INT64_MAX) : sum;
+    }
+    static int64_t Sub(int64_t a, int64_t b) {
+        int64_t diff;
+        return __builtin_sub_overflow(a, b, &diff) ?
+               ((b < 0) ? INT64_MAX : INT64_MIN) : diff;
+    }
+
+    T m_raw;
+};
+
+/** Q15 in 16 bits: [-1, 1) **/
+typedef FixedPoint<15, int16_t> Q15;
+/** Q31 in 32 bits: [-1, 1) **/
+typedef FixedPoint<31, int32_t> Q31;
+/** 15 fractional bits in 32 bits; the StepGenerator motion format **/
+typedef FixedPoint<15, int32_t> Q16_15;
+/** 16 fractional bits in 32 bits **/
+typedef FixedPoint<16, int32_t> Q15_16;
+/** 15 fractional bits in 64 bits; the StepGenerator position format **/
+typedef FixedPoint<15, int64_t> Q48_15;
+
+} // ClearCore namespace
+#endif // HIDE_FROM_DOXYGEN
+
+#endif // __FIXEDPOINT_H__
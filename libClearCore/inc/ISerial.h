@@ -426,6 +426,8 @@ public:
         return Send(number, radix) && SendLine();
     }
 
+    // newlib makes int32_t a long, so plain int needs its own overloads
+#ifdef _INT32_EQ_LONG
     /**
         \brief Send an integer to be printed to the serial port.
 
@@ -449,6 +451,7 @@ public:
     bool SendLine(int number, uint8_t radix = 10) {
         return SendLine(static_cast<int32_t>(number), radix);
     }
+#endif
 
     /**
         Returns number of characters waiting in the receive buffer.
@@ -24,6 +24,8 @@
 #define __IIRFILTER_H__
 
 #include <math.h>
+#include <stdint.h>
+#include "FixedPoint.h"
 #include "SysTiming.h"
 
 #ifndef HIDE_FROM_DOXYGEN
@@ -51,7 +53,7 @@ public:
         Update the output with this input and return new output.
     **/
     void Update(uint16_t input) {
-        m_z = ((static_cast<int64_t>(m_z) * m_tc) >> 15) -
+        m_z = MulQ<15>(m_z, m_tc) -
               ((static_cast<int32_t>(input) * m_tc) << 1) +
               (static_cast<int32_t>(input) << 16);
     }
@@ -77,12 +79,11 @@ public:
     };
 
     void TcSamples(uint16_t riseSamples99pct) {
-        float tcTemp = powf(.01, 1. / riseSamples99pct) * 32768 + 0.5;
-        m_tc = (tcTemp < INT16_MAX) ? tcTemp : INT16_MAX;
+        m_tc = TcFromSamples(riseSamples99pct);
     }
 
     uint16_t TcSamples() {
-        return logf(0.01) / logf(m_tc / 32768.);
+        return SamplesFromTc(m_tc);
     }
 
     uint16_t Tc_ms() {
@@ -98,11 +99,127 @@ public:
         m_z = (newSetting << 16);
     }
 
+    // Convert a 99% rise time in samples to a filter constant
+    static uint16_t TcFromSamples(uint16_t riseSamples99pct) {
+        float tcTemp = powf(.01, 1. / riseSamples99pct) * 32768 + 0.5;
+        return (tcTemp < INT16_MAX) ? tcTemp : INT16_MAX;
+    }
+
+    // Convert a filter constant to a 99% rise time in samples
+    static uint16_t SamplesFromTc(uint16_t tc) {
+        return logf(0.01) / logf(tc / 32768.);
+    }
+
 private:
     uint16_t m_tc; // Filter time constant (positive)
     int32_t m_z;  // "Z" output/accumulator
 };
 
+//*****************************************************************************
+// NAME                                                                       *
+//  Iir16Bank class
+//
+// DESCRIPTION
+///     \brief A bank of N Iir16 filters updated together.
+///
+///     The recurrence is evaluated without the 64-bit multiply of Iir16 by
+///     splitting the accumulator z into its high and low halves:
+///
+///     (z*tc >> 15) - 2*input*tc + (input << 16)
+///         = 2*(tc*(zHi - input) + (input << 15)) + (zLo*tc >> 15)
+///
+///     which is one 32-bit multiply-accumulate and one 32-bit multiply per
+///     filter, and is bit-exact with Iir16.
+///
+///     A filter whose last update left its accumulator unchanged has settled
+///     on its input; it is skipped until its input or time constant changes.
+//
+template<uint8_t N>
+class Iir16Bank {
+public:
+    Iir16Bank(void) {
+        for (uint8_t i = 0; i < N; i++) {
+            m_tc[i] = 0;
+            m_z[i] = 0;
+            m_input[i] = 0;
+            m_settled[i] = false;
+        }
+    }
+
+    /**
+        Update every filter with its input and write the new outputs.
+    **/
+    void Update(const volatile uint16_t *input, volatile uint16_t *output) {
+        for (uint8_t i = 0; i < N; i++) {
+            uint16_t in = input[i];
+            if (!m_settled[i] || in != m_input[i]) {
+                int32_t z = m_z[i];
+                int32_t zNext = 2 * (m_tc[i] * ((z >> 16) - in) + (in << 15)) +
+                                static_cast<int32_t>(
+                                    ((z & 0xFFFFUL) * m_tc[i]) >> 15);
+                m_z[i] = zNext;
+                m_input[i] = in;
+                m_settled[i] = (zNext == z);
+            }
+            output[i] = m_z[i] >> 16;
+        }
+    }
+
+    /**
+        Update one filter with the Iir16 arithmetic.
+    **/
+    void UpdateScalar(uint8_t index, uint16_t input) {
+        m_z[index] = MulQ<15>(m_z[index], m_tc[index]) -
+                     ((static_cast<int32_t>(input) * m_tc[index]) << 1) +
+                     (static_cast<int32_t>(input) << 16);
+        m_settled[index] = false;
+    }
+
+    /**
+        \return Return the last output of a filter
+    **/
+    uint16_t LastOutput(uint8_t index) {
+        return (m_z[index] >> 16);
+    }
+
+    void Tc(uint8_t index, uint16_t newTc) {
+        m_tc[index] = newTc;
+        m_settled[index] = false;
+    }
+
+    uint16_t Tc(uint8_t index) {
+        return m_tc[index];
+    }
+
+    void TcSamples(uint8_t index, uint16_t riseSamples99pct) {
+        Tc(index, Iir16::TcFromSamples(riseSamples99pct));
+    }
+
+    uint16_t TcSamples(uint8_t index) {
+        return Iir16::SamplesFromTc(m_tc[index]);
+    }
+
+    uint16_t Tc_ms(uint8_t index) {
+        return TcSamples(index) / MS_TO_SAMPLES;
+    }
+
+    void Tc_ms(uint8_t index, uint16_t riseMs99pct) {
+        TcSamples(index, riseMs99pct * MS_TO_SAMPLES);
+    }
+
+    // Reset a filter to this level
+    void Reset(uint8_t index, uint16_t newSetting) {
+        m_z[index] = (newSetting << 16);
+        m_settled[index] = false;
+    }
+
+private:
+    uint16_t m_tc[N];              // Filter time constants (positive)
+    int32_t m_z[N];                // "Z" outputs/accumulators
+    uint16_t m_input[N];           // Inputs of the last update
+    volatile bool m_settled[N];    // Last update left m_z unchanged
+};
+
 } // ClearCore namespace
 #endif // HIDE_FROM_DOXYGEN
 #endif // #ifndef __IIRFILTER_H__
@@ -32,13 +32,242 @@
 #ifndef __INPUTMANAGER_H__
 #define __INPUTMANAGER_H__
 
+#include "atomic_utils.h"
 #include "PeripheralRoute.h"
 #include "SysConnectors.h"
+#include "SysSingleton.h"
+#include "VerticalDebounce.h"
 
 namespace ClearCore {
 
 typedef void (*voidFuncPtr)(void);
 
+/**
+    \brief A timestamped edge recorded by a digital input's edge event queue.
+
+    \see DigitalIn::EdgeEventsEnable()
+**/
+struct InputEdgeEvent {
+    /// DWT cycle counter value (CPU_CLK cycles) when the edge was seen.
+    /// Divide differences by CYCLES_PER_MICROSECOND for microseconds.
+    uint32_t Timestamp;
+    /// The ClearCorePins index of the connector the edge occurred on.
+    int8_t Pin;
+    /// True for a deasserted to asserted transition.
+    bool Rising;
+};
+
+#ifndef HIDE_FROM_DOXYGEN
+/**
+    \brief Single-producer, single-consumer ring of InputEdgeEvents.
+
+    Exactly one interrupt context pushes into a queue (the EIC handler or
+    the sample-rate interrupt) and the main loop pops, so the head and tail
+    indices are each written by only one side and no locking is required.
+    The size must be a power of two.
+**/
+class InputEdgeQueue {
+public:
+    InputEdgeQueue()
+        : m_buffer(nullptr),
+          m_mask(0),
+          m_head(0),
+          m_tail(0),
+          m_dropped(0),
+          m_pin(CLEARCORE_PIN_INVALID),
+          m_port(0),
+          m_pinMask(0) {}
+
+    /**
+        Attach a buffer (or nullptr to detach) and empty the queue. Must not
+        be called while the producer is active.
+    **/
+    void Attach(InputEdgeEvent *buffer, uint16_t size, int8_t pin,
+                uint32_t port, uint32_t pinMask) {
+        m_buffer = buffer;
+        m_mask = buffer ? size - 1 : 0;
+        m_head = m_tail = 0;
+        m_dropped = 0;
+        m_pin = pin;
+        m_port = port;
+        m_pinMask = pinMask;
+    }
+
+    /**
+        Producer side: record an edge, or count it as dropped if full.
+    **/
+    void Push(bool rising, uint32_t timestamp) {
+        uint16_t head = m_head;
+        if (static_cast<uint16_t>(head - atomic_load_n(&m_tail)) > m_mask) {
+            m_dropped++;
+            return;
+        }
+        InputEdgeEvent &event = m_buffer[head & m_mask];
+        event.Timestamp = timestamp;
+        event.Pin = m_pin;
+        event.Rising = rising;
+        // Publish the event only after it has been written
+        atomic_store_n(&m_head, static_cast<uint16_t>(head + 1));
+    }
+
+    /**
+        Consumer side: copy out up to \a max events, oldest first.
+    **/
+    uint16_t Pop(InputEdgeEvent *events, uint16_t max) {
+        uint16_t tail = m_tail;
+        uint16_t count = atomic_load_n(&m_head) - tail;
+        if (count > max) {
+            count = max;
+        }
+        for (uint16_t i = 0; i < count; i++) {
+            events[i] = m_buffer[(tail + i) & m_mask];
+        }
+        // Release the slots only after they have been copied
+        atomic_store_n(&m_tail, static_cast<uint16_t>(tail + count));
+        return count;
+    }
+
+    uint16_t Count() {
+        return static_cast<uint16_t>(atomic_load_n(&m_head) - m_tail);
+    }
+
+    uint32_t Dropped() {
+        return m_dropped;
+    }
+
+    uint32_t Port() {
+        return m_port;
+    }
+
+    uint32_t PinMask() {
+        return m_pinMask;
+    }
+
+private:
+    InputEdgeEvent *m_buffer;
+    uint16_t m_mask;
+    volatile uint16_t m_head;
+    volatile uint16_t m_tail;
+    volatile uint32_t m_dropped;
+    int8_t m_pin;
+    uint32_t m_port;
+    uint32_t m_pinMask;
+};
+
+/**
+    \brief Gated frequency and duty cycle measurement from edge timestamps.
+
+    The EIC handler feeds Edge() with the DWT timestamp of every edge and
+    the sample-rate interrupt calls Update(). Each gate the whole number of
+    periods between the first and last asserting edge is averaged, so the
+    result keeps the full CPU_CLK resolution however many edges fall in the
+    gate. If a gate holds less than one full period it is stretched until
+    one arrives, or reports 0 Hz if the input stops for a whole gate.
+**/
+class InputFrequencyMeter {
+public:
+    InputFrequencyMeter()
+        : m_port(0),
+          m_pinMask(0),
+          m_gateSamples(1),
+          m_gateCount(0),
+          m_edges(0),
+          m_firstEdge(0),
+          m_lastEdge(0),
+          m_highCycles(0),
+          m_highPending(0),
+          m_frequency(0),
+          m_duty(0) {}
+
+    /**
+        Reset the measurement and set the input it reads. Must not be
+        called while the EIC line is feeding Edge().
+    **/
+    void Attach(uint32_t port, uint32_t pinMask, uint32_t gateSamples) {
+        m_port = port;
+        m_pinMask = pinMask;
+        m_gateSamples = gateSamples;
+        m_gateCount = 0;
+        m_edges = 0;
+        m_highCycles = 0;
+        m_highPending = 0;
+        m_frequency = 0;
+        m_duty = 0;
+    }
+
+    /**
+        EIC side: record an edge seen at DWT cycle \a cycle.
+    **/
+    void Edge(bool asserted, uint32_t cycle) {
+        // The sample-rate interrupt outranks the EIC; keep it from seeing
+        // a half-recorded edge.
+        __disable_irq();
+        if (asserted) {
+            // The pulse that started at the previous asserting edge is
+            // complete, so its high time belongs to this gate.
+            if (m_edges) {
+                m_highCycles += m_highPending;
+            }
+            else {
+                m_firstEdge = cycle;
+            }
+            m_highPending = 0;
+            m_lastEdge = cycle;
+            m_edges++;
+        }
+        else if (m_edges) {
+            m_highPending = cycle - m_lastEdge;
+        }
+        __enable_irq();
+    }
+
+    /**
+        Sample side: publish the results when the gate time has elapsed.
+    **/
+    void Update(uint32_t cycle, bool asserted);
+
+    void GateSamples(uint32_t samples) {
+        m_gateSamples = samples;
+    }
+
+    uint32_t GateSamples() {
+        return m_gateSamples;
+    }
+
+    volatile const float &Frequency() {
+        return m_frequency;
+    }
+
+    volatile const float &Duty() {
+        return m_duty;
+    }
+
+    uint32_t Port() {
+        return m_port;
+    }
+
+    uint32_t PinMask() {
+        return m_pinMask;
+    }
+
+private:
+    uint32_t m_port;
+    uint32_t m_pinMask;
+    uint32_t m_gateSamples;
+    uint32_t m_gateCount;
+    // Asserting edges seen, and the timestamps of the first and last
+    uint32_t m_edges;
+    uint32_t m_firstEdge;
+    uint32_t m_lastEdge;
+    // Asserted time of the completed pulses, and of the pulse in progress
+    uint32_t m_highCycles;
+    uint32_t m_highPending;
+    // Published results in Hz and percent
+    volatile float m_frequency;
+    volatile float m_duty;
+};
+#endif
+
 /**
     \brief ClearCore input state access.
 
@@ -65,6 +294,13 @@ public:
     } InterruptTrigger;
 
 #ifndef HIDE_FROM_DOXYGEN
+    /**
+        Construct
+
+        \note Only the library's global instance should be constructed
+    **/
+    InputManager();
+
     /**
         Public accessor for singleton instance.
     **/
@@ -238,6 +474,64 @@ public:
         Main external interrupt handler.
     **/
     void EIC_Handler(uint8_t index);
+
+    /**
+        Attach an edge event queue to an external interrupt line and sense
+        both edges on it, or detach it with nullptr.
+    **/
+    bool EdgeQueueSet(int8_t extInt, InputEdgeQueue *queue);
+
+    /**
+        Attach a frequency meter to an external interrupt line and sense
+        both edges on it, or detach it with nullptr.
+    **/
+    bool FrequencyMeterSet(int8_t extInt, InputFrequencyMeter *meter);
+
+    /**
+        Route an external interrupt line to the event system instead of the
+        CPU, or return it to interrupt use. The trigger selects what the
+        event carries: the asserting edges by default, or the asserted level
+        with HIGH. While routed, the line cannot take an ISR, edge queue,
+        frequency meter, or a second event user.
+    **/
+    bool EventOutputSet(int8_t extInt, bool enable,
+                        InterruptTrigger trigger = RISING);
+
+    /**
+        Assign a port bit to a connector for filtering by UpdateFilters().
+        The bit is not filtered until DebounceEnable() is called.
+    **/
+    void DebounceAttach(uint32_t port, uint32_t pinMask, ClearCorePins pin,
+                        uint32_t ledMask);
+
+    /**
+        Start or stop filtering port bits. Enabled bits take their current
+        input value at the next sample.
+    **/
+    void DebounceEnable(uint32_t port, uint32_t pinMask, bool enable);
+
+    /**
+        Set the filter length of port bits, restarting their filters.
+    **/
+    void DebounceLength(uint32_t port, uint32_t pinMask, uint16_t samples);
+
+    /**
+        Have port bits take their current input value at the next sample.
+    **/
+    void DebounceExpire(uint32_t port, uint32_t pinMask);
+
+    /**
+        True until an expire requested with DebounceExpire() is applied.
+    **/
+    bool DebounceExpiring(uint32_t port, uint32_t pinMask) {
+        return m_debounce[port].Expiring() & pinMask;
+    }
+
+    /**
+        Filter every enabled input and publish the filtered register and
+        LED states. Runs each sample once the system is ready.
+    **/
+    void UpdateFilters();
 #endif
 private:
     // State of the unfiltered input port registers from the DSP.
@@ -264,13 +558,23 @@ private:
     voidFuncPtr m_interruptServiceRoutines[EIC_NUMBER_OF_INTERRUPTS];
     // Bitmask indicating which interrupt handlers disable after triggerring
     uint16_t m_oneTimeFlags;
+    // Edge event queues fed by the external interrupt handlers
+    InputEdgeQueue *m_edgeQueues[EIC_NUMBER_OF_INTERRUPTS];
+    // Frequency meters fed by the external interrupt handlers
+    InputFrequencyMeter *m_frequencyMeters[EIC_NUMBER_OF_INTERRUPTS];
+    // Bitmask of lines generating events for the event system
+    uint16_t m_eventLines;
+    // Bit-parallel input filters, one per port
+    VerticalDebounce m_debounce[CLEARCORE_PORT_MAX];
+    // Port bits filtered by m_debounce
+    uint32_t m_debounceEnabled[CLEARCORE_PORT_MAX];
+    // Connector and LED shift register mask of each port bit
+    int8_t m_debouncePin[CLEARCORE_PORT_MAX][32];
+    uint32_t m_debounceLed[CLEARCORE_PORT_MAX][32];
+    // DWT cycle count when the input ports were last sampled
+    uint32_t m_sampleCycle;
 
 #ifndef HIDE_FROM_DOXYGEN
-    /**
-        Construct
-    **/
-    InputManager();
-
     // Configure the addresses to read the inputs from
     void SetInputRegisters(volatile uint32_t *a,
                            volatile uint32_t *b,
@@ -281,6 +585,16 @@ private:
     **/
     uint32_t EicSense(InterruptTrigger trigger);
 
+    /**
+        Arm \a extInt to trigger on both edges for an edge consumer.
+    **/
+    void EicBothEdges(int8_t extInt);
+
+    /**
+        Disarm \a extInt unless something still needs its interrupts.
+    **/
+    void EicRelease(int8_t extInt);
+
 #endif // !HIDE_FROM_DOXYGEN
 }; // InputManager
 
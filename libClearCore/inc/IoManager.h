@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file IoManager.h
+    \brief Bulk output writes and consistent whole-board input snapshots.
+**/
+
+#ifndef __IOMANAGER_H__
+#define __IOMANAGER_H__
+
+#include <stdint.h>
+#include "AdcManager.h"
+#include "MotorDriver.h"
+#include "SysConnectors.h"
+#include "SysSingleton.h"
+
+namespace ClearCore {
+
+/**
+    \brief The state of the board's I/O as of a single sample time.
+
+    Every field is captured in the same sample-rate interrupt, so they are
+    consistent with one another.
+**/
+typedef struct {
+    /// The sample time (tick count) the snapshot was taken at.
+    uint32_t Sample;
+    /// Filtered state of the ClearCore digital inputs.
+    SysConnectorState Inputs;
+    /// Inputs that asserted at this sample time.
+    SysConnectorState Risen;
+    /// Inputs that deasserted at this sample time.
+    SysConnectorState Fallen;
+    /// Filtered ADC readings, indexed by AdcManager::AdcChannels.
+    uint16_t Analog[AdcManager::ADC_CHANNEL_COUNT];
+    /// Filtered state of the CCIO-8 inputs.
+    uint64_t CcioInputs;
+    /// CCIO-8 inputs that asserted at this sample time.
+    uint64_t CcioRisen;
+    /// CCIO-8 inputs that deasserted at this sample time.
+    uint64_t CcioFallen;
+    /// Commanded state of the CCIO-8 outputs.
+    uint64_t CcioOutputs;
+    /// HLFB state of each motor connector.
+    MotorDriver::HlfbStates HlfbState[MOTOR_CON_CNT];
+    /// HLFB PWM duty of each motor connector, in percent.
+    float HlfbPercent[MOTOR_CON_CNT];
+} IoSnapshot;
+
+/**
+    \brief Writes many outputs and reads many inputs at one sample time.
+
+    Setting eight outputs with eight State() calls puts the edges at eight
+    different times, and reading the inputs one connector at a time can mix
+    values from two different samples. The IoManager applies a whole set of
+    output changes at the start of the next sample time, with one write per
+    GPIO port, and publishes a snapshot of the inputs at the end of every
+    sample time.
+
+    Snapshots are published with a sequence lock rather than by disabling
+    interrupts, so reading one never delays the sample-rate interrupt.
+
+    \code{.cpp}
+    // Turn on IO-1 and IO-3 and turn off IO-2 together
+    IoMgr.OutputsWrite((1UL << CLEARCORE_PIN_IO1) | (1UL << CLEARCORE_PIN_IO2) |
+                       (1UL << CLEARCORE_PIN_IO3),
+                       (1UL << CLEARCORE_PIN_IO1) | (1UL << CLEARCORE_PIN_IO3));
+
+    IoSnapshot io;
+    IoMgr.Snapshot(io);
+    if (io.Inputs.bit.CLEARCORE_PIN_DI6 &&
+            io.HlfbState[0] == MotorDriver::HLFB_ASSERTED) {
+        // DI-6 is on and M-0 is in position in the same sample
+    }
+    \endcode
+**/
+class IoManager {
+    friend class SysManager;
+
+public:
+    /**
+        \brief Change several outputs at the next sample time.
+
+        Only connectors in Connector::OUTPUT_DIGITAL mode are changed; other
+        masked bits are ignored when the write is applied. Writes made before
+        the next sample time are merged, with later values taking precedence.
+        Like State(), the write cancels any pulses or output sequences on the
+        affected outputs.
+
+        \param[in] mask The ClearCore pins to change, one bit per
+        #ClearCorePins value. Only IO-0 through IO-5 may be set.
+        \param[in] value The new state of each pin in \a mask.
+        \param[in] ccioMask (optional) The CCIO-8 pins to change, one bit per
+        pin starting at #CLEARCORE_PIN_CCIOA0.
+        \param[in] ccioValue (optional) The new state of each pin in
+        \a ccioMask.
+        \return Success. Fails if \a mask selects a pin that is not an output,
+        or an output driven by a reflex link.
+    **/
+    bool OutputsWrite(uint32_t mask, uint32_t value,
+                      uint64_t ccioMask = 0, uint64_t ccioValue = 0);
+
+    /**
+        \brief True while a write from #OutputsWrite is waiting for the next
+        sample time.
+    **/
+    bool OutputsPending() {
+        return m_pendingMask || m_pendingCcioMask;
+    }
+
+    /**
+        \brief Copy the most recent I/O snapshot.
+
+        \param[out] snapshot Receives the snapshot.
+
+        \note Risen and Fallen only cover the single sample the snapshot was
+        taken at. Use InputManager::InputsRisen() and
+        InputManager::InputsFallen() to catch edges between polls.
+        \note Do not call from an interrupt with a higher priority than the
+        sample-rate interrupt.
+    **/
+    void Snapshot(IoSnapshot &snapshot);
+
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        \brief Constructor for IoManager
+
+        \note Should not be called by anything other than SysManager
+    **/
+    IoManager();
+
+    /**
+        Public accessor for singleton instance
+    **/
+    static IoManager &Instance();
+#endif
+
+private:
+    volatile uint32_t m_pendingMask;
+    volatile uint32_t m_pendingValue;
+    volatile uint64_t m_pendingCcioMask;
+    volatile uint64_t m_pendingCcioValue;
+
+    // Odd while the snapshot is being written
+    volatile uint32_t m_sequence;
+    IoSnapshot m_snapshot;
+    // Set once the first sample is in m_snapshot, so that sample does not
+    // report every asserted input as risen
+    bool m_snapshotValid;
+
+    /**
+        \brief Apply pending output writes. Called at the start of the
+        sample-rate interrupt.
+    **/
+    void UpdateBegin();
+
+    /**
+        \brief Publish the snapshot. Called at the end of the sample-rate
+        interrupt, once the inputs are updated.
+    **/
+    void UpdateEnd();
+}; // IoManager
+
+} // ClearCore namespace
+
+#endif // __IOMANAGER_H__
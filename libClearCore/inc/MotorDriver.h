@@ -418,6 +418,18 @@ public:
     **/
     virtual bool MoveVelocity(int32_t velocity) override;
 
+    /**
+        \copydoc StepGenerator::AnalogJog()
+    **/
+    virtual bool AnalogJog(AdcManager::AdcChannels channel, uint32_t velMax,
+                           uint32_t accelMax, uint16_t deadband = 0,
+                           JogCurves curve = JOG_CURVE_LINEAR) override;
+
+    /**
+        \copydoc StepGenerator::VelocityFollow()
+    **/
+    virtual bool VelocityFollow(uint32_t velMax, uint32_t accelMax) override;
+
     /**
         \brief Sets the filter length in samples. The default is 3 samples.
 
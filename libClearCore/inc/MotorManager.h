@@ -30,6 +30,7 @@
 #include <stdint.h>
 #include "HardwareMapping.h"
 #include "MotorDriver.h"
+#include "SysSingleton.h"
 
 namespace ClearCore {
 
@@ -86,6 +87,13 @@ public:
     } MotorPair;
 
 #ifndef HIDE_FROM_DOXYGEN
+    /**
+        Construct, wire in the Gclk and the mode control pins
+
+        \note Only the library's global instance should be constructed
+    **/
+    MotorManager();
+
     /**
         Public accessor for singleton instance.
     **/
@@ -159,11 +167,6 @@ private:
 
     bool m_initialized;
 
-    /**
-        Construct, wire in the Gclk and the mode control pins
-    **/
-    MotorManager();
-
     void PinMuxSet();
 };
 
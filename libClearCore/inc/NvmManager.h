@@ -30,6 +30,7 @@
 
 #include <stdint.h>
 #include <sam.h>
+#include "SysSingleton.h"
 
 #ifndef HIDE_FROM_DOXYGEN
 namespace ClearCore {
@@ -80,6 +81,17 @@ public:
 
     } NvmLocations;
 
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        \brief Constructor
+
+        Will initialize the page cache if not already done
+
+        \note Only the library's global instance should be constructed
+    **/
+    NvmManager();
+#endif
+
     /**
         Public accessor for singleton instance
     **/
@@ -237,13 +249,6 @@ private:
     uint8_t m_quadWordIndex;
     bool m_pageModified;
 
-    /**
-        \brief Constructor
-
-        Will initialize the page cache if not already done
-    **/
-    NvmManager();
-
     /**
         \brief Populates the nvmPageCache from NVM and sets m_cacheInitialized
         flag
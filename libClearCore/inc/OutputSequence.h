@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file OutputSequence.h
+    \brief Table-driven digital output sequences.
+
+    An output sequence is a table of (level, duration) steps that is played
+    on a digital output from the sample-rate interrupt. Sequences can loop,
+    and a second sequence can be queued to take over when the first one
+    finishes.
+**/
+
+#ifndef __OUTPUTSEQUENCE_H__
+#define __OUTPUTSEQUENCE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ClearCore {
+
+/**
+    \brief One step of an output sequence.
+
+    \code{.cpp}
+    // Open the valve for 250ms, pulse it 3 times at 10ms/10ms, then hold
+    const OutputSequenceStep dispense[] = {
+        {true, 250 * MS_TO_SAMPLES},
+        {false, 10 * MS_TO_SAMPLES}, {true, 10 * MS_TO_SAMPLES},
+        {false, 10 * MS_TO_SAMPLES}, {true, 10 * MS_TO_SAMPLES},
+        {false, 10 * MS_TO_SAMPLES}, {true, 10 * MS_TO_SAMPLES},
+    };
+    \endcode
+**/
+typedef struct {
+    /// The output state during this step.
+    bool Level;
+    /// The length of this step, in sample times. Must be at least 1.
+    uint32_t Samples;
+} OutputSequenceStep;
+
+#ifndef HIDE_FROM_DOXYGEN
+/**
+    \brief Plays an OutputSequenceStep table, one sample at a time.
+
+    Start() and Stop() must be called with interrupts disabled when the
+    sequencer is also being updated from the sample-rate interrupt.
+**/
+class OutputSequencer {
+public:
+    OutputSequencer()
+        : m_steps(NULL),
+          m_count(0),
+          m_loops(0),
+          m_loopsLeft(0),
+          m_index(0),
+          m_remaining(0),
+          m_nextSteps(NULL),
+          m_nextCount(0),
+          m_nextLoops(0),
+          m_level(false),
+          m_active(false) {}
+
+    /**
+        \brief Check that a table can be played.
+    **/
+    static bool Valid(const OutputSequenceStep *steps, uint16_t count) {
+        if (!steps || !count) {
+            return false;
+        }
+        for (uint16_t i = 0; i < count; i++) {
+            if (!steps[i].Samples) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+        \brief Start a sequence, or queue it behind the active one.
+
+        \return True if the sequence started now and the output should be
+        set to Level().
+    **/
+    bool Start(const OutputSequenceStep *steps, uint16_t count,
+               uint16_t loops, bool queue) {
+        if (queue && m_active) {
+            m_nextSteps = steps;
+            m_nextCount = count;
+            m_nextLoops = loops;
+            return false;
+        }
+        m_nextSteps = NULL;
+        Load(steps, count, loops);
+        return true;
+    }
+
+    /**
+        \brief Stop the sequence and drop any queued one.
+    **/
+    void Stop() {
+        m_active = false;
+        m_nextSteps = NULL;
+    }
+
+    /**
+        \brief True while a sequence is playing.
+    **/
+    bool Active() {
+        return m_active;
+    }
+
+    /**
+        \brief True while a sequence is waiting to follow the active one.
+    **/
+    bool Queued() {
+        return m_nextSteps != NULL;
+    }
+
+    /**
+        \brief The output state of the current step.
+    **/
+    bool Level() {
+        return m_level;
+    }
+
+    /**
+        \brief Advance by one sample time.
+
+        \return True if the output state changed.
+    **/
+    bool Update() {
+        if (!m_active || --m_remaining) {
+            return false;
+        }
+
+        bool lastLevel = m_level;
+        if (++m_index >= m_count) {
+            // End of a pass; a queued sequence takes over after the last
+            // pass, or after this one if the active sequence loops forever.
+            bool lastPass = m_loops && m_loopsLeft == 1;
+            if (m_nextSteps && (lastPass || !m_loops)) {
+                Load(m_nextSteps, m_nextCount, m_nextLoops);
+                m_nextSteps = NULL;
+                return m_level != lastLevel;
+            }
+            if (lastPass) {
+                // Done; the output holds the last step's state
+                m_active = false;
+                return false;
+            }
+            if (m_loops) {
+                m_loopsLeft--;
+            }
+            m_index = 0;
+        }
+        m_level = m_steps[m_index].Level;
+        m_remaining = m_steps[m_index].Samples;
+        return m_level != lastLevel;
+    }
+
+private:
+    const OutputSequenceStep *m_steps;
+    uint16_t m_count;
+    // Passes to play; 0 loops forever
+    uint16_t m_loops;
+    uint16_t m_loopsLeft;
+    uint16_t m_index;
+    uint32_t m_remaining;
+    const OutputSequenceStep *volatile m_nextSteps;
+    uint16_t m_nextCount;
+    uint16_t m_nextLoops;
+    bool m_level;
+    volatile bool m_active;
+
+    void Load(const OutputSequenceStep *steps, uint16_t count,
+              uint16_t loops) {
+        m_steps = steps;
+        m_count = count;
+        m_loops = loops;
+        m_loopsLeft = loops;
+        m_index = 0;
+        m_level = steps[0].Level;
+        m_remaining = steps[0].Samples;
+        m_active = true;
+    }
+};
+#endif // !HIDE_FROM_DOXYGEN
+
+} // ClearCore namespace
+
+#endif // __OUTPUTSEQUENCE_H__
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file PidLoop.h
+    \brief Fixed-point PID control loop executed at the sample rate.
+**/
+
+#ifndef __PIDLOOP_H__
+#define __PIDLOOP_H__
+
+#include <stdint.h>
+#include "AdcManager.h"
+
+namespace ClearCore {
+
+class DigitalInOut;
+class DigitalInOutAnalogOut;
+class DigitalInOutHBridge;
+class StepGenerator;
+
+/**
+    \brief A fixed-point PID controller that connects a ClearCore signal to
+    a ClearCore output.
+
+    Once added to the ControlLoopManager, the loop runs in the sample-rate
+    interrupt (every 200 microseconds), so its timing does not depend on the
+    main loop. Each update:
+    - reads the measurement from the configured source,
+    - computes proportional and integral action on the error and derivative
+      action on the filtered measurement (so setpoint changes do not kick),
+    - adds feed-forward from the setpoint,
+    - clamps the output to the limits, freezing the integrator while the
+      output is saturated in the direction of the error (anti-windup),
+    - writes the output to the configured sink.
+
+    Gains are given as floating point and converted once to Q16 fixed point;
+    the per-sample math is integer only.
+
+    \code{.cpp}
+    // Hold the pressure on A-9 at 2/3 of full scale using the IO-0 current
+    // output.
+    PidLoop pressureLoop;
+    pressureLoop.SourceAdc(AdcManager::ADC_AIN09);
+    pressureLoop.SinkDac(&ConnectorIO0);
+    pressureLoop.Gains(0.05, 2.0, 0);
+    pressureLoop.Setpoint(21845);
+    ControlLoopMgr.Add(pressureLoop);
+    pressureLoop.Enable(true);
+    \endcode
+**/
+class PidLoop {
+    friend class DigitalInOutHBridge;
+
+public:
+    /**
+        \enum Sources
+        \brief The measurement that the loop controls.
+    **/
+    typedef enum {
+        /** No source; the measurement is 0. **/
+        SOURCE_NONE,
+        /** A filtered ADC channel, in Q15 ADC units. **/
+        SOURCE_ADC,
+        /** The position of the encoder input, in counts. **/
+        SOURCE_ENCODER_POSITION,
+        /** The velocity of the encoder input, in counts per second. **/
+        SOURCE_ENCODER_VELOCITY,
+        /** The commanded position of a motor, in steps. **/
+        SOURCE_MOTOR_POSITION,
+        /** A user function. **/
+        SOURCE_CALLBACK,
+    } Sources;
+
+    /**
+        \enum Sinks
+        \brief Where the loop output is written.
+    **/
+    typedef enum {
+        /** No sink; the output is only available from Output(). **/
+        SINK_NONE,
+        /** The IO-0 analog output, 0 to 2047. **/
+        SINK_DAC,
+        /** A PWM output duty, 0 to 255. **/
+        SINK_PWM,
+        /** An H-bridge output, -32767 to 32767. **/
+        SINK_HBRIDGE,
+        /** A motor velocity move, in steps per second. **/
+        SINK_MOTOR_VELOCITY,
+        /** A user function. **/
+        SINK_CALLBACK,
+    } Sinks;
+
+    /** User source function; returns the measurement. **/
+    typedef int32_t (*SourceFunc)(void);
+    /** User sink function; receives the loop output. **/
+    typedef void (*SinkFunc)(int32_t output);
+
+    /**
+        \brief Construct a disabled loop with no source, sink or gains.
+    **/
+    PidLoop();
+
+    /**
+        \brief Measure a filtered ADC channel.
+
+        \param[in] adcChannel The ADC channel.
+        \return Success.
+    **/
+    bool SourceAdc(AdcManager::AdcChannels adcChannel);
+
+    /**
+        \brief Measure the encoder input position.
+    **/
+    void SourceEncoderPosition();
+
+    /**
+        \brief Measure the encoder input velocity.
+    **/
+    void SourceEncoderVelocity();
+
+    /**
+        \brief Measure the commanded position of a motor.
+
+        \param[in] motor The motor.
+        \return Success.
+    **/
+    bool SourceMotorPosition(StepGenerator *motor);
+
+    /**
+        \brief Measure the value returned by a function.
+
+        \param[in] source The function; runs in the sample-rate interrupt.
+        \return Success.
+    **/
+    bool SourceCallback(SourceFunc source);
+
+    /**
+        \brief Write the output to the IO-0 analog output.
+
+        The connector must be in analog output mode. Sets the output limits
+        to 0 and 2047. Written with
+        DigitalInOutAnalogOut::AnalogWriteNoWait(), so a sample is skipped
+        if the DAC is still busy with the last one.
+    **/
+    bool SinkDac(DigitalInOutAnalogOut *connector);
+
+    /**
+        \brief Write the output as a 16-bit PWM duty.
+
+        The connector must be in PWM output mode. Sets the output limits to
+        0 and 65535; see DigitalInOut::PwmFrequency() for the duty steps the
+        carrier supports.
+    **/
+    bool SinkPwm(DigitalInOut *connector);
+
+    /**
+        \brief Write the output to an H-bridge.
+
+        The connector must be in H-bridge mode. Sets the output limits to
+        -32767 and 32767.
+    **/
+    bool SinkHBridge(DigitalInOutHBridge *connector);
+
+    /**
+        \brief Command a motor velocity with the output, in step pulses per
+        second.
+
+        Binds the motor with StepGenerator::VelocityFollow(), so the loop
+        only updates the follow target and never issues a move from the
+        interrupt. Sets the output limits to -velMax and velMax. Any move
+        commanded on the motor releases the binding.
+
+        \param[in] motor The motor.
+        \param[in] velMax The largest commanded speed in step pulses/second.
+        \param[in] accelMax The acceleration limit in step pulses/second^2.
+        \return Success. Fails if \a velMax is 0 or the motor refuses the
+        binding.
+    **/
+    bool SinkMotorVelocity(StepGenerator *motor, uint32_t velMax,
+                           uint32_t accelMax);
+
+    /**
+        \brief Pass the output to a function.
+
+        \param[in] sink The function; runs in the sample-rate interrupt.
+    **/
+    bool SinkCallback(SinkFunc sink);
+
+    /**
+        \brief Set the PID gains.
+
+        \param[in] kp Proportional gain, output units per measurement unit.
+        \param[in] ki Integral gain, per second. Held with 24 fractional
+        bits per sample, so small gains are not truncated away.
+        \param[in] kd Derivative gain, in seconds.
+        \return Success. Fails if a gain does not fit in its fixed point
+        format at the sample rate.
+    **/
+    bool Gains(float kp, float ki, float kd);
+
+    /**
+        \brief Set the time constant of the derivative filter.
+
+        \param[in] samples The 99% rise time in samples; 0 disables the
+        filter.
+    **/
+    void DerivativeFilter(uint16_t samples);
+
+    /**
+        \brief Set the feed-forward added to the output.
+
+        output += gain * setpoint + offset
+
+        \return Success.
+    **/
+    bool FeedForward(float gain, int32_t offset);
+
+    /**
+        \brief Set the output limits.
+
+        \return Success. Fails if \a outMin is not less than \a outMax.
+    **/
+    bool OutputLimits(int32_t outMin, int32_t outMax);
+
+    /**
+        \brief Set the setpoint, in measurement units.
+    **/
+    void Setpoint(int32_t setpoint) {
+        m_setpoint = setpoint;
+    }
+
+    /**
+        \brief Get the setpoint.
+    **/
+    int32_t Setpoint() {
+        return m_setpoint;
+    }
+
+    /**
+        \brief Start or stop running the loop.
+
+        Enabling clears the integrator and derivative history. A disabled
+        loop leaves its sink at the last output.
+    **/
+    void Enable(bool enable);
+
+    /**
+        \brief Check whether the loop is running.
+    **/
+    bool Enabled() {
+        return m_enabled;
+    }
+
+    /**
+        \brief Clear the integrator and derivative history.
+    **/
+    void Reset();
+
+    /**
+        \brief The last output written to the sink.
+    **/
+    volatile const int32_t &Output() {
+        return m_output;
+    }
+
+    /**
+        \brief The last measurement read from the source.
+    **/
+    volatile const int32_t &Measurement() {
+        return m_measurement;
+    }
+
+    /**
+        \brief CPU cycles taken by the last update, including the source
+        and sink.
+    **/
+    volatile const uint32_t &CyclesLast() {
+        return m_cyclesLast;
+    }
+
+    /**
+        \brief Most CPU cycles taken by any update since the last call to
+        CyclesMaxReset().
+    **/
+    volatile const uint32_t &CyclesMax() {
+        return m_cyclesMax;
+    }
+
+    /**
+        \brief Clear the maximum update cycles.
+    **/
+    void CyclesMaxReset() {
+        m_cyclesMax = 0;
+    }
+
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        \brief Run one update of the loop. Called by ControlLoopManager.
+    **/
+    void Update();
+#endif
+
+private:
+    Sources m_source;
+    Sinks m_sink;
+    AdcManager::AdcChannels m_adcChannel;
+    // The source or sink object, depending on the type
+    void *m_sourceObj;
+    void *m_sinkObj;
+    SourceFunc m_sourceFunc;
+    SinkFunc m_sinkFunc;
+
+    // Q16 gains, scaled to the sample time; the integral gain is Q24
+    int32_t m_kp;
+    int32_t m_ki;
+    int32_t m_kd;
+    int32_t m_ffGain;
+    int32_t m_ffOffset;
+    // Derivative filter constant, Q15
+    uint16_t m_dTc;
+
+    int32_t m_outMin;
+    int32_t m_outMax;
+    int32_t m_setpoint;
+
+    bool m_enabled;
+    bool m_primed;
+    // Q24, scaled like the integral gain
+    int64_t m_integral;
+    int32_t m_lastMeasurement;
+    int32_t m_derivative;
+
+    volatile int32_t m_output;
+    volatile int32_t m_measurement;
+    volatile uint32_t m_cyclesLast;
+    volatile uint32_t m_cyclesMax;
+
+    bool SinkSet(Sinks sink, void *obj, int32_t outMin, int32_t outMax);
+    int32_t SourceRead();
+    void SinkWrite(int32_t output);
+
+    /**
+        Convert PI gains to fixed point at the sample time: kp in Q16, and
+        the per-sample ki in Q24. Returns false if either does not fit.
+    **/
+    static bool PiGains(float kp, float ki, int32_t &kpQ16, int32_t &kiQ24);
+
+    /**
+        One fixed-point PI step. The Q16 extra term (derivative and feed
+        forward) is added to the output before it is clamped to
+        [outMin, outMax]. The Q24 integral is clamped to the same range and
+        is only kept when it does not push further into saturation.
+    **/
+    static int32_t PiStep(int32_t kp, int32_t ki, int64_t &integral,
+                          int32_t error, int64_t extraQ16,
+                          int32_t outMin, int32_t outMax);
+};
+
+} // ClearCore namespace
+
+#endif // __PIDLOOP_H__
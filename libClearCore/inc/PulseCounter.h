@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file PulseCounter.h
+    \brief ClearCore hardware pulse counter object.
+
+    Counts the asserting edges of one interrupt-capable digital input in a
+    hardware timer, without any per-edge CPU load.
+**/
+
+
+#ifndef __PULSE_COUNTER_H__
+#define __PULSE_COUNTER_H__
+
+#include <stdint.h>
+#include "SysConnectors.h"
+
+/// The timer the pulse counter counts events with
+#define PULSE_COUNTER_TC TC7
+
+namespace ClearCore {
+
+/**
+    \brief ClearCore hardware pulse counter.
+
+    A connector put into #INPUT_COUNTER mode has its external interrupt
+    line routed through the event system into a TC in count mode, so edges
+    are counted in hardware up to the EIC's edge detection rate and
+    regardless of the connector's input filter. The sample interrupt
+    extends the count to 64 bits, computes the count rate and drives the
+    compare output.
+
+    Only one connector, from DI-6 through A-12, can use the counter at a
+    time. While counting, that connector cannot also take an interrupt
+    handler, edge event queue, or frequency measurement.
+
+    \code{.cpp}
+    ConnectorDI6.Mode(Connector::INPUT_COUNTER);
+    CounterIn.CompareValue(1000);
+    CounterIn.CompareOutput(CLEARCORE_PIN_IO0);
+    \endcode
+**/
+class PulseCounter {
+    friend class SysManager;
+    friend class DigitalIn;
+
+public:
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        Construct
+    **/
+    PulseCounter(uint8_t evsysChannel);
+#endif
+
+    /**
+        \brief Read the number of pulses counted.
+
+        \code{.cpp}
+        if (CounterIn.Count() > 100000) {
+            // Passed 100000 pulses, do something.
+        }
+        \endcode
+
+        \return The pulse count.
+    **/
+    int64_t Count();
+
+    /**
+        \brief Preset the pulse count.
+
+        \code{.cpp}
+        // Zero the count at the start of a batch
+        CounterIn.Count(0);
+        \endcode
+
+        \param[in] preset The new count.
+    **/
+    void Count(int64_t preset);
+
+    /**
+        \brief The count rate in pulses per second, averaged over the last
+        rate gate.
+
+        \code{.cpp}
+        float litersPerMinute = CounterIn.Rate() * 60 / pulsesPerLiter;
+        \endcode
+
+        \return The averaged count rate.
+    **/
+    volatile const float &Rate() {
+        return m_rate;
+    }
+
+    /**
+        \brief Set the gate time the count rate is averaged over.
+        The default is 100 ms.
+
+        \param[in] gateMs The gate time in milliseconds, from 1 to 60000.
+        \return True if the gate time was valid.
+    **/
+    bool RateGate(uint16_t gateMs);
+
+    /**
+        \brief Get the count rate gate time in milliseconds.
+    **/
+    uint16_t RateGate();
+
+    /**
+        \brief The number of pulses counted in the last sample time.
+    **/
+    volatile const uint16_t &CountsLastSample() {
+        return m_countsLast;
+    }
+
+    /**
+        \brief Set the count at which the compare output asserts.
+
+        The compare output is asserted while the count is greater than or
+        equal to the compare value.
+
+        \code{.cpp}
+        // Assert the compare output after 500 pulses
+        CounterIn.Count(0);
+        CounterIn.CompareValue(500);
+        \endcode
+
+        \param[in] value The compare value.
+    **/
+    void CompareValue(int64_t value);
+
+    /**
+        \brief Get the compare value.
+    **/
+    int64_t CompareValue();
+
+    /**
+        \brief The compare output's state, as of the last sample time.
+
+        \return True if the count has reached the compare value.
+    **/
+    volatile const bool &CompareReached() {
+        return m_compareReached;
+    }
+
+    /**
+        \brief Drive a digital output with the compare output's state.
+
+        The output is written in the sample time the compare state changes,
+        so it follows the count to within one sample time. A write made to
+        the pin in between holds until the next change.
+
+        \code{.cpp}
+        ConnectorIO0.Mode(Connector::OUTPUT_DIGITAL);
+        CounterIn.CompareOutput(CLEARCORE_PIN_IO0);
+        \endcode
+
+        \param[in] pin IO-0 through IO-5 or a CCIO-8 pin, or
+        CLEARCORE_PIN_INVALID to stop driving an output.
+        \return True if the pin was valid; false if it is not a digital
+        output pin, is driven by a reflex link, or is running a sequence.
+    **/
+    bool CompareOutput(ClearCorePins pin);
+
+    /**
+        \brief Get the pin driven by the compare output.
+
+        \return The compare output pin, or CLEARCORE_PIN_INVALID.
+    **/
+    ClearCorePins CompareOutput() {
+        return m_compareOutputPin;
+    }
+
+    /**
+        \brief The connector being counted.
+
+        \return The connector in #INPUT_COUNTER mode, or
+        CLEARCORE_PIN_INVALID if the counter is unused.
+    **/
+    ClearCorePins InputConnector() {
+        return m_inputPin;
+    }
+
+private:
+    uint8_t m_evsysChannel;
+    volatile ClearCorePins m_inputPin;
+    int8_t m_extInt;
+    uint16_t m_hwCount;
+    volatile uint16_t m_countsLast;
+    // 64-bit values are read and written with interrupts blocked
+    int64_t m_count;
+    int64_t m_compareValue;
+    volatile bool m_compareReached;
+    ClearCorePins m_compareOutputPin;
+    // Count rate calculation
+    int64_t m_gateStartCount;
+    uint32_t m_gateSamples;
+    uint32_t m_gateCount;
+    volatile float m_rate;
+
+    /**
+        Set up the timer; it is left stopped until a connector attaches.
+    **/
+    void Initialize();
+
+    /**
+        Drive the compare output pin, if any, to the given state.
+    **/
+    void CompareOutputWrite(bool state);
+
+    /**
+        Extend the hardware count, update the rate and compare output.
+    **/
+    void Update();
+
+    /**
+        Route a connector's external interrupt line into the timer.
+    **/
+    bool Attach(ClearCorePins pin, int8_t extInt);
+
+    /**
+        Stop counting the connector, if it is the one being counted.
+    **/
+    void Detach(ClearCorePins pin);
+}; // PulseCounter
+
+} // ClearCore namespace
+
+#endif /* __PULSE_COUNTER_H__ */
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file ReflexManager.h
+    \brief Input-to-output reflex links run by the event system.
+
+    Links an interrupt-capable input to an output through the event system,
+    so the output reacts to the input in hardware, without the CPU.
+**/
+
+#ifndef __REFLEXMANAGER_H__
+#define __REFLEXMANAGER_H__
+
+#include <stdint.h>
+#include "SysConnectors.h"
+
+/// Event system channels used by the reflex links
+#define REFLEX_EVSYS_CHANNELS 5
+
+/// Longest reflex pulse, in microseconds
+#define REFLEX_PULSE_MAX_US 30000000UL
+
+namespace ClearCore {
+
+/**
+    \brief ClearCore input-to-output reflex links.
+
+    A reflex link connects the external interrupt line of DI-6 through A-12
+    to one of the outputs IO-0 through IO-5 through the event system. Once
+    linked, the output reacts to the input within a few clock cycles, with
+    no interrupt or sample-time delay, and keeps working if the application
+    stalls.
+
+    A #REFLEX_PULSE link fires a retriggerable one-shot pulse in the
+    output's timer on each asserting edge of the input. Any of IO-0 through
+    IO-5 can pulse, but the outputs are paired on timers (IO-0 and IO-1,
+    IO-2 and IO-3, IO-4 and IO-5), so while one output of a pair is pulsing
+    the other cannot output PWM or be pulse linked itself.
+
+    The logic links (#REFLEX_FOLLOW, #REFLEX_INVERT, #REFLEX_AND and
+    #REFLEX_OR) are built from the configurable custom logic (CCL) lookup
+    tables, so the output must be on a pin with a CCL output. On ClearCore
+    only IO-3 has one.
+
+    Each input can feed one link, and while linked it cannot also take an
+    interrupt handler, edge event queue, frequency measurement, or the pulse
+    counter. The input's filter does not apply to the link. Linked inputs
+    must stay in Connector::INPUT_DIGITAL mode, and a linked output must be
+    in Connector::OUTPUT_DIGITAL mode and cannot change mode until it is
+    unlinked. Writes to a linked output fail: State(), output pulses and
+    output sequences are refused, and IoManager::OutputsWrite() returns
+    false if its mask includes the output.
+
+    \code{.cpp}
+    // Blank the laser gate on IO-3 whenever the light curtain on DI-6 is
+    // interrupted: IO-3 is on while DI-6 is off.
+    ConnectorIO3.Mode(Connector::OUTPUT_DIGITAL);
+    ReflexMgr.Link(CLEARCORE_PIN_IO3, ReflexManager::REFLEX_INVERT,
+                   CLEARCORE_PIN_DI6);
+
+    // Fire a 150us strobe on IO-1 on each DI-7 sync edge
+    ConnectorIO1.Mode(Connector::OUTPUT_DIGITAL);
+    ReflexMgr.Link(CLEARCORE_PIN_IO1, ReflexManager::REFLEX_PULSE,
+                   CLEARCORE_PIN_DI7, CLEARCORE_PIN_INVALID, 150);
+    \endcode
+**/
+class ReflexManager {
+public:
+    /**
+        \enum ReflexModes
+
+        \brief How a linked output responds to its inputs.
+    **/
+    typedef enum {
+        /**
+            Not linked.
+        **/
+        REFLEX_NONE,
+        /**
+            The output is on while input A is asserted.
+        **/
+        REFLEX_FOLLOW,
+        /**
+            The output is on while input A is not asserted.
+        **/
+        REFLEX_INVERT,
+        /**
+            The output is on while inputs A and B are both asserted.
+        **/
+        REFLEX_AND,
+        /**
+            The output is on while input A or input B is asserted.
+        **/
+        REFLEX_OR,
+        /**
+            The output turns on for a set time on each asserting edge of
+            input A. An edge during the pulse restarts the pulse.
+        **/
+        REFLEX_PULSE,
+    } ReflexModes;
+
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        \brief Construct the reflex links on a block of event system
+        channels.
+
+        \param[in] evsysChannel The first of #REFLEX_EVSYS_CHANNELS event
+        system channels to use.
+    **/
+    ReflexManager(uint8_t evsysChannel);
+#endif
+
+    /**
+        \brief Link an output to one or two inputs.
+
+        The link is checked against the peripheral routing of the connectors:
+        each input needs an external interrupt line, a pulse output needs a
+        timer, and a logic output needs a CCL output.
+
+        \param[in] output The output connector, IO-0 through IO-5.
+        \param[in] mode How the output responds.
+        \param[in] inputA The input connector, DI-6 through A-12.
+        \param[in] inputB (optional) The second input for #REFLEX_AND and
+        #REFLEX_OR; must differ from \a inputA.
+        \param[in] pulseUs (optional) The pulse length for #REFLEX_PULSE,
+        from 1 to #REFLEX_PULSE_MAX_US microseconds. The resolution is about
+        0.5us for pulses up to 32ms and coarser beyond.
+
+        \return Success. Fails if the output is already linked, the
+        connectors are not valid for \a mode, or a resource the link needs
+        is in use.
+    **/
+    bool Link(ClearCorePins output, ReflexModes mode, ClearCorePins inputA,
+              ClearCorePins inputB = CLEARCORE_PIN_INVALID,
+              uint32_t pulseUs = 0);
+
+    /**
+        \brief Remove the link driving an output.
+
+        The output is returned to software control and set to off, and its
+        inputs are released.
+
+        \param[in] output The output connector.
+    **/
+    void Unlink(ClearCorePins output);
+
+    /**
+        \brief The mode of the link driving an output.
+
+        \param[in] output The output connector.
+        \return The link mode, or #REFLEX_NONE if not linked.
+    **/
+    ReflexModes LinkMode(ClearCorePins output);
+
+private:
+    static const uint8_t OUTPUT_CNT = CLEARCORE_PIN_IO5 + 1;
+
+    uint8_t m_evsysChannel;
+    ReflexModes m_mode[OUTPUT_CNT];
+    int8_t m_extIntA[OUTPUT_CNT];
+    int8_t m_extIntB[OUTPUT_CNT];
+    // PWM carrier of the timer before a pulse link took it
+    uint32_t m_pwmFrequency[OUTPUT_CNT];
+    bool m_pwmWide[OUTPUT_CNT];
+    uint8_t m_drvCtrl[OUTPUT_CNT];
+
+    /**
+        \brief The external interrupt line of a connector that can feed a
+        link, or -1.
+    **/
+    int8_t InputLine(ClearCorePins input);
+
+    bool LinkPulse(ClearCorePins output, int8_t extInt, uint32_t pulseUs);
+    bool LinkLogic(ClearCorePins output, ReflexModes mode, int8_t extIntA,
+                   int8_t extIntB);
+    void UnlinkPulse(ClearCorePins output);
+    void UnlinkLogic(ClearCorePins output);
+}; // ReflexManager
+
+} // ClearCore namespace
+
+#endif // __REFLEXMANAGER_H__
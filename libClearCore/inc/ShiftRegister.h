@@ -53,6 +53,7 @@ class ShiftRegister {
     friend class DigitalInOut;
     friend class DigitalInOutHBridge;
     friend class CcioBoardManager;
+    friend class InputManager;
     friend class LedDriver;
     friend class MotorDriver;
     friend class MotorManager;
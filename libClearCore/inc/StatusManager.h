@@ -26,6 +26,7 @@
 #include "ShiftRegister.h"
 #include "BlinkCodeDriver.h"
 #include "SysConnectors.h"
+#include "SysSingleton.h"
 
 namespace ClearCore {
 
@@ -144,6 +145,21 @@ public:
     };
 
 #ifndef HIDE_FROM_DOXYGEN
+    /**
+        \brief Constructor for StatusManager
+
+        \note Only the library's global instance should be constructed
+    **/
+    StatusManager()
+        : m_statusRegSinceStartup(),
+          m_statusRegRT(),
+          m_statusRegAccum(),
+          m_statusRegRisen(),
+          m_statusRegFallen(),
+          m_faultLed(ShiftRegister::SR_NO_FEEDBACK_MASK),
+          m_disableMotors(false),
+          m_hbridgeResetting(false) {}
+
     /**
         Public accessor for singleton instance
     **/
@@ -496,16 +512,6 @@ private:
     bool m_disableMotors;
     volatile bool m_hbridgeResetting;
 
-    StatusManager()
-        : m_statusRegSinceStartup(),
-          m_statusRegRT(),
-          m_statusRegAccum(),
-          m_statusRegRisen(),
-          m_statusRegFallen(),
-          m_faultLed(ShiftRegister::SR_NO_FEEDBACK_MASK),
-          m_disableMotors(false),
-          m_hbridgeResetting(false) {}
-
     /**
         Activate a blink code.
 
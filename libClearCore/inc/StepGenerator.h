@@ -33,6 +33,7 @@
 #define __STEPGENERATOR_H__
 
 #include <stdint.h>
+#include "AdcManager.h"
 
 namespace ClearCore {
 
@@ -67,6 +68,22 @@ public:
         MOVE_TARGET_REL_END_POSN,
     } MoveTarget;
 
+    /**
+        \enum JogCurves
+
+        \brief Shapes of the stick deflection to velocity mapping used by
+        AnalogJog().
+    **/
+    typedef enum {
+        /// Velocity is proportional to the deflection.
+        JOG_CURVE_LINEAR = 1,
+        /// Velocity follows the square of the deflection for finer control
+        /// near center.
+        JOG_CURVE_SQUARE,
+        /// Velocity follows the cube of the deflection.
+        JOG_CURVE_CUBE,
+    } JogCurves;
+
     /**
         \brief Issues a positional move for the specified distance.
 
@@ -136,6 +153,100 @@ public:
     **/
     void MoveStopDecel(uint32_t decelMax = 0);
 
+    /**
+        \brief Binds the velocity of this generator to an analog input.
+
+        Every sample the filtered reading of the analog input is compared to
+        the jog center (see AnalogJogCenter()). Deflections within the
+        deadband command zero velocity. Outside of the deadband the remaining
+        deflection is scaled to 0..1, shaped by the selected curve and
+        multiplied by velMax. The commanded velocity is slewed toward that
+        target at no more than accelMax, reversing direction through zero.
+
+        The binding runs entirely in the sample interrupt; no main loop calls
+        are needed while jogging. Any Move(), MoveVelocity(), MoveStopAbrupt()
+        or MoveStopDecel() call (including those issued internally for
+        E-stop or travel limits) releases the binding.
+
+        \code{.cpp}
+        // Jog M-0 from a 0-10V joystick on A-9: 20000 pulses/sec at full
+        // deflection, 2% deadband, quadratic response
+        ConnectorM0.AnalogJog(AdcManager::ADC_AIN09, 20000, 100000, 655,
+                              StepGenerator::JOG_CURVE_SQUARE);
+        \endcode
+
+        \param[in] channel The ADC channel supplying the jog command.
+        \param[in] velMax The velocity at full deflection in step
+        pulses/second.
+        \param[in] accelMax The acceleration limit in step pulses/second^2.
+        \param[in] deadband Half-width of the zero band around the center,
+        in Q15 ADC units (the units of AdcManager::FilteredResult()).
+        \param[in] curve The deflection to velocity curve.
+
+        \return True if the binding was accepted.
+    **/
+    virtual bool AnalogJog(AdcManager::AdcChannels channel, uint32_t velMax,
+                           uint32_t accelMax, uint16_t deadband = 0,
+                           JogCurves curve = JOG_CURVE_LINEAR);
+
+    /**
+        \brief Sets the analog reading that corresponds to zero velocity.
+
+        Defaults to mid-scale (16384), the center of a 0-10V joystick on a
+        0-10V input. The deflection is normalized separately on each side of
+        the center so an off-center joystick still reaches velMax at both
+        ends of travel.
+
+        \param[in] center The center reading in Q15 ADC units.
+    **/
+    void AnalogJogCenter(uint16_t center) {
+        m_jogCenter = center;
+    }
+
+    /**
+        \brief Releases the analog jog binding and ramps to a stop at the jog
+        acceleration limit.
+    **/
+    void AnalogJogStop();
+
+    /**
+        \brief Check whether the analog jog binding is active.
+
+        \return True if the velocity is bound to an analog input.
+    **/
+    volatile const bool &AnalogJogActive() {
+        return m_jogActive;
+    }
+
+    /**
+        \brief Binds the velocity of this generator to a target that may be
+        updated from an interrupt.
+
+        This works like AnalogJog(), with the target velocity taken from the
+        last VelocityFollowTarget() call instead of an analog input. The
+        target starts at zero. The commanded velocity is slewed toward the
+        target at no more than accelMax, reversing direction through zero.
+        The same calls that release an analog jog release this binding, and
+        AnalogJogActive() reports it.
+
+        \param[in] velMax The largest target speed in step pulses/second.
+        \param[in] accelMax The acceleration limit in step pulses/second^2.
+
+        \return True if the binding was accepted.
+    **/
+    virtual bool VelocityFollow(uint32_t velMax, uint32_t accelMax);
+
+    /**
+        \brief Sets the target velocity of a VelocityFollow() binding.
+
+        Only stores the target, so it may be called from the sample-rate
+        interrupt, e.g. by a PidLoop. Targets beyond the velMax of the binding
+        are clamped to it.
+
+        \param[in] velocity The target velocity in step pulses/second.
+    **/
+    void VelocityFollowTarget(int32_t velocity);
+
     /**
         \brief Sets the absolute commanded position to the given value.
 
@@ -334,11 +445,25 @@ private:
     bool m_moveDirChange;     // The move is changing direction
     bool m_dirCommanded;      // The direction of the commanded move
 
+    // Analog jog binding
+    volatile bool m_jogActive;
+    AdcManager::AdcChannels m_jogChannel;
+    JogCurves m_jogCurve;
+    uint16_t m_jogCenter;
+    uint16_t m_jogDeadband;
+    int32_t m_jogVelMaxQx;
+    int32_t m_jogAccelQx;
+    // Velocity follow binding, sharing the jog slew
+    bool m_jogFollow;
+    volatile int32_t m_jogTargetQx;
 
     // All of the position, velocity and acceleration parameters are signed and
     // in Q format, with all arithmetic performed in fixed point.
     // FRACT_BITS defines the Q value - the number of bits that are treated as
-    // fractional values.
+    // fractional values. Conversions go through the Q16_15 and Q48_15 types
+    // of FixedPoint.h. The members stay plain integers because the move
+    // states detect overflow by the sign of a wrapped sum, which saturating
+    // arithmetic would hide.
 
     int32_t m_velLimitQx;     // Velocity limit
     int32_t m_altVelLimitQx;  // Velocity move Velocity limit
@@ -363,6 +488,9 @@ private:
 
     void AltVelMax(int32_t velMax);
 
+    int32_t JogAnalogTarget(bool &negative);
+    void JogCalculated();
+
     /**
         \brief Private helper function for Move functions to call that
         updates the internal vel/accel limits to those set by the user.
@@ -73,6 +73,33 @@ public:
         RESET_TO_BOOTLOADER,
     } ResetModes;
 
+    /**
+        \brief RAM usage and headroom information.
+
+        \note The main loop and all interrupts share a single stack, so the
+        stack figures include the worst case interrupt nesting seen so far.
+    **/
+    typedef struct {
+        /// Bytes of RAM used by initialized and zeroed static data.
+        uint32_t StaticBytes;
+        /// Bytes of RAM given to the heap so far.
+        uint32_t HeapArenaBytes;
+        /// Bytes of the heap arena currently allocated.
+        uint32_t HeapUsedBytes;
+        /// Bytes of the heap arena currently free for reuse.
+        uint32_t HeapFreeBytes;
+        /// Number of free blocks in the heap arena; a measure of
+        /// fragmentation.
+        uint32_t HeapFreeBlocks;
+        /// Bytes of stack in use by the caller.
+        uint32_t StackUsedBytes;
+        /// Most bytes of stack ever used since power-up.
+        uint32_t StackMaxUsedBytes;
+        /// Least amount of unused RAM ever seen between the top of the heap
+        /// and the bottom of the stack.
+        uint32_t HeadroomBytes;
+    } MemoryDiagnostics;
+
 #ifndef HIDE_FROM_DOXYGEN
     /**
         Constructor
@@ -124,6 +151,84 @@ public:
     **/
     void ResetBoard(ResetModes mode = RESET_NORMAL);
 
+    /**
+        \brief Gather the current RAM usage of the application.
+
+        The unused RAM between the heap and the stack is filled with a known
+        pattern at startup. The stack high-water mark is found by searching
+        for the deepest word that no longer holds the pattern.
+
+        \code{.cpp}
+        SysManager::MemoryDiagnostics mem;
+        SysMgr.GetMemoryDiagnostics(mem);
+        if (mem.HeadroomBytes < 1024) {
+            // Running low on RAM
+        }
+        \endcode
+
+        \param[out] diagnostics The current RAM usage.
+
+        \note The search for the stack high-water mark may take up to a few
+        milliseconds when there is a lot of unused RAM.
+    **/
+    void GetMemoryDiagnostics(MemoryDiagnostics &diagnostics);
+
+    /**
+        \brief The number of CPU cycles spent starting up the board.
+
+        Counts from the reset handler through the static constructors and
+        the board initialization, up to the call to main(). The CPU runs
+        from the 48 MHz startup clock until the board initialization
+        switches to 120 MHz, so this is a cycle count rather than a time.
+
+        \return The startup cycle count.
+    **/
+    uint32_t StartupCycles();
+
+    /**
+        \brief Enable or disable the Cortex-M cache controller (CMCC).
+
+        The cache is enabled at startup. Disabling it makes every instruction
+        fetch and flash read pay the flash wait states, which makes execution
+        time slower but more repeatable.
+
+        \param[in] enable True to enable the cache, false to disable it.
+    **/
+    void CacheEnable(bool enable);
+
+    /**
+        \brief Accessor for the cache controller state.
+
+        \return True if the cache is enabled.
+    **/
+    bool CacheEnabled();
+
+    /**
+        \brief Invalidate all lines of the cache.
+
+        The cache is briefly disabled while it is invalidated.
+    **/
+    void CacheInvalidate();
+
+    /**
+        \brief Lock ways of the 4-way cache so that their contents are not
+        replaced.
+
+        To keep a piece of code resident, lock every way except one, run the
+        code to load it into the remaining way, then lock that way as well.
+
+        \code{.cpp}
+        // Keep way 0 free for loading, lock ways 1-3
+        SysMgr.CacheWaysLock(0xE);
+        // ... run the code to be kept in the cache ...
+        SysMgr.CacheWaysLock(0xF);
+        \endcode
+
+        \param[in] wayMask Bit mask of the ways to lock; bit N locks way N.
+        Pass zero to unlock all ways.
+    **/
+    void CacheWaysLock(uint8_t wayMask);
+
 #ifndef HIDE_FROM_DOXYGEN
     // Ideally these would be private, but they need to be called from C
     // interrupt handler functions that can't be friends without putting them
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file SysSingleton.h
+    \brief Storage selection for the ClearCore manager singletons.
+
+    By default each manager is allocated from the heap the first time its
+    Instance() accessor is called, and is reached through a global reference
+    such as InputMgr. Defining CLEARCORE_STATIC_SINGLETONS for the library
+    build instead defines each manager as a plain global object. This keeps
+    the heap allocator out of startup, lets the linker account for the
+    managers' RAM, and lets the sample-rate code address a manager's members
+    directly instead of first loading the reference.
+
+    The manager constructors are public so that the static globals can be
+    defined. In the default heap build nothing stops a second manager of the
+    same type from being constructed, so the single instance is only kept by
+    convention: the application must use the global names and never
+    construct a manager itself.
+
+    The manager globals change type with this setting, so the application
+    must be built with the same CLEARCORE_STATIC_SINGLETONS setting as the
+    library.
+
+    CLEARCORE_SINGLETON_SECTION may also be defined as a section attribute to
+    gather the managers in one place, e.g.
+    __attribute__((section(".bss.singletons"))). The section name must be
+    matched by a RAM output section of the linker script.
+**/
+
+#ifndef __SYSSINGLETON_H__
+#define __SYSSINGLETON_H__
+
+#ifndef HIDE_FROM_DOXYGEN
+
+#ifdef CLEARCORE_STATIC_SINGLETONS
+#ifndef CLEARCORE_SINGLETON_SECTION
+#define CLEARCORE_SINGLETON_SECTION
+#endif
+
+/**
+    The type of the global name a manager of type T is declared with.
+**/
+#define SINGLETON_REF(T) T
+
+/**
+    Define the global manager NAME of type T and T's Instance() accessor.
+**/
+#define SINGLETON_DEFINE(T, NAME)                                              \
+    T NAME CLEARCORE_SINGLETON_SECTION;                                        \
+    T &T::Instance() {                                                         \
+        return NAME;                                                           \
+    }
+#else
+#define SINGLETON_REF(T) T &
+
+#define SINGLETON_DEFINE(T, NAME)                                              \
+    T &NAME = T::Instance();                                                   \
+    T &T::Instance() {                                                         \
+        static T *instance = new T();                                          \
+        return *instance;                                                      \
+    }
+#endif // CLEARCORE_STATIC_SINGLETONS
+
+#endif // !HIDE_FROM_DOXYGEN
+
+#endif // __SYSSINGLETON_H__
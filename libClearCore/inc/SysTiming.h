@@ -30,12 +30,16 @@
 #define __SYSTIMING_H__
 
 #include <stdint.h>
+#include "SysSingleton.h"
 
 /** Number of CPU cycles, in Hz. (120MHz) **/
 #ifndef CPU_CLK
 #define CPU_CLK 120000000
 #endif // CPU_CLK
 
+/** Clock of the connector output and HLFB TCs, in Hz. (2.048MHz) **/
+#define TC_CLK 2048000UL
+
 /**
     ClearCore sample rate for main interrupt processing (5 kHz).
 **/
@@ -101,6 +105,13 @@ public:
     **/
     void GetIsrLoading(uint32_t &minSlot, uint32_t &maxSlot);
 
+    /**
+        Constructor
+
+        \note Only the library's global instance should be constructed
+    **/
+    SysTiming();
+
     /**
         Public accessor for singleton instance
     **/
@@ -213,11 +224,6 @@ private:
     uint32_t m_microAdjLowRemainder;
 
 
-    /**
-        Constructor
-    **/
-    SysTiming();
-
     /**
         \brief Signal the start of the main interrupt service routine
 
@@ -187,6 +187,18 @@ while (GCLK->SYNCBUSY.reg & GCLK_SYNCBUSY_GENCTRL((GCLK_INDEX))) {             \
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 #endif
 
+/**
+    Mark a function that runs every sample time. When the library is built
+    with CLEARCORE_HOT_CODE_IN_RAM defined, the function is placed in SRAM
+    (copied from flash at startup along with the initialized data) so that
+    it runs without flash wait states or cache misses.
+**/
+#ifdef CLEARCORE_HOT_CODE_IN_RAM
+#define HOT_ISR_FUNC __attribute__((section(".ramfunc"), noinline))
+#else
+#define HOT_ISR_FUNC
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -43,6 +43,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <sam.h>
+#include "SysSingleton.h"
 
 // extern "C" {
 //     #include "cdcdf_acm.h"
@@ -179,6 +180,13 @@ class UsbManager {
     friend class SysManager;
 public:
 #ifndef HIDE_FROM_DOXYGEN
+    /**
+        \brief Constructor for UsbManager
+
+        \note Only the library's global instance should be constructed
+    **/
+    UsbManager();
+
     /**
         Public accessor for singleton instance
     **/
@@ -248,8 +256,6 @@ public:
         return m_lineState;
     }
 
-    UsbManager();
-
 private:
 
     void Refresh();
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file VerticalDebounce.h
+    \brief Bit-parallel input debounce using vertical counters.
+
+    Filters up to 32 inputs at once. Each input has its own stability count,
+    stored one bit per "plane" word, so counting and comparing every input
+    takes a handful of bitwise operations per plane.
+**/
+
+#ifndef __VERTICALDEBOUNCE_H__
+#define __VERTICALDEBOUNCE_H__
+
+#include <stdint.h>
+
+#ifndef HIDE_FROM_DOXYGEN
+namespace ClearCore {
+
+/**
+    \brief Debounces 32 inputs in parallel.
+
+    Bit n of every word belongs to input n. When an input changes its count
+    is restarted; once it has been stable for its filter length in samples
+    the filtered state takes on the input's value. This matches the per-pin
+    countdown filter of DigitalIn and CcioPin: a length of 0 passes changes
+    straight through, and a length of N updates on the Nth unchanged sample
+    after the last change.
+
+    The count of input n is the number made of bit n of m_count[0..PLANES),
+    and its filter length is held the same way in m_length. Counting stops
+    at the highest plane any length uses and as soon as no input carries,
+    so a quiet port costs a single test.
+**/
+class VerticalDebounce {
+public:
+    /// Count planes; filter lengths can be up to 2^PLANES - 1 samples.
+    static const uint8_t PLANES = 16;
+
+    VerticalDebounce()
+        : m_count(),
+          m_length(),
+          m_planes(0),
+          m_active(0),
+          m_expire(0),
+          m_filtered(0) {}
+
+    /**
+        Set the filter length of the inputs in \a mask and restart them.
+    **/
+    void Length(uint32_t mask, uint16_t samples) {
+        uint8_t planes = 0;
+        for (uint8_t k = 0; k < PLANES; k++) {
+            if (samples & (1U << k)) {
+                m_length[k] |= mask;
+            }
+            else {
+                m_length[k] &= ~mask;
+            }
+            if (m_length[k]) {
+                planes = k + 1;
+            }
+        }
+        m_planes = planes;
+        Restart(mask);
+    }
+
+    /**
+        The filter length of input \a bit in samples.
+    **/
+    uint16_t Length(uint8_t bit) const {
+        uint16_t samples = 0;
+        for (uint8_t k = 0; k < PLANES; k++) {
+            samples |= ((m_length[k] >> bit) & 1U) << k;
+        }
+        return samples;
+    }
+
+    /**
+        Restart the inputs in \a mask as if they had just changed.
+    **/
+    void Restart(uint32_t mask) {
+        for (uint8_t k = 0; k < PLANES; k++) {
+            m_count[k] &= ~mask;
+        }
+        m_active |= mask;
+    }
+
+    /**
+        Stop filtering the inputs in \a mask until they change or are
+        restarted.
+    **/
+    void Stop(uint32_t mask) {
+        m_active &= ~mask;
+        m_expire &= ~mask;
+    }
+
+    /**
+        Have the inputs in \a mask take their input value on the next
+        Update(), regardless of their count.
+    **/
+    void Expire(uint32_t mask) {
+        m_expire |= mask;
+    }
+
+    /**
+        Inputs still waiting for an Expire() to be applied.
+    **/
+    uint32_t Expiring() const {
+        return m_expire;
+    }
+
+    /**
+        Filter one sample.
+
+        \param[in] inputs The current input values.
+        \param[in] changes The inputs that changed since the last sample.
+        \return The inputs whose filtered state was written this sample,
+        whether or not it changed value.
+    **/
+    uint32_t Update(uint32_t inputs, uint32_t changes) {
+        uint32_t active = m_active | changes;
+        uint32_t expire = m_expire;
+        if (!(active | expire)) {
+            return 0;
+        }
+
+        if (changes) {
+            // Restart the counts of the inputs that changed
+            for (uint8_t k = 0; k < m_planes; k++) {
+                m_count[k] &= ~changes;
+            }
+        }
+
+        // Ripple-carry increment of every input that held steady
+        uint32_t carry = active & ~changes;
+        for (uint8_t k = 0; carry && k < m_planes; k++) {
+            uint32_t count = m_count[k];
+            m_count[k] = count ^ carry;
+            carry &= count;
+        }
+
+        // Inputs whose count equals their length are done
+        uint32_t done = active;
+        for (uint8_t k = 0; done && k < m_planes; k++) {
+            done &= ~(m_count[k] ^ m_length[k]);
+        }
+        done |= expire;
+
+        m_expire = 0;
+        m_active = active & ~done;
+        m_filtered = (m_filtered & ~done) | (inputs & done);
+        return done;
+    }
+
+    /**
+        The filtered input states.
+    **/
+    uint32_t Filtered() const {
+        return m_filtered;
+    }
+
+private:
+    uint32_t m_count[PLANES];
+    uint32_t m_length[PLANES];
+    uint8_t m_planes;
+    uint32_t m_active;
+    uint32_t m_expire;
+    uint32_t m_filtered;
+};
+
+} // ClearCore namespace
+#endif // HIDE_FROM_DOXYGEN
+
+#endif // __VERTICALDEBOUNCE_H__
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    \file WorkScheduler.h
+    \brief ClearCore deferred work scheduler.
+
+    Provides a way for interrupt handlers to hand off longer-running work to a
+    low-priority context that runs on the PendSV exception.
+**/
+
+#ifndef __WORKSCHEDULER_H__
+#define __WORKSCHEDULER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "SysSingleton.h"
+
+namespace ClearCore {
+
+/** Number of work items that can be pending per priority level. **/
+#ifndef WORK_QUEUE_DEPTH
+#define WORK_QUEUE_DEPTH 16
+#endif
+
+/**
+    \brief ClearCore deferred work scheduler.
+
+    Work items are posted to one of several priority queues and are executed
+    from the PendSV exception, which runs at the lowest interrupt priority.
+    This lets time-critical interrupts hand off long-running work (e.g.
+    protocol processing, NVM writes, CCIO-8 rediscovery) without blocking, and
+    without depending on the application's main loop.
+
+    Posting is lock-free and may be done from any interrupt or from the main
+    loop. Queued work items are executed in priority order; all pending
+    higher priority work is completed before any lower priority work is
+    started. Work items cannot preempt each other, so each item should run to
+    completion in a reasonable amount of time.
+
+    \code{.cpp}
+    void SaveSettings(void *context) {
+        // Runs in the background at the lowest interrupt priority
+        NvmMgr.Int32(NvmManager::NVM_LOC_USER_START, *(int32_t *)context);
+    }
+
+    // From an interrupt handler, request that the work be done with a
+    // deadline of 5ms.
+    WorkSched.Post(SaveSettings, &settings,
+                   WorkScheduler::WORK_PRIORITY_LOW, 5000);
+    \endcode
+**/
+class WorkScheduler {
+public:
+    /**
+        \enum WorkPriority
+
+        \brief Priority levels of the deferred work queues.
+    **/
+    typedef enum {
+        WORK_PRIORITY_HIGH = 0,
+        WORK_PRIORITY_NORMAL,
+        WORK_PRIORITY_LOW,
+        WORK_PRIORITY_COUNT
+    } WorkPriority;
+
+    /**
+        \brief Work item callback function type.
+
+        \param[in] context The context pointer that was given to Post().
+    **/
+    typedef void (*WorkFunc)(void *context);
+
+    /**
+        \brief Statistics gathered for a work priority level.
+    **/
+    typedef struct {
+        /// Number of work items successfully posted.
+        uint32_t Posted;
+        /// Number of work items executed.
+        uint32_t Completed;
+        /// Number of work items rejected because the queue was full.
+        uint32_t Dropped;
+        /// Number of work items that completed after their deadline.
+        uint32_t Overruns;
+        /// Longest time from posting to start of execution, in CPU cycles.
+        uint32_t MaxLatencyCycles;
+        /// Longest execution time of a single work item, in CPU cycles.
+        uint32_t MaxRunCycles;
+    } WorkStats;
+
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        Construct, and initialize the work queues.
+
+        \note Only the library's global instance should be constructed
+    **/
+    WorkScheduler();
+
+    /**
+        Public accessor for singleton instance.
+    **/
+    static WorkScheduler &Instance();
+#endif
+
+    /**
+        \brief Post a work item to be executed in the background.
+
+        May be called from any interrupt context or from the main loop.
+
+        \param[in] func The function to execute.
+        \param[in] context (optional) Pointer passed to \a func when it runs.
+        \param[in] priority (optional) The priority queue to post to.
+        Default: WORK_PRIORITY_NORMAL.
+        \param[in] deadlineUs (optional) Time allowed, in microseconds, from
+        posting until the work item completes. Work items that complete late
+        are counted as overruns. Zero disables the deadline check.
+
+        \return True if the work item was queued; false if the queue for
+        \a priority was full or the arguments were invalid.
+    **/
+    bool Post(WorkFunc func, void *context = NULL,
+              WorkPriority priority = WORK_PRIORITY_NORMAL,
+              uint32_t deadlineUs = 0);
+
+    /**
+        \brief Number of work items waiting in a priority queue.
+
+        \param[in] priority The priority queue to check.
+
+        \return Count of pending work items.
+    **/
+    uint32_t Pending(WorkPriority priority);
+
+    /**
+        \brief Accessor for the statistics of a priority level.
+
+        \param[in] priority The priority level to query.
+        \param[out] stats The statistics of \a priority.
+
+        \return True if \a priority is valid.
+    **/
+    bool Stats(WorkPriority priority, WorkStats &stats);
+
+    /**
+        \brief Clear the statistics of all priority levels.
+    **/
+    void StatsReset();
+
+#ifndef HIDE_FROM_DOXYGEN
+    /**
+        \brief Execute all pending work items in priority order.
+
+        \note Called from the PendSV exception handler; this should not be
+        called directly.
+    **/
+    void Drain();
+#endif
+
+private:
+    typedef struct {
+        WorkFunc Func;
+        void *Context;
+        uint32_t PostCycle;
+        uint32_t DeadlineCycles;
+        volatile bool Ready;
+    } WorkItem;
+
+    typedef struct {
+        WorkItem Items[WORK_QUEUE_DEPTH];
+        // Next slot to be reserved by a producer
+        volatile uint32_t Head;
+        // Next slot to be executed by the consumer
+        volatile uint32_t Tail;
+    } WorkQueue;
+
+    WorkQueue m_queues[WORK_PRIORITY_COUNT];
+    WorkStats m_stats[WORK_PRIORITY_COUNT];
+
+}; // WorkScheduler
+
+} // ClearCore namespace
+
+#endif // __WORKSCHEDULER_H__
@@ -60,6 +60,10 @@
 #define atomic_exchange_n(ptr, val)                                            \
     __atomic_exchange_n(ptr, val, __ATOMIC_ACQ_REL)
 
+#define atomic_compare_exchange_n(ptr, expected, desired)                      \
+    __atomic_compare_exchange_n(ptr, expected, desired, false,                 \
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
 #define atomic_test_and_set(ptr) __atomic_test_and_set(ptr, __ATOMIC_ACQUIRE)
 
 #define atomic_clear(ptr) __atomic_clear(ptr, __ATOMIC_RELEASE)
@@ -28,19 +28,24 @@
 
 #include "AdcManager.h"
 #include <cstring>
+#include <math.h>
 #include <stdio.h>
 #include <sam.h>
 #include "DmaManager.h"
+#include "FixedPoint.h"
 #include "HardwareMapping.h"
 #include "ShiftRegister.h"
 #include "StatusManager.h"
+#include "StepGenerator.h"
+#include "SysSingleton.h"
 #include "SysUtils.h"
+#include "atomic_utils.h"
 
 namespace ClearCore {
 
 extern ShiftRegister ShiftReg;
-extern StatusManager &StatusMgr;
-AdcManager &AdcMgr = AdcManager::Instance();
+extern SINGLETON_REF(StatusManager) StatusMgr;
+SINGLETON_DEFINE(AdcManager, AdcMgr)
 
 constexpr float AdcManager::ADC_INITIAL_FILTER_VALUE_V[ADC_CHANNEL_COUNT];
 constexpr float AdcManager::ADC_CHANNEL_MAX_FLOAT[ADC_CHANNEL_COUNT];
@@ -55,39 +60,70 @@ volatile uint16_t AdcResultsRaw[AdcManager::ADC_CHANNEL_COUNT] = {0};
 
 /**
     ADC channel selection DMA data source structure
+
+    The ADC loads one 32-bit DSEQDATA word into each register enabled in
+    DSEQCTRL, in register order, before every conversion.
 **/
-union adcDSeqCfg {
-    struct {
-        ADC_INPUTCTRL_Type INPUTCTRL; ///< Offset: 0x04 (R/W 16) Input Control
-        ADC_CTRLB_Type CTRLB;         ///< Offset: 0x06 (R/W 16) Control B
-    } bit;
-    uint32_t reg;
-#ifdef __cplusplus
-    adcDSeqCfg() {
-        reg = 0;
-    }
-    adcDSeqCfg(uint16_t inputCtrl, uint16_t ctrlb) {
-        bit.INPUTCTRL.reg = inputCtrl;
-        bit.CTRLB.reg = ctrlb;
-    }
-#endif
+struct adcDSeqCfg {
+    uint32_t INPUTCTRL; ///< Input Control
+    uint32_t CTRLB;     ///< Control B (resolution)
+    uint32_t AVGCTRL;   ///< Average Control (oversampling)
 };
 
-// ADC channel selection DMA data source
-// The first argument is the full INPUTCTRL register value that will be loaded
-// into the ADC
+// Number of DSEQDATA words per conversion
+#define ADC_DSEQ_WORDS (sizeof(adcDSeqCfg) / sizeof(uint32_t))
+
+// ADC input for each channel
+// Note: index matched to AdcChannels
+static const uint16_t adcMuxPos[AdcManager::ADC_CHANNEL_COUNT] = {
+    ADC_INPUTCTRL_MUXPOS_AIN4,
+    ADC_INPUTCTRL_MUXPOS_AIN5,
+    ADC_INPUTCTRL_MUXPOS_AIN6,
+    ADC_INPUTCTRL_MUXPOS_AIN7,
+    ADC_INPUTCTRL_MUXPOS_AIN8,
+    ADC_INPUTCTRL_MUXPOS_AIN9,
+    ADC_INPUTCTRL_MUXPOS_AIN10,
+    ADC_INPUTCTRL_MUXPOS_AIN11,
+};
+
+// ADC channel selection DMA data source, filled in by SequenceUpdate()
 // Note: The last position also has the Sequence stop bit enabled
 //       to alert the ADC that the sequence is finished
 // Note: index matched to AdcChannels
-static const adcDSeqCfg adcSequence[AdcManager::ADC_CHANNEL_COUNT] = {
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN4, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN5, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN6, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN7, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN8, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN9, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN10, 0),
-    adcDSeqCfg(ADC_INPUTCTRL_MUXPOS_AIN11 | ADC_INPUTCTRL_DSEQSTOP, 0),
+static adcDSeqCfg adcSequence[AdcManager::ADC_CHANNEL_COUNT];
+
+// ADC clock after the prescaler, GCLK4 (48 MHz) / 4
+#define ADC_CLK_HZ (48000000 / 4)
+// Sampling time of each conversion in ADC clocks, SAMPCTRL.SAMPLEN + 1
+#define ADC_SAMPLEN 31
+#define ADC_SAMPLE_CLKS (ADC_SAMPLEN + 1)
+
+// Estimated CPU cycles per sample of each filter type
+#define FILTER_CYCLES_IIR 20
+#define FILTER_CYCLES_BIQUAD_SECTION 50
+#define FILTER_CYCLES_MOVING_AVERAGE 30
+#define FILTER_CYCLES_MEDIAN_PER_TAP 15
+
+/**
+    Oversampling setting details
+    Note: index matched to AdcOversampling
+**/
+static const struct {
+    // Effective resolution in bits, zero to follow the ADC resolution
+    uint8_t bits;
+    // Number of conversions accumulated by the ADC per sample time
+    uint16_t conversions;
+    // AVGCTRL register value to accumulate and right-adjust the conversions
+    uint8_t avgCtrl;
+    // Software decimation, the number of sample times averaged is
+    // 4^decimateShift
+    uint8_t decimateShift;
+} adcOversampleSettings[AdcManager::ADC_OVERSAMPLE_COUNT] = {
+    {0, 1, ADC_AVGCTRL_SAMPLENUM_1 | ADC_AVGCTRL_ADJRES(0), 0},
+    {13, 4, ADC_AVGCTRL_SAMPLENUM_4 | ADC_AVGCTRL_ADJRES(1), 0},
+    {14, 16, ADC_AVGCTRL_SAMPLENUM_16 | ADC_AVGCTRL_ADJRES(2), 0},
+    {15, 16, ADC_AVGCTRL_SAMPLENUM_16 | ADC_AVGCTRL_ADJRES(2), 1},
+    {16, 16, ADC_AVGCTRL_SAMPLENUM_16 | ADC_AVGCTRL_ADJRES(2), 2},
 };
 
 static inline void WaitAdc() {
@@ -96,23 +132,55 @@ static inline void WaitAdc() {
     }
 }
 
-AdcManager &AdcManager::Instance() {
-    static AdcManager *instance = new AdcManager();
-    return *instance;
-}
-
 /**
     Constructor
 **/
 AdcManager::AdcManager()
-    : m_initialized(false),
+    : m_captureBuffer(NULL),
+      m_captureFrames(0),
+      m_capturePreTrigger(0),
+      m_captureMask(0),
+      m_captureChannels(0),
+      m_captureTrigger(CAPTURE_TRIGGER_SOFTWARE),
+      m_captureTriggerChannel(ADC_AIN12),
+      m_captureLevel(0),
+      m_captureLastResult(0),
+      m_captureState(CAPTURE_IDLE),
+      m_captureForce(false),
+      m_captureHead(0),
+      m_captureCount(0),
+      m_capturePostRemaining(0),
+      m_capturePostFrames(0),
+      m_captureTriggerFrame(0),
+      m_compEnabled(0),
+      m_compRisen(0),
+      m_compFallen(0),
+      m_statsWindow(0),
+      m_statsCount(0),
+      m_statsSequence(0),
+      m_initialized(false),
       m_AdcTimeout(false),
       m_shiftRegSnapshot(UINT32_MAX),
       m_shiftRegPending(UINT32_MAX),
       m_AdcResolution(ADC_RESOLUTION_DEFAULT),
       m_AdcResPending(ADC_RESOLUTION_DEFAULT),
       m_AdcTimeoutLimit(ADC_TIMEOUT_DEFAULT),
-      m_AdcBusyCount(0) {}
+      m_AdcBusyCount(0) {
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        m_oversampling[i] = ADC_OVERSAMPLE_NONE;
+        m_oversamplingPending[i] = ADC_OVERSAMPLE_NONE;
+        m_decimateAccum[i] = 0;
+        m_decimateCount[i] = 0;
+        m_compUpper[i] = m_compUpperExit[i] = INT16_MAX;
+        m_compLower[i] = m_compLowerExit[i] = 0;
+        m_compQualify[i] = 0;
+        m_compCount[i] = 0;
+        m_compState[i] = COMPARATOR_IN_WINDOW;
+        m_compCallback[i] = nullptr;
+        m_compMotor[i] = nullptr;
+    }
+    m_sequencePending = false;
+}
 
 /**
     Initialize the ADC to power-up state.
@@ -129,8 +197,14 @@ void AdcManager::Initialize() {
 
     // Set default filter constants
     for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
-        m_analogFilter[i].Tc_ms(ADC_IIR_FILTER_TC_MS);
+        m_analogFilter.Tc_ms(i, ADC_IIR_FILTER_TC_MS);
+        m_filterType[i] = FILTER_TYPE_IIR;
+        m_oversampling[i] = ADC_OVERSAMPLE_NONE;
+        m_oversamplingPending[i] = ADC_OVERSAMPLE_NONE;
+        m_decimateAccum[i] = 0;
+        m_decimateCount[i] = 0;
     }
+    m_sequencePending = false;
 
     // Configure internal analog inputs: Sdrvr2, Sdrvr3, VBus, 5V Ob monitor
     const uint8_t INTERNAL_ADC_INPUTS = 4;
@@ -162,7 +236,7 @@ void AdcManager::Initialize() {
     ADC1->CTRLA.bit.SWRST = 1;
     SYNCBUSY_WAIT(ADC1, ADC_SYNCBUSY_SWRST);
 
-    // Configure the ADC read resolution
+    // Configure the ADC read resolution and build the conversion sequence
     AdcResChange();
 
     // Set clock pre-scaler to 4 to result in a clock signal of 48/4 = 12 MHz
@@ -176,8 +250,9 @@ void AdcManager::Initialize() {
     // Setup the DMA input/result transfers
     DmaInit();
 
-    // Update INPUTCTRL from the DMA engine
-    ADC1->DSEQCTRL.bit.INPUTCTRL = 1;
+    // Update INPUTCTRL, CTRLB and AVGCTRL from the DMA engine
+    ADC1->DSEQCTRL.reg = ADC_DSEQCTRL_INPUTCTRL | ADC_DSEQCTRL_CTRLB |
+                         ADC_DSEQCTRL_AVGCTRL;
     SYNCBUSY_WAIT(ADC1, ADC_SYNCBUSY_INPUTCTRL);
     ADC1->DSEQCTRL.bit.AUTOSTART = 1;
 
@@ -190,7 +265,7 @@ void AdcManager::Initialize() {
     // performed in the background, which results in more reliable readings.
     // Setting the sample length to 31 uses approximately 20% of the available
     // time when doing 8 12-bit readings per 5 kHz interrupt slot.
-    ADC1->SAMPCTRL.reg = ADC_SAMPCTRL_SAMPLEN(31);
+    ADC1->SAMPCTRL.reg = ADC_SAMPCTRL_SAMPLEN(ADC_SAMPLEN);
     SYNCBUSY_WAIT(ADC1, ADC_SYNCBUSY_SAMPCTRL);
 
     ADC1->DBGCTRL.bit.DBGRUN = 1;
@@ -217,8 +292,8 @@ void AdcManager::Initialize() {
         uint16_t val = ADC_INITIAL_FILTER_VALUE_V[i] * (1 << 15) /
                        ADC_CHANNEL_MAX_FLOAT[i];
         m_AdcResultsConverted[i] = val;
-        m_AdcResultsConvertedFiltered[i] = val;
-        m_analogFilter[i].Reset(val);
+        m_AdcResultsFullScale[i] = val << 1;
+        FilterResetImpl(static_cast<AdcChannels>(i), val);
     }
 
     m_initialized = true;
@@ -227,7 +302,7 @@ void AdcManager::Initialize() {
 /**
     Update systems at the sample rate
 **/
-void AdcManager::Update() {
+HOT_ISR_FUNC void AdcManager::Update() {
     if (!m_initialized) {
         return;
     }
@@ -246,31 +321,88 @@ void AdcManager::Update() {
         m_AdcBusyCount = 0;
         m_AdcTimeout = false;
 
+        if (m_captureState == CAPTURE_ARMED ||
+                m_captureState == CAPTURE_TRIGGERED) {
+            CaptureUpdate();
+        }
+
         // Copy the finished results into m_AdcResultsConverted and convert to
         // Q15
+        uint32_t freshResults = 0;
         for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
             // If HBridgeReset is set, do not update the VSupply value
             if (i == ADC_VSUPPLY_MON && StatusMgr.StatusRT().bit.HBridgeReset) {
                 continue;
             }
-            // Normalize the ADC results to a Q15 value
-            m_AdcResultsConverted[i] =
-                AdcResultsRaw[i] << (15 - m_AdcResolution);
+            uint32_t result = AdcResultsRaw[i];
+
+            // Average oversampled results over multiple sample times
+            uint8_t decimateShift =
+                adcOversampleSettings[m_oversampling[i]].decimateShift;
+            if (decimateShift) {
+                m_decimateAccum[i] += result;
+                if (++m_decimateCount[i] < (1 << (2 * decimateShift))) {
+                    continue;
+                }
+                result = m_decimateAccum[i] >> decimateShift;
+                m_decimateAccum[i] = 0;
+                m_decimateCount[i] = 0;
+            }
+
+            // Normalize the ADC results to a 16-bit full scale value, and
+            // to a Q15 value
+            uint8_t bits = ChannelResolution(static_cast<AdcChannels>(i));
+            m_AdcResultsFullScale[i] = result << (16 - bits);
+            m_AdcResultsConverted[i] = Q15::FromUnsigned(result, bits).Raw();
+            freshResults |= 1UL << i;
+        }
+
+        if (m_statsWindow) {
+            StatsUpdate(freshResults);
         }
 
         // Kick off next conversion sequence
         if (m_AdcResolution != m_AdcResPending) {
             AdcResChange();
         }
+        if (m_sequencePending) {
+            SequenceUpdate();
+        }
         m_shiftRegSnapshot = m_shiftRegPending;
         m_shiftRegPending = ShiftReg.LastOutput();
         DmaUpdate();
     }
 
-    // Apply IIR filtering even if the ADC values have not been updated
+    // Apply filtering even if the ADC values have not been updated. The IIR
+    // filters run on every channel, skipping those that have settled on an
+    // unchanged input; channels using another filter type overwrite the IIR
+    // output.
+    m_analogFilter.Update(m_AdcResultsConverted, m_AdcResultsConvertedFiltered);
     for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
-        m_analogFilter[i].Update(m_AdcResultsConverted[i]);
-        m_AdcResultsConvertedFiltered[i] = m_analogFilter[i].LastOutput();
+        switch (m_filterType[i]) {
+            case FILTER_TYPE_BIQUAD:
+                m_altFilter[i].biquad.Update(m_AdcResultsConverted[i]);
+                m_AdcResultsConvertedFiltered[i] =
+                    m_altFilter[i].biquad.LastOutput();
+                break;
+            case FILTER_TYPE_MOVING_AVERAGE:
+                m_altFilter[i].movingAverage.Update(m_AdcResultsConverted[i]);
+                m_AdcResultsConvertedFiltered[i] =
+                    m_altFilter[i].movingAverage.LastOutput();
+                break;
+            case FILTER_TYPE_MEDIAN:
+                m_altFilter[i].median.Update(m_AdcResultsConverted[i]);
+                m_AdcResultsConvertedFiltered[i] =
+                    m_altFilter[i].median.LastOutput();
+                break;
+            case FILTER_TYPE_IIR:
+            default:
+                break;
+        }
+    }
+
+    if (m_compEnabled) {
+        ComparatorUpdate();
     }
 }
 
@@ -350,7 +482,7 @@ void AdcManager::DmaInit() {
     // data before the src addr.
     baseDesc->SRCADDR.reg =
         (reinterpret_cast<uint32_t>(&adcSequence)) + sizeof(adcSequence);
-    baseDesc->BTCNT.reg = ADC_CHANNEL_COUNT;
+    baseDesc->BTCNT.reg = ADC_CHANNEL_COUNT * ADC_DSEQ_WORDS;
     // The Destination is the ADC register for sequence data.
     // The sequence data is what will be moved into the ADC.
     baseDesc->DSTADDR.reg =
@@ -359,6 +491,501 @@ void AdcManager::DmaInit() {
                            DMAC_BTCTRL_VALID | DMAC_BTCTRL_SRCINC;
 }
 
+bool AdcManager::FilterBiquad(AdcChannels adcChannel, float cutoffHz,
+                              uint8_t order) {
+    if (adcChannel >= ADC_CHANNEL_COUNT ||
+            FilterCycles(adcChannel, FILTER_CYCLES_IIR +
+                         FILTER_CYCLES_BIQUAD_SECTION * order / 2) >
+            ADC_FILTER_BUDGET_CYCLES) {
+        return false;
+    }
+
+    // Design the filter outside of the critical section, then swap it in
+    Biquad16 filter;
+    if (!filter.Butterworth(cutoffHz, order)) {
+        return false;
+    }
+
+    __disable_irq();
+    m_altFilter[adcChannel].biquad = filter;
+    m_filterType[adcChannel] = FILTER_TYPE_BIQUAD;
+    FilterResetImpl(adcChannel, m_AdcResultsConvertedFiltered[adcChannel]);
+    __enable_irq();
+    return true;
+}
+
+bool AdcManager::FilterMovingAverage(AdcChannels adcChannel,
+                                     uint8_t length) {
+    if (adcChannel >= ADC_CHANNEL_COUNT ||
+            FilterCycles(adcChannel, FILTER_CYCLES_IIR +
+                         FILTER_CYCLES_MOVING_AVERAGE) >
+            ADC_FILTER_BUDGET_CYCLES) {
+        return false;
+    }
+
+    MovingAverage16 filter;
+    if (!filter.Length(length)) {
+        return false;
+    }
+
+    __disable_irq();
+    m_altFilter[adcChannel].movingAverage = filter;
+    m_filterType[adcChannel] = FILTER_TYPE_MOVING_AVERAGE;
+    FilterResetImpl(adcChannel, m_AdcResultsConvertedFiltered[adcChannel]);
+    __enable_irq();
+    return true;
+}
+
+bool AdcManager::FilterMedian(AdcChannels adcChannel, uint8_t length) {
+    if (adcChannel >= ADC_CHANNEL_COUNT ||
+            FilterCycles(adcChannel, FILTER_CYCLES_IIR +
+                         FILTER_CYCLES_MEDIAN_PER_TAP * length) >
+            ADC_FILTER_BUDGET_CYCLES) {
+        return false;
+    }
+
+    Median16 filter;
+    if (!filter.Length(length)) {
+        return false;
+    }
+
+    __disable_irq();
+    m_altFilter[adcChannel].median = filter;
+    m_filterType[adcChannel] = FILTER_TYPE_MEDIAN;
+    FilterResetImpl(adcChannel, m_AdcResultsConvertedFiltered[adcChannel]);
+    __enable_irq();
+    return true;
+}
+
+bool AdcManager::FilterReset(AdcChannels adcChannel, uint16_t newSetting) {
+    if (adcChannel >= ADC_CHANNEL_COUNT) {
+        return false;
+    }
+    __disable_irq();
+    FilterResetImpl(adcChannel, newSetting);
+    __enable_irq();
+    return true;
+}
+
+void AdcManager::FilterResetImpl(AdcChannels adcChannel,
+                                 uint16_t newSetting) {
+    switch (m_filterType[adcChannel]) {
+        case FILTER_TYPE_BIQUAD:
+            m_altFilter[adcChannel].biquad.Reset(newSetting);
+            break;
+        case FILTER_TYPE_MOVING_AVERAGE:
+            m_altFilter[adcChannel].movingAverage.Reset(newSetting);
+            break;
+        case FILTER_TYPE_MEDIAN:
+            m_altFilter[adcChannel].median.Reset(newSetting);
+            break;
+        case FILTER_TYPE_IIR:
+        default:
+            m_analogFilter.Reset(adcChannel, newSetting);
+            break;
+    }
+    m_AdcResultsConvertedFiltered[adcChannel] = newSetting;
+}
+
+uint32_t AdcManager::FilterCycles(AdcChannels adcChannel) {
+    switch (m_filterType[adcChannel]) {
+        // The IIR filter runs on every channel
+        case FILTER_TYPE_BIQUAD:
+            return FILTER_CYCLES_IIR + FILTER_CYCLES_BIQUAD_SECTION *
+                   m_altFilter[adcChannel].biquad.Sections();
+        case FILTER_TYPE_MOVING_AVERAGE:
+            return FILTER_CYCLES_IIR + FILTER_CYCLES_MOVING_AVERAGE;
+        case FILTER_TYPE_MEDIAN:
+            return FILTER_CYCLES_IIR + FILTER_CYCLES_MEDIAN_PER_TAP *
+                   m_altFilter[adcChannel].median.Length();
+        case FILTER_TYPE_IIR:
+        default:
+            return FILTER_CYCLES_IIR;
+    }
+}
+
+uint32_t AdcManager::FilterCycles(AdcChannels adcChannel, uint32_t cycles) {
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        if (i != adcChannel) {
+            cycles += FilterCycles(static_cast<AdcChannels>(i));
+        }
+    }
+    return cycles;
+}
+
+bool AdcManager::CaptureConfig(uint16_t *buffer, uint32_t frames,
+                               uint16_t channelMask,
+                               uint32_t preTriggerFrames) {
+    channelMask &= (1 << ADC_CHANNEL_COUNT) - 1;
+    if (m_captureState == CAPTURE_ARMED ||
+            m_captureState == CAPTURE_TRIGGERED || !buffer || !channelMask ||
+            preTriggerFrames >= frames) {
+        return false;
+    }
+
+    m_captureBuffer = buffer;
+    m_captureFrames = frames;
+    m_capturePreTrigger = preTriggerFrames;
+    m_captureMask = channelMask;
+    m_captureChannels = __builtin_popcount(channelMask);
+    m_captureState = CAPTURE_IDLE;
+    return true;
+}
+
+bool AdcManager::CaptureTrigger(CaptureTriggers trigger, AdcChannels channel,
+                                uint16_t level) {
+    if (m_captureState == CAPTURE_ARMED ||
+            m_captureState == CAPTURE_TRIGGERED ||
+            channel >= ADC_CHANNEL_COUNT) {
+        return false;
+    }
+
+    m_captureTrigger = trigger;
+    m_captureTriggerChannel = channel;
+    m_captureLevel = level;
+    return true;
+}
+
+bool AdcManager::CaptureArm() {
+    if (!m_captureBuffer || m_captureState == CAPTURE_ARMED ||
+            m_captureState == CAPTURE_TRIGGERED) {
+        return false;
+    }
+
+    m_captureHead = 0;
+    m_captureCount = 0;
+    m_capturePostFrames = 0;
+    m_captureTriggerFrame = 0;
+    m_captureLastResult = AdcResultsRaw[m_captureTriggerChannel];
+    m_captureForce = false;
+    // Set the state last; the interrupt starts recording once it is armed
+    m_captureState = CAPTURE_ARMED;
+    return true;
+}
+
+void AdcManager::CaptureStop() {
+    m_captureState = CAPTURE_IDLE;
+    m_captureForce = false;
+}
+
+bool AdcManager::CaptureData(const uint16_t *&first, uint32_t &firstFrames,
+                             const uint16_t *&second,
+                             uint32_t &secondFrames) {
+    if (m_captureState != CAPTURE_DONE) {
+        return false;
+    }
+
+    if (m_captureCount < m_captureFrames) {
+        // The buffer never wrapped
+        first = m_captureBuffer;
+        firstFrames = m_captureCount;
+        second = m_captureBuffer;
+        secondFrames = 0;
+    }
+    else {
+        // The oldest frame is the next one that would have been written
+        first = m_captureBuffer + m_captureHead * m_captureChannels;
+        firstFrames = m_captureFrames - m_captureHead;
+        second = m_captureBuffer;
+        secondFrames = m_captureHead;
+    }
+    return true;
+}
+
+HOT_ISR_FUNC void AdcManager::CaptureUpdate() {
+    // Append a frame of the selected raw results
+    uint16_t *frame = m_captureBuffer + m_captureHead * m_captureChannels;
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        if (m_captureMask & (1 << i)) {
+            *frame++ = AdcResultsRaw[i];
+        }
+    }
+    if (++m_captureHead >= m_captureFrames) {
+        m_captureHead = 0;
+    }
+    if (m_captureCount < m_captureFrames) {
+        m_captureCount++;
+    }
+
+    uint16_t result = AdcResultsRaw[m_captureTriggerChannel];
+    if (m_captureState == CAPTURE_ARMED) {
+        // Wait for a full pre-trigger history unless forced
+        if (m_captureForce || (m_captureCount > m_capturePreTrigger &&
+                               CaptureTriggered(result))) {
+            m_captureForce = false;
+            m_capturePostRemaining = m_captureFrames - m_capturePreTrigger - 1;
+            m_capturePostFrames = 0;
+            m_captureState = CAPTURE_TRIGGERED;
+        }
+    }
+    else {
+        m_capturePostFrames++;
+        m_capturePostRemaining--;
+    }
+    m_captureLastResult = result;
+
+    if (m_captureState == CAPTURE_TRIGGERED && !m_capturePostRemaining) {
+        m_captureTriggerFrame = m_captureCount - 1 - m_capturePostFrames;
+        m_captureState = CAPTURE_DONE;
+    }
+}
+
+HOT_ISR_FUNC bool AdcManager::CaptureTriggered(uint16_t result) {
+    switch (m_captureTrigger) {
+        case CAPTURE_TRIGGER_RISING:
+            return m_captureLastResult < m_captureLevel &&
+                   result >= m_captureLevel;
+        case CAPTURE_TRIGGER_FALLING:
+            return m_captureLastResult >= m_captureLevel &&
+                   result < m_captureLevel;
+        case CAPTURE_TRIGGER_ABOVE:
+            return result >= m_captureLevel;
+        case CAPTURE_TRIGGER_BELOW:
+            return result < m_captureLevel;
+        case CAPTURE_TRIGGER_SOFTWARE:
+        default:
+            return false;
+    }
+}
+
+bool AdcManager::ComparatorConfig(AdcChannels adcChannel, float upperVolts,
+                                  float lowerVolts, float hysteresisVolts,
+                                  uint16_t qualifySamples) {
+    if (adcChannel >= ADC_CHANNEL_COUNT || lowerVolts >= upperVolts ||
+            hysteresisVolts < 0) {
+        return false;
+    }
+
+    uint16_t upper = VoltsToQ15(adcChannel, upperVolts);
+    uint16_t lower = VoltsToQ15(adcChannel, lowerVolts);
+    uint16_t hysteresis = VoltsToQ15(adcChannel, hysteresisVolts);
+
+    __disable_irq();
+    m_compUpper[adcChannel] = upper;
+    m_compUpperExit[adcChannel] = (upper > hysteresis) ? upper - hysteresis
+                                  : 0;
+    m_compLower[adcChannel] = lower;
+    m_compLowerExit[adcChannel] = (lower < INT16_MAX - hysteresis)
+                                  ? lower + hysteresis : INT16_MAX;
+    m_compQualify[adcChannel] = qualifySamples;
+    m_compCount[adcChannel] = 0;
+    __enable_irq();
+    return true;
+}
+
+bool AdcManager::ComparatorEnable(AdcChannels adcChannel, bool enable) {
+    if (adcChannel >= ADC_CHANNEL_COUNT) {
+        return false;
+    }
+
+    if (enable) {
+        if (!(atomic_load_n(&m_compEnabled) & (1UL << adcChannel))) {
+            m_compState[adcChannel] = COMPARATOR_IN_WINDOW;
+            m_compCount[adcChannel] = 0;
+            atomic_or_fetch(&m_compEnabled, 1UL << adcChannel);
+        }
+    }
+    else {
+        atomic_and_fetch(&m_compEnabled, ~(1UL << adcChannel));
+    }
+    return true;
+}
+
+bool AdcManager::ComparatorCallback(AdcChannels adcChannel,
+                                    voidFuncPtr callback) {
+    if (adcChannel >= ADC_CHANNEL_COUNT) {
+        return false;
+    }
+    m_compCallback[adcChannel] = callback;
+    return true;
+}
+
+bool AdcManager::ComparatorStopMotor(AdcChannels adcChannel,
+                                     StepGenerator *motor) {
+    if (adcChannel >= ADC_CHANNEL_COUNT) {
+        return false;
+    }
+    m_compMotor[adcChannel] = motor;
+    return true;
+}
+
+uint32_t AdcManager::ComparatorsRisen(uint32_t mask) {
+    return atomic_fetch_and(&m_compRisen, ~mask) & mask;
+}
+
+uint32_t AdcManager::ComparatorsFallen(uint32_t mask) {
+    return atomic_fetch_and(&m_compFallen, ~mask) & mask;
+}
+
+HOT_ISR_FUNC void AdcManager::ComparatorUpdate() {
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        if (!(m_compEnabled & (1UL << i))) {
+            continue;
+        }
+
+        uint16_t reading = m_AdcResultsConvertedFiltered[i];
+        ComparatorStates state = m_compState[i];
+        ComparatorStates target;
+        switch (state) {
+            case COMPARATOR_ABOVE:
+                target = (reading >= m_compUpperExit[i]) ? COMPARATOR_ABOVE
+                         : (reading <= m_compLower[i]) ? COMPARATOR_BELOW
+                         : COMPARATOR_IN_WINDOW;
+                break;
+            case COMPARATOR_BELOW:
+                target = (reading <= m_compLowerExit[i]) ? COMPARATOR_BELOW
+                         : (reading >= m_compUpper[i]) ? COMPARATOR_ABOVE
+                         : COMPARATOR_IN_WINDOW;
+                break;
+            case COMPARATOR_IN_WINDOW:
+            default:
+                target = (reading >= m_compUpper[i]) ? COMPARATOR_ABOVE
+                         : (reading <= m_compLower[i]) ? COMPARATOR_BELOW
+                         : COMPARATOR_IN_WINDOW;
+                break;
+        }
+
+        // Require the new state to persist for the qualification time
+        if (target == state) {
+            m_compCount[i] = 0;
+            continue;
+        }
+        if (++m_compCount[i] < m_compQualify[i]) {
+            continue;
+        }
+        m_compCount[i] = 0;
+        m_compState[i] = target;
+
+        if (target == COMPARATOR_IN_WINDOW) {
+            continue;
+        }
+        if (target == COMPARATOR_ABOVE) {
+            atomic_or_fetch(&m_compRisen, 1UL << i);
+        }
+        else {
+            atomic_or_fetch(&m_compFallen, 1UL << i);
+        }
+        if (m_compMotor[i]) {
+            m_compMotor[i]->MoveStopAbrupt();
+        }
+        if (m_compCallback[i]) {
+            m_compCallback[i]();
+        }
+    }
+}
+
+uint16_t AdcManager::VoltsToQ15(AdcChannels adcChannel, float volts) {
+    // Match the scaling used by AnalogVoltage()
+    uint8_t bits = ChannelResolution(adcChannel);
+    if (bits > 15) {
+        bits = 15;
+    }
+    uint16_t maxReading = INT16_MAX & ~(INT16_MAX >> bits);
+    float counts = volts * maxReading / ADC_CHANNEL_MAX_FLOAT[adcChannel];
+    if (counts <= 0) {
+        return 0;
+    }
+    return (counts >= INT16_MAX) ? INT16_MAX : counts + 0.5f;
+}
+
+bool AdcManager::StatsWindow(uint32_t samples) {
+    // Keep the sum of a full scale window within 32 bits
+    if (samples > (1UL << 17)) {
+        return false;
+    }
+    __disable_irq();
+    m_statsWindow = samples;
+    StatsRestart();
+    __enable_irq();
+    return true;
+}
+
+bool AdcManager::Stats(AdcChannels adcChannel, AdcStats &stats) {
+    if (adcChannel >= ADC_CHANNEL_COUNT) {
+        return false;
+    }
+
+    // Retry if a new snapshot was published during the copy
+    uint32_t sequence;
+    do {
+        sequence = m_statsSequence;
+        __DMB();
+        stats = m_statsSnapshot[sequence & 1][adcChannel];
+        __DMB();
+    } while (sequence != m_statsSequence);
+    return sequence != 0;
+}
+
+bool AdcManager::StatsVolts(AdcChannels adcChannel, float &minVolts,
+                            float &maxVolts, float &meanVolts,
+                            float &rmsVolts) {
+    AdcStats stats;
+    if (!Stats(adcChannel, stats) || !stats.Count) {
+        return false;
+    }
+
+    // Match the scaling used by AnalogVoltage()
+    uint8_t bits = ChannelResolution(adcChannel);
+    if (bits > 15) {
+        bits = 15;
+    }
+    uint16_t maxReading = INT16_MAX & ~(INT16_MAX >> bits);
+    float scale = ADC_CHANNEL_MAX_FLOAT[adcChannel] / maxReading;
+
+    minVolts = stats.Min * scale;
+    maxVolts = stats.Max * scale;
+    meanVolts = static_cast<float>(stats.Sum) / stats.Count * scale;
+    rmsVolts = sqrtf(static_cast<float>(stats.SumSquares) / stats.Count) *
+               scale;
+    return true;
+}
+
+HOT_ISR_FUNC void AdcManager::StatsUpdate(uint32_t freshResults) {
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        // Decimated channels only have a new reading every few samples;
+        // count each reading once rather than repeating the last one
+        if (!(freshResults & (1UL << i))) {
+            continue;
+        }
+        uint32_t reading = m_AdcResultsConverted[i];
+        AdcStats &accum = m_statsAccum[i];
+        accum.Count++;
+        if (reading < accum.Min) {
+            accum.Min = reading;
+        }
+        if (reading > accum.Max) {
+            accum.Max = reading;
+        }
+        accum.Sum += reading;
+        accum.SumSquares += reading * reading;
+    }
+
+    if (++m_statsCount < m_statsWindow) {
+        return;
+    }
+
+    // Publish into the buffer that readers are not using
+    uint32_t sequence = m_statsSequence + 1;
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        m_statsSnapshot[sequence & 1][i] = m_statsAccum[i];
+    }
+    // The snapshot must be complete before readers can see the new sequence
+    __DMB();
+    m_statsSequence = sequence;
+    StatsRestart();
+}
+
+void AdcManager::StatsRestart() {
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        m_statsAccum[i].Min = UINT16_MAX;
+        m_statsAccum[i].Max = 0;
+        m_statsAccum[i].Count = 0;
+        m_statsAccum[i].Sum = 0;
+        m_statsAccum[i].SumSquares = 0;
+    }
+    m_statsCount = 0;
+}
+
 /**
     Initialize the DMA engine to stream ADC conversions and results.
 **/
@@ -408,10 +1035,102 @@ bool AdcManager::AdcResChange() {
     }
 
     m_AdcResolution = m_AdcResPending;
+    SequenceUpdate();
+
+    return true;
+}
+
+void AdcManager::SequenceUpdate() {
+    m_sequencePending = false;
+
+    uint32_t resSel;
+    switch (m_AdcResolution) {
+        case 8:
+            resSel = ADC_CTRLB_RESSEL_8BIT;
+            break;
+        case 10:
+            resSel = ADC_CTRLB_RESSEL_10BIT;
+            break;
+        default:
+            resSel = ADC_CTRLB_RESSEL_12BIT;
+            break;
+    }
+
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        if (m_oversampling[i] != m_oversamplingPending[i]) {
+            m_oversampling[i] = m_oversamplingPending[i];
+            m_decimateAccum[i] = 0;
+            m_decimateCount[i] = 0;
+        }
+
+        adcSequence[i].INPUTCTRL = adcMuxPos[i];
+        if (m_oversampling[i] == ADC_OVERSAMPLE_NONE) {
+            adcSequence[i].CTRLB = resSel;
+        }
+        else {
+            // Accumulated results are only available in 16-bit mode
+            adcSequence[i].CTRLB = ADC_CTRLB_RESSEL_16BIT;
+        }
+        adcSequence[i].AVGCTRL = adcOversampleSettings[m_oversampling[i]].avgCtrl;
+    }
+    adcSequence[ADC_CHANNEL_COUNT - 1].INPUTCTRL |= ADC_INPUTCTRL_DSEQSTOP;
+}
+
+bool AdcManager::Oversampling(AdcChannels adcChannel,
+                              AdcOversampling setting) {
+    if (adcChannel >= ADC_CHANNEL_COUNT || setting >= ADC_OVERSAMPLE_COUNT) {
+        return false;
+    }
+
+    AdcOversampling settings[ADC_CHANNEL_COUNT];
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        settings[i] = m_oversamplingPending[i];
+    }
+    settings[adcChannel] = setting;
+    if (SequenceTimeUs(settings) > ADC_SEQUENCE_BUDGET_US) {
+        return false;
+    }
 
+    m_oversamplingPending[adcChannel] = setting;
+    if (m_initialized) {
+        // Apply the change in the interrupt when the ADC is idle
+        m_sequencePending = true;
+    }
+    else {
+        m_oversampling[adcChannel] = setting;
+    }
     return true;
 }
 
+AdcManager::AdcOversampling AdcManager::Oversampling(AdcChannels adcChannel) {
+    if (adcChannel >= ADC_CHANNEL_COUNT) {
+        return ADC_OVERSAMPLE_NONE;
+    }
+    return m_oversamplingPending[adcChannel];
+}
+
+uint8_t AdcManager::ChannelResolution(AdcChannels adcChannel) {
+    uint8_t bits = adcOversampleSettings[m_oversampling[adcChannel]].bits;
+    return bits ? bits : m_AdcResolution;
+}
+
+uint32_t AdcManager::SequenceTimeUs() {
+    return SequenceTimeUs(m_oversampling);
+}
+
+uint32_t AdcManager::SequenceTimeUs(const AdcOversampling *settings) {
+    uint32_t adcClocks = 0;
+    for (uint8_t i = 0; i < ADC_CHANNEL_COUNT; i++) {
+        // Oversampled channels always make 12-bit conversions
+        uint8_t bits = (settings[i] == ADC_OVERSAMPLE_NONE) ? m_AdcResPending
+                       : ADC_RESOLUTION_DEFAULT;
+        adcClocks += adcOversampleSettings[settings[i]].conversions *
+                     (ADC_SAMPLE_CLKS + bits);
+    }
+    // Round up to the next microsecond
+    return (adcClocks * 1000000ULL + ADC_CLK_HZ - 1) / ADC_CLK_HZ;
+}
+
 bool AdcManager::FilterTc(AdcChannels adcChannel,
                           uint16_t tc,
                           FilterUnits theUnits) {
@@ -419,20 +1138,36 @@ bool AdcManager::FilterTc(AdcChannels adcChannel,
         return false;
     }
 
+    if (m_filterType[adcChannel] != FILTER_TYPE_IIR &&
+            FilterCycles(adcChannel, FILTER_CYCLES_IIR) >
+            ADC_FILTER_BUDGET_CYCLES) {
+        return false;
+    }
+
     switch (theUnits) {
         case AdcManager::FilterUnits::FILTER_UNIT_RAW:
-            m_analogFilter[adcChannel].Tc(tc);
-            return true;
+            m_analogFilter.Tc(adcChannel, tc);
+            break;
         case AdcManager::FilterUnits::FILTER_UNIT_MS:
-            m_analogFilter[adcChannel].Tc_ms(tc);
-            return true;
+            m_analogFilter.Tc_ms(adcChannel, tc);
+            break;
         case AdcManager::FilterUnits::FILTER_UNIT_SAMPLES:
-            m_analogFilter[adcChannel].TcSamples(tc);
-            return true;
+            m_analogFilter.TcSamples(adcChannel, tc);
+            break;
         default:
             // Error
             return false;
     }
+
+    if (m_filterType[adcChannel] != FILTER_TYPE_IIR) {
+        // Start the IIR filter from the current output to avoid a step
+        __disable_irq();
+        m_filterType[adcChannel] = FILTER_TYPE_IIR;
+        m_analogFilter.Reset(adcChannel,
+                             m_AdcResultsConvertedFiltered[adcChannel]);
+        __enable_irq();
+    }
+    return true;
 }
 
 uint16_t AdcManager::FilterTc(AdcChannels adcChannel,
@@ -443,11 +1178,11 @@ uint16_t AdcManager::FilterTc(AdcChannels adcChannel,
 
     switch (theUnits) {
         case AdcManager::FilterUnits::FILTER_UNIT_RAW:
-            return m_analogFilter[adcChannel].Tc();
+            return m_analogFilter.Tc(adcChannel);
         case AdcManager::FilterUnits::FILTER_UNIT_MS:
-            return m_analogFilter[adcChannel].Tc_ms();
+            return m_analogFilter.Tc_ms(adcChannel);
         case AdcManager::FilterUnits::FILTER_UNIT_SAMPLES:
-            return m_analogFilter[adcChannel].TcSamples();
+            return m_analogFilter.TcSamples(adcChannel);
         default:
             // Error
             return 0;
@@ -25,20 +25,25 @@
 **/
 
 #include "CcioBoardManager.h"
+#include <sam.h>
 #include <stddef.h>
 #include "SerialBase.h"
 #include "SerialDriver.h"
 #include "ShiftRegister.h"
 #include "SysConnectors.h"
 #include "StatusManager.h"
+#include "SysSingleton.h"
 #include "SysTiming.h"
+#include "SysUtils.h"
+#include "WorkScheduler.h"
 
 namespace ClearCore {
 
 extern ShiftRegister ShiftReg;
-extern StatusManager &StatusMgr;
+extern SINGLETON_REF(StatusManager) StatusMgr;
+extern SINGLETON_REF(WorkScheduler) WorkSched;
 extern volatile uint32_t tickCnt;
-CcioBoardManager &CcioMgr = CcioBoardManager::Instance();
+SINGLETON_DEFINE(CcioBoardManager, CcioMgr)
 
 #define MARKER_BYTE (0xCC)
 #define CCIO_REDISCOVER_TIME_TICKS (1000 * MS_TO_SAMPLES)
@@ -72,14 +77,7 @@ inline uint64_t modifyBit(uint64_t originalNumber, uint8_t position,
     \return Swapped value
 **/
 inline uint32_t reverseBytes(uint32_t value) {
-    uint32_t res = 0;
-    __asm("REV %[result], %[input]" : [result] "=r"(res) : [input] "r"(value));
-    return res;
-}
-
-CcioBoardManager &CcioBoardManager::Instance() {
-    static CcioBoardManager *instance = new CcioBoardManager();
-    return *instance;
+    return __REV(value);
 }
 
 #ifndef HIDE_FROM_DOXYGEN
@@ -103,6 +101,7 @@ CcioBoardManager::CcioBoardManager()
       m_pulseActive(0),
       m_pulseValue(0),
       m_pulseStopPending(0),
+      m_sequenceActive(0),
       m_consGlitchCnt(0),
       m_ccioLinkBroken(false),
       m_ccioOverloaded(0),
@@ -112,7 +111,8 @@ CcioBoardManager::CcioBoardManager()
       m_inputRegFallen(0),
       m_faultLed(ShiftRegister::SR_NO_FEEDBACK_MASK),
       m_autoRediscover(true),
-      m_lastDiscoverTime(0) {
+      m_lastDiscoverTime(0),
+      m_rediscoverPending(false) {
 }
 #endif
 
@@ -138,6 +138,7 @@ void CcioBoardManager::Initialize() {
     m_pulseActive = 0;
     m_pulseValue = 0;
     m_pulseStopPending = 0;
+    m_sequenceActive = 0;
     m_consGlitchCnt = 0;
     m_ccioLinkBroken = false;
     m_ccioOverloaded = 0;
@@ -249,6 +250,35 @@ void CcioBoardManager::Refresh() {
         m_currentOutputs = (m_currentOutputs | pulseRise) & ~pulseFall;
     }
 
+    // Step any output sequences every sample so their timing is exact
+    if (m_sequenceActive) {
+        uint64_t sequencesEnded = 0;
+        uint64_t sequenceRise = 0;
+        uint64_t sequenceFall = 0;
+        uint64_t sequenceMask = 1;
+
+        for (uint8_t i = 0; i < CCIO_PINS_PER_BOARD * m_ccioCnt; i++) {
+            if (m_sequenceActive & sequenceMask) {
+                OutputSequencer &sequence = m_ccioPins[i].m_sequence;
+                if (sequence.Update()) {
+                    if (sequence.Level()) {
+                        sequenceRise |= sequenceMask;
+                    }
+                    else {
+                        sequenceFall |= sequenceMask;
+                    }
+                }
+                if (!sequence.Active()) {
+                    sequencesEnded |= sequenceMask;
+                }
+            }
+            sequenceMask <<= 1;
+        }
+
+        m_sequenceActive &= ~sequencesEnded;
+        m_currentOutputs = (m_currentOutputs | sequenceRise) & ~sequenceFall;
+    }
+
     // Bail out unless the refresh delay has timed out
     if (--m_ccioRefreshDelay) {
         return;
@@ -381,13 +411,24 @@ void CcioBoardManager::Refresh() {
 
 void CcioBoardManager::RefreshSlow() {
     if (m_serPort && LinkBroken() && m_autoRediscover &&
+            !m_rediscoverPending &&
             tickCnt - m_lastDiscoverTime > CCIO_REDISCOVER_TIME_TICKS) {
-        // Reset the discover state and try to remake the broken link network
-        m_discoverState = CCIO_SEARCH;
-        CcioDiscover(m_serPort);
+        // The discover blocks on SPI transfers; hand it off to the background
+        // rather than holding up the SysTick interrupt.
+        m_rediscoverPending =
+            WorkSched.Post(RediscoverWork, this,
+                           WorkScheduler::WORK_PRIORITY_LOW);
     }
 }
 
+void CcioBoardManager::RediscoverWork(void *context) {
+    CcioBoardManager *mgr = static_cast<CcioBoardManager *>(context);
+    // Reset the discover state and try to remake the broken link network
+    mgr->m_discoverState = CCIO_SEARCH;
+    mgr->CcioDiscover(mgr->m_serPort);
+    mgr->m_rediscoverPending = false;
+}
+
 void CcioBoardManager::IoOverloadRT(uint64_t overloadState) {
     // OR the current overload state into the accum
     m_ccioOverloadAccum |= overloadState;
@@ -444,6 +485,12 @@ void CcioBoardManager::OutputPulsesStart(ClearCorePins pinNum, uint32_t onTime,
         return;
     }
     CcioPin &currentPin = m_ccioPins[pinNum];
+    if (m_sequenceActive & pinMask) {
+        __disable_irq();
+        currentPin.m_sequence.Stop();
+        m_sequenceActive &= ~pinMask;
+        __enable_irq();
+    }
     currentPin.m_pulseCounter = 0;
     currentPin.m_pulseStopCount = pulseCount;
     currentPin.m_pulseOnTicks = onTime * MS_TO_SAMPLES;
@@ -466,6 +513,71 @@ void CcioBoardManager::OutputPulsesStart(ClearCorePins pinNum, uint32_t onTime,
     }
 }
 
+bool CcioBoardManager::OutputSequenceStart(ClearCorePins pinNum,
+        const OutputSequenceStep *steps, uint16_t count, uint16_t loops,
+        bool queue) {
+    if (pinNum < CLEARCORE_PIN_CCIO_BASE || pinNum >= CLEARCORE_PIN_CCIO_MAX) {
+        return false;
+    }
+    if (!OutputSequencer::Valid(steps, count)) {
+        return false;
+    }
+    // Reposition the pin reference to work correctly with masking
+    pinNum = static_cast<ClearCorePins>(pinNum - CLEARCORE_PIN_CCIO_BASE);
+    uint64_t pinMask = 1ULL << pinNum;
+    // Do not start a sequence if we are in input mode
+    if (!(pinMask & m_outputMask)) {
+        return false;
+    }
+
+    OutputSequencer &sequence = m_ccioPins[pinNum].m_sequence;
+    __disable_irq();
+    if (sequence.Start(steps, count, loops, queue)) {
+        // The sequence replaces any pulses
+        m_pulseActive &= ~pinMask;
+        m_pulseStopPending &= ~pinMask;
+        if (sequence.Level()) {
+            m_currentOutputs |= pinMask;
+        }
+        else {
+            m_currentOutputs &= ~pinMask;
+        }
+        m_sequenceActive |= pinMask;
+    }
+    __enable_irq();
+    return true;
+}
+
+void CcioBoardManager::OutputSequenceStop(ClearCorePins pinNum) {
+    if (pinNum < CLEARCORE_PIN_CCIO_BASE || pinNum >= CLEARCORE_PIN_CCIO_MAX) {
+        return;
+    }
+    // Reposition the pin reference to work correctly with masking
+    pinNum = static_cast<ClearCorePins>(pinNum - CLEARCORE_PIN_CCIO_BASE);
+    uint64_t pinMask = 1ULL << pinNum;
+
+    __disable_irq();
+    m_ccioPins[pinNum].m_sequence.Stop();
+    if (m_sequenceActive & pinMask) {
+        m_sequenceActive &= ~pinMask;
+        // Turn off the output directly
+        m_currentOutputs &= ~pinMask;
+    }
+    __enable_irq();
+}
+
+HOT_ISR_FUNC void CcioBoardManager::OutputsLatch(uint64_t pinMask) {
+    m_pulseActive &= ~pinMask;
+    m_pulseStopPending &= ~pinMask;
+    uint64_t sequenceMask = pinMask & m_sequenceActive;
+    m_sequenceActive &= ~sequenceMask;
+    for (uint8_t i = 0; sequenceMask; i++, sequenceMask >>= 1) {
+        if (sequenceMask & 1) {
+            m_ccioPins[i].m_sequence.Stop();
+        }
+    }
+}
+
 void CcioBoardManager::LinkClose() {
     m_discoverState = CCIO_SEARCH;
     ShiftReg.LedPattern(m_faultLed, ShiftRegister::LED_BLINK_CCIO_COMM_ERR,
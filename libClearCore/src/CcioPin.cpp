@@ -33,7 +33,7 @@
 
 namespace ClearCore {
 
-extern CcioBoardManager &CcioMgr;
+extern SINGLETON_REF(CcioBoardManager) CcioMgr;
 
 CcioPin::CcioPin()
     : Connector(),
@@ -62,6 +62,7 @@ void CcioPin::Initialize(ClearCorePins ccioPin) {
     m_pulseTicksRemaining = 0;
     m_pulseStopCount = 0;
     m_pulseCounter = 0;
+    m_sequence.Stop();
 }
 
 bool CcioPin::Mode(ConnectorModes newMode) {
@@ -80,6 +81,7 @@ bool CcioPin::Mode(ConnectorModes newMode) {
         case INPUT_DIGITAL:
             CcioMgr.m_outputMask &= ~m_dataBit;
             CcioMgr.m_pulseActive &= ~m_dataBit;
+            CcioMgr.OutputSequenceStop(m_clearCorePin);
             m_mode = newMode;
             break;
         // Unsupported mode, don't change anything
@@ -111,12 +113,16 @@ bool CcioPin::State(int16_t newState) {
 
     switch (m_mode) {
         case OUTPUT_DIGITAL:
+            // A direct write replaces any running pulses or sequence
+            __disable_irq();
+            CcioMgr.OutputsLatch(m_dataBit);
             if (newState) {
                 CcioMgr.m_currentOutputs |= m_dataBit;
             }
             else {
                 CcioMgr.m_currentOutputs &= ~m_dataBit;
             }
+            __enable_irq();
             success = true;
             break;
         case INPUT_DIGITAL:
@@ -158,4 +164,14 @@ void CcioPin::OutputPulsesStop(bool stopImmediately) {
     CcioMgr.OutputPulsesStop(m_clearCorePin, stopImmediately);
 }
 
+bool CcioPin::OutputSequenceStart(const OutputSequenceStep *steps,
+                                  uint16_t count, uint16_t loops, bool queue) {
+    return CcioMgr.OutputSequenceStart(m_clearCorePin, steps, count, loops,
+                                       queue);
+}
+
+void CcioPin::OutputSequenceStop() {
+    CcioMgr.OutputSequenceStop(m_clearCorePin);
+}
+
 } // ClearCore namespace
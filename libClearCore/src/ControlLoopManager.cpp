@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    ClearCore control loop manager.
+**/
+
+#include "ControlLoopManager.h"
+#include <stddef.h>
+#include <sam.h>
+#include "SysSingleton.h"
+#include "SysUtils.h"
+
+namespace ClearCore {
+
+SINGLETON_DEFINE(ControlLoopManager, ControlLoopMgr)
+
+ControlLoopManager::ControlLoopManager()
+    : m_count(0),
+      m_cyclesLast(0) {
+    for (uint8_t i = 0; i < CONTROL_LOOP_MAX; i++) {
+        m_loops[i] = NULL;
+    }
+}
+
+bool ControlLoopManager::Add(PidLoop &loop) {
+    bool success = false;
+    __disable_irq();
+    if (m_count < CONTROL_LOOP_MAX) {
+        success = true;
+        for (uint8_t i = 0; i < m_count; i++) {
+            if (m_loops[i] == &loop) {
+                success = false;
+                break;
+            }
+        }
+        if (success) {
+            m_loops[m_count++] = &loop;
+        }
+    }
+    __enable_irq();
+    return success;
+}
+
+bool ControlLoopManager::Remove(PidLoop &loop) {
+    bool success = false;
+    __disable_irq();
+    for (uint8_t i = 0; i < m_count; i++) {
+        if (m_loops[i] == &loop) {
+            // Keep the remaining loops in order
+            for (uint8_t j = i + 1; j < m_count; j++) {
+                m_loops[j - 1] = m_loops[j];
+            }
+            m_loops[--m_count] = NULL;
+            success = true;
+            break;
+        }
+    }
+    __enable_irq();
+    return success;
+}
+
+HOT_ISR_FUNC void ControlLoopManager::Update() {
+    uint32_t startCycles = DWT->CYCCNT;
+    for (uint8_t i = 0; i < m_count; i++) {
+        m_loops[i]->Update();
+    }
+    m_cyclesLast = DWT->CYCCNT - startCycles;
+}
+
+} // ClearCore namespace
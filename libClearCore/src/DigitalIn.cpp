@@ -30,12 +30,14 @@
 #include <sam.h>
 #include "atomic_utils.h"
 #include "InputManager.h"
+#include "PulseCounter.h"
 #include "SysUtils.h"
 
 namespace ClearCore {
 
 extern ShiftRegister ShiftReg;
-extern InputManager &InputMgr;
+extern SINGLETON_REF(InputManager) InputMgr;
+extern PulseCounter CounterIn;
 
 #define OVERLOAD_CHECK_HOLDOFF 3
 
@@ -60,25 +62,24 @@ DigitalIn::DigitalIn(
       m_changeRegPtr(nullptr),
       m_inRegPtr(nullptr),
       m_inputRegRTPtr(nullptr),
-      m_stateFiltered(false),
       m_filterLength(3),
-      m_filterTicksLeft(1) {}
+      m_edgeQueue(),
+      m_edgeQueueSampled(false),
+      m_frequencyMeter() {}
 
 /**
     Set connector's internal state and update filtering if required.
 **/
-void DigitalIn::Refresh() {
-    if (*m_changeRegPtr & m_inputDataMask) {
-        m_filterTicksLeft = m_filterLength;
-
-        if (!m_filterLength) {
-            // If the filter length is zero, set the filtered state
-            UpdateFilterState();
-        }
+HOT_ISR_FUNC void DigitalIn::Refresh() {
+    // Filtering was already done for every input by InputMgr
+    if (m_edgeQueueSampled && (*m_changeRegPtr & m_inputDataMask)) {
+        m_edgeQueue.Push(!(*m_inRegPtr & m_inputDataMask),
+                         InputMgr.m_sampleCycle);
     }
-    else if (m_filterTicksLeft && !--m_filterTicksLeft) {
-        // When we decrement to zero, set the filtered state
-        UpdateFilterState();
+
+    if (m_mode == INPUT_FREQUENCY) {
+        m_frequencyMeter.Update(InputMgr.m_sampleCycle,
+                                !(*m_inRegPtr & m_inputDataMask));
     }
 }
 
@@ -87,10 +88,12 @@ void DigitalIn::Refresh() {
 **/
 void DigitalIn::Initialize(ClearCorePins clearCorePin) {
     // Clean up any state that Reinitialize may require
+    FrequencyEnable(false);
+    CounterEnable(false);
     m_mode = INVALID_NONE;
-    m_stateFiltered = false;
     m_filterLength = 3;
-    m_filterTicksLeft = 1;
+    m_frequencyMeter.Attach(m_inputPort, m_inputDataMask,
+                            100 * MS_TO_SAMPLES);
 
     // Enabling peripheral mux for interrupts
     PMUX_SELECTION(m_inputPort, m_inputDataBit, PER_EXTINT);
@@ -109,18 +112,46 @@ void DigitalIn::Initialize(ClearCorePins clearCorePin) {
     m_inRegPtr = &InputMgr.m_inputsUnfiltered[m_inputPort];
     m_inputRegRTPtr = &InputMgr.m_inputRegRT.reg;
 
-    ShiftReg.ShifterState(m_stateFiltered, m_ledMask);
+    // Start deasserted and take the input's value at the first sample
+    atomic_and_fetch(m_inputRegRTPtr, ~(1UL << clearCorePin));
+    ShiftReg.ShifterState(false, m_ledMask);
+    InputMgr.DebounceAttach(m_inputPort, m_inputDataMask, clearCorePin,
+                            m_ledMask);
+    InputMgr.DebounceLength(m_inputPort, m_inputDataMask, m_filterLength);
+    InputMgr.DebounceEnable(m_inputPort, m_inputDataMask, true);
 
     m_clearCorePin = clearCorePin;
     Mode(INPUT_DIGITAL);
 }
 
+bool DigitalIn::Mode(ConnectorModes newMode) {
+    if (newMode == m_mode) {
+        return true;
+    }
+    if (newMode != INPUT_DIGITAL && newMode != INPUT_FREQUENCY &&
+            newMode != INPUT_COUNTER) {
+        return false;
+    }
+
+    // Release whatever the current mode is using
+    FrequencyEnable(false);
+    CounterEnable(false);
+    m_mode = INPUT_DIGITAL;
+
+    if ((newMode == INPUT_FREQUENCY && !FrequencyEnable(true)) ||
+            (newMode == INPUT_COUNTER && !CounterEnable(true))) {
+        return false;
+    }
+    m_mode = newMode;
+    return true;
+}
+
 int16_t DigitalIn::State() {
     if (m_filterLength == 0) {
         // Pull an unfiltered, real time input value.
         return StateRT();
     }
-    return m_stateFiltered;
+    return FilteredState();
 }
 
 int16_t DigitalIn::StateRT() {
@@ -150,18 +181,78 @@ void DigitalIn::InterruptEnable(bool enable) {
     InputMgr.InterruptEnable(m_extInt, enable);
 }
 
-// Write the current filtered pin status back to the member variables
-void DigitalIn::UpdateFilterState() {
-    m_stateFiltered = !(*m_inRegPtr & m_inputDataMask);
-    ShiftReg.ShifterState(m_stateFiltered, m_ledMask);
+bool DigitalIn::EdgeEventsEnable(InputEdgeEvent *buffer, uint16_t size) {
+    if (buffer && (size < 2 || size > 32768 || (size & (size - 1)))) {
+        return false;
+    }
+
+    // Stop whichever producer feeds the queue before touching it
+    m_edgeQueueSampled = false;
+    if (m_interruptAvail) {
+        InputMgr.EdgeQueueSet(m_extInt, nullptr);
+    }
+    m_edgeQueue.Attach(buffer, size, m_clearCorePin, m_inputPort,
+                       m_inputDataMask);
+    if (!buffer) {
+        return true;
+    }
 
-    // Update the SysManager Register
-    if (m_stateFiltered) {
-        atomic_or_fetch(m_inputRegRTPtr, 1UL << m_clearCorePin);
+    if (m_interruptAvail) {
+        return InputMgr.EdgeQueueSet(m_extInt, &m_edgeQueue);
     }
-    else {
-        atomic_and_fetch(m_inputRegRTPtr, ~(1UL << m_clearCorePin));
+    m_edgeQueueSampled = true;
+    return true;
+}
+
+bool DigitalIn::FrequencyGate(uint16_t gateMs) {
+    // Keep the gate well inside one wrap of the 32-bit cycle counter
+    if (gateMs < 1 || gateMs > 10000) {
+        return false;
+    }
+    m_frequencyMeter.GateSamples(gateMs * MS_TO_SAMPLES);
+    return true;
+}
+
+bool DigitalIn::FrequencyEnable(bool enable) {
+    if (!m_interruptAvail) {
+        return !enable;
+    }
+    if (m_mode == INPUT_FREQUENCY) {
+        if (enable) {
+            return true;
+        }
+        InputMgr.FrequencyMeterSet(m_extInt, nullptr);
+    }
+    else if (enable) {
+        m_frequencyMeter.Attach(m_inputPort, m_inputDataMask,
+                                m_frequencyMeter.GateSamples());
+        return InputMgr.FrequencyMeterSet(m_extInt, &m_frequencyMeter);
     }
+    return true;
+}
+
+bool DigitalIn::CounterEnable(bool enable) {
+    if (!m_interruptAvail) {
+        return !enable;
+    }
+    if (enable) {
+        return CounterIn.Attach(m_clearCorePin, m_extInt);
+    }
+    if (m_mode == INPUT_COUNTER) {
+        CounterIn.Detach(m_clearCorePin);
+    }
+    return true;
+}
+
+void DigitalIn::FilterLength(uint16_t length, FilterUnits units) {
+    // 1 ms = 1000 us = 5 * (200 us) = 5 sample times
+    uint16_t samples = (units == FILTER_UNIT_MS) ? 5 * length : length;
+    m_filterLength = samples;
+    InputMgr.DebounceLength(m_inputPort, m_inputDataMask, samples);
+}
+
+void DigitalIn::FilterExpire() {
+    InputMgr.DebounceExpire(m_inputPort, m_inputDataMask);
 }
 
 } // ClearCore namespace
@@ -35,8 +35,9 @@
 namespace ClearCore {
 
 extern ShiftRegister ShiftReg;
-extern AdcManager &AdcMgr;
-extern StatusManager &StatusMgr;
+extern SINGLETON_REF(AdcManager) AdcMgr;
+extern SINGLETON_REF(InputManager) InputMgr;
+extern SINGLETON_REF(StatusManager) StatusMgr;
 
 DigitalInAnalogIn::DigitalInAnalogIn(ShiftRegister::Masks ledMask,
                                      ShiftRegister::Masks modeControlMask,
@@ -53,7 +54,7 @@ DigitalInAnalogIn::DigitalInAnalogIn(ShiftRegister::Masks ledMask,
     In digital mode, read the input.
     In analog mode, read the raw value and update the filtered value.
 **/
-void DigitalInAnalogIn::Refresh() {
+HOT_ISR_FUNC void DigitalInAnalogIn::Refresh() {
     switch (m_mode) {
         case INPUT_ANALOG:
             // If the ShiftRegister was not set up for the analog input
@@ -75,6 +76,8 @@ void DigitalInAnalogIn::Refresh() {
             }
             break;
         case INPUT_DIGITAL:
+        case INPUT_FREQUENCY:
+        case INPUT_COUNTER:
             DigitalIn::Refresh();
             break;
         default:
@@ -111,10 +114,12 @@ int16_t DigitalInAnalogIn::State() {
             }
             else {
                 state = *m_adcResultConvertedFilteredPtr >>
-                        (15 - AdcMgr.AdcResolution());
+                        (15 - min(AdcMgr.ChannelResolution(m_adcChannel), 15));
             }
             break;
         case INPUT_DIGITAL:
+        case INPUT_FREQUENCY:
+        case INPUT_COUNTER:
             state = DigitalIn::State();
             break;
         default:
@@ -129,6 +134,22 @@ bool DigitalInAnalogIn::FilterTc(uint16_t tc,
     return AdcMgr.FilterTc(m_adcChannel, tc, theUnits);
 }
 
+bool DigitalInAnalogIn::FilterBiquad(float cutoffHz, uint8_t order) {
+    return AdcMgr.FilterBiquad(m_adcChannel, cutoffHz, order);
+}
+
+bool DigitalInAnalogIn::FilterMovingAverage(uint8_t length) {
+    return AdcMgr.FilterMovingAverage(m_adcChannel, length);
+}
+
+bool DigitalInAnalogIn::FilterMedian(uint8_t length) {
+    return AdcMgr.FilterMedian(m_adcChannel, length);
+}
+
+AdcManager::FilterTypes DigitalInAnalogIn::FilterType() {
+    return AdcMgr.FilterType(m_adcChannel);
+}
+
 bool DigitalInAnalogIn::Mode(ConnectorModes newMode) {
     // Bail out if we are already in the requested mode
     if (newMode == m_mode) {
@@ -137,20 +158,38 @@ bool DigitalInAnalogIn::Mode(ConnectorModes newMode) {
 
     switch (newMode) {
         case INPUT_DIGITAL:
-            ShiftReg.ShifterState(true, m_modeControlBitMask);
-            // If the system has already been initialized, wait until the
-            // digital reading is valid then reset the filtered state
-            if (ShiftReg.Ready()) {
-                while (!(AdcMgr.ShiftRegSnapshot() & m_modeControlBitMask)) {
-                    continue;
+        case INPUT_FREQUENCY:
+        case INPUT_COUNTER:
+            if (m_mode == INPUT_ANALOG || m_mode == INVALID_NONE) {
+                ShiftReg.ShifterState(true, m_modeControlBitMask);
+                // If the system has already been initialized, wait until the
+                // digital reading is valid then reset the filtered state
+                if (ShiftReg.Ready()) {
+                    while (!(AdcMgr.ShiftRegSnapshot() &
+                             m_modeControlBitMask)) {
+                        continue;
+                    }
+                }
+                InputMgr.DebounceEnable(m_inputPort, m_inputDataMask, true);
+                if (ShiftReg.Ready()) {
+                    while (InputMgr.DebounceExpiring(m_inputPort,
+                                                     m_inputDataMask)) {
+                        continue;
+                    }
                 }
-                UpdateFilterState();
+                ShiftReg.LedInPwm(m_ledMask, false, m_clearCorePin);
+                m_analogValid = false;
+                m_mode = INPUT_DIGITAL;
             }
-            ShiftReg.LedInPwm(m_ledMask, false, m_clearCorePin);
-            m_mode = newMode;
-            m_analogValid = false;
+            // The base class sets up the frequency meter or counter
+            DigitalIn::Mode(newMode);
             break;
         case INPUT_ANALOG:
+            FrequencyEnable(false);
+            CounterEnable(false);
+            // The pin is not a digital input while the shifter selects the
+            // analog path, so freeze its filtered state
+            InputMgr.DebounceEnable(m_inputPort, m_inputDataMask, false);
             ShiftReg.ShifterState(false, m_modeControlBitMask);
             m_mode = newMode;
             // If the system has already been initialized, wait until the analog
@@ -31,18 +31,25 @@
 #include "DigitalInOut.h"
 #include <sam.h>
 #include "StatusManager.h"
+#include "SysManager.h"
 #include "SysTiming.h"
 #include "SysUtils.h"
 
 #define OVERLOAD_TRIP_TICKS ((uint8_t)(2.4 * MS_TO_SAMPLES))
 #define OVERLOAD_FOLDBACK_TICKS (100 * MS_TO_SAMPLES)
 
+#define PWM_FREQ_MIN 10
+#define PWM_FREQ_MAX 50000
+
 namespace ClearCore {
 
-extern StatusManager &StatusMgr;
+extern SINGLETON_REF(StatusManager) StatusMgr;
 extern ShiftRegister ShiftReg;
+extern SysManager SysMgr;
 extern volatile uint32_t tickCnt;
 
+const uint8_t DigitalInOut::TcPrescalerShift[] = {0, 1, 2, 3, 4, 6, 8, 10};
+
 /**
     Construct and wire in the Input/Output pair.
 **/
@@ -67,7 +74,10 @@ DigitalInOut::DigitalInOut(ShiftRegister::Masks ledMask,
       m_pulseActive(false),
       m_pulseValue(false),
       m_pulseStopPending(false),
-      m_overloadFoldbackCnt(0) {
+      m_overloadFoldbackCnt(0),
+      m_pwmDuty(0),
+      m_reflexOutput(false),
+      m_reflexTc(false) {
     static Tc *const tc_modules[TC_INST_NUM] = TC_INSTS;
     m_tc = tc_modules[outputInfo->tcNum];
 }
@@ -77,6 +87,10 @@ bool DigitalInOut::Mode(ConnectorModes newMode) {
     if (newMode == m_mode) {
         return true;
     }
+    // The pin belongs to a reflex link until it is unlinked
+    if (m_reflexOutput) {
+        return false;
+    }
 
     switch (newMode) {
         // Set up as output
@@ -94,6 +108,7 @@ bool DigitalInOut::Mode(ConnectorModes newMode) {
             // Force set output to avoid fault condition
             m_pulseActive = false;
             m_pulseStopPending = false;
+            m_sequence.Stop();
             OutputPin(false);
             ShiftReg.LedInPwm(m_ledMask, false, m_clearCorePin);
             PMUX_DISABLE(m_outputPort, m_outputDataBit);
@@ -101,6 +116,11 @@ bool DigitalInOut::Mode(ConnectorModes newMode) {
             IsInHwFault(false);
             break;
         case OUTPUT_PWM:
+            // In 16-bit mode the timer's first channel sets the period, and
+            // a reflex pulse link takes the whole timer
+            if (!m_tc || m_reflexTc || (!m_tcPadNum && PwmWide())) {
+                break;
+            }
             m_mode = newMode;
             State(0);
             ShiftReg.LedInPwm(m_ledMask, true, m_clearCorePin);
@@ -119,7 +139,7 @@ bool DigitalInOut::Mode(ConnectorModes newMode) {
 /**
     Update connector's state.
 **/
-void DigitalInOut::Refresh() {
+HOT_ISR_FUNC void DigitalInOut::Refresh() {
     DigitalIn::Refresh();
 
     switch (m_mode) {
@@ -146,6 +166,9 @@ void DigitalInOut::Refresh() {
                 m_overloadTripCnt = OVERLOAD_TRIP_TICKS;
                 IsInHwFault(false);
             }
+            if (m_sequence.Update()) {
+                SequenceOutput(m_sequence.Level());
+            }
             if (!m_pulseActive) {
                 break;
             }
@@ -216,16 +239,7 @@ int16_t DigitalInOut::State() {
             state = DigitalIn::State();
             break;
         case OUTPUT_PWM:
-            if (!m_tc) {
-                break;
-            }
-
-            if (m_logicInversion) {
-                state = m_tc->COUNT8.CCBUF[m_tcPadNum].reg;
-            }
-            else {
-                state = 255 - m_tc->COUNT8.CCBUF[m_tcPadNum].reg;
-            }
+            state = m_pwmDuty >> 8;
             break;
         default:
             state = 0;
@@ -235,17 +249,18 @@ int16_t DigitalInOut::State() {
 }
 
 bool DigitalInOut::State(int16_t newState) {
+    // The pin belongs to a reflex link until it is unlinked
+    if (m_reflexOutput) {
+        return false;
+    }
     bool success = false;
     m_pulseActive = false;
     m_pulseStopPending = false;
+    m_sequence.Stop();
 
     switch (m_mode) {
         case OUTPUT_DIGITAL:
-            if (m_outState != static_cast<bool>(newState)) {
-                m_overloadTripCnt = OVERLOAD_TRIP_TICKS;
-                m_outState = static_cast<bool>(newState);
-            }
-            OutputPin(newState && !m_overloadFoldbackCnt);
+            OutputPin(OutputLatch(newState));
             success = true;
             break;
         case INPUT_DIGITAL:
@@ -267,6 +282,17 @@ bool DigitalInOut::State(int16_t newState) {
     return success;
 }
 
+bool DigitalInOut::OutputLatch(bool newState) {
+    m_pulseActive = false;
+    m_pulseStopPending = false;
+    m_sequence.Stop();
+    if (m_outState != newState) {
+        m_overloadTripCnt = OVERLOAD_TRIP_TICKS;
+        m_outState = newState;
+    }
+    return newState && !m_overloadFoldbackCnt;
+}
+
 /**
     Initialize a digital input/output connector. Set to input mode.
 **/
@@ -276,6 +302,7 @@ void DigitalInOut::Initialize(ClearCorePins clearCorePin) {
     m_isInFault = false;
     m_pulseActive = false;
     m_pulseStopPending = false;
+    m_pwmDuty = 0;
 
     // Set up to multiplex with TC for periodic user output functions
     PMUX_SELECTION(m_outputPort, m_outputDataBit, PER_TIMER);
@@ -290,8 +317,8 @@ void DigitalInOut::Initialize(ClearCorePins clearCorePin) {
 
 void DigitalInOut::OutputPulsesStart(uint32_t onTime, uint32_t offTime,
                                      uint16_t pulseCount, bool blockUntilDone) {
-    // Do not start output pulses if we are in input mode
-    if (!IsWritable()) {
+    // Do not start output pulses if we are in input mode or reflex linked
+    if (!IsWritable() || m_reflexOutput) {
         return;
     }
     // Ignore pulses that never turn on or off
@@ -300,6 +327,7 @@ void DigitalInOut::OutputPulsesStart(uint32_t onTime, uint32_t offTime,
     }
 
     Mode(OUTPUT_DIGITAL);
+    m_sequence.Stop();
     m_pulseOnTicks = onTime * MS_TO_SAMPLES;
     m_pulseOffTicks = offTime * MS_TO_SAMPLES;
 
@@ -335,23 +363,170 @@ void DigitalInOut::OutputPulsesStop(bool stopImmediately) {
     }
 }
 
+bool DigitalInOut::OutputSequenceStart(const OutputSequenceStep *steps,
+                                       uint16_t count, uint16_t loops,
+                                       bool queue) {
+    // Do not start a sequence if we are in input mode or reflex linked
+    if (!IsWritable() || m_reflexOutput ||
+            !OutputSequencer::Valid(steps, count)) {
+        return false;
+    }
+
+    Mode(OUTPUT_DIGITAL);
+    __disable_irq();
+    if (m_sequence.Start(steps, count, loops, queue)) {
+        // The sequence replaces any pulses
+        m_pulseActive = false;
+        m_pulseStopPending = false;
+        SequenceOutput(m_sequence.Level());
+    }
+    __enable_irq();
+    return true;
+}
+
+void DigitalInOut::OutputSequenceStop() {
+    if (m_mode != OUTPUT_DIGITAL) {
+        return;
+    }
+    State(false);
+}
+
+HOT_ISR_FUNC void DigitalInOut::SequenceOutput(bool level) {
+    if (m_outState != level) {
+        // Reset the filter when the output changes (to prevent an overload
+        // condition being falsely reported)
+        m_overloadTripCnt = OVERLOAD_TRIP_TICKS;
+        m_outState = level;
+    }
+    // Drive the output pin if we are not in overload foldback
+    OutputPin(level && !m_overloadFoldbackCnt);
+}
+
 bool DigitalInOut::PwmDuty(uint8_t newDuty) {
+    // Scale so that UINT8_MAX maps to UINT16_MAX
+    return PwmDuty16(newDuty * (UINT16_MAX / UINT8_MAX));
+}
+
+bool DigitalInOut::PwmDuty16(uint16_t newDuty) {
     // Bail out if not in PWM output mode
     if (m_mode != OUTPUT_PWM) {
         return false;
     }
 
-    // Wait for the TC CC value to be ready to be written
-    uint8_t ccBufVal = (m_logicInversion) ? newDuty : 255 - newDuty;
-    if (m_tc->COUNT8.CCBUF[m_tcPadNum].reg != ccBufVal) {
-        uint32_t syncMask = m_tcPadNum ? TC_SYNCBUSY_CC1 : TC_SYNCBUSY_CC0;
+    m_pwmDuty = newDuty;
+    uint32_t ccBufVal = PwmCount(newDuty, PwmPeriod());
+    uint32_t syncMask = m_tcPadNum ? TC_SYNCBUSY_CC1 : TC_SYNCBUSY_CC0;
+
+    // Write the buffer so the new duty starts with the next period
+    if (PwmWide()) {
+        if (m_tc->COUNT16.CCBUF[m_tcPadNum].reg != ccBufVal) {
+            SYNCBUSY_WAIT(&m_tc->COUNT16, syncMask);
+            m_tc->COUNT16.CCBUF[m_tcPadNum].reg = ccBufVal;
+        }
+    }
+    else if (m_tc->COUNT8.CCBUF[m_tcPadNum].reg != ccBufVal) {
         SYNCBUSY_WAIT(&m_tc->COUNT8, syncMask);
         m_tc->COUNT8.CCBUF[m_tcPadNum].reg = ccBufVal;
     }
-    ShiftReg.LedPwmValue(m_clearCorePin, newDuty);
+    ShiftReg.LedPwmValue(m_clearCorePin, newDuty >> 8);
     return true;
 }
 
+bool DigitalInOut::PwmFrequency(uint32_t frequency, bool wide) {
+    if (!m_tc || m_reflexTc || frequency < PWM_FREQ_MIN ||
+            frequency > PWM_FREQ_MAX) {
+        return false;
+    }
+
+    // The connectors sharing a TC are adjacent: IO-0 and IO-1, IO-2 and
+    // IO-3, IO-4 and IO-5.
+    ClearCorePins partnerPin = static_cast<ClearCorePins>(m_clearCorePin ^ 1);
+    DigitalInOut *partner =
+        static_cast<DigitalInOut *>(SysMgr.ConnectorByIndex(partnerPin));
+    if (wide && (!m_tcPadNum || partner->m_mode == OUTPUT_PWM)) {
+        return false;
+    }
+
+    // Use the smallest prescaler that fits the period in the counter to
+    // get the most duty steps
+    uint32_t periodMax = wide ? UINT16_MAX + 1UL : UINT8_MAX + 1;
+    uint8_t prescaler = 0;
+    uint32_t period;
+    while (true) {
+        period = ((TC_CLK >> TcPrescalerShift[prescaler]) +
+                  frequency / 2) / frequency;
+        if (period <= periodMax ||
+                prescaler == TC_CTRLA_PRESCALER_DIV1024_Val) {
+            break;
+        }
+        prescaler++;
+    }
+
+    DigitalInOut *pads[2];
+    pads[m_tcPadNum] = this;
+    pads[!m_tcPadNum] = partner;
+
+    // MODE and PRESCALER can only be written while the TC is disabled
+    TcCount8 *tcCount8 = &m_tc->COUNT8;
+    TcCount16 *tcCount16 = &m_tc->COUNT16;
+    tcCount8->CTRLA.bit.ENABLE = 0;
+    SYNCBUSY_WAIT(tcCount8, TC_SYNCBUSY_ENABLE);
+
+    tcCount8->CTRLA.bit.MODE =
+        wide ? TC_CTRLA_MODE_COUNT16_Val : TC_CTRLA_MODE_COUNT8_Val;
+    tcCount8->CTRLA.bit.PRESCALER = prescaler;
+    tcCount8->WAVE.reg = wide ? TC_WAVE_WAVEGEN_MPWM : TC_WAVE_WAVEGEN_NPWM;
+
+    // Load the period and keep the duty of each connector in PWM mode
+    for (uint8_t pad = 0; pad < 2; pad++) {
+        DigitalInOut *output = pads[pad];
+        uint16_t duty = (output->m_mode == OUTPUT_PWM) ? output->m_pwmDuty : 0;
+        uint32_t ccVal = output->PwmCount(duty, period);
+        if (wide) {
+            if (!pad) {
+                ccVal = period - 1;
+            }
+            tcCount16->CC[pad].reg = ccVal;
+            tcCount16->CCBUF[pad].reg = ccVal;
+        }
+        else {
+            tcCount8->CC[pad].reg = ccVal;
+            tcCount8->CCBUF[pad].reg = ccVal;
+        }
+    }
+    if (!wide) {
+        tcCount8->PER.reg = period - 1;
+        tcCount8->PERBUF.reg = period - 1;
+    }
+    SYNCBUSY_WAIT(tcCount8, TC_SYNCBUSY_PER | TC_SYNCBUSY_CC0 |
+                  TC_SYNCBUSY_CC1);
+
+    tcCount8->COUNT.reg = 0;
+    tcCount8->CTRLA.bit.ENABLE = 1;
+    SYNCBUSY_WAIT(tcCount8, TC_SYNCBUSY_ENABLE);
+    return true;
+}
+
+uint32_t DigitalInOut::PwmFrequency() {
+    if (!m_tc) {
+        return 0;
+    }
+    uint8_t prescaler = m_tc->COUNT8.CTRLA.bit.PRESCALER;
+    return (TC_CLK >> TcPrescalerShift[prescaler]) / PwmPeriod();
+}
+
+uint32_t DigitalInOut::PwmResolution() {
+    return m_tc ? PwmPeriod() : 0;
+}
+
+uint32_t DigitalInOut::PwmCount(uint16_t duty, uint32_t period) {
+    // A compare value of period holds the output on for the whole period
+    uint32_t count = (duty * period + UINT16_MAX / 2) / UINT16_MAX;
+    count = m_logicInversion ? count : period - count;
+    // Unless the period fills the counter
+    return min(count, PwmWide() ? UINT16_MAX : UINT8_MAX);
+}
+
 void DigitalInOut::IsInHwFault(bool inFault) {
     if (inFault != m_isInFault) {
         m_isInFault = inFault;
@@ -30,18 +30,28 @@
 
 #include "DigitalInOutAnalogOut.h"
 #include <sam.h>
+#include "DmaManager.h"
+#include "InputManager.h"
 #include "NvmManager.h"
+#include "SysTiming.h"
 #include "SysUtils.h"
 
 #define DAC_BITS    11
 #define DAC_MAX_VALUE   (UINT16_MAX >> (16 - DAC_BITS))
 #define DAC_MAX_OUTPUT_UA   20000
 #define DAC_DEFAULT_SPAN    1700
+// TCC2 paces waveform playback; it shares the CPU clock with TCC3
+#define WAVEFORM_TCC        TCC2
+#define WAVEFORM_TCC_HZ     CPU_CLK
 
 namespace ClearCore {
 
 extern ShiftRegister ShiftReg;
-extern NvmManager &NvmMgr;
+extern SINGLETON_REF(InputManager) InputMgr;
+extern SINGLETON_REF(NvmManager) NvmMgr;
+
+// Second DMA descriptor for ping-pong waveform playback
+static DmacDescriptor waveformDescriptor __attribute__((aligned(16)));
 
 /**
     Construct, wire in the Input/Output pair, and set pad to input mode.
@@ -56,12 +66,16 @@ DigitalInOutAnalogOut::DigitalInOutAnalogOut(
       m_analogPort(outputAnalogInfo->gpioPort),
       m_analogDataBit(outputAnalogInfo->gpioPin),
       m_dacZero(0),
-      m_dacSpan(DAC_DEFAULT_SPAN) {}
+      m_dacSpan(DAC_DEFAULT_SPAN),
+      m_waveformActive(false),
+      m_waveformMode(WAVEFORM_LOOP),
+      m_waveformTables{nullptr, nullptr},
+      m_waveformLength(0) {}
 
 /**
     Do nothing if in analog output mode; otherwise call DigitalInOut's Refresh
 **/
-void DigitalInOutAnalogOut::Refresh() {
+HOT_ISR_FUNC void DigitalInOutAnalogOut::Refresh() {
     switch (m_mode) {
         case INPUT_DIGITAL:
         case OUTPUT_DIGITAL:
@@ -86,7 +100,12 @@ bool DigitalInOutAnalogOut::Mode(ConnectorModes newMode) {
         case OUTPUT_DIGITAL:
         case OUTPUT_PWM:
             // The DAC isn't needed in these modes
+            WaveformStop();
             DacDisable();
+            if (m_mode == OUTPUT_ANALOG) {
+                // The pin is a digital input again; restart its filter
+                InputMgr.DebounceEnable(m_inputPort, m_inputDataMask, true);
+            }
             // Leave the work to the base class
             DigitalInOut::Mode(newMode);
             break;
@@ -94,6 +113,8 @@ bool DigitalInOutAnalogOut::Mode(ConnectorModes newMode) {
             // Analog output requires the output pin to be turned off
             // similar to when we are in digital input mode
             DigitalInOut::Mode(INPUT_DIGITAL);
+            // The input follows the DAC, so freeze its filtered state
+            InputMgr.DebounceEnable(m_inputPort, m_inputDataMask, false);
             // Need the DAC for this mode
             DacEnable();
             m_mode = newMode;
@@ -271,19 +292,190 @@ void DigitalInOutAnalogOut::AnalogWrite(uint16_t value) {
     if (m_mode != OUTPUT_ANALOG) {
         return;
     }
+    if (m_waveformActive) {
+        WaveformStop();
+    }
+
+    value = min(value, DAC_MAX_VALUE);
+
+    // Set the LED blink value
+    ShiftReg.LedPwmValue(m_clearCorePin, value * UINT8_MAX / DAC_MAX_VALUE);
+
+    DacRegisterWrite(DacCommand(value));
+}
+
+HOT_ISR_FUNC bool DigitalInOutAnalogOut::AnalogWriteNoWait(uint16_t value) {
+    if (m_mode != OUTPUT_ANALOG || m_waveformActive ||
+            (DAC->SYNCBUSY.reg & DAC_SYNCBUSY_DATA0)) {
+        return false;
+    }
 
     value = min(value, DAC_MAX_VALUE);
 
     // Set the LED blink value
     ShiftReg.LedPwmValue(m_clearCorePin, value * UINT8_MAX / DAC_MAX_VALUE);
 
-    // Factor in calibration
+    DAC->DATA[0].reg = DacCommand(value);
+    return true;
+}
+
+/**
+    Factor in calibration
+**/
+uint16_t DigitalInOutAnalogOut::DacCommand(uint16_t value) {
+    value = min(value, DAC_MAX_VALUE);
     uint16_t command = ((static_cast<uint32_t>(value) * m_dacSpan)
                         / DAC_MAX_VALUE) + m_dacZero;
+    return min(command, DAC_MAX_VALUE);
+}
+
+/**
+    Start DMA playback of a table of output values
+**/
+bool DigitalInOutAnalogOut::Waveform(uint16_t *table, uint16_t length,
+                                     uint32_t rateHz, WaveformModes mode,
+                                     uint16_t *table2) {
+    if (m_mode != OUTPUT_ANALOG || !table || !length || !rateHz ||
+            rateHz > WAVEFORM_RATE_MAX_HZ ||
+            (mode == WAVEFORM_PING_PONG && !table2)) {
+        return false;
+    }
+    // Use the finest prescaler that lets the period fit in 16 bits
+    static const uint16_t prescalers[] = {1, 2, 4, 8, 16, 64, 256, 1024};
+    uint8_t prescaler = 0;
+    uint32_t period;
+    while (true) {
+        uint32_t clockHz = WAVEFORM_TCC_HZ / prescalers[prescaler];
+        period = (clockHz + rateHz / 2) / rateHz - 1;
+        if (period <= UINT16_MAX ||
+                ++prescaler == sizeof(prescalers) / sizeof(prescalers[0])) {
+            break;
+        }
+    }
+    if (period > UINT16_MAX) {
+        return false;
+    }
 
-    command = min(command, DAC_MAX_VALUE);
+    WaveformStop();
 
-    DacRegisterWrite(command);
+    // Calibrate the tables up front so that the DMA can write them directly
+    WaveformCalibrate(table, length);
+    if (mode == WAVEFORM_PING_PONG) {
+        WaveformCalibrate(table2, length);
+    }
+    m_waveformMode = mode;
+    m_waveformTables[0] = table;
+    m_waveformTables[1] = table2;
+    m_waveformLength = length;
+
+    /***************************************************************
+     * DMA_DAC_WAVEFORM Channel
+     * Write one table value to the DAC on each timer overflow.
+     ***************************************************************/
+    DmacChannel *channel = DmaManager::Channel(DMA_DAC_WAVEFORM);
+    DmacDescriptor *baseDesc = DmaManager::BaseDescriptor(DMA_DAC_WAVEFORM);
+    channel->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+    // Wait for the reset to finish
+    while (channel->CHCTRLA.reg == DMAC_CHCTRLA_SWRST) {
+        continue;
+    }
+    channel->CHCTRLA.reg = DMAC_CHCTRLA_TRIGSRC(TCC2_DMAC_ID_OVF) |
+                           DMAC_CHCTRLA_TRIGACT_BURST |
+                           DMAC_CHCTRLA_BURSTLEN_SINGLE;
+
+    // In ping-pong mode each finished table sets the transfer complete flag
+    uint16_t blockAction = (mode == WAVEFORM_PING_PONG)
+                           ? DMAC_BTCTRL_BLOCKACT_INT
+                           : DMAC_BTCTRL_BLOCKACT_NOACT;
+    DmacDescriptor *descs[2] = {baseDesc, &waveformDescriptor};
+    for (uint8_t i = 0; i < 2; i++) {
+        uint16_t *src = (i == 0) ? table : table2;
+        if (!src) {
+            break;
+        }
+        descs[i]->BTCTRL.reg = DMAC_BTCTRL_BEATSIZE_HWORD |
+                               DMAC_BTCTRL_SRCINC | DMAC_BTCTRL_VALID |
+                               blockAction;
+        descs[i]->BTCNT.reg = length;
+        // The source address is the end of the table
+        descs[i]->SRCADDR.reg = reinterpret_cast<uint32_t>(src + length);
+        descs[i]->DSTADDR.reg = reinterpret_cast<uint32_t>(&DAC->DATA[0].reg);
+    }
+    switch (mode) {
+        case WAVEFORM_ONE_SHOT:
+            baseDesc->DESCADDR.reg = 0;
+            break;
+        case WAVEFORM_PING_PONG:
+            baseDesc->DESCADDR.reg =
+                reinterpret_cast<uint32_t>(&waveformDescriptor);
+            waveformDescriptor.DESCADDR.reg =
+                reinterpret_cast<uint32_t>(baseDesc);
+            break;
+        case WAVEFORM_LOOP:
+        default:
+            baseDesc->DESCADDR.reg = reinterpret_cast<uint32_t>(baseDesc);
+            break;
+    }
+    channel->CHINTFLAG.reg = DMAC_CHINTFLAG_MASK;
+    channel->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+
+    // Pace the transfers with TCC2 in normal frequency mode
+    WAVEFORM_TCC->CTRLA.reg = TCC_CTRLA_PRESCALER(prescaler);
+    WAVEFORM_TCC->WAVE.reg = TCC_WAVE_WAVEGEN_NFRQ;
+    SYNCBUSY_WAIT(WAVEFORM_TCC, TCC_SYNCBUSY_WAVE);
+    WAVEFORM_TCC->PER.reg = period;
+    SYNCBUSY_WAIT(WAVEFORM_TCC, TCC_SYNCBUSY_PER);
+    WAVEFORM_TCC->COUNT.reg = 0;
+    SYNCBUSY_WAIT(WAVEFORM_TCC, TCC_SYNCBUSY_COUNT);
+    WAVEFORM_TCC->CTRLA.bit.ENABLE = 1;
+    SYNCBUSY_WAIT(WAVEFORM_TCC, TCC_SYNCBUSY_ENABLE);
+
+    m_waveformActive = true;
+    return true;
+}
+
+void DigitalInOutAnalogOut::WaveformStop() {
+    WAVEFORM_TCC->CTRLA.bit.ENABLE = 0;
+    SYNCBUSY_WAIT(WAVEFORM_TCC, TCC_SYNCBUSY_ENABLE);
+    DmaManager::Channel(DMA_DAC_WAVEFORM)->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+    m_waveformActive = false;
+}
+
+bool DigitalInOutAnalogOut::WaveformActive() {
+    if (m_waveformActive && m_waveformMode == WAVEFORM_ONE_SHOT) {
+        // The channel disables itself after the last value
+        return DmaManager::Channel(DMA_DAC_WAVEFORM)->CHCTRLA.bit.ENABLE;
+    }
+    return m_waveformActive;
+}
+
+uint16_t *DigitalInOutAnalogOut::WaveformBufferFree() {
+    if (!m_waveformActive || m_waveformMode != WAVEFORM_PING_PONG) {
+        return nullptr;
+    }
+    DmacChannel *channel = DmaManager::Channel(DMA_DAC_WAVEFORM);
+    if (!channel->CHINTFLAG.bit.TCMPL) {
+        return nullptr;
+    }
+    // Clear the flag before looking at which table is playing, so a table
+    // that finishes after this point is reported by the next call
+    channel->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+    // More than one table may have finished since the last call, so find
+    // the one playing from the channel's write-back descriptor rather than
+    // by counting. Its source address is the end of the table playing.
+    uint32_t playingEnd =
+        DmaManager::WriteBackDescriptor(DMA_DAC_WAVEFORM)->SRCADDR.reg;
+    uint16_t *table1 = m_waveformTables[1];
+    bool playing1 = playingEnd ==
+                    reinterpret_cast<uint32_t>(table1 + m_waveformLength);
+    return m_waveformTables[playing1 ? 0 : 1];
+}
+
+void DigitalInOutAnalogOut::WaveformCalibrate(uint16_t *values,
+                                              uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        values[i] = DacCommand(values[i]);
+    }
 }
 
 /**
@@ -347,6 +539,9 @@ void DigitalInOutAnalogOut::AnalogWriteUncalibrated(uint16_t value) {
     if (m_mode != OUTPUT_ANALOG) {
         return;
     }
+    if (m_waveformActive) {
+        WaveformStop();
+    }
 
     value = min(value, DAC_MAX_VALUE);
 
@@ -28,9 +28,14 @@
 
 #include "DigitalInOutHBridge.h"
 #include <arm_math.h>
+#include <math.h>
 #include <sam.h>
 #include <stdlib.h>
 #include "DigitalInOut.h"
+#include "DmaManager.h"
+#include "EncoderInput.h"
+#include "InputManager.h"
+#include "PidLoop.h"
 #include "StatusManager.h"
 #include "SysTiming.h"
 #include "SysUtils.h"
@@ -45,33 +50,71 @@ namespace ClearCore {
 // PWM related constants
 #define TONE_RATE_HZ (22050)
 #define TONE_MAXIMUM_FREQ_HZ (TONE_RATE_HZ / 4)
+// Envelope gain at full amplitude
+#define TONE_GAIN_FULL (1UL << 24)
 
+extern SINGLETON_REF(AdcManager) AdcMgr;
+extern EncoderInput EncoderIn;
+extern SINGLETON_REF(InputManager) InputMgr;
 extern ShiftRegister ShiftReg;
 extern volatile uint32_t tickCnt;
 
+// Second DMA descriptor of each tone channel's ping-pong pair. These live
+// outside the class so connector objects stay assignable.
+static DmacDescriptor toneDescriptor[DMA_CHANNEL_COUNT - DMA_IO4_TONE_A]
+__attribute__((aligned(16)));
+
+extern DigitalInOutHBridge ConnectorIO4;
+extern DigitalInOutHBridge ConnectorIO5;
+
 DigitalInOutHBridge::DigitalInOutHBridge(ShiftRegister::Masks ledMask,
         const PeripheralRoute *inputInfo,
         const PeripheralRoute *outputInfo,
         const PeripheralRoute *pwmAInfo,
         const PeripheralRoute *pwmBInfo,
-        IRQn_Type tccIrq,
+        DmaChannels toneDma,
         bool invertDigitalLogic)
     : DigitalInOut(ledMask,
                    inputInfo,
                    outputInfo,
                    invertDigitalLogic),
       m_amplitude(INT16_MAX / 10),
-      m_sinStep(0),
-      m_angle(0),
+      m_phase{0, 0},
+      m_phaseStep{0, 0},
+      m_chirpStep(0),
+      m_chirpSamples(0),
+      m_toneGain(0),
+      m_attackStep(TONE_GAIN_FULL),
+      m_releaseStep(0),
       m_toneStartTick(0),
       m_toneOnTicks(0),
       m_toneOffTicks(0),
       m_toneState(TONE_OFF),
       m_pwmAInfo(pwmAInfo),
       m_pwmBInfo(pwmBInfo),
-      m_tccIrq(tccIrq),
       m_inFault(false),
-      m_forceToneDuration(false) {
+      m_forceToneDuration(false),
+      m_dcMode(DC_MOTOR_OFF),
+      m_dcSenseChannel(AdcManager::ADC_CHANNEL_COUNT),
+      m_dcSenseFullScale(0),
+      m_dcCurrentLimit(0),
+      m_dcCommand(0),
+      m_dcKp(0),
+      m_dcKi(0),
+      m_dcVelocityKp(0),
+      m_dcVelocityKi(0),
+      m_dcIntegral(0),
+      m_dcVelocityIntegral(0),
+      m_dcOutput(0),
+      m_dcStallSamples(0),
+      m_dcStallCount(0),
+      m_dcStalled(false),
+      m_dcCurrent(0),
+      m_toneDma(toneDma),
+      m_toneRunning(false),
+      m_toneSilent(false),
+      m_toneNextFree(0),
+      m_toneCyclesMax(0) {
     static Tcc *const tcc_modules[TCC_INST_NUM] = TCC_INSTS;
     m_tcc = tcc_modules[pwmAInfo->tccNum];
 }
@@ -122,8 +165,6 @@ int16_t DigitalInOutHBridge::State() {
 bool DigitalInOutHBridge::State(int16_t newState) {
     bool success = false;
 
-    uint16_t halfDuty = m_tcc->PER.reg >> 1; // 50% duty cycle
-
     switch (m_mode) {
         case INPUT_DIGITAL:
         case OUTPUT_DIGITAL:
@@ -132,17 +173,11 @@ bool DigitalInOutHBridge::State(int16_t newState) {
             success = DigitalInOut::State(newState);
             break;
         case OUTPUT_H_BRIDGE:
-            if (newState == INT16_MIN) {
-                ShiftReg.LedPwmValue(m_clearCorePin, UINT8_MAX);
-            }
-            else {
-                ShiftReg.LedPwmValue(m_clearCorePin, labs(newState) >> 7);
-            }
+            // Setting the output directly takes over from the DC motor drive
+            m_dcMode = DC_MOTOR_OFF;
         // Fall through
         case OUTPUT_TONE:
-            // Create a PWM differential where state 0 is 50/50 duty cycles
-            m_tcc->CCBUF[0].reg = halfDuty + halfDuty * newState / INT16_MAX;
-            m_tcc->CCBUF[1].reg = halfDuty - halfDuty * newState / INT16_MAX;
+            BridgeWrite(newState);
             success = true;
             break;
         default:
@@ -152,7 +187,23 @@ bool DigitalInOutHBridge::State(int16_t newState) {
     return success;
 }
 
-void DigitalInOutHBridge::Refresh() {
+void DigitalInOutHBridge::BridgeWrite(int16_t value) {
+    uint16_t halfDuty = m_tcc->PER.reg >> 1; // 50% duty cycle
+
+    if (m_mode == OUTPUT_H_BRIDGE) {
+        if (value == INT16_MIN) {
+            ShiftReg.LedPwmValue(m_clearCorePin, UINT8_MAX);
+        }
+        else {
+            ShiftReg.LedPwmValue(m_clearCorePin, labs(value) >> 7);
+        }
+    }
+    // Create a PWM differential where state 0 is 50/50 duty cycles
+    m_tcc->CCBUF[0].reg = halfDuty + halfDuty * value / INT16_MAX;
+    m_tcc->CCBUF[1].reg = halfDuty - halfDuty * value / INT16_MAX;
+}
+
+HOT_ISR_FUNC void DigitalInOutHBridge::Refresh() {
     switch (m_mode) {
         case INPUT_DIGITAL:
         case OUTPUT_DIGITAL:
@@ -163,6 +214,7 @@ void DigitalInOutHBridge::Refresh() {
         case OUTPUT_WAVE:
             break;
         case OUTPUT_H_BRIDGE:
+            DcMotorUpdate();
             break;
         case OUTPUT_TONE:
             switch (m_toneState) {
@@ -185,8 +237,6 @@ void DigitalInOutHBridge::Refresh() {
                 case TONE_PERIODIC_OFF:
                     if (tickCnt - m_toneStartTick > m_toneOffTicks) {
                         m_toneState = TONE_PERIODIC_ON;
-                        // Interrupt every period
-                        m_tcc->INTENSET.bit.OVF = 1;
                         m_toneStartTick = tickCnt;
                         ShiftReg.LedInPwm(m_ledMask, true, m_clearCorePin);
                     }
@@ -201,25 +251,166 @@ void DigitalInOutHBridge::Refresh() {
     }
 }
 
-void DigitalInOutHBridge::ToneUpdate() {
-    int32_t nextAngle = static_cast<int32_t>(m_angle) + m_sinStep;
-    // When a tone is active, or a tone is ending and we haven't yet reached
-    // the end of the final sine wave, find the next value to output
-    if ((ToneActiveState() && (ToneActiveState() != TONE_PERIODIC_OFF)) ||
-            (m_mode == OUTPUT_TONE && nextAngle < INT16_MAX)) {
-        // Increment the current angle and clip to q15 [0 +1)
-        m_angle = nextAngle & INT16_MAX;
-        State(static_cast<int16_t>((static_cast<int32_t>(arm_sin_q15(m_angle)) *
-                                    m_amplitude) >> 15));
+void DigitalInOutHBridge::ToneStart() {
+    if (m_toneRunning) {
+        return;
+    }
+    static const uint8_t tccOvfTriggers[TCC_INST_NUM] = {
+        TCC0_DMAC_ID_OVF, TCC1_DMAC_ID_OVF, TCC2_DMAC_ID_OVF,
+        TCC3_DMAC_ID_OVF, TCC4_DMAC_ID_OVF
+    };
+
+    // Fill both blocks before the first transfer. Mask the sample interrupt
+    // so Refresh() cannot change the tone state partway through a block.
+    NVIC_DisableIRQ(TCC0_0_IRQn);
+    m_toneNextFree = 0;
+    m_toneSilent = !ToneFill(0);
+    m_toneSilent = !ToneFill(1) && m_toneSilent;
+    NVIC_EnableIRQ(TCC0_0_IRQn);
+
+    /***************************************************************
+     * Tone DMA channels
+     * Write the next value of each compare buffer on each TCC overflow,
+     * alternating between the two blocks of each buffer.
+     ***************************************************************/
+    for (uint8_t leg = 0; leg < 2; leg++) {
+        DmaChannels index = static_cast<DmaChannels>(m_toneDma + leg);
+        DmacChannel *channel = DmaManager::Channel(index);
+        channel->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+        // Wait for the reset to finish
+        while (channel->CHCTRLA.reg == DMAC_CHCTRLA_SWRST) {
+            continue;
+        }
+        channel->CHCTRLA.reg =
+            DMAC_CHCTRLA_TRIGSRC(tccOvfTriggers[m_pwmAInfo->tccNum]) |
+            DMAC_CHCTRLA_TRIGACT_BURST |
+            DMAC_CHCTRLA_BURSTLEN_SINGLE;
+
+        DmacDescriptor *descs[2] = {
+            DmaManager::BaseDescriptor(index),
+            &toneDescriptor[index - DMA_IO4_TONE_A]
+        };
+        for (uint8_t block = 0; block < 2; block++) {
+            // Each finished block sets the transfer complete flag
+            descs[block]->BTCTRL.reg = DMAC_BTCTRL_BEATSIZE_HWORD |
+                                       DMAC_BTCTRL_SRCINC |
+                                       DMAC_BTCTRL_VALID |
+                                       DMAC_BTCTRL_BLOCKACT_INT;
+            descs[block]->BTCNT.reg = TONE_BLOCK_SAMPLES;
+            // The source address is the end of the block
+            uint16_t *src = m_toneBuffer[block][leg];
+            descs[block]->SRCADDR.reg =
+                reinterpret_cast<uint32_t>(src + TONE_BLOCK_SAMPLES);
+            descs[block]->DSTADDR.reg =
+                reinterpret_cast<uint32_t>(&m_tcc->CCBUF[leg].reg);
+            descs[block]->DESCADDR.reg =
+                reinterpret_cast<uint32_t>(descs[block ^ 1]);
+        }
+        channel->CHINTFLAG.reg = DMAC_CHINTFLAG_MASK;
+        channel->CHCTRLA.reg |= DMAC_CHCTRLA_ENABLE;
+    }
+    m_toneRunning = true;
+    // Both channels run in step, so the first one paces the refills
+    DmaManager::Channel(m_toneDma)->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;
+}
+
+void DigitalInOutHBridge::ToneEnd() {
+    // Clear the flag first so that a refill interrupt taken part way
+    // through leaves the playback alone
+    m_toneRunning = false;
+    DmaManager::Channel(m_toneDma)->CHINTENCLR.reg = DMAC_CHINTENCLR_TCMPL;
+    for (uint8_t leg = 0; leg < 2; leg++) {
+        DmaManager::Channel(static_cast<DmaChannels>(m_toneDma + leg))
+        ->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+    }
+    m_toneGain = 0;
+    m_phase[0] = m_phase[1] = 0;
+    State(0);
+}
+
+void DigitalInOutHBridge::ToneService() {
+    if (!m_toneRunning) {
+        return;
+    }
+    DmacChannel *channel = DmaManager::Channel(m_toneDma);
+    if (!channel->CHINTFLAG.bit.TCMPL) {
+        return;
+    }
+    uint32_t startCycles = DWT->CYCCNT;
+    channel->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+    DmaManager::Channel(static_cast<DmaChannels>(m_toneDma + 1))
+    ->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+
+    bool sounding = ToneFill(m_toneNextFree);
+    m_toneNextFree ^= 1;
+    // Once a silent block has played out and the next is silent too, the
+    // tone is over. Periodic tones keep the playback running between beeps.
+    if (!sounding && m_toneSilent && m_toneState == TONE_OFF) {
+        ToneEnd();
     }
     else {
-        // End the tone output and disable the interrupt
-        m_tcc->INTENCLR.bit.OVF = 1;
-        m_angle = 0;
-        State(0);
+        m_toneSilent = !sounding;
+    }
+
+    uint32_t cycles = DWT->CYCCNT - startCycles;
+    if (cycles > m_toneCyclesMax) {
+        m_toneCyclesMax = cycles;
     }
 }
 
+bool DigitalInOutHBridge::ToneFill(uint8_t block) {
+    bool active = m_toneState != TONE_OFF &&
+                  m_toneState != TONE_PERIODIC_OFF;
+    int32_t halfDuty = m_tcc->PER.reg >> 1; // 50% duty cycle
+    uint16_t *legA = m_toneBuffer[block][0];
+    uint16_t *legB = m_toneBuffer[block][1];
+    bool sounding = false;
+
+    for (uint8_t i = 0; i < TONE_BLOCK_SAMPLES; i++) {
+        // Step the envelope
+        if (active) {
+            m_toneGain = min(m_toneGain + m_attackStep, TONE_GAIN_FULL);
+        }
+        else if (m_releaseStep) {
+            m_toneGain = (m_toneGain > m_releaseStep)
+                         ? m_toneGain - m_releaseStep : 0;
+        }
+        else if (!m_phaseStep[0] ||
+                 m_phase[0] + m_phaseStep[0] < m_phase[0]) {
+            // Without a release, end at the end of the current sine wave
+            m_toneGain = 0;
+        }
+
+        if (!m_toneGain) {
+            // Silent; start the next tone at the beginning of a sine wave
+            m_phase[0] = m_phase[1] = 0;
+            legA[i] = legB[i] = halfDuty;
+            continue;
+        }
+        sounding = true;
+
+        // The top 15 bits of the phase are the q15 angle
+        int32_t level = arm_sin_q15(m_phase[0] >> 17);
+        if (m_phaseStep[1]) {
+            level = (level + arm_sin_q15(m_phase[1] >> 17)) >> 1;
+            m_phase[1] += m_phaseStep[1];
+        }
+        m_phase[0] += m_phaseStep[0];
+        if (m_chirpSamples) {
+            m_phaseStep[0] += m_chirpStep;
+            m_chirpSamples--;
+        }
+        level = (level * m_amplitude) >> 15;
+        level = (level * static_cast<int32_t>(m_toneGain >> 9)) >> 15;
+
+        // Create a PWM differential where level 0 is 50/50 duty cycles
+        int32_t delta = (halfDuty * level) >> 15;
+        legA[i] = halfDuty + delta;
+        legB[i] = halfDuty - delta;
+    }
+    return sounding;
+}
+
 void DigitalInOutHBridge::Initialize(ClearCorePins clearCorePin) {
     DigitalInOut::Initialize(clearCorePin);
     // Mode is now INPUT_DIGITAL
@@ -237,7 +428,7 @@ void DigitalInOutHBridge::Initialize(ClearCorePins clearCorePin) {
     m_tcc->CTRLBCLR.bit.LUPD = 1;
     // TCC using dual-slope bottom PWM
     m_tcc->WAVE.reg |= TCC_WAVE_WAVEGEN_DSBOTTOM;
-    // Interrupt every period when in TONE_OUTPUT, off for now
+    // Tones are streamed by DMA, so no period interrupt is needed
     m_tcc->INTENCLR.bit.OVF = 1;
     // Set the period for the TCC
     m_tcc->PER.reg = SystemCoreClock / (TONE_RATE_HZ << 1) - 1;
@@ -261,12 +452,40 @@ void DigitalInOutHBridge::Initialize(ClearCorePins clearCorePin) {
     PMUX_SELECTION(m_pwmBInfo->gpioPort, m_pwmBInfo->gpioPin, PER_TIMER_ALT);
 }
 
-void DigitalInOutHBridge::ToneFrequency(uint16_t frequency) {
+/**
+    Phase accumulator step of a tone frequency
+**/
+static uint32_t TonePhaseStep(uint16_t frequency) {
     // Enforce a maximum frequency to stay under the Nyquist frequency
     if (frequency > TONE_MAXIMUM_FREQ_HZ) {
         frequency = TONE_MAXIMUM_FREQ_HZ;
     }
-    m_sinStep = static_cast<int32_t>(INT16_MAX) * frequency / TONE_RATE_HZ;
+    return (static_cast<uint64_t>(frequency) << 32) / TONE_RATE_HZ;
+}
+
+void DigitalInOutHBridge::ToneFrequency(uint16_t frequency) {
+    uint32_t phaseStep = TonePhaseStep(frequency);
+    __disable_irq();
+    m_phaseStep[0] = phaseStep;
+    m_chirpSamples = 0;
+    __enable_irq();
+}
+
+void DigitalInOutHBridge::ToneMix(uint16_t frequency) {
+    m_phaseStep[1] = frequency ? TonePhaseStep(frequency) : 0;
+}
+
+void DigitalInOutHBridge::ToneEnvelope(uint16_t attack, uint16_t release) {
+    uint32_t attackSamples = static_cast<uint32_t>(attack) *
+                             TONE_RATE_HZ / 1000;
+    uint32_t releaseSamples = static_cast<uint32_t>(release) *
+                              TONE_RATE_HZ / 1000;
+    __disable_irq();
+    m_attackStep = attackSamples ? max(TONE_GAIN_FULL / attackSamples, 1UL)
+                   : TONE_GAIN_FULL;
+    m_releaseStep = releaseSamples
+                    ? max(TONE_GAIN_FULL / releaseSamples, 1UL) : 0;
+    __enable_irq();
 }
 
 void DigitalInOutHBridge::ToneAmplitude(int16_t amplitude) {
@@ -284,41 +503,76 @@ void DigitalInOutHBridge::ToneContinuous(uint16_t frequency) {
     ShiftReg.LedInPwm(m_ledMask, true, m_clearCorePin);
     ToneFrequency(frequency);
     m_toneState = TONE_CONTINUOUS;
-    // Interrupt every period
-    m_tcc->INTENSET.bit.OVF = 1;
+    ToneStart();
 }
 
 void DigitalInOutHBridge::ToneTimed(uint16_t frequency, uint32_t duration,
                                     bool blocking, bool forceDuration) {
-    if (m_mode != OUTPUT_TONE) {
+    if (!ToneTimedStart(frequency, frequency, duration, forceDuration)) {
         return;
     }
+    if (blocking && duration) {
+        while (ToneActiveState()) {
+            continue;
+        }
+    }
+}
+
+void DigitalInOutHBridge::ToneChirp(uint16_t startFrequency,
+                                    uint16_t endFrequency, uint32_t duration,
+                                    bool blocking, bool forceDuration) {
+    if (!duration ||
+            !ToneTimedStart(startFrequency, endFrequency, duration,
+                            forceDuration)) {
+        return;
+    }
+    if (blocking) {
+        while (ToneActiveState()) {
+            continue;
+        }
+    }
+}
+
+bool DigitalInOutHBridge::ToneTimedStart(uint16_t startFrequency,
+        uint16_t endFrequency,
+        uint32_t duration,
+        bool forceDuration) {
+    if (m_mode != OUTPUT_TONE) {
+        return false;
+    }
 
     if (m_toneState == TONE_TIMED && m_forceToneDuration) {
         // There is already a timed tone with strict duration playing that
         // hasn't sounded for the full duration. Wait for it to finish
         // before generating a new tone.
-        return;
+        return false;
     }
 
     ShiftReg.LedInPwm(m_ledMask, true, m_clearCorePin);
-    ToneFrequency(frequency);
+    ToneFrequency(startFrequency);
+    if (endFrequency != startFrequency) {
+        // Sweep the phase step linearly over the tone's samples
+        uint32_t samples = min(static_cast<uint64_t>(duration) *
+                               TONE_RATE_HZ / 1000, UINT32_MAX);
+        int64_t stepChange =
+            static_cast<int64_t>(TonePhaseStep(endFrequency)) -
+            TonePhaseStep(startFrequency);
+        __disable_irq();
+        m_chirpStep = stepChange / static_cast<int64_t>(max(samples, 1UL));
+        m_chirpSamples = samples;
+        __enable_irq();
+    }
     m_toneStartTick = tickCnt;
     m_toneOnTicks = duration * MS_TO_SAMPLES;
-    m_tcc->INTENSET.bit.OVF = 1; // Interrupt every period
     if (duration == 0) {
         m_toneState = TONE_CONTINUOUS;
     }
     else {
         m_toneState = TONE_TIMED;
         m_forceToneDuration = forceDuration;
-
-        if (blocking) {
-            while (ToneActiveState()) {
-                continue;
-            }
-        }
     }
+    ToneStart();
+    return true;
 }
 
 void DigitalInOutHBridge::TonePeriodic(uint16_t frequency, uint32_t timeOn,
@@ -333,8 +587,7 @@ void DigitalInOutHBridge::TonePeriodic(uint16_t frequency, uint32_t timeOn,
     m_toneOnTicks = timeOn * MS_TO_SAMPLES;
     m_toneOffTicks = timeOff * MS_TO_SAMPLES;
     m_toneState = TONE_PERIODIC_ON;
-    // Interrupt every period
-    m_tcc->INTENSET.bit.OVF = 1;
+    ToneStart();
 }
 
 void DigitalInOutHBridge::ToneStop() {
@@ -361,12 +614,27 @@ bool DigitalInOutHBridge::Mode(ConnectorModes newMode) {
     // Note: having the TCC control a pin will disconnect the CPU pins.
     bool tccControlPwm = false;
 
+    m_dcMode = DC_MOTOR_OFF;
+    if (m_mode == OUTPUT_TONE) {
+        // Leaving tone mode; silence any tone still playing
+        if (m_toneRunning) {
+            ToneEnd();
+        }
+        m_toneState = TONE_OFF;
+        m_forceToneDuration = false;
+    }
+
     switch (newMode) {
         case INPUT_DIGITAL:
         case OUTPUT_DIGITAL:
         // Fall through. INPUT_DIGITAL, OUTPUT_DIGITAL, and OUTPUT_PWM
         // all are run by the DigitalInOut class
         case OUTPUT_PWM:
+            if (m_mode == OUTPUT_TONE || m_mode == OUTPUT_H_BRIDGE ||
+                    m_mode == OUTPUT_WAVE) {
+                // The pin is a digital input again; restart its filter
+                InputMgr.DebounceEnable(m_inputPort, m_inputDataMask, true);
+            }
             // Update the LED pattern
             ShiftReg.LedInPwm(m_ledMask, false, m_clearCorePin);
             modeChangeSuccess = DigitalInOut::Mode(newMode);
@@ -379,6 +647,8 @@ bool DigitalInOutHBridge::Mode(ConnectorModes newMode) {
         case OUTPUT_WAVE:
             DATA_OUTPUT_STATE(m_outputPort, m_outputDataMask, !m_inFault);
             PMUX_DISABLE(m_outputPort, m_outputDataBit);
+            // The input follows the bridge, so freeze its filtered state
+            InputMgr.DebounceEnable(m_inputPort, m_inputDataMask, false);
             tccControlPwm = true;
             modeChangeSuccess = true;
 
@@ -418,6 +688,11 @@ bool DigitalInOutHBridge::Mode(ConnectorModes newMode) {
 
 void DigitalInOutHBridge::FaultState(bool isFaulted) {
     m_inFault = isFaulted;
+    if (isFaulted) {
+        // Don't wind up the drive against a disabled bridge
+        m_dcMode = DC_MOTOR_OFF;
+        m_dcOutput = 0;
+    }
     // Disable H-bridge driver when in an overload state
     switch (Mode()) {
         case OUTPUT_H_BRIDGE:
@@ -430,4 +705,153 @@ void DigitalInOutHBridge::FaultState(bool isFaulted) {
     }
 }
 
-} // ClearCore namespace
\ No newline at end of file
+bool DigitalInOutHBridge::DcMotorCurrentSense(
+    AdcManager::AdcChannels adcChannel, uint16_t fullScale) {
+    if (adcChannel >= AdcManager::ADC_CHANNEL_COUNT || !fullScale) {
+        return false;
+    }
+    __disable_irq();
+    m_dcSenseChannel = adcChannel;
+    m_dcSenseFullScale = fullScale;
+    __enable_irq();
+    return true;
+}
+
+bool DigitalInOutHBridge::DcMotorCurrentGains(float kp, float ki) {
+    int32_t kpQ16, kiQ24;
+    if (!PidLoop::PiGains(kp, ki, kpQ16, kiQ24)) {
+        return false;
+    }
+    __disable_irq();
+    m_dcKp = kpQ16;
+    m_dcKi = kiQ24;
+    __enable_irq();
+    return true;
+}
+
+bool DigitalInOutHBridge::DcMotorVelocityGains(float kp, float ki) {
+    int32_t kpQ16, kiQ24;
+    if (!PidLoop::PiGains(kp, ki, kpQ16, kiQ24)) {
+        return false;
+    }
+    __disable_irq();
+    m_dcVelocityKp = kpQ16;
+    m_dcVelocityKi = kiQ24;
+    __enable_irq();
+    return true;
+}
+
+void DigitalInOutHBridge::DcMotorCurrentLimit(uint16_t limit) {
+    m_dcCurrentLimit = limit;
+}
+
+void DigitalInOutHBridge::DcMotorStallTime(uint16_t stallTime) {
+    __disable_irq();
+    m_dcStallSamples = stallTime * MS_TO_SAMPLES;
+    m_dcStallCount = 0;
+    __enable_irq();
+}
+
+bool DigitalInOutHBridge::DcMotorTorque(int32_t current) {
+    return DcMotorStart(DC_MOTOR_TORQUE, current);
+}
+
+bool DigitalInOutHBridge::DcMotorVelocity(int32_t velocity) {
+    return DcMotorStart(DC_MOTOR_VELOCITY, velocity);
+}
+
+bool DigitalInOutHBridge::DcMotorStart(DcMotorModes mode, int32_t command) {
+    // Nothing bounds the motor current until a limit is set
+    if (m_mode != OUTPUT_H_BRIDGE ||
+            m_dcSenseChannel >= AdcManager::ADC_CHANNEL_COUNT ||
+            !m_dcCurrentLimit) {
+        return false;
+    }
+    __disable_irq();
+    if (m_dcMode != mode) {
+        // Start the loops from rest when entering a mode
+        m_dcIntegral = 0;
+        m_dcVelocityIntegral = 0;
+        m_dcStallCount = 0;
+    }
+    m_dcCommand = command;
+    m_dcStalled = false;
+    m_dcMode = mode;
+    __enable_irq();
+    return true;
+}
+
+void DigitalInOutHBridge::DcMotorStop() {
+    __disable_irq();
+    m_dcMode = DC_MOTOR_OFF;
+    m_dcOutput = 0;
+    if (m_mode == OUTPUT_H_BRIDGE) {
+        BridgeWrite(0);
+    }
+    __enable_irq();
+}
+
+HOT_ISR_FUNC void DigitalInOutHBridge::DcMotorUpdate() {
+    if (m_dcMode == DC_MOTOR_OFF) {
+        return;
+    }
+
+    // The feedback is the current magnitude; sign it by the drive direction
+    int32_t current =
+        (static_cast<uint32_t>(AdcMgr.ConvertedResult(m_dcSenseChannel)) *
+         m_dcSenseFullScale) >> 15;
+    if (m_dcOutput < 0) {
+        current = -current;
+    }
+    m_dcCurrent = current;
+
+    int32_t target;
+    bool stalling;
+    if (m_dcMode == DC_MOTOR_VELOCITY) {
+        int32_t velocity = EncoderIn.Velocity();
+        target = PidLoop::PiStep(m_dcVelocityKp, m_dcVelocityKi,
+                                 m_dcVelocityIntegral, m_dcCommand - velocity,
+                                 0, -m_dcCurrentLimit, m_dcCurrentLimit);
+        m_dcOutput = PidLoop::PiStep(m_dcKp, m_dcKi, m_dcIntegral,
+                                     target - current, 0, -INT16_MAX,
+                                     INT16_MAX);
+        // Stall: asking for the full current limit and still short of half
+        // the commanded velocity
+        stalling = labs(target) >= m_dcCurrentLimit &&
+                   labs(velocity) < labs(m_dcCommand) / 2;
+    }
+    else {
+        target = max(min(m_dcCommand, m_dcCurrentLimit), -m_dcCurrentLimit);
+        m_dcOutput = PidLoop::PiStep(m_dcKp, m_dcKi, m_dcIntegral,
+                                     target - current, 0, -INT16_MAX,
+                                     INT16_MAX);
+        // Holding current at standstill is normal in torque mode, so only a
+        // current loop driving the bridge flat out counts toward a stall
+        stalling = labs(m_dcOutput) >= INT16_MAX;
+    }
+    BridgeWrite(m_dcOutput);
+
+    if (m_dcStallSamples && stalling) {
+        if (++m_dcStallCount >= m_dcStallSamples) {
+            m_dcStalled = true;
+            m_dcMode = DC_MOTOR_OFF;
+            m_dcOutput = 0;
+            BridgeWrite(0);
+        }
+    }
+    else {
+        m_dcStallCount = 0;
+    }
+}
+
+/**
+    Tone block refills for IO-4 and IO-5. The tone DMA channels share this
+    interrupt line with the other channels from 4 up, which do not enable
+    their interrupts.
+**/
+extern "C" void DMAC_4_Handler(void) {
+    ConnectorIO4.ToneService();
+    ConnectorIO5.ToneService();
+}
+
+} // ClearCore namespace
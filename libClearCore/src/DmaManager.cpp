@@ -29,12 +29,15 @@
 #include "DmaManager.h"
 #include <stddef.h>
 #include <sam.h>
+#include "SysSingleton.h"
 #include "SysUtils.h"
 
 namespace ClearCore {
 
 // Interrupt priority 0(High) - 7(Low)
 #define DMA_COMPLETE_PRIORITY 2
+// Tone block refills run below the sample-rate interrupt
+#define DMA_TONE_PRIORITY 5
 
 #if (DMA_CHANNEL_COUNT > DMAC_CH_NUM)
 #error "Attempting to use more DMA channels than available on the device"
@@ -49,12 +52,7 @@ DmacDescriptor DmaManager::descriptorBase[DMA_CHANNEL_COUNT] __attribute__((
             aligned(16)));
 #endif
 
-DmaManager &DmaMgr = DmaManager::Instance();
-
-DmaManager &DmaManager::Instance() {
-    static DmaManager *instance = new DmaManager();
-    return *instance;
-}
+SINGLETON_DEFINE(DmaManager, DmaMgr)
 
 void DmaManager::Initialize() {
     /***********************************************************
@@ -72,8 +70,10 @@ void DmaManager::Initialize() {
 
     /* Disable GPDMA interrupt */
     NVIC_DisableIRQ(DMAC_0_IRQn);
+    NVIC_DisableIRQ(DMAC_4_IRQn);
     /* Initialize DMA interrupt priority  */
     NVIC_SetPriority(DMAC_0_IRQn, DMA_COMPLETE_PRIORITY);
+    NVIC_SetPriority(DMAC_4_IRQn, DMA_TONE_PRIORITY);
 
     // Tell the DMAC where the descriptors are (must be located in SRAM)
     DMAC->BASEADDR.reg = (uint32_t)descriptorBase;
@@ -85,6 +85,7 @@ void DmaManager::Initialize() {
     DMAC->DBGCTRL.bit.DBGRUN = 1;
 
     NVIC_EnableIRQ(DMAC_0_IRQn);
+    NVIC_EnableIRQ(DMAC_4_IRQn);
 
     /***************************************************************
      * DMA channels that will be automatically triggered
@@ -92,7 +93,10 @@ void DmaManager::Initialize() {
     DMAC->SWTRIGCTRL.reg &=
         ~((1UL << DMA_ADC_SEQUENCE) | (1UL << DMA_ADC_RESULTS) |
           (1UL << DMA_SERCOM0_SPI_TX) | (1UL << DMA_SERCOM0_SPI_RX) |
-          (1UL << DMA_SERCOM7_SPI_TX) | (1UL << DMA_SERCOM7_SPI_RX));
+          (1UL << DMA_SERCOM7_SPI_TX) | (1UL << DMA_SERCOM7_SPI_RX) |
+          (1UL << DMA_DAC_WAVEFORM) |
+          (1UL << DMA_IO4_TONE_A) | (1UL << DMA_IO4_TONE_B) |
+          (1UL << DMA_IO5_TONE_A) | (1UL << DMA_IO5_TONE_B));
 }
 
 DmacChannel *DmaManager::Channel(DmaChannels index) {
@@ -109,4 +113,11 @@ DmacDescriptor *DmaManager::BaseDescriptor(DmaChannels index) {
     return &descriptorBase[index];
 }
 
+volatile DmacDescriptor *DmaManager::WriteBackDescriptor(DmaChannels index) {
+    if (index >= DMA_CHANNEL_COUNT) {
+        return NULL;
+    }
+    return &writeBackDescriptor[index];
+}
+
 } // ClearCore namespace
\ No newline at end of file
@@ -35,10 +35,10 @@
 #include <stdlib.h>
 
 #define EIC_INDEX_INTERRUPT_PRIORITY 1
-#define EIC_INTERRUPT_PRIORITY 7
+#define EIC_INTERRUPT_PRIORITY 6
 
 namespace ClearCore {
-extern InputManager &InputMgr;
+extern SINGLETON_REF(InputManager) InputMgr;
 extern EncoderInput EncoderIn;
 
 void IndexCallback() {
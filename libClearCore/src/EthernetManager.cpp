@@ -33,18 +33,14 @@
 #include "lwip/dns.h"
 #include "lwip/timeouts.h"
 #include "NvmManager.h"
+#include "SysSingleton.h"
 #include "SysTiming.h"
 
 namespace ClearCore {
 
-extern NvmManager &NvmMgr;
+extern SINGLETON_REF(NvmManager) NvmMgr;
 
-EthernetManager &EthernetMgr = EthernetManager::Instance();
-
-EthernetManager &EthernetManager::Instance() {
-    static EthernetManager *instance = new EthernetManager();
-    return *instance;
-}
+SINGLETON_DEFINE(EthernetManager, EthernetMgr)
 
 EthernetManager::EthernetManager()
     : m_portPhyTxen(PHY_TXEN.gpioPort), m_pinPhyTxen(PHY_TXEN.gpioPin),
@@ -30,7 +30,7 @@
 
 namespace ClearCore {
 
-extern EthernetManager &EthernetMgr;
+extern SINGLETON_REF(EthernetManager) EthernetMgr;
 
 EthernetTcpClient::EthernetTcpClient()
     : EthernetTcp(),
@@ -25,7 +25,7 @@
 
 namespace ClearCore {
 
-extern EthernetManager &EthernetMgr;
+extern SINGLETON_REF(EthernetManager) EthernetMgr;
 
 EthernetTcpServer::EthernetTcpServer(uint16_t port)
     : EthernetTcp(), m_initialized(false), m_serverPort(port) {
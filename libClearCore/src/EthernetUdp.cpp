@@ -25,7 +25,7 @@
 
 namespace ClearCore {
 
-extern EthernetManager &EthernetMgr;
+extern SINGLETON_REF(EthernetManager) EthernetMgr;
 
 EthernetUdp::EthernetUdp():
     m_udpData({}),
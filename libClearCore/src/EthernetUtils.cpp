@@ -28,7 +28,7 @@
 
 namespace ClearCore {
 
-extern EthernetManager &EthernetMgr;
+extern SINGLETON_REF(EthernetManager) EthernetMgr;
 
 void DnsFound(const char *hostname, const ip_addr_t *ip, void *arg) {
     // Suppress unused param warning
@@ -30,16 +30,16 @@
 #include "InputManager.h"
 #include <stddef.h>
 #include "atomic_utils.h"
+#include "ShiftRegister.h"
+#include "SysSingleton.h"
+#include "SysTiming.h"
 #include "SysUtils.h"
 
 namespace ClearCore {
 
-InputManager &InputMgr = InputManager::Instance();
+extern ShiftRegister ShiftReg;
 
-InputManager &InputManager::Instance() {
-    static InputManager *instance = new InputManager();
-    return *instance;
-}
+SINGLETON_DEFINE(InputManager, InputMgr)
 
 /**
     Constructor
@@ -54,7 +54,15 @@ InputManager::InputManager()
       m_interruptsMask(0),
       m_interruptsEnabled(true),
       m_interruptServiceRoutines(),
-      m_oneTimeFlags(0) {}
+      m_oneTimeFlags(0),
+      m_edgeQueues(),
+      m_frequencyMeters(),
+      m_eventLines(0),
+      m_debounce(),
+      m_debounceEnabled(),
+      m_debouncePin(),
+      m_debounceLed(),
+      m_sampleCycle(0) {}
 
 /**
     Initialize the InputManager.
@@ -94,6 +102,9 @@ bool InputManager::InterruptHandlerSet(int8_t extInt, voidFuncPtr callback,
     if (extInt < 0 || extInt >= EIC_NUMBER_OF_INTERRUPTS) {
         return false; // Invalid external interrupt number
     }
+    if (callback != nullptr && (m_eventLines & (1UL << extInt))) {
+        return false; // The line is feeding the event system
+    }
 
     EIC->CTRLA.bit.ENABLE = 0;
     SYNCBUSY_WAIT(EIC, EIC_SYNCBUSY_ENABLE);
@@ -101,7 +112,14 @@ bool InputManager::InterruptHandlerSet(int8_t extInt, voidFuncPtr callback,
     // Clear any existing interrupt flag
     EIC->INTFLAG.reg = (1UL << extInt);
 
-    if (callback != nullptr) {
+    if (m_edgeQueues[extInt] != nullptr ||
+            m_frequencyMeters[extInt] != nullptr) {
+        // An edge event queue or frequency meter owns the trigger
+        // condition; it senses both edges and must stay armed.
+        enable = true;
+        oneTime = false;
+    }
+    else if (callback != nullptr) {
         // Clear the existing interrupt trigger condition
         uint8_t shiftAmt = 4 * (extInt % 8);
         EIC->CONFIG[extInt / 8].reg &= ~(0xf << shiftAmt);
@@ -166,7 +184,114 @@ void InputManager::InterruptsEnabled(bool enable) {
     }
 }
 
+bool InputManager::EdgeQueueSet(int8_t extInt, InputEdgeQueue *queue) {
+    if (extInt < 0 || extInt >= EIC_NUMBER_OF_INTERRUPTS) {
+        return false; // Invalid external interrupt number
+    }
+
+    if (queue != nullptr && (m_eventLines & (1UL << extInt))) {
+        return false; // The line is feeding the event system
+    }
+
+    m_edgeQueues[extInt] = queue;
+    if (queue == nullptr) {
+        EicRelease(extInt);
+    }
+    else {
+        EicBothEdges(extInt);
+    }
+    return true;
+}
+
+bool InputManager::FrequencyMeterSet(int8_t extInt,
+                                     InputFrequencyMeter *meter) {
+    if (extInt < 0 || extInt >= EIC_NUMBER_OF_INTERRUPTS) {
+        return false; // Invalid external interrupt number
+    }
+
+    if (meter != nullptr && (m_eventLines & (1UL << extInt))) {
+        return false; // The line is feeding the event system
+    }
+
+    m_frequencyMeters[extInt] = meter;
+    if (meter == nullptr) {
+        EicRelease(extInt);
+    }
+    else {
+        EicBothEdges(extInt);
+    }
+    return true;
+}
+
+void InputManager::EicBothEdges(int8_t extInt) {
+    EIC->CTRLA.bit.ENABLE = 0;
+    SYNCBUSY_WAIT(EIC, EIC_SYNCBUSY_ENABLE);
+
+    // Clear any existing interrupt flag
+    EIC->INTFLAG.reg = (1UL << extInt);
+
+    // Every edge must be seen, so sense both and never disarm
+    uint8_t shiftAmt = 4 * (extInt % 8);
+    EIC->CONFIG[extInt / 8].reg &= ~(0xf << shiftAmt);
+    EIC->CONFIG[extInt / 8].reg |=
+        static_cast<uint32_t>(EicSense(CHANGE) << shiftAmt);
+    m_oneTimeFlags &= ~(1UL << extInt);
+
+    InterruptEnable(extInt, true);
+
+    EIC->CTRLA.bit.ENABLE = 1;
+    SYNCBUSY_WAIT(EIC, EIC_SYNCBUSY_ENABLE);
+}
+
+void InputManager::EicRelease(int8_t extInt) {
+    // Leave the line running if anything else still needs it
+    if (m_interruptServiceRoutines[extInt] == nullptr &&
+            m_edgeQueues[extInt] == nullptr &&
+            m_frequencyMeters[extInt] == nullptr) {
+        InterruptEnable(extInt, false);
+    }
+}
+
+bool InputManager::EventOutputSet(int8_t extInt, bool enable,
+                                  InterruptTrigger trigger) {
+    if (extInt < 0 || extInt >= EIC_NUMBER_OF_INTERRUPTS) {
+        return false; // Invalid external interrupt number
+    }
+    if (enable && (m_eventLines & (1UL << extInt))) {
+        return false; // Already feeding another event user
+    }
+    if (enable && (m_interruptServiceRoutines[extInt] != nullptr ||
+                   m_edgeQueues[extInt] != nullptr ||
+                   m_frequencyMeters[extInt] != nullptr)) {
+        return false; // Something else owns the trigger condition
+    }
+
+    EIC->CTRLA.bit.ENABLE = 0;
+    SYNCBUSY_WAIT(EIC, EIC_SYNCBUSY_ENABLE);
+
+    InterruptEnable(extInt, false);
+    uint8_t shiftAmt = 4 * (extInt % 8);
+    EIC->CONFIG[extInt / 8].reg &= ~(0xf << shiftAmt);
+    if (enable) {
+        EIC->CONFIG[extInt / 8].reg |=
+            static_cast<uint32_t>(EicSense(trigger) << shiftAmt);
+        EIC->EVCTRL.reg |= 1UL << extInt;
+        m_eventLines |= 1UL << extInt;
+    }
+    else {
+        EIC->EVCTRL.reg &= ~(1UL << extInt);
+        m_eventLines &= ~(1UL << extInt);
+    }
+
+    EIC->CTRLA.bit.ENABLE = 1;
+    SYNCBUSY_WAIT(EIC, EIC_SYNCBUSY_ENABLE);
+
+    return true;
+}
+
 void InputManager::EIC_Handler(uint8_t index) {
+    // Timestamp before anything else to keep the latency constant
+    uint32_t cycle = DWT->CYCCNT;
     if (index < EIC_NUMBER_OF_INTERRUPTS) {
         // If this is a one time interrupt, disable the interrupt.
         if (m_oneTimeFlags & (1UL << index)) {
@@ -175,6 +300,17 @@ void InputManager::EIC_Handler(uint8_t index) {
         }
         // Ack the interrupt early so that we don't miss subsequent events
         EIC->INTFLAG.reg = 1UL << index;
+        InputEdgeQueue *queue = m_edgeQueues[index];
+        if (queue != nullptr) {
+            // Inputs are active low
+            queue->Push(!(*m_inputPtrs[queue->Port()] & queue->PinMask()),
+                        cycle);
+        }
+        InputFrequencyMeter *meter = m_frequencyMeters[index];
+        if (meter != nullptr) {
+            meter->Edge(!(*m_inputPtrs[meter->Port()] & meter->PinMask()),
+                        cycle);
+        }
         voidFuncPtr callback = m_interruptServiceRoutines[index];
         if (callback != nullptr) {
             callback();
@@ -182,7 +318,8 @@ void InputManager::EIC_Handler(uint8_t index) {
     }
 }
 
-void InputManager::UpdateBegin() {
+HOT_ISR_FUNC void InputManager::UpdateBegin() {
+    m_sampleCycle = DWT->CYCCNT;
     for (int8_t iPort = 0; iPort < CLEARCORE_PORT_MAX; iPort++) {
         uint32_t last = m_inputsUnfiltered[iPort];
         m_inputsUnfiltered[iPort] = *m_inputPtrs[iPort];
@@ -190,7 +327,7 @@ void InputManager::UpdateBegin() {
     }
 }
 
-void InputManager::UpdateEnd() {
+HOT_ISR_FUNC void InputManager::UpdateEnd() {
     atomic_fetch_or(&m_inputRegRisen.reg,
                     m_inputRegRT.reg & (~m_inputRegLast.reg));
     atomic_fetch_or(&m_inputRegFallen.reg,
@@ -198,6 +335,112 @@ void InputManager::UpdateEnd() {
     m_inputRegLast.reg = m_inputRegRT.reg;
 }
 
+void InputManager::DebounceAttach(uint32_t port, uint32_t pinMask,
+                                  ClearCorePins pin, uint32_t ledMask) {
+    uint8_t bit = 31 - __CLZ(pinMask);
+    m_debouncePin[port][bit] = pin;
+    m_debounceLed[port][bit] = ledMask;
+}
+
+void InputManager::DebounceEnable(uint32_t port, uint32_t pinMask,
+                                  bool enable) {
+    __disable_irq();
+    if (enable) {
+        m_debounceEnabled[port] |= pinMask;
+        m_debounce[port].Expire(pinMask);
+    }
+    else {
+        m_debounceEnabled[port] &= ~pinMask;
+        m_debounce[port].Stop(pinMask);
+    }
+    __enable_irq();
+}
+
+void InputManager::DebounceLength(uint32_t port, uint32_t pinMask,
+                                  uint16_t samples) {
+    __disable_irq();
+    m_debounce[port].Length(pinMask, samples);
+    __enable_irq();
+}
+
+void InputManager::DebounceExpire(uint32_t port, uint32_t pinMask) {
+    __disable_irq();
+    m_debounce[port].Expire(pinMask & m_debounceEnabled[port]);
+    __enable_irq();
+}
+
+HOT_ISR_FUNC void InputManager::UpdateFilters() {
+    uint32_t rtSet = 0;
+    uint32_t rtClear = 0;
+    uint32_t ledSet = 0;
+    uint32_t ledClear = 0;
+
+    for (uint8_t iPort = 0; iPort < CLEARCORE_PORT_MAX; iPort++) {
+        uint32_t enabled = m_debounceEnabled[iPort];
+        // Inputs are active low
+        uint32_t done =
+            m_debounce[iPort].Update(~m_inputsUnfiltered[iPort] & enabled,
+                                     m_inputsUnfilteredChanges[iPort] &
+                                     enabled);
+        if (!done) {
+            continue;
+        }
+
+        // Only inputs at the end of their filter time get here, so
+        // visiting them one at a time is rare.
+        uint32_t filtered = m_debounce[iPort].Filtered();
+        while (done) {
+            uint8_t bit = 31 - __CLZ(done);
+            done &= ~(1UL << bit);
+            uint32_t pinMask = 1UL << m_debouncePin[iPort][bit];
+            if (filtered & (1UL << bit)) {
+                rtSet |= pinMask;
+                ledSet |= m_debounceLed[iPort][bit];
+            }
+            else {
+                rtClear |= pinMask;
+                ledClear |= m_debounceLed[iPort][bit];
+            }
+        }
+    }
+
+    if (rtSet | rtClear) {
+        atomic_or_fetch(&m_inputRegRT.reg, rtSet);
+        atomic_and_fetch(&m_inputRegRT.reg, ~rtClear);
+        ShiftReg.ShifterState(true, ShiftRegister::ShiftChain(ledSet));
+        ShiftReg.ShifterState(false, ShiftRegister::ShiftChain(ledClear));
+    }
+}
+
+HOT_ISR_FUNC void InputFrequencyMeter::Update(uint32_t cycle,
+                                              bool asserted) {
+    if (++m_gateCount < m_gateSamples) {
+        return;
+    }
+    m_gateCount = 0;
+
+    // Edge() runs at a lower priority than this, so the accumulators
+    // cannot change underneath us.
+    uint32_t edges = m_edges;
+    uint32_t lastEdge = m_lastEdge;
+    if (edges >= 2) {
+        uint32_t span = lastEdge - m_firstEdge;
+        m_frequency = (edges - 1) * static_cast<float>(CPU_CLK) / span;
+        m_duty = m_highCycles * 100.0f / span;
+        // Start the next gate at the last edge so no period is lost
+        m_edges = 1;
+        m_firstEdge = lastEdge;
+        m_highCycles = 0;
+    }
+    else if (!edges ||
+             cycle - lastEdge >= m_gateSamples * CYCLES_PER_INTERRUPT) {
+        // Not a single period in a whole gate; the input is idle
+        m_frequency = 0;
+        m_duty = asserted ? 100.0f : 0.0f;
+        m_edges = 0;
+    }
+}
+
 SysConnectorState InputManager::InputsRisen(SysConnectorState mask) {
     SysConnectorState retVal;
     retVal.reg = atomic_fetch_and(&m_inputRegRisen.reg, ~mask.reg) & mask.reg;
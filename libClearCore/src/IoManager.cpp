@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    IoManager implementation
+
+    Applies bulk output writes and publishes whole-board input snapshots.
+**/
+
+#include "IoManager.h"
+#include <sam.h>
+#include "CcioBoardManager.h"
+#include "DigitalInOut.h"
+#include "InputManager.h"
+#include "SysManager.h"
+#include "SysSingleton.h"
+#include "SysUtils.h"
+
+namespace ClearCore {
+
+SINGLETON_DEFINE(IoManager, IoMgr)
+
+extern SINGLETON_REF(CcioBoardManager) CcioMgr;
+extern SINGLETON_REF(InputManager) InputMgr;
+extern SINGLETON_REF(AdcManager) AdcMgr;
+extern SysManager SysMgr;
+extern MotorDriver *const MotorConnectors[MOTOR_CON_CNT];
+extern volatile uint32_t tickCnt;
+
+// IO-0 through IO-5 are the only local digital outputs
+#define LOCAL_OUTPUT_MASK                                                      \
+    (((1UL << (CLEARCORE_PIN_IO5 + 1)) - 1) & ~((1UL << CLEARCORE_PIN_IO0) - 1))
+
+IoManager::IoManager()
+    : m_pendingMask(0),
+      m_pendingValue(0),
+      m_pendingCcioMask(0),
+      m_pendingCcioValue(0),
+      m_sequence(0),
+      m_snapshot(),
+      m_snapshotValid(false) {}
+
+bool IoManager::OutputsWrite(uint32_t mask, uint32_t value,
+                             uint64_t ccioMask, uint64_t ccioValue) {
+    if (mask & ~LOCAL_OUTPUT_MASK) {
+        return false;
+    }
+    // Outputs driven by a reflex link are not ours to write
+    for (uint8_t i = CLEARCORE_PIN_IO0; i <= CLEARCORE_PIN_IO5; i++) {
+        if ((mask & (1UL << i)) &&
+                static_cast<DigitalInOut *>(SysMgr.ConnectorByIndex(
+                    static_cast<ClearCorePins>(i)))->m_reflexOutput) {
+            return false;
+        }
+    }
+
+    // Merge with any write that has not been applied yet
+    __disable_irq();
+    m_pendingValue = (m_pendingValue & ~mask) | (value & mask);
+    m_pendingMask |= mask;
+    m_pendingCcioValue =
+        (m_pendingCcioValue & ~ccioMask) | (ccioValue & ccioMask);
+    m_pendingCcioMask |= ccioMask;
+    __enable_irq();
+    return true;
+}
+
+void IoManager::Snapshot(IoSnapshot &snapshot) {
+    uint32_t sequence;
+    do {
+        sequence = m_sequence;
+        __DMB();
+        snapshot = m_snapshot;
+        __DMB();
+        // Retry if the sample-rate interrupt published during the copy
+    } while ((sequence & 1) || sequence != m_sequence);
+}
+
+HOT_ISR_FUNC void IoManager::UpdateBegin() {
+    if (!SysMgr.Ready() || !(m_pendingMask || m_pendingCcioMask)) {
+        return;
+    }
+
+    uint32_t mask = m_pendingMask;
+    uint32_t value = m_pendingValue;
+    m_pendingMask = 0;
+
+    // Gather the pin changes for each GPIO port so every port is written
+    // once and all of its outputs change together.
+    uint32_t portMask[PORT_GROUPS] = {0};
+    uint32_t portLevel[PORT_GROUPS] = {0};
+    for (uint8_t i = CLEARCORE_PIN_IO0; mask && i <= CLEARCORE_PIN_IO5; i++) {
+        uint32_t pinBit = 1UL << i;
+        if (!(mask & pinBit)) {
+            continue;
+        }
+        mask &= ~pinBit;
+        DigitalInOut *output = static_cast<DigitalInOut *>(
+            SysMgr.ConnectorByIndex(static_cast<ClearCorePins>(i)));
+        // Skip outputs that were reflex linked after the write was queued
+        if (output->Mode() != Connector::OUTPUT_DIGITAL ||
+                output->m_reflexOutput) {
+            continue;
+        }
+        bool level = output->OutputLatch(value & pinBit) !=
+                     output->m_logicInversion;
+        portMask[output->m_outputPort] |= output->m_outputDataMask;
+        if (level) {
+            portLevel[output->m_outputPort] |= output->m_outputDataMask;
+        }
+    }
+    for (uint8_t port = 0; port < PORT_GROUPS; port++) {
+        if (portMask[port]) {
+            // Toggle only the pins that differ; a single atomic write that
+            // leaves the rest of the port alone.
+            PORT->Group[port].OUTTGL.reg =
+                (PORT->Group[port].OUT.reg ^ portLevel[port]) & portMask[port];
+        }
+    }
+
+    // CCIO-8 outputs all go out together in the next link transfer
+    uint64_t ccioMask = m_pendingCcioMask & CcioMgr.m_outputMask;
+    if (ccioMask) {
+        // As with DigitalInOut::OutputLatch(), the write replaces any pulses
+        // or sequences
+        CcioMgr.OutputsLatch(ccioMask);
+        CcioMgr.m_currentOutputs = (CcioMgr.m_currentOutputs & ~ccioMask) |
+                                   (m_pendingCcioValue & ccioMask);
+    }
+    m_pendingCcioMask = 0;
+}
+
+HOT_ISR_FUNC void IoManager::UpdateEnd() {
+    if (!SysMgr.Ready()) {
+        return;
+    }
+
+    SysConnectorState inputs = InputMgr.InputsRT();
+    uint64_t ccioInputs = CcioMgr.InputState();
+    // The first sample has nothing to compare against, so it has no edges
+    uint32_t lastInputs = m_snapshotValid ? m_snapshot.Inputs.reg
+                          : inputs.reg;
+    uint64_t lastCcioInputs = m_snapshotValid ? m_snapshot.CcioInputs
+                              : ccioInputs;
+    m_snapshotValid = true;
+
+    m_sequence++;
+    __DMB();
+
+    m_snapshot.Sample = tickCnt;
+    m_snapshot.Inputs = inputs;
+    m_snapshot.Risen.reg = m_snapshot.Inputs.reg & ~lastInputs;
+    m_snapshot.Fallen.reg = lastInputs & ~m_snapshot.Inputs.reg;
+    for (uint8_t i = 0; i < AdcManager::ADC_CHANNEL_COUNT; i++) {
+        m_snapshot.Analog[i] = AdcMgr.FilteredResult(
+                                   static_cast<AdcManager::AdcChannels>(i));
+    }
+    m_snapshot.CcioInputs = ccioInputs;
+    m_snapshot.CcioRisen = m_snapshot.CcioInputs & ~lastCcioInputs;
+    m_snapshot.CcioFallen = lastCcioInputs & ~m_snapshot.CcioInputs;
+    m_snapshot.CcioOutputs = CcioMgr.OutputState();
+    for (uint8_t i = 0; i < MOTOR_CON_CNT; i++) {
+        m_snapshot.HlfbState[i] = MotorConnectors[i]->HlfbState();
+        m_snapshot.HlfbPercent[i] = MotorConnectors[i]->HlfbPercent();
+    }
+
+    __DMB();
+    m_sequence++;
+}
+
+} // ClearCore namespace
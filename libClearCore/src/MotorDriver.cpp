@@ -49,10 +49,10 @@
 
 namespace ClearCore {
 
-extern MotorManager &MotorMgr;
+extern SINGLETON_REF(MotorManager) MotorMgr;
 extern SysManager SysMgr;
-extern SysTiming &TimingMgr;
-extern CcioBoardManager &CcioMgr;
+extern SINGLETON_REF(SysTiming) TimingMgr;
+extern SINGLETON_REF(CcioBoardManager) CcioMgr;
 extern ShiftRegister ShiftReg;
 extern volatile uint32_t tickCnt;
 
@@ -165,7 +165,7 @@ MotorDriver::MotorDriver(ShiftRegister::Masks enableMask,
 /*
     Update the HLFB state
 */
-void MotorDriver::Refresh() {
+HOT_ISR_FUNC void MotorDriver::Refresh() {
     if (!m_initialized) {
         return;
     }
@@ -222,10 +222,15 @@ void MotorDriver::Refresh() {
                     // by having the signal go away.
                     if (m_hlfbPwmReadingPending) {
                         m_hlfbCarrierLost = false;
-                        float dutyCycle = static_cast<float>(m_hlfbWidth[0]) /
-                                          static_cast<float>(m_hlfbPeriod[0]);
-                        // Convert to floating and inflate 5-95% to 0-100%
-                        m_hlfbDuty = (dutyCycle - 0.05) * (10000. / 90.);
+                        // Inflate 5-95% to 0-100%:
+                        //   (width / period - 0.05) * 100 / 0.9
+                        //   = (20 * width - period) * 50 / (9 * period)
+                        // The integer terms are exact, so the conversion and
+                        // the single-precision divide are the only roundings.
+                        int32_t offsetWidth = 20 * m_hlfbWidth[0] -
+                                              m_hlfbPeriod[0];
+                        m_hlfbDuty = static_cast<float>(offsetWidth * 50) /
+                                     static_cast<float>(9 * m_hlfbPeriod[0]);
 
                         if (invert) {
                             m_hlfbDuty = 100 - m_hlfbDuty;
@@ -233,7 +238,7 @@ void MotorDriver::Refresh() {
 
                         // Convert unipolar to bipolar?
                         if (m_hlfbMode == HLFB_MODE_HAS_BIPOLAR_PWM) {
-                            m_hlfbDuty = 2.0 * (m_hlfbDuty - 50.);
+                            m_hlfbDuty = 2.0f * (m_hlfbDuty - 50.0f);
                         }
                         m_hlfbState = HLFB_HAS_MEASUREMENT;
                     }
@@ -247,7 +252,7 @@ void MotorDriver::Refresh() {
             }
             else {
                 // check for an HLFB state change
-                bool readHlfbState = (DigitalIn::m_stateFiltered ^ invert);
+                bool readHlfbState = (DigitalIn::FilteredState() ^ invert);
                 if (readHlfbState != m_lastHlfbInputValue) {
                     m_hlfbStateChangeCounter = (MS_TO_SAMPLES * m_hlfbCarrierLossStateChange_ms);
                     m_lastHlfbInputValue = readHlfbState;
@@ -262,7 +267,7 @@ void MotorDriver::Refresh() {
         case HLFB_MODE_STATIC:
         default:
             m_hlfbDuty = HLFB_DUTY_UNKNOWN;
-            m_hlfbState = (DigitalIn::m_stateFiltered ^ invert) ?
+            m_hlfbState = (DigitalIn::FilteredState() ^ invert) ?
                           HLFB_ASSERTED : HLFB_DEASSERTED;
             break;
     }
@@ -511,6 +516,34 @@ bool MotorDriver::MoveVelocity(int32_t velocity) {
     return StepGenerator::MoveVelocity(velocity);
 }
 
+bool MotorDriver::AnalogJog(AdcManager::AdcChannels channel, uint32_t velMax,
+                            uint32_t accelMax, uint16_t deadband,
+                            JogCurves curve) {
+    // The jog itself won't drive into an asserted limit, so only check the
+    // limit opposite any that is currently asserted.
+    if (!ValidateMove(m_limitInfo.InPosHWLimit)) {
+        if (m_statusRegMotor.bit.StepsActive) {
+            MoveStopDecel();
+        }
+        return false;
+    }
+    m_lastMoveWasPositional = false;
+    return StepGenerator::AnalogJog(channel, velMax, accelMax, deadband,
+                                    curve);
+}
+
+bool MotorDriver::VelocityFollow(uint32_t velMax, uint32_t accelMax) {
+    // As with a jog, the follower won't drive into an asserted limit
+    if (!ValidateMove(m_limitInfo.InPosHWLimit)) {
+        if (m_statusRegMotor.bit.StepsActive) {
+            MoveStopDecel();
+        }
+        return false;
+    }
+    m_lastMoveWasPositional = false;
+    return StepGenerator::VelocityFollow(velMax, accelMax);
+}
+
 MotorDriver::StatusRegMotor MotorDriver::StatusRegRisen() {
     return StatusRegMotor(atomic_exchange_n(&m_statusRegMotorRisen.reg, 0));
 }
@@ -704,8 +737,8 @@ bool MotorDriver::PolarityInvertSDDirection(bool invert) {
 bool MotorDriver::PolarityInvertSDHlfb(bool invert) {
     if (m_mode == Connector::CPM_MODE_STEP_AND_DIR) {
         m_polarityInversions.bit.hlfbInverted = invert ? 1 : 0;
-        // Force the HLFB filtering to re-evaluate by setting TicksLeft
-        m_filterTicksLeft = 1;
+        // Force the HLFB filtering to re-evaluate at the next sample
+        FilterExpire();
         return true;
     }
     else {
@@ -30,6 +30,7 @@
 #include "MotorDriver.h"
 #include "ShiftRegister.h"
 #include "SysConnectors.h"
+#include "SysSingleton.h"
 #include "SysUtils.h"
 
 namespace ClearCore {
@@ -38,12 +39,7 @@ namespace ClearCore {
 extern MotorDriver *const MotorConnectors[MOTOR_CON_CNT];
 extern ShiftRegister ShiftReg;
 
-MotorManager &MotorMgr = MotorManager::Instance();
-
-MotorManager &MotorManager::Instance() {
-    static MotorManager *instance = new MotorManager();
-    return *instance;
-}
+SINGLETON_DEFINE(MotorManager, MotorMgr)
 
 /**
     Construct and wire in our output pins
@@ -30,6 +30,7 @@
 #include "NvmManager.h"
 #include "AdcManager.h"
 #include "StatusManager.h"
+#include "SysSingleton.h"
 #include "atomic_utils.h"
 #include <cstring>
 #include <sam.h>
@@ -58,14 +59,9 @@ namespace ClearCore {
 #define NVM_LOCATION_TO_INDEX(loc) ((loc) + 32)
 #define DEFAULT_MAC_ADDRESS 0x241510b00000
 
-NvmManager &NvmMgr = NvmManager::Instance();
+SINGLETON_DEFINE(NvmManager, NvmMgr)
 uint32_t NvmMgrUnlock;
 
-NvmManager &NvmManager::Instance() {
-    static NvmManager *instance = new NvmManager();
-    return *instance;
-}
-
 NvmManager::NvmManager()
     : m_nvmPageCache32(reinterpret_cast<int32_t *>(m_nvmPageCache)),
       m_writeState(IDLE),
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    ClearCore fixed-point PID control loop.
+**/
+
+#include "PidLoop.h"
+#include <math.h>
+#include <sam.h>
+#include "DigitalInOut.h"
+#include "DigitalInOutAnalogOut.h"
+#include "DigitalInOutHBridge.h"
+#include "EncoderInput.h"
+#include "IirFilter.h"
+#include "StepGenerator.h"
+#include "SysTiming.h"
+#include "SysUtils.h"
+
+namespace ClearCore {
+
+extern SINGLETON_REF(AdcManager) AdcMgr;
+extern EncoderInput EncoderIn;
+
+// Q16 gains must fit in a signed 32-bit value
+#define PID_GAIN_MAX ((float)INT32_MAX / (1 << 16))
+// The per-sample integral gain keeps more fractional bits, since it is
+// usually a small fraction
+#define PID_KI_FRAC_BITS 24
+#define PID_KI_MAX ((float)INT32_MAX / (1L << PID_KI_FRAC_BITS))
+
+PidLoop::PidLoop()
+    : m_source(SOURCE_NONE),
+      m_sink(SINK_NONE),
+      m_adcChannel(AdcManager::ADC_AIN12),
+      m_sourceObj(nullptr),
+      m_sinkObj(nullptr),
+      m_sourceFunc(nullptr),
+      m_sinkFunc(nullptr),
+      m_kp(0),
+      m_ki(0),
+      m_kd(0),
+      m_ffGain(0),
+      m_ffOffset(0),
+      m_dTc(0),
+      m_outMin(INT32_MIN),
+      m_outMax(INT32_MAX),
+      m_setpoint(0),
+      m_enabled(false),
+      m_primed(false),
+      m_integral(0),
+      m_lastMeasurement(0),
+      m_derivative(0),
+      m_output(0),
+      m_measurement(0),
+      m_cyclesLast(0),
+      m_cyclesMax(0) {}
+
+bool PidLoop::SourceAdc(AdcManager::AdcChannels adcChannel) {
+    if (adcChannel >= AdcManager::ADC_CHANNEL_COUNT) {
+        return false;
+    }
+    __disable_irq();
+    m_adcChannel = adcChannel;
+    m_source = SOURCE_ADC;
+    m_primed = false;
+    __enable_irq();
+    return true;
+}
+
+void PidLoop::SourceEncoderPosition() {
+    __disable_irq();
+    m_source = SOURCE_ENCODER_POSITION;
+    m_primed = false;
+    __enable_irq();
+}
+
+void PidLoop::SourceEncoderVelocity() {
+    __disable_irq();
+    m_source = SOURCE_ENCODER_VELOCITY;
+    m_primed = false;
+    __enable_irq();
+}
+
+bool PidLoop::SourceMotorPosition(StepGenerator *motor) {
+    if (!motor) {
+        return false;
+    }
+    __disable_irq();
+    m_sourceObj = motor;
+    m_source = SOURCE_MOTOR_POSITION;
+    m_primed = false;
+    __enable_irq();
+    return true;
+}
+
+bool PidLoop::SourceCallback(SourceFunc source) {
+    if (!source) {
+        return false;
+    }
+    __disable_irq();
+    m_sourceFunc = source;
+    m_source = SOURCE_CALLBACK;
+    m_primed = false;
+    __enable_irq();
+    return true;
+}
+
+bool PidLoop::SinkDac(DigitalInOutAnalogOut *connector) {
+    return SinkSet(SINK_DAC, connector, 0, 2047);
+}
+
+bool PidLoop::SinkPwm(DigitalInOut *connector) {
+    return SinkSet(SINK_PWM, connector, 0, UINT16_MAX);
+}
+
+bool PidLoop::SinkHBridge(DigitalInOutHBridge *connector) {
+    return SinkSet(SINK_HBRIDGE, connector, -INT16_MAX, INT16_MAX);
+}
+
+bool PidLoop::SinkMotorVelocity(StepGenerator *motor, uint32_t velMax,
+                                uint32_t accelMax) {
+    if (!motor || !velMax || !motor->VelocityFollow(velMax, accelMax)) {
+        return false;
+    }
+    int32_t limit = min(velMax, static_cast<uint32_t>(INT32_MAX));
+    return SinkSet(SINK_MOTOR_VELOCITY, motor, -limit, limit);
+}
+
+bool PidLoop::SinkCallback(SinkFunc sink) {
+    if (!sink) {
+        return false;
+    }
+    __disable_irq();
+    m_sinkFunc = sink;
+    m_sink = SINK_CALLBACK;
+    __enable_irq();
+    return true;
+}
+
+bool PidLoop::SinkSet(Sinks sink, void *obj, int32_t outMin, int32_t outMax) {
+    if (!obj) {
+        return false;
+    }
+    __disable_irq();
+    m_sinkObj = obj;
+    m_sink = sink;
+    m_outMin = outMin;
+    m_outMax = outMax;
+    __enable_irq();
+    return true;
+}
+
+bool PidLoop::PiGains(float kp, float ki, int32_t &kpQ16, int32_t &kiQ24) {
+    // Scale the integral gain to one sample time
+    float kiSample = ki / SampleRateHz;
+    if (fabsf(kp) > PID_GAIN_MAX || fabsf(kiSample) > PID_KI_MAX) {
+        return false;
+    }
+    kpQ16 = lroundf(kp * (1 << 16));
+    kiQ24 = lroundf(kiSample * (1L << PID_KI_FRAC_BITS));
+    return true;
+}
+
+bool PidLoop::Gains(float kp, float ki, float kd) {
+    // Scale the derivative gain to one sample time
+    float kdSample = kd * SampleRateHz;
+    int32_t kpQ16, kiQ24;
+    if (!PiGains(kp, ki, kpQ16, kiQ24) || fabsf(kdSample) > PID_GAIN_MAX) {
+        return false;
+    }
+
+    __disable_irq();
+    m_kp = kpQ16;
+    m_ki = kiQ24;
+    m_kd = lroundf(kdSample * (1 << 16));
+    __enable_irq();
+    return true;
+}
+
+void PidLoop::DerivativeFilter(uint16_t samples) {
+    m_dTc = samples ? Iir16::TcFromSamples(samples) : 0;
+}
+
+bool PidLoop::FeedForward(float gain, int32_t offset) {
+    if (fabsf(gain) > PID_GAIN_MAX) {
+        return false;
+    }
+    __disable_irq();
+    m_ffGain = lroundf(gain * (1 << 16));
+    m_ffOffset = offset;
+    __enable_irq();
+    return true;
+}
+
+bool PidLoop::OutputLimits(int32_t outMin, int32_t outMax) {
+    if (outMin >= outMax) {
+        return false;
+    }
+    __disable_irq();
+    m_outMin = outMin;
+    m_outMax = outMax;
+    __enable_irq();
+    return true;
+}
+
+void PidLoop::Enable(bool enable) {
+    __disable_irq();
+    if (enable && !m_enabled) {
+        m_integral = 0;
+        m_derivative = 0;
+        m_primed = false;
+    }
+    m_enabled = enable;
+    __enable_irq();
+}
+
+void PidLoop::Reset() {
+    __disable_irq();
+    m_integral = 0;
+    m_derivative = 0;
+    m_primed = false;
+    __enable_irq();
+}
+
+HOT_ISR_FUNC void PidLoop::Update() {
+    if (!m_enabled) {
+        return;
+    }
+    uint32_t startCycles = DWT->CYCCNT;
+
+    int32_t measurement = SourceRead();
+    bool first = !m_primed;
+    if (first) {
+        // Start the derivative from the current measurement
+        m_lastMeasurement = measurement;
+        m_primed = true;
+    }
+    int32_t error = m_setpoint - measurement;
+
+    // Derivative of the measurement rather than the error, so that
+    // setpoint steps do not kick the output
+    int32_t dRaw = m_lastMeasurement - measurement;
+    m_lastMeasurement = measurement;
+    m_derivative = (static_cast<int64_t>(m_derivative) * m_dTc +
+                    static_cast<int64_t>(dRaw) * ((1 << 15) - m_dTc)) >> 15;
+
+    int64_t extraQ16 = static_cast<int64_t>(m_kd) * m_derivative +
+                       static_cast<int64_t>(m_ffGain) * m_setpoint +
+                       (static_cast<int64_t>(m_ffOffset) << 16);
+    int32_t output = PiStep(m_kp, m_ki, m_integral, error, extraQ16,
+                            m_outMin, m_outMax);
+    SinkWrite(output);
+    m_output = output;
+    m_measurement = measurement;
+
+    m_cyclesLast = DWT->CYCCNT - startCycles;
+    if (m_cyclesLast > m_cyclesMax) {
+        m_cyclesMax = m_cyclesLast;
+    }
+}
+
+HOT_ISR_FUNC int32_t PidLoop::PiStep(int32_t kp, int32_t ki,
+                                     int64_t &integral, int32_t error,
+                                     int64_t extraQ16, int32_t outMin,
+                                     int32_t outMax) {
+    int64_t outMinQ16 = static_cast<int64_t>(outMin) << 16;
+    int64_t outMaxQ16 = static_cast<int64_t>(outMax) << 16;
+    // The integral is held with the integral gain's fractional bits
+    const uint8_t kiShift = PID_KI_FRAC_BITS - 16;
+    int64_t newIntegral = integral + static_cast<int64_t>(ki) * error;
+    if (newIntegral > outMaxQ16 << kiShift) {
+        newIntegral = outMaxQ16 << kiShift;
+    }
+    else if (newIntegral < outMinQ16 << kiShift) {
+        newIntegral = outMinQ16 << kiShift;
+    }
+
+    int64_t outputQ16 = static_cast<int64_t>(kp) * error + extraQ16 +
+                        ((newIntegral + (1 << (kiShift - 1))) >> kiShift);
+
+    // Clamp the output, and only keep the new integral if it does not
+    // push further into saturation
+    if (outputQ16 > outMaxQ16) {
+        outputQ16 = outMaxQ16;
+        if (error < 0) {
+            integral = newIntegral;
+        }
+    }
+    else if (outputQ16 < outMinQ16) {
+        outputQ16 = outMinQ16;
+        if (error > 0) {
+            integral = newIntegral;
+        }
+    }
+    else {
+        integral = newIntegral;
+    }
+    return (outputQ16 + (1 << 15)) >> 16;
+}
+
+HOT_ISR_FUNC int32_t PidLoop::SourceRead() {
+    switch (m_source) {
+        case SOURCE_ADC:
+            return AdcMgr.FilteredResult(m_adcChannel);
+        case SOURCE_ENCODER_POSITION:
+            return EncoderIn.Position();
+        case SOURCE_ENCODER_VELOCITY:
+            return EncoderIn.Velocity();
+        case SOURCE_MOTOR_POSITION:
+            return static_cast<StepGenerator *>(m_sourceObj)
+                   ->PositionRefCommanded();
+        case SOURCE_CALLBACK:
+            return m_sourceFunc();
+        case SOURCE_NONE:
+        default:
+            return 0;
+    }
+}
+
+HOT_ISR_FUNC void PidLoop::SinkWrite(int32_t output) {
+    switch (m_sink) {
+        case SINK_DAC:
+            static_cast<DigitalInOutAnalogOut *>(m_sinkObj)
+            ->AnalogWriteNoWait(output);
+            break;
+        case SINK_PWM:
+            static_cast<DigitalInOut *>(m_sinkObj)->PwmDuty16(output);
+            break;
+        case SINK_HBRIDGE:
+            static_cast<DigitalInOutHBridge *>(m_sinkObj)->State(output);
+            break;
+        case SINK_MOTOR_VELOCITY:
+            static_cast<StepGenerator *>(m_sinkObj)
+            ->VelocityFollowTarget(output);
+            break;
+        case SINK_CALLBACK:
+            m_sinkFunc(output);
+            break;
+        case SINK_NONE:
+        default:
+            break;
+    }
+}
+
+} // ClearCore namespace
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    ClearCore hardware pulse counter.
+
+    Counts the asserting edges of one interrupt-capable digital input in a
+    hardware timer, without any per-edge CPU load.
+**/
+
+#include "PulseCounter.h"
+#include <sam.h>
+#include <stdint.h>
+#include "CcioBoardManager.h"
+#include "DigitalInOut.h"
+#include "InputManager.h"
+#include "SysManager.h"
+#include "SysTiming.h"
+#include "SysUtils.h"
+
+namespace ClearCore {
+
+extern SINGLETON_REF(CcioBoardManager) CcioMgr;
+extern SINGLETON_REF(InputManager) InputMgr;
+extern SysManager SysMgr;
+
+PulseCounter::PulseCounter(uint8_t evsysChannel)
+    : m_evsysChannel(evsysChannel),
+      m_inputPin(CLEARCORE_PIN_INVALID),
+      m_extInt(-1),
+      m_hwCount(0),
+      m_countsLast(0),
+      m_count(0),
+      m_compareValue(INT64_MAX),
+      m_compareReached(false),
+      m_compareOutputPin(CLEARCORE_PIN_INVALID),
+      m_gateStartCount(0),
+      m_gateSamples(100 * MS_TO_SAMPLES),
+      m_gateCount(0),
+      m_rate(0) {}
+
+void PulseCounter::Initialize() {
+    // The TC7 clock channel is shared with TC6, which is already on GCLK6
+    CLOCK_ENABLE(APBDMASK, TC7_);
+
+    TcCount16 *tcCount = &PULSE_COUNTER_TC->COUNT16;
+    tcCount->CTRLA.bit.ENABLE = 0;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_ENABLE);
+    tcCount->CTRLA.bit.SWRST = 1;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_SWRST);
+
+    tcCount->CTRLA.reg = TC_CTRLA_MODE_COUNT16 |
+                         TC_CTRLA_PRESCALER_DIV1 |
+                         TC_CTRLA_PRESCSYNC_GCLK;
+    // Count each input event rather than the clock
+    tcCount->EVCTRL.reg = TC_EVCTRL_EVACT_COUNT | TC_EVCTRL_TCEI;
+}
+
+int64_t PulseCounter::Count() {
+    __disable_irq();
+    int64_t count = m_count;
+    __enable_irq();
+    return count;
+}
+
+void PulseCounter::Count(int64_t preset) {
+    __disable_irq();
+    // Shift the rate gate with the count so the preset is not a pulse
+    m_gateStartCount += preset - m_count;
+    m_count = preset;
+    __enable_irq();
+}
+
+bool PulseCounter::RateGate(uint16_t gateMs) {
+    if (gateMs < 1 || gateMs > 60000) {
+        return false;
+    }
+    __disable_irq();
+    m_gateSamples = gateMs * MS_TO_SAMPLES;
+    m_gateCount = 0;
+    m_gateStartCount = m_count;
+    __enable_irq();
+    return true;
+}
+
+uint16_t PulseCounter::RateGate() {
+    return m_gateSamples / MS_TO_SAMPLES;
+}
+
+void PulseCounter::CompareValue(int64_t value) {
+    __disable_irq();
+    m_compareValue = value;
+    __enable_irq();
+}
+
+int64_t PulseCounter::CompareValue() {
+    __disable_irq();
+    int64_t value = m_compareValue;
+    __enable_irq();
+    return value;
+}
+
+bool PulseCounter::CompareOutput(ClearCorePins pin) {
+    // Pins IO-0 through IO-5 and all CCIO-8 connectors are the only
+    // valid digital output pins available.
+    if (pin != CLEARCORE_PIN_INVALID &&
+            !(pin >= CLEARCORE_PIN_IO0 && pin <= CLEARCORE_PIN_IO5) &&
+            !(pin >= CLEARCORE_PIN_CCIOA0 && pin <= CLEARCORE_PIN_CCIOH7)) {
+        return false;
+    }
+    // A pin owned by a reflex link or running a sequence is left alone
+    if (pin >= CLEARCORE_PIN_CCIOA0) {
+        if (CcioMgr.OutputSequencesActive() &
+                (1ULL << (pin - CLEARCORE_PIN_CCIO_BASE))) {
+            return false;
+        }
+    }
+    else if (pin != CLEARCORE_PIN_INVALID) {
+        DigitalInOut *output =
+            static_cast<DigitalInOut *>(SysMgr.ConnectorByIndex(pin));
+        if (output->m_reflexOutput || output->OutputSequenceActive()) {
+            return false;
+        }
+    }
+    if (pin != m_compareOutputPin &&
+            m_compareOutputPin != CLEARCORE_PIN_INVALID) {
+        // Reset the state of the previous compare output connector
+        SysMgr.ConnectorByIndex(m_compareOutputPin)->State(false);
+    }
+    __disable_irq();
+    m_compareOutputPin = pin;
+    // Update() only writes on a change, so bring the new pin in line now
+    CompareOutputWrite(m_compareReached);
+    __enable_irq();
+    return true;
+}
+
+bool PulseCounter::Attach(ClearCorePins pin, int8_t extInt) {
+    if (m_inputPin == pin) {
+        return true;
+    }
+    if (m_inputPin != CLEARCORE_PIN_INVALID) {
+        return false; // Another connector is using the counter
+    }
+    if (!InputMgr.EventOutputSet(extInt, true)) {
+        return false;
+    }
+
+    // Connect the EXTINT event generator to the timer
+    EvsysChannel *theEvCh = &EVSYS->Channel[m_evsysChannel];
+    EVSYS->USER[EVSYS_ID_USER_TC7_EVU].reg = m_evsysChannel + 1;
+    theEvCh->CHANNEL.reg =
+        EVSYS_CHANNEL_EVGEN(EVSYS_ID_GEN_EIC_EXTINT_0 + extInt) |
+        EVSYS_CHANNEL_PATH_ASYNCHRONOUS;
+
+    TcCount16 *tcCount = &PULSE_COUNTER_TC->COUNT16;
+    tcCount->COUNT.reg = 0;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_COUNT);
+    tcCount->CTRLA.bit.ENABLE = 1;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_ENABLE);
+    // Have COUNT ready for the first update
+    tcCount->CTRLBSET.reg = TC_CTRLBSET_CMD_READSYNC;
+
+    __disable_irq();
+    m_extInt = extInt;
+    m_hwCount = 0;
+    m_countsLast = 0;
+    m_count = 0;
+    m_gateStartCount = 0;
+    m_gateCount = 0;
+    m_rate = 0;
+    m_inputPin = pin;
+    __enable_irq();
+    return true;
+}
+
+void PulseCounter::Detach(ClearCorePins pin) {
+    if (m_inputPin != pin || pin == CLEARCORE_PIN_INVALID) {
+        return;
+    }
+    m_inputPin = CLEARCORE_PIN_INVALID;
+    m_countsLast = 0;
+    m_rate = 0;
+
+    TcCount16 *tcCount = &PULSE_COUNTER_TC->COUNT16;
+    tcCount->CTRLA.bit.ENABLE = 0;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_ENABLE);
+
+    EVSYS->USER[EVSYS_ID_USER_TC7_EVU].reg = 0;
+    EVSYS->Channel[m_evsysChannel].CHANNEL.reg = 0;
+    InputMgr.EventOutputSet(m_extInt, false);
+}
+
+HOT_ISR_FUNC void PulseCounter::Update() {
+    if (m_inputPin == CLEARCORE_PIN_INVALID) {
+        return;
+    }
+
+    // COUNT was synchronized by the request made last sample time, so it
+    // can be read without waiting on the slow timer clock.
+    TcCount16 *tcCount = &PULSE_COUNTER_TC->COUNT16;
+    uint16_t hwCount = tcCount->COUNT.reg;
+    tcCount->CTRLBSET.reg = TC_CTRLBSET_CMD_READSYNC;
+
+    m_countsLast = hwCount - m_hwCount;
+    m_hwCount = hwCount;
+    m_count += m_countsLast;
+
+    if (++m_gateCount >= m_gateSamples) {
+        m_rate = static_cast<float>(m_count - m_gateStartCount) *
+                 _CLEARCORE_SAMPLE_RATE_HZ / m_gateSamples;
+        m_gateStartCount = m_count;
+        m_gateCount = 0;
+    }
+
+    bool reached = m_count >= m_compareValue;
+    if (reached != m_compareReached) {
+        m_compareReached = reached;
+        CompareOutputWrite(reached);
+    }
+}
+
+HOT_ISR_FUNC void PulseCounter::CompareOutputWrite(bool state) {
+    if (m_compareOutputPin == CLEARCORE_PIN_INVALID ||
+            SysMgr.ConnectorByIndex(m_compareOutputPin)->Mode() !=
+            Connector::OUTPUT_DIGITAL) {
+        return;
+    }
+    if (m_compareOutputPin >= CLEARCORE_PIN_CCIOA0) {
+        uint64_t pinMask =
+            1ULL << (m_compareOutputPin - CLEARCORE_PIN_CCIO_BASE);
+        CcioMgr.OutputsLatch(pinMask);
+        if (state) {
+            CcioMgr.m_currentOutputs |= pinMask;
+        }
+        else {
+            CcioMgr.m_currentOutputs &= ~pinMask;
+        }
+    }
+    else {
+        DigitalInOut *output = static_cast<DigitalInOut *>(
+                                   SysMgr.ConnectorByIndex(m_compareOutputPin));
+        // A reflex link made after CompareOutput() keeps the pin
+        if (!output->m_reflexOutput) {
+            output->OutputPin(output->OutputLatch(state));
+        }
+    }
+}
+
+} // ClearCore namespace
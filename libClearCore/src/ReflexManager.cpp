@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+    ClearCore input-to-output reflex links.
+
+    Routes the external interrupt lines of the digital inputs through the
+    event system to a timer one-shot or a CCL lookup table that drives an
+    output directly.
+**/
+
+#include "ReflexManager.h"
+#include <sam.h>
+#include "DigitalInOut.h"
+#include "HardwareMapping.h"
+#include "InputManager.h"
+#include "SysManager.h"
+#include "SysTiming.h"
+#include "SysUtils.h"
+
+namespace ClearCore {
+
+extern SINGLETON_REF(InputManager) InputMgr;
+extern SysManager SysMgr;
+
+// Event system channel offsets: one per output timer pair, then the inputs
+// of the CCL lookup tables
+#define REFLEX_CH_LUT_A (CLEARCORE_PIN_IO5 / 2 + 1)
+#define REFLEX_CH_LUT_B (REFLEX_CH_LUT_A + 1)
+
+static const PeripheralRoute *const InputRoutes[CLEARCORE_PIN_A12 + 1] = {
+    &IN00n_Aout00n, &IN01n, &IN02n, &IN03n, &IN04n, &IN05n,
+    &IN06n_QuadA, &IN07n_QuadB, &IN08n_QuadI,
+    &IN09n_AIN09, &IN10n_AIN10, &IN11n_AIN11, &IN12n_AIN12
+};
+
+static const PeripheralRoute *const OutputRoutes[CLEARCORE_PIN_IO5 + 1] = {
+    &OUT00, &OUT01, &OUT02, &OUT03, &OUT04_ENABLE04, &OUT05_ENABLE05
+};
+
+// Output pins with a CCL lookup table output on peripheral function N
+typedef struct {
+    ClearCorePorts gpioPort;
+    uint8_t gpioPin;
+    uint8_t lut;
+} CclOutput;
+
+static const CclOutput CclOutputs[] = {
+    {PORTA, 7, 0},
+};
+
+static int8_t CclLut(const PeripheralRoute *route) {
+    for (uint8_t i = 0; i < sizeof(CclOutputs) / sizeof(CclOutputs[0]);
+            i++) {
+        if (CclOutputs[i].gpioPort == route->gpioPort &&
+                CclOutputs[i].gpioPin == route->gpioPin) {
+            return CclOutputs[i].lut;
+        }
+    }
+    return -1;
+}
+
+static void EventRoute(uint8_t channel, uint8_t user, int8_t extInt) {
+    EVSYS->USER[user].reg = channel + 1;
+    EVSYS->Channel[channel].CHANNEL.reg =
+        EVSYS_CHANNEL_EVGEN(EVSYS_ID_GEN_EIC_EXTINT_0 + extInt) |
+        EVSYS_CHANNEL_PATH_ASYNCHRONOUS;
+}
+
+static void EventUnroute(uint8_t channel, uint8_t user) {
+    EVSYS->USER[user].reg = 0;
+    EVSYS->Channel[channel].CHANNEL.reg = 0;
+}
+
+ReflexManager::ReflexManager(uint8_t evsysChannel)
+    : m_evsysChannel(evsysChannel) {
+    for (uint8_t i = 0; i < OUTPUT_CNT; i++) {
+        m_mode[i] = REFLEX_NONE;
+        m_extIntA[i] = -1;
+        m_extIntB[i] = -1;
+        m_pwmFrequency[i] = 0;
+        m_pwmWide[i] = false;
+        m_drvCtrl[i] = 0;
+    }
+}
+
+bool ReflexManager::Link(ClearCorePins output, ReflexModes mode,
+                         ClearCorePins inputA, ClearCorePins inputB,
+                         uint32_t pulseUs) {
+    if (output < CLEARCORE_PIN_IO0 || output > CLEARCORE_PIN_IO5 ||
+            m_mode[output] != REFLEX_NONE) {
+        return false;
+    }
+    if (SysMgr.ConnectorByIndex(output)->Mode() !=
+            Connector::OUTPUT_DIGITAL) {
+        return false;
+    }
+    int8_t extIntA = InputLine(inputA);
+    if (extIntA < 0) {
+        return false;
+    }
+
+    bool success;
+    switch (mode) {
+        case REFLEX_PULSE:
+            success = LinkPulse(output, extIntA, pulseUs);
+            break;
+        case REFLEX_FOLLOW:
+        case REFLEX_INVERT:
+            success = LinkLogic(output, mode, extIntA, -1);
+            break;
+        case REFLEX_AND:
+        case REFLEX_OR: {
+            int8_t extIntB = InputLine(inputB);
+            success = extIntB >= 0 && extIntB != extIntA &&
+                      LinkLogic(output, mode, extIntA, extIntB);
+            break;
+        }
+        default:
+            success = false;
+            break;
+    }
+    if (success) {
+        m_mode[output] = mode;
+    }
+    return success;
+}
+
+void ReflexManager::Unlink(ClearCorePins output) {
+    if (output < CLEARCORE_PIN_IO0 || output > CLEARCORE_PIN_IO5 ||
+            m_mode[output] == REFLEX_NONE) {
+        return;
+    }
+    if (m_mode[output] == REFLEX_PULSE) {
+        UnlinkPulse(output);
+    }
+    else {
+        UnlinkLogic(output);
+    }
+    m_mode[output] = REFLEX_NONE;
+    m_extIntA[output] = -1;
+    m_extIntB[output] = -1;
+}
+
+ReflexManager::ReflexModes ReflexManager::LinkMode(ClearCorePins output) {
+    if (output < CLEARCORE_PIN_IO0 || output > CLEARCORE_PIN_IO5) {
+        return REFLEX_NONE;
+    }
+    return m_mode[output];
+}
+
+int8_t ReflexManager::InputLine(ClearCorePins input) {
+    if (input < CLEARCORE_PIN_IO0 || input > CLEARCORE_PIN_A12) {
+        return -1;
+    }
+    const PeripheralRoute *route = InputRoutes[input];
+    if (!route->extIntAvail) {
+        return -1;
+    }
+    if (SysMgr.ConnectorByIndex(input)->Mode() != Connector::INPUT_DIGITAL) {
+        return -1;
+    }
+    return route->extInt;
+}
+
+bool ReflexManager::LinkPulse(ClearCorePins output, int8_t extInt,
+                              uint32_t pulseUs) {
+    if (pulseUs < 1 || pulseUs > REFLEX_PULSE_MAX_US) {
+        return false;
+    }
+    const PeripheralRoute *route = OutputRoutes[output];
+    DigitalInOut *out =
+        static_cast<DigitalInOut *>(SysMgr.ConnectorByIndex(output));
+    ClearCorePins partnerPin = static_cast<ClearCorePins>(output ^ 1);
+    DigitalInOut *partner =
+        static_cast<DigitalInOut *>(SysMgr.ConnectorByIndex(partnerPin));
+    if (route->tcNum == UINT8_MAX || out->m_reflexTc ||
+            partner->Mode() == Connector::OUTPUT_PWM) {
+        return false;
+    }
+
+    // Use the finest prescaler that fits the pulse in the 16-bit count,
+    // leaving room for the counter to run out to TOP after the pulse
+    uint8_t prescaler = 0;
+    uint32_t counts;
+    while (true) {
+        uint32_t clock =
+            TC_CLK >> DigitalInOut::TcPrescalerShift[prescaler];
+        counts = (static_cast<uint64_t>(pulseUs) * clock + 500000) /
+                 1000000;
+        if (counts < UINT16_MAX ||
+                prescaler == TC_CTRLA_PRESCALER_DIV1024_Val) {
+            break;
+        }
+        prescaler++;
+    }
+    if (!counts) {
+        counts = 1;
+    }
+
+    if (!InputMgr.EventOutputSet(extInt, true, InputManager::RISING)) {
+        return false;
+    }
+
+    // Save the pair's PWM carrier to restore when unlinked
+    m_pwmFrequency[output] = out->PwmFrequency();
+    m_pwmWide[output] = out->PwmWide();
+    out->State(false);
+
+    TcCount16 *tcCount = &out->m_tc->COUNT16;
+    tcCount->CTRLA.bit.ENABLE = 0;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_ENABLE);
+    m_drvCtrl[output] = tcCount->DRVCTRL.reg;
+
+    tcCount->CTRLA.bit.MODE = TC_CTRLA_MODE_COUNT16_Val;
+    tcCount->CTRLA.bit.PRESCALER = prescaler;
+    // In a one-shot NPWM cycle the output is on from the start event until
+    // the CC match; the timer then stops at TOP with the output off
+    tcCount->WAVE.reg = TC_WAVE_WAVEGEN_NPWM;
+    uint8_t pad = out->m_tcPadNum;
+    tcCount->CC[pad].reg = counts;
+    tcCount->CC[!pad].reg = 0;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_CC0 | TC_SYNCBUSY_CC1);
+    if (out->m_logicInversion) {
+        tcCount->DRVCTRL.reg |= TC_DRVCTRL_INVEN0 << pad;
+    }
+    else {
+        tcCount->DRVCTRL.reg &= ~(TC_DRVCTRL_INVEN0 << pad);
+    }
+    // Each input event restarts the cycle, so a new edge stretches the pulse
+    tcCount->EVCTRL.reg = TC_EVCTRL_TCEI | TC_EVCTRL_EVACT_RETRIGGER;
+    tcCount->CTRLBSET.reg = TC_CTRLBSET_ONESHOT;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_CTRLB);
+    // Start parked at TOP, past the CC match, so the output is already
+    // deasserted when the timer is enabled; the next tick overflows and
+    // the one-shot stops there until the first event
+    tcCount->COUNT.reg = UINT16_MAX;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_COUNT);
+    tcCount->CTRLA.bit.ENABLE = 1;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_ENABLE);
+    // Idle until the first event
+    tcCount->CTRLBSET.reg = TC_CTRLBSET_CMD_STOP;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_CTRLB);
+
+    EventRoute(m_evsysChannel + (output >> 1),
+               EVSYS_ID_USER_TC0_EVU + route->tcNum, extInt);
+
+    out->m_reflexOutput = true;
+    out->m_reflexTc = true;
+    partner->m_reflexTc = true;
+    m_extIntA[output] = extInt;
+    PMUX_ENABLE(out->m_outputPort, out->m_outputDataBit);
+    return true;
+}
+
+void ReflexManager::UnlinkPulse(ClearCorePins output) {
+    const PeripheralRoute *route = OutputRoutes[output];
+    DigitalInOut *out =
+        static_cast<DigitalInOut *>(SysMgr.ConnectorByIndex(output));
+    ClearCorePins partnerPin = static_cast<ClearCorePins>(output ^ 1);
+    DigitalInOut *partner =
+        static_cast<DigitalInOut *>(SysMgr.ConnectorByIndex(partnerPin));
+
+    // Hand the pin back to the port, which still holds the off state
+    PMUX_DISABLE(out->m_outputPort, out->m_outputDataBit);
+    EventUnroute(m_evsysChannel + (output >> 1),
+                 EVSYS_ID_USER_TC0_EVU + route->tcNum);
+    InputMgr.EventOutputSet(m_extIntA[output], false);
+
+    TcCount16 *tcCount = &out->m_tc->COUNT16;
+    tcCount->CTRLA.bit.ENABLE = 0;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_ENABLE);
+    tcCount->EVCTRL.reg = 0;
+    tcCount->CTRLBCLR.reg = TC_CTRLBCLR_ONESHOT;
+    SYNCBUSY_WAIT(tcCount, TC_SYNCBUSY_CTRLB);
+    tcCount->DRVCTRL.reg = m_drvCtrl[output];
+
+    out->m_reflexOutput = false;
+    out->m_reflexTc = false;
+    partner->m_reflexTc = false;
+
+    // Restart the carrier; a 16-bit carrier belongs to the second pad
+    DigitalInOut *pad1 = out->m_tcPadNum ? out : partner;
+    pad1->PwmFrequency(m_pwmFrequency[output], m_pwmWide[output]);
+}
+
+bool ReflexManager::LinkLogic(ClearCorePins output, ReflexModes mode,
+                              int8_t extIntA, int8_t extIntB) {
+    int8_t lut = CclLut(OutputRoutes[output]);
+    if (lut < 0) {
+        return false;
+    }
+    // A second input reaches the table through its LINK input, which is
+    // the output of the next table
+    uint8_t linkLut = (lut + 1) % CCL_LUT_NUM;
+    if (CCL->LUTCTRL[lut].bit.ENABLE ||
+            (extIntB >= 0 && CCL->LUTCTRL[linkLut].bit.ENABLE)) {
+        return false;
+    }
+
+    // Level events: high while the input is asserted
+    if (!InputMgr.EventOutputSet(extIntA, true, InputManager::HIGH)) {
+        return false;
+    }
+    if (extIntB >= 0 &&
+            !InputMgr.EventOutputSet(extIntB, true, InputManager::HIGH)) {
+        InputMgr.EventOutputSet(extIntA, false);
+        return false;
+    }
+
+    DigitalInOut *out =
+        static_cast<DigitalInOut *>(SysMgr.ConnectorByIndex(output));
+    uint8_t truth;
+    switch (mode) {
+        case REFLEX_INVERT:
+            truth = 0x55;
+            break;
+        case REFLEX_AND:
+            truth = 0x88;
+            break;
+        case REFLEX_OR:
+            truth = 0xEE;
+            break;
+        case REFLEX_FOLLOW:
+        default:
+            truth = 0xAA;
+            break;
+    }
+    // The CCL output has no inversion of its own
+    if (out->m_logicInversion) {
+        truth = ~truth;
+    }
+    out->State(false);
+
+    CLOCK_ENABLE(APBCMASK, CCL_);
+    // The tables can only be changed while the CCL is disabled
+    CCL->CTRL.bit.ENABLE = 0;
+    if (extIntB >= 0) {
+        CCL->LUTCTRL[linkLut].reg = CCL_LUTCTRL_INSEL0_EVENT |
+                                    CCL_LUTCTRL_LUTEI |
+                                    CCL_LUTCTRL_TRUTH(0xAA) |
+                                    CCL_LUTCTRL_ENABLE;
+        CCL->LUTCTRL[lut].reg = CCL_LUTCTRL_INSEL0_EVENT |
+                                CCL_LUTCTRL_INSEL1_LINK |
+                                CCL_LUTCTRL_LUTEI |
+                                CCL_LUTCTRL_TRUTH(truth) |
+                                CCL_LUTCTRL_ENABLE;
+        EventRoute(m_evsysChannel + REFLEX_CH_LUT_A,
+                   EVSYS_ID_USER_CCL_LUT_0 + linkLut, extIntA);
+        EventRoute(m_evsysChannel + REFLEX_CH_LUT_B,
+                   EVSYS_ID_USER_CCL_LUT_0 + lut, extIntB);
+    }
+    else {
+        CCL->LUTCTRL[lut].reg = CCL_LUTCTRL_INSEL0_EVENT |
+                                CCL_LUTCTRL_LUTEI |
+                                CCL_LUTCTRL_TRUTH(truth) |
+                                CCL_LUTCTRL_ENABLE;
+        EventRoute(m_evsysChannel + REFLEX_CH_LUT_A,
+                   EVSYS_ID_USER_CCL_LUT_0 + lut, extIntA);
+    }
+    CCL->CTRL.bit.ENABLE = 1;
+
+    out->m_reflexOutput = true;
+    m_extIntA[output] = extIntA;
+    m_extIntB[output] = extIntB;
+    PMUX_SELECTION(out->m_outputPort, out->m_outputDataBit, PER_CCL);
+    PMUX_ENABLE(out->m_outputPort, out->m_outputDataBit);
+    return true;
+}
+
+void ReflexManager::UnlinkLogic(ClearCorePins output) {
+    int8_t lut = CclLut(OutputRoutes[output]);
+    uint8_t linkLut = (lut + 1) % CCL_LUT_NUM;
+    DigitalInOut *out =
+        static_cast<DigitalInOut *>(SysMgr.ConnectorByIndex(output));
+
+    // Hand the pin back to the port, and the mux back to the timer for PWM
+    PMUX_DISABLE(out->m_outputPort, out->m_outputDataBit);
+    PMUX_SELECTION(out->m_outputPort, out->m_outputDataBit, PER_TIMER);
+
+    CCL->CTRL.bit.ENABLE = 0;
+    CCL->LUTCTRL[lut].reg = 0;
+    if (m_extIntB[output] >= 0) {
+        CCL->LUTCTRL[linkLut].reg = 0;
+        EventUnroute(m_evsysChannel + REFLEX_CH_LUT_A,
+                     EVSYS_ID_USER_CCL_LUT_0 + linkLut);
+        EventUnroute(m_evsysChannel + REFLEX_CH_LUT_B,
+                     EVSYS_ID_USER_CCL_LUT_0 + lut);
+        InputMgr.EventOutputSet(m_extIntB[output], false);
+    }
+    else {
+        EventUnroute(m_evsysChannel + REFLEX_CH_LUT_A,
+                     EVSYS_ID_USER_CCL_LUT_0 + lut);
+    }
+    CCL->CTRL.bit.ENABLE = 1;
+    InputMgr.EventOutputSet(m_extIntA[output], false);
+
+    out->m_reflexOutput = false;
+}
+
+} // ClearCore namespace
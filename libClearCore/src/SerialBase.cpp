@@ -47,7 +47,7 @@ namespace ClearCore {
 static uint32_t spiDummy;
 
 extern volatile uint32_t tickCnt;
-extern InputManager &InputMgr;
+extern SINGLETON_REF(InputManager) InputMgr;
 
 /**
     Construct this instance and remember all the pads and bit locations.
@@ -38,7 +38,7 @@ namespace ClearCore {
 // LED feedback and option shift register
 extern ShiftRegister ShiftReg;
 // CCIO-8 management
-extern CcioBoardManager &CcioMgr;
+extern SINGLETON_REF(CcioBoardManager) CcioMgr;
 
 SerialDriver::SerialDriver(uint16_t index,
                            ShiftRegister::Masks feedBackLedMask,
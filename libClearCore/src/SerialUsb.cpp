@@ -28,7 +28,7 @@
 
 namespace ClearCore {
 
-extern UsbManager &UsbMgr;
+extern SINGLETON_REF(UsbManager) UsbMgr;
 
 SerialUsb::SerialUsb(uint16_t index) :
     m_index(index) {}
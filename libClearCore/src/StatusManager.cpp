@@ -33,6 +33,7 @@
 #include "NvmManager.h"
 #include "SdCardDriver.h"
 #include "SysConnectors.h"
+#include "SysSingleton.h"
 #include "SysTiming.h"
 
 namespace ClearCore {
@@ -40,13 +41,13 @@ namespace ClearCore {
 extern volatile uint32_t tickCnt;
 extern DigitalInOutHBridge *const hBridgeCon[];
 extern MotorDriver *const MotorConnectors[];
-extern AdcManager &AdcMgr;
-extern CcioBoardManager &CcioMgr;
-extern EthernetManager &EthernetMgr;
-extern NvmManager &NvmMgr;
+extern SINGLETON_REF(AdcManager) AdcMgr;
+extern SINGLETON_REF(CcioBoardManager) CcioMgr;
+extern SINGLETON_REF(EthernetManager) EthernetMgr;
+extern SINGLETON_REF(NvmManager) NvmMgr;
 extern ShiftRegister ShiftReg;
 extern SdCardDriver SdCard;
-StatusManager &StatusMgr = StatusManager::Instance();
+SINGLETON_DEFINE(StatusManager, StatusMgr)
 
 #define OFFBOARD_5V_TRIP_V 4.0
 #define OVER_VOLTAGE_TRIP_V 32.0
@@ -69,13 +70,6 @@ StatusManager &StatusMgr = StatusManager::Instance();
 #define UNDER_VOLTAGE_EXIT_CNT ((uint16_t)(UNDER_VOLTAGE_EXIT_V * (1 << 15) / \
    AdcManager::ADC_CHANNEL_MAX_FLOAT[AdcManager::ADC_VSUPPLY_MON]))
 
-
-// Ensures that only one instance of StatusManager is ever created.
-StatusManager &StatusManager::Instance() {
-    static StatusManager *instance = new StatusManager;
-    return *instance;
-}
-
 StatusManager::StatusRegister StatusManager::StatusRT(StatusRegister mask) {
     StatusRegister statusReg;
     statusReg.reg = atomic_load_n(&m_statusRegRT.reg) & mask.reg;
@@ -23,20 +23,35 @@
 #include "StepGenerator.h"
 #include <math.h>
 #include <sam.h>
+#include "FixedPoint.h"
 #include "SysTiming.h"
+#include "SysUtils.h"
 
 namespace ClearCore {
 
+extern SINGLETON_REF(AdcManager) AdcMgr;
+
 #define min(a, b) (((a) < (b)) ? (a) : (b))
 #define max(a, b) (((a) > (b)) ? (a) : (b))
 
+// Velocities and accelerations are Q16_15; positions are Q48_15
+static_assert(Q16_15::FromInt(1).Raw() == 1 << FRACT_BITS &&
+              Q48_15::FromInt(1).Raw() == 1 << FRACT_BITS,
+              "StepGenerator: FRACT_BITS must match the FixedPoint formats");
+
 /*
     This is an internal function to calculate how many pulses to send to each
     motor. It tracks the current command, as well as how many steps have been
     sent, and calculates how many steps to send in the next ISR.
 */
 
-void StepGenerator::StepsCalculated() {
+HOT_ISR_FUNC void StepGenerator::StepsCalculated() {
+
+    // An analog jog binding bypasses the move state machine entirely.
+    if (m_jogActive) {
+        JogCalculated();
+        return;
+    }
 
     // Perform setup for a newly issued move.
     // This is handled separately from the main state machine to determine
@@ -45,8 +60,7 @@ void StepGenerator::StepsCalculated() {
     if (m_moveState == MS_START) {
         // Compute move parameters
         m_accelCurrentQx = m_accelLimitQx;
-        m_posnTargetQx = static_cast<int64_t>(m_stepsCommanded)
-                         << FRACT_BITS;
+        m_posnTargetQx = Q48_15::FromInt(m_stepsCommanded).Raw();
 
         if (m_velocityMove) {
             if (m_velTargetQx && m_velCurrentQx && m_direction != m_dirCommanded) {
@@ -119,11 +133,11 @@ void StepGenerator::StepsCalculated() {
                                         m_velCurrentQx / 2) / m_accelLimitQx;
                 if (static_cast<int64_t>(m_velLimitQx) * m_velLimitQx /
                         m_accelLimitQx - accelStepsQx > m_posnTargetQx) {
-                    // Multiplication by 2^FRACT_BITS to preserve Q-format
-                    int64_t vel64 =
-                        static_cast<int64_t>(sqrtf((float)(
-                                                       ((static_cast<int64_t>(m_stepsCommanded) << FRACT_BITS)
-                                                        + accelStepsQx) * m_accelLimitQx)));
+                    // The commanded steps are converted to Q format so the
+                    // root is in Q format as well
+                    int64_t vel64 = static_cast<int64_t>(sqrtf((float)(
+                        (Q48_15::FromInt(m_stepsCommanded).Raw() +
+                         accelStepsQx) * m_accelLimitQx)));
 
                     m_velTargetQx = static_cast<int32_t>(min(vel64, INT32_MAX));
                 }
@@ -314,7 +328,7 @@ void StepGenerator::StepsCalculated() {
             m_dirCommanded = !m_direction;
             // Zero previous move
             m_stepsSent = 0;
-            m_posnCurrentQx = m_posnCurrentQx & ~(UINT64_MAX << FRACT_BITS);
+            m_posnCurrentQx = Q48_15::FromRaw(m_posnCurrentQx).Frac().Raw();
 
             m_moveState = MS_START;
             m_moveDirChange = false;
@@ -335,7 +349,7 @@ void StepGenerator::StepsCalculated() {
     }
 
     // Compute burst value
-    m_stepsPrevious = (m_posnCurrentQx >> FRACT_BITS) - m_stepsSent;
+    m_stepsPrevious = Q48_15::FromRaw(m_posnCurrentQx).ToInt() - m_stepsSent;
 
     // Update accumulated integer position
     m_stepsSent += m_stepsPrevious;
@@ -344,6 +358,100 @@ void StepGenerator::StepsCalculated() {
     m_posnAbsolute += m_direction ? -m_stepsPrevious : m_stepsPrevious;
 }
 
+/*
+    This is an internal function to map the analog jog input to a target
+    speed. The direction of the deflection is returned in negative.
+*/
+HOT_ISR_FUNC int32_t StepGenerator::JogAnalogTarget(bool &negative) {
+    int32_t deflection = AdcMgr.FilteredResult(m_jogChannel) - m_jogCenter;
+    negative = deflection < 0;
+    // Each side of the center is normalized separately
+    int32_t span = (negative ? m_jogCenter : INT16_MAX - m_jogCenter) -
+                   m_jogDeadband;
+    int32_t magnitude = abs(deflection) - m_jogDeadband;
+
+    int32_t velTargetQx = 0;
+    if (magnitude > 0 && span > 0) {
+        // Deflection past the deadband as a fraction of full travel
+        Q16_15 fract =
+            min(Q16_15::FromRaw(Q16_15::FromInt(magnitude).Raw() / span),
+                Q16_15::FromInt(1));
+        switch (m_jogCurve) {
+            case JOG_CURVE_SQUARE:
+                fract *= fract;
+                break;
+            case JOG_CURVE_CUBE:
+                fract *= fract * fract;
+                break;
+            case JOG_CURVE_LINEAR:
+            default:
+                break;
+        }
+        velTargetQx = (Q16_15::FromRaw(m_jogVelMaxQx) * fract).Raw();
+    }
+    return velTargetQx;
+}
+
+/*
+    This is an internal function to calculate the steps for the next sample
+    while the velocity is bound to an analog input or a follow target. The
+    target velocity is found and the current velocity is slewed toward it
+    at the jog acceleration limit. Reversals ramp through zero before the
+    direction output is flipped.
+*/
+HOT_ISR_FUNC void StepGenerator::JogCalculated() {
+    bool negative;
+    int32_t velTargetQx;
+    if (m_jogFollow) {
+        int32_t targetQx = m_jogTargetQx;
+        negative = targetQx < 0;
+        velTargetQx = min(abs(targetQx), m_jogVelMaxQx);
+    }
+    else {
+        velTargetQx = JogAnalogTarget(negative);
+    }
+
+    // Don't drive further into an asserted hardware limit
+    if (negative ? m_limitInfo.InNegHWLimit : m_limitInfo.InPosHWLimit) {
+        velTargetQx = 0;
+    }
+
+    if (negative != m_direction && velTargetQx) {
+        if (m_velCurrentQx) {
+            // Still moving the other way, ramp down to zero first
+            velTargetQx = 0;
+        }
+        else {
+            m_direction = negative;
+            m_dirCommanded = negative;
+            OutputDirection();
+        }
+    }
+
+    int32_t velLastQx = m_velCurrentQx;
+    if (m_velCurrentQx < velTargetQx) {
+        m_velCurrentQx = min(m_velCurrentQx + m_jogAccelQx, velTargetQx);
+        m_moveState = MS_ACCEL;
+    }
+    else if (m_velCurrentQx > velTargetQx) {
+        m_velCurrentQx = max(m_velCurrentQx - m_jogAccelQx, velTargetQx);
+        m_moveState = MS_DECEL_VEL;
+    }
+    else {
+        m_moveState = MS_CRUISE;
+    }
+    m_velTargetQx = velTargetQx;
+
+    // Keep only the partial step so the position can never overflow, then
+    // advance by the average velocity over the sample.
+    m_posnCurrentQx = Q48_15::FromRaw(m_posnCurrentQx).Frac().Raw();
+    m_posnCurrentQx += (velLastQx + m_velCurrentQx) >> 1;
+
+    m_stepsPrevious = Q48_15::FromRaw(m_posnCurrentQx).ToInt();
+    m_stepsSent = m_stepsPrevious;
+    m_posnAbsolute += m_direction ? -m_stepsPrevious : m_stepsPrevious;
+}
+
 /*
     Default constructor
 */
@@ -360,6 +468,15 @@ StepGenerator::StepGenerator()
       m_velocityMove(false),
       m_moveDirChange(false),
       m_dirCommanded(false),
+      m_jogActive(false),
+      m_jogChannel(AdcManager::ADC_AIN09),
+      m_jogCurve(JOG_CURVE_LINEAR),
+      m_jogCenter(1 << 14),
+      m_jogDeadband(0),
+      m_jogVelMaxQx(0),
+      m_jogAccelQx(2),
+      m_jogFollow(false),
+      m_jogTargetQx(0),
       m_velLimitQx(1),
       m_altVelLimitQx(0),
       m_accelLimitQx(2),
@@ -384,6 +501,7 @@ StepGenerator::StepGenerator()
 void StepGenerator::MoveStopAbrupt() {
     // Block the interrupt while changing the command
     __disable_irq();
+    m_jogActive = false;
     m_posnCurrentQx = 0;
     m_velCurrentQx = 0;
     m_stepsSent = 0;
@@ -404,6 +522,7 @@ bool StepGenerator::Move(int32_t dist, MoveTarget moveTarget) {
 
     // Block the interrupt while changing the command
     __disable_irq();
+    m_jogActive = false;
     // Make relative moves be based off of current position during a velocity
     // move
     if (m_velocityMove) {
@@ -440,7 +559,7 @@ bool StepGenerator::Move(int32_t dist, MoveTarget moveTarget) {
 
     // Zero the integer portion of the current position. We want to keep
     // partial steps so movement is smooth.
-    m_posnCurrentQx = m_posnCurrentQx & ~(UINT64_MAX << FRACT_BITS);
+    m_posnCurrentQx = Q48_15::FromRaw(m_posnCurrentQx).Frac().Raw();
 
     // Determine the direction of the movements.
     m_dirCommanded = m_stepsCommanded < 0;
@@ -463,6 +582,7 @@ bool StepGenerator::Move(int32_t dist, MoveTarget moveTarget) {
 bool StepGenerator::MoveVelocity(int32_t velocity) {
     // Block the interrupt while changing the command
     __disable_irq();
+    m_jogActive = false;
     m_dirCommanded = (velocity < 0);
 
     m_velocityMove = true;
@@ -471,7 +591,7 @@ bool StepGenerator::MoveVelocity(int32_t velocity) {
     AltVelMax(velAbsolute);
     UpdatePendingMoveLimits();
     m_stepsCommanded = INT32_MAX;
-    m_posnCurrentQx &= ~(UINT64_MAX << FRACT_BITS);
+    m_posnCurrentQx = Q48_15::FromRaw(m_posnCurrentQx).Frac().Raw();
     m_stepsSent = 0;
 
     m_moveState = MS_START;
@@ -486,6 +606,7 @@ void StepGenerator::MoveStopDecel(uint32_t decelMax) {
         m_altDecelLimitQx = m_altDecelLimitPendingQx;
     }
     __disable_irq();
+    m_jogActive = false;
     m_accelLimitQx = max(m_altDecelLimitQx, m_accelLimitQx);
     m_velocityMove = true;
     m_altVelLimitQx = 0;
@@ -500,10 +621,10 @@ void StepGenerator::MoveStopDecel(uint32_t decelMax) {
 void StepGenerator::VelMax(uint32_t velMax) {
     // Convert from step pulses/sec to step pulses/sample
     int64_t velLim64 =
-        (static_cast<int64_t>(velMax) << FRACT_BITS) / SampleRateHz;
+        Q48_15::FromInt(velMax).Raw() / SampleRateHz;
     // Enforce the max steps per sample time
     velLim64 =
-        min(velLim64, static_cast<int64_t>(m_stepsPerSampleMax) << FRACT_BITS);
+        min(velLim64, Q48_15::FromInt(m_stepsPerSampleMax).Raw());
     // Ensure we didn't overflow 32-bit int
     velLim64 = min(velLim64, INT32_MAX);
     // Enforce minimum velocity of 1 step pulse/sample
@@ -517,26 +638,26 @@ void StepGenerator::VelMax(uint32_t velMax) {
 void StepGenerator::AltVelMax(int32_t velMax) {
     // Convert from step pulses/sec to step pulses/sample
     int64_t velLim64 =
-        (static_cast<int64_t>(velMax) << FRACT_BITS) / SampleRateHz;
+        Q48_15::FromInt(velMax).Raw() / SampleRateHz;
     // Enforce the max steps per sample time
     velLim64 =
-        min(velLim64, static_cast<int64_t>(m_stepsPerSampleMax) << FRACT_BITS);
+        min(velLim64, Q48_15::FromInt(m_stepsPerSampleMax).Raw());
     // Ensure we didn't overflow 32-bit int
     m_altVelLimitPendingQx = min(velLim64, INT32_MAX);
 }
 
 int32_t StepGenerator::VelocityRefCommanded() {
     // Reverse the calculation in AltVelMax to get the velocity in the same
-    // units that the user put in. Add half a decimal for rounding.
-    int32_t velTemp = ((static_cast<int64_t>(m_velCurrentQx) * SampleRateHz +
-                        (1 << (FRACT_BITS - 1))) >> FRACT_BITS);
+    // units that the user put in, rounded to the nearest.
+    int32_t velTemp = Q48_15::FromRaw(static_cast<int64_t>(m_velCurrentQx) *
+                                      SampleRateHz).ToIntRounded();
     return m_direction ? -velTemp : velTemp;
 }
 
 static int32_t ConvertAccel(uint32_t pulsesPerSecSq) {
     // Convert from step pulses/sec/sec to step pulses/sample/sample
-    int64_t accelLim64 = ((static_cast<int64_t>(pulsesPerSecSq) << FRACT_BITS) /
-                          (SampleRateHz * SampleRateHz));
+    int64_t accelLim64 = Q48_15::FromInt(pulsesPerSecSq).Raw() /
+                         (SampleRateHz * SampleRateHz);
     // Ensure we didn't overflow 32-bit int
     int32_t accelLim32 = min(accelLim64, INT32_MAX);
     // Since accel has to be divided by 2 when calculating position increments,
@@ -549,6 +670,101 @@ static int32_t ConvertAccel(uint32_t pulsesPerSecSq) {
     return accelLim32;
 }
 
+/*
+    This function binds the velocity to an analog input. The limits are
+    converted to Q format here so the sample interrupt only has to scale.
+*/
+bool StepGenerator::AnalogJog(AdcManager::AdcChannels channel,
+                              uint32_t velMax, uint32_t accelMax,
+                              uint16_t deadband, JogCurves curve) {
+    if (channel >= AdcManager::ADC_CHANNEL_COUNT) {
+        return false;
+    }
+    // Convert from step pulses/sec to step pulses/sample
+    int64_t velLim64 =
+        Q48_15::FromInt(velMax).Raw() / SampleRateHz;
+    // Enforce the max steps per sample time
+    velLim64 =
+        min(velLim64, Q48_15::FromInt(m_stepsPerSampleMax).Raw());
+    velLim64 = min(velLim64, INT32_MAX);
+
+    // Block the interrupt while changing the command
+    __disable_irq();
+    m_jogChannel = channel;
+    m_jogVelMaxQx = velLim64;
+    m_jogAccelQx = ConvertAccel(accelMax);
+    m_jogDeadband = deadband;
+    m_jogCurve = curve;
+    m_jogFollow = false;
+
+    m_velocityMove = true;
+    m_moveDirChange = false;
+    m_dirCommanded = m_direction;
+    UpdatePendingMoveLimits();
+    m_stepsCommanded = INT32_MAX;
+    m_posnCurrentQx = Q48_15::FromRaw(m_posnCurrentQx).Frac().Raw();
+    m_stepsSent = 0;
+    m_jogActive = true;
+    __enable_irq();
+
+    return true;
+}
+
+void StepGenerator::AnalogJogStop() {
+    __disable_irq();
+    if (m_jogActive) {
+        m_jogActive = false;
+        // Finish as a velocity move ramping to zero at the jog rate
+        m_accelLimitQx = m_jogAccelQx;
+        m_altVelLimitQx = 0;
+        m_moveState = MS_START;
+    }
+    __enable_irq();
+}
+
+/*
+    This function binds the velocity to a target set by VelocityFollowTarget,
+    slewed by the same code as an analog jog.
+*/
+bool StepGenerator::VelocityFollow(uint32_t velMax, uint32_t accelMax) {
+    // Convert from step pulses/sec to step pulses/sample
+    int64_t velLim64 =
+        Q48_15::FromInt(velMax).Raw() / SampleRateHz;
+    // Enforce the max steps per sample time
+    velLim64 =
+        min(velLim64, Q48_15::FromInt(m_stepsPerSampleMax).Raw());
+    velLim64 = min(velLim64, INT32_MAX);
+
+    // Block the interrupt while changing the command
+    __disable_irq();
+    m_jogVelMaxQx = velLim64;
+    m_jogAccelQx = ConvertAccel(accelMax);
+    m_jogTargetQx = 0;
+    m_jogFollow = true;
+
+    m_velocityMove = true;
+    m_moveDirChange = false;
+    m_dirCommanded = m_direction;
+    UpdatePendingMoveLimits();
+    m_stepsCommanded = INT32_MAX;
+    m_posnCurrentQx = Q48_15::FromRaw(m_posnCurrentQx).Frac().Raw();
+    m_stepsSent = 0;
+    m_jogActive = true;
+    __enable_irq();
+
+    return true;
+}
+
+HOT_ISR_FUNC void StepGenerator::VelocityFollowTarget(int32_t velocity) {
+    // Convert from step pulses/sec to step pulses/sample. The binding clamps
+    // the target to its velMax, which always fits in 32 bits.
+    int64_t targetQx =
+        Q48_15::FromInt(velocity).Raw() / SampleRateHz;
+    targetQx = max(min(targetQx, INT32_MAX), -INT32_MAX);
+    // A single store, so the interrupt never sees a partial update
+    m_jogTargetQx = targetQx;
+}
+
 /*
     This function takes the acceleration in step pulses/sec^2
     and sets AccLimitQx in step pulses/sample^2.
@@ -577,7 +793,7 @@ void StepGenerator::StepsPerSampleMaxSet(uint32_t maxSteps) {
     MoveStopAbrupt();
     m_stepsPerSampleMax = maxSteps;
     // Recalculate maximum velocity limit
-    int64_t velLim64 = static_cast<int64_t>(m_stepsPerSampleMax) << FRACT_BITS;
+    int64_t velLim64 = Q48_15::FromInt(m_stepsPerSampleMax).Raw();
     // Ensure we didn't overflow 32-bit int
     velLim64 = min(velLim64, INT32_MAX);
     // Enforce minimum velocity of 1 step pulse/sample
@@ -28,10 +28,12 @@
 **/
 
 #include "SysManager.h"
+#include <malloc.h>
 #include <stddef.h>
 #include <stdio.h>
 #include "AdcManager.h"
 #include "CcioBoardManager.h"
+#include "ControlLoopManager.h"
 #include "DigitalIn.h"
 #include "DigitalInAnalogIn.h"
 #include "DigitalInOut.h"
@@ -42,10 +44,13 @@
 #include "EthernetManager.h"
 #include "HardwareMapping.h"
 #include "InputManager.h"
+#include "IoManager.h"
 #include "LedDriver.h"
 #include "MotorDriver.h"
 #include "MotorManager.h"
 #include "NvmManager.h"
+#include "PulseCounter.h"
+#include "ReflexManager.h"
 #include "SdCardDriver.h"
 #include "SerialDriver.h"
 #include "SerialUsb.h"
@@ -55,49 +60,75 @@
 #include "SysTiming.h"
 #include "SysUtils.h"
 #include "UsbManager.h"
+#include "WorkScheduler.h"
 #include "XBeeDriver.h"
 
-// Variable from linker script
+// Variables from linker script
 extern uint32_t __text_start__;
+extern uint32_t __data_start__;
+extern uint32_t __bss_end__;
+extern uint32_t __end__;
+extern uint32_t __StackTop;
+extern "C" char *_sbrk(int incr);
 
 namespace ClearCore {
 
 bool FastSysTick = false;
 
+// CPU cycles from reset to main(), recorded by Reset_Handler
+static uint32_t startupCycleCount = 0;
+
 // Interrupt priority 0(High) - 7(Low)
-#define TONE_INTERRUPT_PRIORITY 2
 #define MAIN_INTERRUPT_PRIORITY 3
 #define SYSTICK_INTERRUPT_PRIORITY 6
-#define EIC_INTERRUPT_PRIORITY 7
+#define EIC_INTERRUPT_PRIORITY 6
+// Deferred work may block (e.g. CCIO-8 rediscovery over SPI), so it must
+// sit strictly below the input interrupts
+#define PENDSV_INTERRUPT_PRIORITY 7
 
 // These must match the bootloader!
 #define DOUBLE_TAP_MAGIC            0xf01669efUL
 #define BOOT_DOUBLE_TAP_ADDRESS     (HSRAM_ADDR + HSRAM_SIZE - 4)
 
+// Fill pattern for unused RAM between the heap and the stack
+#define STACK_PAINT_PATTERN         0xC1EAC0DEUL
+// Bytes below the stack pointer left unpainted at startup
+#define STACK_PAINT_GUARD           64
+
 // EVSYS channel assignments
 enum _evSysCh {
     // Motor HLFB event generators for period/pulse-width TC mode
     EVSYS_M0,
     EVSYS_M1,
     EVSYS_M2,
-    EVSYS_M3
+    EVSYS_M3,
+    // EIC event generator for the pulse counter TC
+    EVSYS_COUNTER,
+    // EIC event generators for the reflex links
+    EVSYS_REFLEX,
+    EVSYS_REFLEX_END = EVSYS_REFLEX + REFLEX_EVSYS_CHANNELS
 };
 
 extern volatile uint32_t tickCnt;
 extern uint32_t NvmMgrUnlock;
 
 // Create our core system objects
-extern AdcManager &AdcMgr;
-extern DmaManager &DmaMgr;
-extern EthernetManager &EthernetMgr;
-extern CcioBoardManager &CcioMgr;
+extern SINGLETON_REF(AdcManager) AdcMgr;
+extern SINGLETON_REF(DmaManager) DmaMgr;
+extern SINGLETON_REF(EthernetManager) EthernetMgr;
+extern SINGLETON_REF(CcioBoardManager) CcioMgr;
+extern SINGLETON_REF(ControlLoopManager) ControlLoopMgr;
 EncoderInput EncoderIn;
-extern InputManager &InputMgr;
-extern MotorManager &MotorMgr;
-extern NvmManager &NvmMgr;
-extern StatusManager &StatusMgr;
-extern UsbManager &UsbMgr;
-extern SysTiming &TimingMgr;
+PulseCounter CounterIn(EVSYS_COUNTER);
+ReflexManager ReflexMgr(EVSYS_REFLEX);
+extern SINGLETON_REF(InputManager) InputMgr;
+extern SINGLETON_REF(IoManager) IoMgr;
+extern SINGLETON_REF(MotorManager) MotorMgr;
+extern SINGLETON_REF(NvmManager) NvmMgr;
+extern SINGLETON_REF(StatusManager) StatusMgr;
+extern SINGLETON_REF(UsbManager) UsbMgr;
+extern SINGLETON_REF(SysTiming) TimingMgr;
+extern SINGLETON_REF(WorkScheduler) WorkSched;
 SdCardDriver SdCard;
 ShiftRegister ShiftReg;
 XBeeDriver XBee;
@@ -179,10 +210,12 @@ SysManager::SysManager() : m_readyForOperations(false) {
 
     ConnectorIO4 = DigitalInOutHBridge(ShiftRegister::SR_LED_IO_4_MASK, &IN04n,
                                        &OUT04_ENABLE04, &Polarity04_PWM04A,
-                                       &Polarity04S_PWM04B, TCC4_0_IRQn, false);
+                                       &Polarity04S_PWM04B, DMA_IO4_TONE_A,
+                                       false);
     ConnectorIO5 = DigitalInOutHBridge(ShiftRegister::SR_LED_IO_5_MASK, &IN05n,
                                        &OUT05_ENABLE05, &Polarity05_PWM05A,
-                                       &Polarity05S_PWM05B, TCC3_0_IRQn, false);
+                                       &Polarity05S_PWM05B, DMA_IO5_TONE_A,
+                                       false);
 
     ConnectorDI6 = DigitalIn(ShiftRegister::SR_LED_DI_6_MASK, &IN06n_QuadA);
     ConnectorDI7 = DigitalIn(ShiftRegister::SR_LED_DI_7_MASK, &IN07n_QuadB);
@@ -273,6 +306,7 @@ void SysManager::Initialize() {
     CcioMgr.Initialize();
     UsbMgr.Initialize();
     EncoderIn.Initialize();
+    CounterIn.Initialize();
 
     // Configure external interrupt controller
     SET_CLOCK_SOURCE(EIC_GCLK_ID, 0);
@@ -297,11 +331,6 @@ void SysManager::Initialize() {
     NVIC_EnableIRQ(GMAC_IRQn);
     NVIC_SetPriority(GMAC_IRQn, MAIN_INTERRUPT_PRIORITY);
 
-    NVIC_EnableIRQ(TCC4_0_IRQn); // Enable IO4 tone interrupt
-    NVIC_EnableIRQ(TCC3_0_IRQn); // Enable IO5 tone interrupt
-    NVIC_SetPriority(TCC4_0_IRQn, TONE_INTERRUPT_PRIORITY); // Set priority
-    NVIC_SetPriority(TCC3_0_IRQn, TONE_INTERRUPT_PRIORITY); // Set priority
-
     // Set SysTick to 1ms interval
     if (TimingMgr.SysTickPeriodMicroSec(1000)) {
         // Capture error
@@ -312,6 +341,10 @@ void SysManager::Initialize() {
     // Set priority for SysTick interrupt (2nd lowest).
     NVIC_SetPriority(SysTick_IRQn, SYSTICK_INTERRUPT_PRIORITY);
 
+    // Deferred work runs on PendSV at the lowest priority so that it never
+    // holds off any other interrupt.
+    NVIC_SetPriority(PendSV_IRQn, PENDSV_INTERRUPT_PRIORITY);
+
     // Run power-on tests and detect faults if any.
     StatusMgr.Initialize(ShiftRegister::SR_UNDERGLOW_MASK);
 
@@ -328,21 +361,30 @@ void SysManager::Initialize() {
 /**
     Update systems at the sample rate
 **/
-void SysManager::UpdateFastImpl() {
+HOT_ISR_FUNC void SysManager::UpdateFastImpl() {
+    IoMgr.UpdateBegin();
     CcioMgr.Refresh();
     AdcMgr.Update();
     StatusMgr.Refresh();
     UsbMgr.Refresh();
     InputMgr.UpdateBegin();
+    // Read the encoder first so the DC motor velocity loops run in the
+    // connector refresh see this sample's velocity
+    EncoderIn.Update();
 
     if (SysMgr.Ready()) {
+        InputMgr.UpdateFilters();
         for (uint8_t i = 0; i < CLEARCORE_PIN_MAX; i++) {
             Connectors[i]->Refresh();
         }
     }
 
     InputMgr.UpdateEnd();
-    EncoderIn.Update();
+    CounterIn.Update();
+    IoMgr.UpdateEnd();
+
+    // Close control loops once all of the inputs are updated
+    ControlLoopMgr.Update();
 
     // Update subsystems in the background
     ShiftReg.Update();
@@ -441,6 +483,10 @@ void SysManager::InitClocks() {
     SET_CLOCK_SOURCE(TCC3_GCLK_ID, 0);
     CLOCK_ENABLE(APBCMASK, TCC3_);
 
+    // TCC2 paces IO0 analog waveform playback. Its clock is shared with
+    // TCC3.
+    CLOCK_ENABLE(APBCMASK, TCC2_);
+
     // TCC4 used by IO4 for H-bridge PWM generation
     SET_CLOCK_SOURCE(TCC4_GCLK_ID, 0);
     CLOCK_ENABLE(APBDMASK, TCC4_);
@@ -456,7 +502,8 @@ void SysManager::InitClocks() {
 
         tcCount->CTRLBCLR.bit.LUPD = 1; // Double buffering
         tcCount->CTRLA.bit.MODE = TC_CTRLA_MODE_COUNT8_Val;
-        // Make 500Hz carrier from GCLK
+        // Make the default 500Hz carrier from GCLK; DigitalInOut::PwmFrequency
+        // may change it later
         tcCount->CTRLA.bit.PRESCALER = TC_CTRLA_PRESCALER_DIV16_Val;
         tcCount->WAVE.reg = TC_WAVE_WAVEGEN_NPWM;
         tcCount->DRVCTRL.reg = TC_DRVCTRL_INVEN_Msk;
@@ -492,6 +539,67 @@ void SysManager::ResetBoard(ResetModes mode) {
     }
 }
 
+uint32_t SysManager::StartupCycles() {
+    return startupCycleCount;
+}
+
+void SysManager::GetMemoryDiagnostics(MemoryDiagnostics &diagnostics) {
+    struct mallinfo heapInfo = mallinfo();
+    uint32_t *heapTop = reinterpret_cast<uint32_t *>(
+                            (reinterpret_cast<uint32_t>(_sbrk(0)) + 3) & ~3UL);
+    uint32_t stackTop = reinterpret_cast<uint32_t>(&__StackTop);
+
+    // Anything the heap has grown into no longer counts as painted, so start
+    // the search at the top of the heap.
+    uint32_t *stackLowest = heapTop;
+    while (stackLowest < &__StackTop && *stackLowest == STACK_PAINT_PATTERN) {
+        stackLowest++;
+    }
+
+    diagnostics.StaticBytes = reinterpret_cast<uint32_t>(&__bss_end__) -
+                              reinterpret_cast<uint32_t>(&__data_start__);
+    diagnostics.HeapArenaBytes = heapInfo.arena;
+    diagnostics.HeapUsedBytes = heapInfo.uordblks;
+    diagnostics.HeapFreeBytes = heapInfo.fordblks;
+    diagnostics.HeapFreeBlocks = heapInfo.ordblks;
+    diagnostics.StackUsedBytes = stackTop - __get_MSP();
+    diagnostics.StackMaxUsedBytes =
+        stackTop - reinterpret_cast<uint32_t>(stackLowest);
+    diagnostics.HeadroomBytes = reinterpret_cast<uint32_t>(stackLowest) -
+                                reinterpret_cast<uint32_t>(heapTop);
+}
+
+void SysManager::CacheEnable(bool enable) {
+    if (enable) {
+        CMCC->CTRL.reg = CMCC_CTRL_CEN;
+    }
+    else {
+        CMCC->CTRL.reg = 0;
+        // Wait for the cache to report that it is disabled
+        while (CMCC->SR.bit.CSTS) {
+            continue;
+        }
+    }
+}
+
+bool SysManager::CacheEnabled() {
+    return CMCC->SR.bit.CSTS;
+}
+
+void SysManager::CacheInvalidate() {
+    bool wasEnabled = CacheEnabled();
+    // The cache must be disabled while it is invalidated
+    CacheEnable(false);
+    CMCC->MAINT0.reg = CMCC_MAINT0_INVALL;
+    if (wasEnabled) {
+        CacheEnable(true);
+    }
+}
+
+void SysManager::CacheWaysLock(uint8_t wayMask) {
+    CMCC->LCKWAY.reg = CMCC_LCKWAY_LCKWAY(wayMask);
+}
+
 void SysManager::SysTickUpdate() {
     if (!FastSysTick) {
         SysMgr.UpdateSlowImpl();
@@ -500,7 +608,7 @@ void SysManager::SysTickUpdate() {
 
 #define ACK_FAST_UPDATE_INT TCC0->INTFLAG.reg = TCC_INTFLAG_MASK
 
-void SysManager::FastUpdate() {
+HOT_ISR_FUNC void SysManager::FastUpdate() {
     ACK_FAST_UPDATE_INT;
     TimingMgr.IsrStart();
     SysMgr.UpdateFastImpl();
@@ -616,18 +724,16 @@ extern "C" void EIC_15_Handler(void) {
     ClearCore::InputMgr.EIC_Handler(15);
 }
 
-extern "C" void TCC3_0_Handler(void) {
-    TCC3->INTFLAG.reg = TCC_INTFLAG_MASK;
-    ClearCore::ConnectorIO5.ToneUpdate();
-}
-extern "C" void TCC4_0_Handler(void) {
-    TCC4->INTFLAG.reg = TCC_INTFLAG_MASK;
-    ClearCore::ConnectorIO4.ToneUpdate();
-}
-
 extern "C" void SysTick_Handler(void) {
     ClearCore::SysMgr.SysTickUpdate();
 }
+
+/**
+    Lowest priority exception to run deferred background work
+**/
+extern "C" void PendSV_Handler(void) {
+    ClearCore::WorkSched.Drain();
+}
 /**
     Interrupt to handle ClearCore background tasks
 **/
@@ -645,11 +751,8 @@ extern "C" void InitSysManager() {
 /////////////////////////////////////////////////////////////////
 
 extern uint32_t __etext;
-extern uint32_t __data_start__;
 extern uint32_t __data_end__;
 extern uint32_t __bss_start__;
-extern uint32_t __bss_end__;
-extern uint32_t __StackTop;
 extern "C" void __libc_init_array(void);
 
 extern int main(void);
@@ -660,6 +763,11 @@ extern int main(void);
 void Reset_Handler(void) {
     uint32_t *pSrc, *pDest;
 
+    // Count the startup cycles; SysMgr.Initialize() restarts the counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL = DWT_CTRL_CYCCNTENA_Msk;
+
     // Initialize the initialized data section
     pSrc = &__etext;
     pDest = &__data_start__;
@@ -677,12 +785,22 @@ void Reset_Handler(void) {
         }
     }
 
+    // Paint the unused RAM so that the stack high-water mark can be found
+    // later. Leave a guard below the current stack pointer alone.
+    for (pDest = &__end__;
+            reinterpret_cast<uint32_t>(pDest) <
+            __get_MSP() - STACK_PAINT_GUARD; pDest++) {
+        *pDest = STACK_PAINT_PATTERN;
+    }
+
     SystemInit();
 
     /* Initialize the C library */
     __libc_init_array();
 
+    uint32_t initCycles = DWT->CYCCNT;
     ClearCore::SysMgr.Initialize();
+    ClearCore::startupCycleCount = initCycles + DWT->CYCCNT;
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
@@ -25,6 +25,7 @@
 **/
 
 #include "SysTiming.h"
+#include "SysSingleton.h"
 #include <sam.h>
 
 namespace ClearCore {
@@ -34,7 +35,7 @@ extern const uint16_t SampleRateHz;
 extern bool FastSysTick;
 volatile uint32_t tickCnt = 0;
 
-SysTiming &TimingMgr = SysTiming::Instance();
+SINGLETON_DEFINE(SysTiming, TimingMgr)
 
 SysTiming::SysTiming() :
     m_isrStartCycle(0),
@@ -51,11 +52,6 @@ SysTiming::SysTiming() :
     m_microAdjLowRemainder(0) {}
 
 
-SysTiming &SysTiming::Instance() {
-    static SysTiming *instance = new SysTiming();
-    return *instance;
-}
-
 void SysTiming::IsrStart() {
     m_isrStartCycle = DWT->CYCCNT;
 }
@@ -30,6 +30,7 @@
 #include "HardwareMapping.h"
 #include "ShiftRegister.h"
 #include "SysManager.h"
+#include "SysSingleton.h"
 #include "SysUtils.h"
 #include "SysTiming.h"
 #include "sam.h"
@@ -53,7 +54,7 @@ namespace ClearCore {
 #define PA25 GPIO(GPIO_PORTA, 25)
 
 extern SysManager SysMgr;
-UsbManager &UsbMgr = UsbManager::Instance();
+SINGLETON_DEFINE(UsbManager, UsbMgr)
 
 #if CONF_USBD_HS_SP
 static uint8_t single_desc_bytes[] = {
@@ -239,11 +240,6 @@ void USB_DEVICE_INSTANCE_PORT_init(void) {
                           PINMUX_PA25H_USB_DP);
 }
 
-UsbManager &UsbManager::Instance() {
-    static UsbManager *instance = new UsbManager();
-    return *instance;
-}
-
 UsbManager::UsbManager() :
     m_inHead(0),
     m_inTail(0),
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2020 Teknic, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+    Implements the deferred work scheduler.
+
+    Work items are held in one multi-producer, single-consumer ring buffer
+    per priority level. Producers reserve a slot by advancing Head with a
+    compare-and-swap, fill in the slot, and then mark it Ready. The PendSV
+    handler is the only consumer and advances Tail.
+*/
+
+#include "WorkScheduler.h"
+#include <sam.h>
+#include "atomic_utils.h"
+#include "SysSingleton.h"
+#include "SysTiming.h"
+
+namespace ClearCore {
+
+static_assert((WORK_QUEUE_DEPTH & (WORK_QUEUE_DEPTH - 1)) == 0,
+              "WORK_QUEUE_DEPTH must be a power of 2");
+
+#define WORK_QUEUE_MASK (WORK_QUEUE_DEPTH - 1)
+
+SINGLETON_DEFINE(WorkScheduler, WorkSched)
+
+/**
+    Constructor
+**/
+WorkScheduler::WorkScheduler()
+    : m_queues(),
+      m_stats() {}
+
+/**
+    Post a work item to be executed in the background.
+**/
+bool WorkScheduler::Post(WorkFunc func, void *context, WorkPriority priority,
+                         uint32_t deadlineUs) {
+    if (!func || priority < WORK_PRIORITY_HIGH ||
+            priority >= WORK_PRIORITY_COUNT) {
+        return false;
+    }
+
+    WorkQueue &queue = m_queues[priority];
+
+    // Reserve a slot. Another producer may preempt us between the load and
+    // the exchange, in which case the exchange fails and we try again.
+    uint32_t head = atomic_load_n(&queue.Head);
+    do {
+        if (head - atomic_load_n(&queue.Tail) >= WORK_QUEUE_DEPTH) {
+            atomic_add_fetch(&m_stats[priority].Dropped, 1);
+            return false;
+        }
+    } while (!atomic_compare_exchange_n(&queue.Head, &head, head + 1));
+
+    WorkItem &item = queue.Items[head & WORK_QUEUE_MASK];
+    item.Func = func;
+    item.Context = context;
+    item.DeadlineCycles = deadlineUs * CYCLES_PER_MICROSECOND;
+    item.PostCycle = DWT->CYCCNT;
+    atomic_store_n(&item.Ready, true);
+
+    atomic_add_fetch(&m_stats[priority].Posted, 1);
+
+    // Request the PendSV exception; it will run once all other interrupts
+    // have finished.
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    return true;
+}
+
+/**
+    Number of work items waiting in a priority queue.
+**/
+uint32_t WorkScheduler::Pending(WorkPriority priority) {
+    if (priority < WORK_PRIORITY_HIGH || priority >= WORK_PRIORITY_COUNT) {
+        return 0;
+    }
+    return m_queues[priority].Head - m_queues[priority].Tail;
+}
+
+/**
+    Accessor for the statistics of a priority level.
+**/
+bool WorkScheduler::Stats(WorkPriority priority, WorkStats &stats) {
+    if (priority < WORK_PRIORITY_HIGH || priority >= WORK_PRIORITY_COUNT) {
+        return false;
+    }
+    __disable_irq();
+    stats = m_stats[priority];
+    __enable_irq();
+    return true;
+}
+
+/**
+    Clear the statistics of all priority levels.
+**/
+void WorkScheduler::StatsReset() {
+    __disable_irq();
+    for (uint8_t i = 0; i < WORK_PRIORITY_COUNT; i++) {
+        m_stats[i] = WorkStats();
+    }
+    __enable_irq();
+}
+
+/**
+    Execute all pending work items in priority order.
+**/
+void WorkScheduler::Drain() {
+    uint8_t priority = WORK_PRIORITY_HIGH;
+
+    while (priority < WORK_PRIORITY_COUNT) {
+        WorkQueue &queue = m_queues[priority];
+        uint32_t tail = queue.Tail;
+        WorkItem &item = queue.Items[tail & WORK_QUEUE_MASK];
+
+        // If the queue is empty, or the producer that reserved the next slot
+        // has not finished filling it in, move on to the next priority. The
+        // producer will pend PendSV again once the slot is ready.
+        if (tail == atomic_load_n(&queue.Head) || !atomic_load_n(&item.Ready)) {
+            priority++;
+            continue;
+        }
+
+        WorkFunc func = item.Func;
+        void *context = item.Context;
+        uint32_t postCycle = item.PostCycle;
+        uint32_t deadlineCycles = item.DeadlineCycles;
+        item.Ready = false;
+        // Release the slot before running so that the work item may re-post
+        // itself.
+        atomic_store_n(&queue.Tail, tail + 1);
+
+        uint32_t startCycle = DWT->CYCCNT;
+        func(context);
+        uint32_t endCycle = DWT->CYCCNT;
+
+        WorkStats &stats = m_stats[priority];
+        stats.Completed++;
+        if (stats.MaxLatencyCycles < startCycle - postCycle) {
+            stats.MaxLatencyCycles = startCycle - postCycle;
+        }
+        if (stats.MaxRunCycles < endCycle - startCycle) {
+            stats.MaxRunCycles = endCycle - startCycle;
+        }
+        if (deadlineCycles && endCycle - postCycle > deadlineCycles) {
+            stats.Overruns++;
+        }
+
+        // Any higher priority work posted while this item ran goes next.
+        priority = WORK_PRIORITY_HIGH;
+    }
+}
+
+} // ClearCore namespace